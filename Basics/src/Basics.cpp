@@ -21,6 +21,10 @@
 #include <ctime>
 #include <cstdio>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 //---------------------------------------------------------------------------
 /** \namespace Ino
   Namespace Ino is used for library functions that are developed by
@@ -1092,6 +1096,269 @@ int compareNcAlphaNum(const wchar_t *s1, const wchar_t *s2)
   return 0;
 }
 
+//---------------------------------------------------------------------------
+//------- Alpha numerical sort keys -----------------------------------------
+//---------------------------------------------------------------------------
+// The compareAlphaNum functions split a string into tokens of a (possibly
+// empty) digit run and the character that ends it (the last digit if the
+// string ends in the run). Tokens compare on the digit run value (wrapped
+// as in the functions), then the number of digits, then that character.
+// A key encodes each token prefix free and order preserving:
+//   digit run: none, or 0xFF + (1 for value 0, 1 + n + n value bytes)
+//              + the digit count as 1..4 count bytes;
+//   char:      the byte with the sign bit of char flipped, 0xFF 0 for 0xFF;
+//   wchar_t:   1..0x7F as is, 0x80 + n + n bytes above that,
+//              0 + 4 bytes for negative values.
+// So plain text costs one byte per character. A leading 1 makes every
+// string greater than NULL (an empty key).
+
+static inline bool anIsDigit(char c)    { return isdigit(c) != 0; }
+static inline bool anIsDigit(wchar_t c) { return iswdigit(c) != 0; }
+
+static inline char    anLower(char c)    { return (char)tolower(c); }
+static inline wchar_t anLower(wchar_t c) { return towlower(c); }
+
+static inline void anPut(unsigned char *key, size_t cap, size_t& len,
+                                                        unsigned int b)
+{
+  if (len < cap) key[len] = (unsigned char)b;
+  ++len;
+}
+
+static void anPutBytes(unsigned char *key, size_t cap, size_t& len,
+                       unsigned __int64 v, int n)
+{
+  while (--n >= 0) anPut(key,cap,len,(unsigned int)(v >> (8*n)) & 0xFF);
+}
+
+static int anByteCnt(unsigned __int64 v)
+{
+  int n = 0;
+
+  for (;v;v >>= 8) n++;
+
+  return n;
+}
+
+static void anPutChar(unsigned char *key, size_t cap, size_t& len, char c)
+{
+  const unsigned int signFlip = (char)-1 < 0 ? 0x80 : 0;
+
+  unsigned int b = (unsigned char)c ^ signFlip;
+
+  anPut(key,cap,len,b);
+  if (b == 0xFF) anPut(key,cap,len,0);
+}
+
+static void anPutChar(unsigned char *key, size_t cap, size_t& len,
+                                                              wchar_t c)
+{
+  if (c < 0) {
+    anPut(key,cap,len,0);
+    anPutBytes(key,cap,len,(unsigned int)c,4);
+  }
+  else if (c < 0x80) anPut(key,cap,len,(unsigned int)c);
+  else {
+    int n = anByteCnt((unsigned __int64)c);
+
+    anPut(key,cap,len,0x80 + n);
+    anPutBytes(key,cap,len,(unsigned __int64)c,n);
+  }
+}
+
+template <class C>
+static size_t anKey(const C *s, unsigned char *key, size_t cap, bool noCase)
+{
+  size_t len = 0;
+
+  if (!s) return len;
+
+  anPut(key,cap,len,1);
+
+  while (*s) {
+    C c = 0;
+    unsigned __int64 v = 0;
+    int digs = 0;
+
+    while (*s && anIsDigit(c = noCase ? anLower(*s++) : *s++)) {
+      digs++;
+      v *= 10; v += (c - '0');
+    }
+
+    if (digs > 0) {
+      int n = anByteCnt(v);
+
+      anPut(key,cap,len,0xFF);
+      anPut(key,cap,len,1 + n);
+      anPutBytes(key,cap,len,v,n);
+
+      n = anByteCnt((unsigned int)digs);
+
+      anPut(key,cap,len,n);
+      anPutBytes(key,cap,len,(unsigned int)digs,n);
+    }
+
+    anPutChar(key,cap,len,c);
+  }
+
+  return len;
+}
+
+//---------------------------------------------------------------------------
+/** Builds the <em>alpha numerical</em> sort key of an ASCII string.
+
+    Comparing two keys with compareAlphaNumKeys() gives the same result as
+    comparing the strings with compareAlphaNum(), or compareNcAlphaNum()
+    if \c noCase is \c true. Build the keys once to sort or search many
+    strings.
+
+    \param s The string, may be \c NULL (gives an empty key).
+    \param key Receives the key, at most \c keyCap bytes are written.
+    \param keyCap The capacity of \c key, may be \c 0.
+    \param noCase If \c true the key ignores case.
+    \return The length of the complete key, which may be larger than
+    \c keyCap. About one byte per character.
+*/
+
+size_t alphaNumKey(const char *s, unsigned char *key, size_t keyCap,
+                                                            bool noCase)
+{
+  return anKey(s,key,keyCap,noCase);
+}
+
+//---------------------------------------------------------------------------
+/** Builds the <em>alpha numerical</em> sort key of a Unicode string.
+    See alphaNumKey(const char *, unsigned char *, size_t, bool).
+*/
+
+size_t alphaNumKey(const wchar_t *s, unsigned char *key, size_t keyCap,
+                                                            bool noCase)
+{
+  return anKey(s,key,keyCap,noCase);
+}
+
+//---------------------------------------------------------------------------
+/** Compares two keys built by alphaNumKey().
+    \return -1, 0 or 1, as the comparison of the strings.
+*/
+
+int compareAlphaNumKeys(const unsigned char *k1, size_t len1,
+                        const unsigned char *k2, size_t len2)
+{
+  int cmp = memcmp(k1,k2,len1 < len2 ? len1 : len2);
+
+  if (cmp < 0) return -1;
+  if (cmp > 0) return  1;
+
+  if (len1 < len2) return -1;
+  if (len1 > len2) return  1;
+
+  return 0;
+}
+
+//---------------------------------------------------------------------------
+
+// Sort entries carry the first 8 key bytes, which decide most comparisons
+// without touching the keys.
+
+struct AnSortEntry
+{
+  unsigned __int64 prefix;
+  int idx;
+};
+
+struct AnEntryLess
+{
+  const unsigned char *keys;
+  const size_t *offs;
+
+  AnEntryLess(const unsigned char *k, const size_t *o) : keys(k), offs(o) {}
+
+  bool operator()(const AnSortEntry& e1, const AnSortEntry& e2) const
+  {
+    if (e1.prefix != e2.prefix) return e1.prefix < e2.prefix;
+
+    int i1 = e1.idx, i2 = e2.idx;
+
+    int cmp = compareAlphaNumKeys(keys+offs[i1],offs[i1+1]-offs[i1],
+                                  keys+offs[i2],offs[i2+1]-offs[i2]);
+
+    return cmp < 0 || (cmp == 0 && i1 < i2);
+  }
+};
+
+template <class C>
+static void anSort(const C *const *strs, int cnt, int *order, bool noCase)
+{
+  if (cnt < 1) return;
+
+  std::vector<size_t> offs(cnt+1);
+  std::vector<unsigned char> keys;
+  std::vector<AnSortEntry> entries(cnt);
+
+  size_t len = 0;
+
+  for (int i=0; i<cnt; ++i) {
+    size_t maxLen = 1;
+    if (strs[i]) maxLen += 9 * std::char_traits<C>::length(strs[i]);
+
+    if (keys.size() < len + maxLen) keys.resize(2 * (len + maxLen));
+
+    unsigned char *key = &keys[len];
+    size_t keyLen = anKey(strs[i],key,maxLen,noCase);
+
+    unsigned __int64 prefix = 0;
+
+    for (size_t k=0; k<8; ++k) {
+      prefix <<= 8;
+      if (k < keyLen) prefix |= key[k];
+    }
+
+    entries[i].prefix = prefix;
+    entries[i].idx    = i;
+
+    offs[i] = len;
+    len += keyLen;
+  }
+
+  offs[cnt] = len;
+
+  std::sort(entries.begin(),entries.end(),
+            AnEntryLess(keys.empty() ? NULL : &keys[0],&offs[0]));
+
+  for (int i=0; i<cnt; ++i) order[i] = entries[i].idx;
+}
+
+//---------------------------------------------------------------------------
+/** Sorts ASCII strings <em>alpha numerically</em> through their sort keys.
+
+    The order is that of a stable sort with compareAlphaNum(), or
+    compareNcAlphaNum() if \c noCase is \c true, but the strings are
+    scanned only once.
+
+    \param strs The strings, elements may be \c NULL.
+    \param cnt The number of strings.
+    \param order Receives the indices of the strings in sorted order,
+    must hold \c cnt elements.
+    \param noCase If \c true the sort ignores case.
+*/
+
+void sortAlphaNum(const char *const *strs, int cnt, int *order, bool noCase)
+{
+  anSort(strs,cnt,order,noCase);
+}
+
+//---------------------------------------------------------------------------
+/** Sorts Unicode strings <em>alpha numerically</em> through their sort
+    keys. See sortAlphaNum(const char *const *, int, int *, bool).
+*/
+
+void sortAlphaNum(const wchar_t *const *strs, int cnt, int *order,
+                                                            bool noCase)
+{
+  anSort(strs,cnt,order,noCase);
+}
+
 //---------------------------------------------------------------------------
 /** Converts radians to degrees.
     \param val the value to convert from radians.
@@ -35,6 +35,21 @@ NonLinLsSolver::NonLinLsSolver(int maxSolDims, int maxDataPoints)
 
 //---------------------------------------------------------------------------
 
+NonLinLsSolver::NonLinLsSolver(MatrixWorkspace& ws, int maxSolDims,
+                                                     int maxDataPoints)
+: maxIterCount(0), relTol(1e-12), absTol(0.0),
+  rank(maxSolDims), iterCount(0),
+  solDims(maxSolDims), mat(ws,maxDataPoints,maxSolDims),
+  secMat(ws,maxDataPoints,maxSolDims),
+  vt(ws,maxSolDims,maxSolDims), rhs(ws,maxDataPoints),
+  curSol(ws,maxSolDims), deltaSol(ws,maxSolDims)
+{
+  if (maxDataPoints < maxSolDims)
+       throw IllegalArgumentException("NonLinLsSolver::NonLinLsSolver(");
+}
+
+//---------------------------------------------------------------------------
+
 NonLinLsSolver::~NonLinLsSolver()
 {
 }
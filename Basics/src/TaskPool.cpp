@@ -0,0 +1,412 @@
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//------- Shared Task Scheduling --------------------------------------------
+//---------------------------------------------------------------------------
+//------- Copyright Inofor Hoek Aut BV OCT 2026 -----------------------------
+//---------------------------------------------------------------------------
+//------- C. Wolters --------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
+#include "TaskPool.h"
+#include "Vec.h"
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <thread>
+
+namespace Ino
+{
+
+//---------------------------------------------------------------------------
+//------- Job queues --------------------------------------------------------
+//---------------------------------------------------------------------------
+// A queue is locked for each push and take. Jobs are coarse (a loop
+// worker, a chunk of objects), so this is not where the time goes.
+
+struct TaskPool::Queue
+{
+  struct Entry
+  {
+    void (*job)(void *);
+    void *arg;
+  };
+
+  std::mutex mtx;
+  std::deque<Entry> jobs;
+
+  bool pop(bool newest, Entry& ent)
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    if (jobs.empty()) return false;
+
+    if (newest) { ent = jobs.back();  jobs.pop_back(); }
+    else        { ent = jobs.front(); jobs.pop_front(); }
+
+    return true;
+  }
+};
+
+struct TaskPool::Worker
+{
+  std::thread thr;
+};
+
+static thread_local TaskPool *poolCur = NULL;  // Pool of this worker
+static thread_local int poolSelf = 0;          // Its queue index
+
+//---------------------------------------------------------------------------
+/** \param threads The concurrency, the waiting thread included, so
+    <tt>threads - 1</tt> workers are started. A value below one selects
+    the number of hardware threads.
+*/
+
+TaskPool::TaskPool(int threads)
+: queues(), workers(), queued(0), sleepers(0), stop(false)
+{
+  if (threads < 1) threads = (int)std::thread::hardware_concurrency();
+  if (threads < 1) threads = 1;
+
+  queues.push_back(new Queue);
+
+  for (int i=1; i<threads; ++i) queues.push_back(new Queue);
+
+  for (int i=1; i<threads; ++i) {
+    Worker *wrk = new Worker;
+
+    try {
+      wrk->thr = std::thread(&TaskPool::work,this,i);
+    }
+    catch (std::exception&) { // Continue with fewer threads
+      delete wrk;
+      break;
+    }
+
+    workers.push_back(wrk);
+  }
+}
+
+//---------------------------------------------------------------------------
+/** Stops the workers after the queued jobs are done. */
+
+TaskPool::~TaskPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(sleepMtx);
+    stop = true;
+  }
+
+  wake.notify_all();
+
+  for (size_t i=0; i<workers.size(); ++i) {
+    workers[i]->thr.join();
+    delete workers[i];
+  }
+
+  void (*job)(void *); void *arg;
+  while (take(0,job,arg)) job(arg);
+
+  for (size_t i=0; i<queues.size(); ++i) delete queues[i];
+}
+
+//---------------------------------------------------------------------------
+// A worker takes the newest job of its own queue, then the oldest of the
+// shared one, then steals the oldest of another worker.
+
+bool TaskPool::take(int self, void (*&job)(void *), void *& arg)
+{
+  if (queued.load() < 1) return false;
+
+  Queue::Entry ent;
+  bool fnd = self > 0 && queues[self]->pop(true,ent);
+
+  if (!fnd) fnd = queues[0]->pop(false,ent);
+
+  int qCnt = (int)queues.size();
+
+  for (int k=1; !fnd && k<qCnt; ++k) {
+    int q = (self + k) % qCnt;
+    if (q > 0 && q != self) fnd = queues[q]->pop(false,ent);
+  }
+
+  if (!fnd) return false;
+
+  --queued;
+
+  job = ent.job;
+  arg = ent.arg;
+
+  return true;
+}
+
+//---------------------------------------------------------------------------
+
+void TaskPool::work(int self)
+{
+  poolCur  = this;
+  poolSelf = self;
+
+  for (;;) {
+    void (*job)(void *); void *arg;
+
+    if (take(self,job,arg)) {
+      job(arg);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMtx);
+
+    if (stop && queued.load() < 1) break;
+
+    ++sleepers;
+    wake.wait(lock,[this]() { return queued.load() > 0 || stop; });
+    --sleepers;
+  }
+
+  poolCur = NULL;
+}
+
+//---------------------------------------------------------------------------
+/** Queues \c job. On a worker of this pool it goes to the worker's own
+    queue, where it is the first to be taken by that worker.
+*/
+
+void TaskPool::execute(void (*job)(void *arg), void *arg)
+{
+  int q = poolCur == this ? poolSelf : 0;
+
+  {
+    Queue& que = *queues[q];
+    std::lock_guard<std::mutex> lock(que.mtx);
+
+    Queue::Entry ent = { job, arg };
+    que.jobs.push_back(ent);
+  }
+
+  ++queued;
+
+  if (sleepers.load() > 0) {
+    std::lock_guard<std::mutex> lock(sleepMtx);
+    wake.notify_one();
+  }
+}
+
+//---------------------------------------------------------------------------
+
+bool TaskPool::isWorker()
+{
+  return poolCur != NULL;
+}
+
+//---------------------------------------------------------------------------
+/** Runs one queued job of the pool of the calling worker thread.
+    \return \c false if there was none or this is not a worker thread.
+*/
+
+bool TaskPool::helpOne()
+{
+  TaskPool *pool = poolCur;
+  if (!pool) return false;
+
+  void (*job)(void *); void *arg;
+  if (!pool->take(poolSelf,job,arg)) return false;
+
+  job(arg);
+
+  return true;
+}
+
+//---------------------------------------------------------------------------
+//------- The shared pool and the executor in use ---------------------------
+//---------------------------------------------------------------------------
+
+static std::mutex poolSharedMtx;
+static std::unique_ptr<TaskPool> poolShared;
+static int poolSharedThreads = 0;
+static std::atomic<TaskExecutor *> poolExecutor(NULL);
+
+//---------------------------------------------------------------------------
+/** Sets the concurrency of the shared pool, by default the number of
+    hardware threads. The pool is started on first use, a running one is
+    replaced.\n
+    Only call this while the library does no parallel work.
+*/
+
+void TaskPool::setThreads(int threads)
+{
+  std::lock_guard<std::mutex> lock(poolSharedMtx);
+
+  poolSharedThreads = threads;
+
+  if (poolShared) poolShared.reset(new TaskPool(threads));
+}
+
+//---------------------------------------------------------------------------
+/** Makes the library run its parallel work on \c ex, which must outlive
+    that use. \c NULL selects the shared pool again.\n
+    Only call this while the library does no parallel work.
+*/
+
+void TaskPool::setExecutor(TaskExecutor *ex)
+{
+  poolExecutor.store(ex);
+}
+
+//---------------------------------------------------------------------------
+/** \return The executor set, else the shared pool (started if needed). */
+
+TaskExecutor& TaskPool::executor()
+{
+  TaskExecutor *ex = poolExecutor.load();
+  if (ex) return *ex;
+
+  std::lock_guard<std::mutex> lock(poolSharedMtx);
+
+  if (!poolShared) poolShared.reset(new TaskPool(poolSharedThreads));
+
+  return *poolShared;
+}
+
+//---------------------------------------------------------------------------
+//------- Task groups -------------------------------------------------------
+//---------------------------------------------------------------------------
+// A job is referenced by the executor, until it has called invoke(), and
+// by the group, until wait() is done. Who claims it first runs it: the
+// executor, or the owner in wait() when the executor has not got to it.
+
+TaskGroup::Job::Job(TaskGroup *g)
+: grp(g), tol(Vec2::curTol), state(0), refs(2)
+{
+}
+
+//---------------------------------------------------------------------------
+
+void TaskGroup::Job::invoke(void *job)
+{
+  Job *jb = (Job *)job;
+
+  if (jb->claim()) jb->grp->execute(jb);
+
+  jb->release();
+}
+
+//---------------------------------------------------------------------------
+
+TaskGroup::~TaskGroup()
+{
+  try { wait(); }
+  catch (...) {}
+}
+
+//---------------------------------------------------------------------------
+
+void TaskGroup::submit(Job *job)
+{
+  try {
+    jobs.push_back(job);
+  }
+  catch (...) {
+    delete job;
+    throw;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    ++pending;
+  }
+
+  try {
+    ex.execute(&Job::invoke,job);
+  }
+  catch (std::exception&) { // Not handed out, wait() runs it
+    job->release();
+  }
+}
+
+//---------------------------------------------------------------------------
+// Runs a claimed job under the tolerances of the thread that queued it.
+
+void TaskGroup::execute(Job *job)
+{
+  if (!cancelled()) {
+    const TolContext *prevTol = Vec2::curTol;
+    Vec2::curTol = job->tol;
+
+    try {
+      job->call();
+    }
+    catch (...) {
+      fail();
+    }
+
+    Vec2::curTol = prevTol;
+  }
+
+  std::lock_guard<std::mutex> lock(mtx);
+  if (--pending == 0) done.notify_all();
+}
+
+//---------------------------------------------------------------------------
+// Called in a catch block: keeps the first exception, cancels the rest.
+
+void TaskGroup::fail()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+
+  if (!err) err = std::current_exception();
+  cancel = true;
+}
+
+//---------------------------------------------------------------------------
+/** Runs the jobs no thread has started yet, then waits for the others.
+    On a worker of a TaskPool queued jobs of that pool are run meanwhile.
+    Rethrows the first exception of a job, the group can then be used
+    again.
+*/
+
+void TaskGroup::wait()
+{
+  for (size_t i=0; i<jobs.size(); ++i) {
+    if (jobs[i]->claim()) execute(jobs[i]);
+  }
+
+  bool onWorker = TaskPool::isWorker();
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      if (pending == 0) break;
+
+      if (!onWorker) {
+        done.wait(lock,[this]() { return pending == 0; });
+        break;
+      }
+    }
+
+    if (TaskPool::helpOne()) continue;
+
+    std::unique_lock<std::mutex> lock(mtx);
+    done.wait_for(lock,std::chrono::microseconds(200),
+                                       [this]() { return pending == 0; });
+  }
+
+  for (size_t i=0; i<jobs.size(); ++i) jobs[i]->release();
+  jobs.clear();
+
+  std::exception_ptr e;
+
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    e = err;
+    err = NULL;
+    cancel = false;
+  }
+
+  if (e) std::rethrow_exception(e);
+}
+
+} // namespace Ino
+
+//---------------------------------------------------------------------------
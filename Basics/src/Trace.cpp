@@ -0,0 +1,238 @@
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//------- Timeline Tracing --------------------------------------------------
+//---------------------------------------------------------------------------
+//------- Copyright Inofor Hoek Aut BV OCT 2026 -----------------------------
+//---------------------------------------------------------------------------
+//------- C. Wolters --------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
+#include "Trace.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace Ino
+{
+
+//---------------------------------------------------------------------------
+//------- Per thread event buffers ------------------------------------------
+//---------------------------------------------------------------------------
+// A buffer is only written by its own thread. The number of valid events
+// is published with a release store, so a dump can run concurrently with
+// recording threads. Buffers are linked into a lock free list and are
+// never deleted (threads keep a pointer to their buffer).
+
+struct TraceEvent
+{
+  const char *name;
+  double ts;         // Microseconds since the start of the program
+  long count;
+  char ph;           // 'B' or 'E'
+};
+
+enum { TraceChunkSz = 4096, TraceMaxChunks = 256 };
+
+struct TraceBuf
+{
+  TraceBuf *next;
+  int tid;
+
+  std::atomic<int> cnt;
+  TraceEvent *chunks[TraceMaxChunks];
+
+  TraceBuf(int id) : next(NULL), tid(id), cnt(0)
+  {
+    memset(chunks,0,sizeof(chunks));
+  }
+};
+
+static std::atomic<TraceBuf *> traceBufs(NULL);
+static std::atomic<int>  traceNextTid(1);
+static std::atomic<long> traceDropped(0);
+
+static thread_local TraceBuf *traceCurBuf = NULL;
+
+static const std::chrono::steady_clock::time_point traceStart =
+                                           std::chrono::steady_clock::now();
+
+std::atomic<bool> Trace::on(false);
+
+//---------------------------------------------------------------------------
+
+static TraceBuf *threadBuf()
+{
+  if (!traceCurBuf) {
+    TraceBuf *buf = new TraceBuf(traceNextTid.fetch_add(1));
+
+    buf->next = traceBufs.load(std::memory_order_relaxed);
+
+    while (!traceBufs.compare_exchange_weak(buf->next,buf,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed));
+    traceCurBuf = buf;
+  }
+
+  return traceCurBuf;
+}
+
+//---------------------------------------------------------------------------
+
+static void record(const char *name, char ph, long count)
+{
+  TraceBuf *buf = threadBuf();
+
+  int n  = buf->cnt.load(std::memory_order_relaxed);
+  int ch = n / TraceChunkSz;
+
+  if (ch >= TraceMaxChunks) {
+    traceDropped.fetch_add(1,std::memory_order_relaxed);
+    return;
+  }
+
+  if (!buf->chunks[ch]) buf->chunks[ch] = new TraceEvent[TraceChunkSz];
+
+  TraceEvent& ev = buf->chunks[ch][n % TraceChunkSz];
+
+  ev.name  = name;
+  ev.ts    = std::chrono::duration<double,std::micro>(
+                        std::chrono::steady_clock::now() - traceStart).count();
+  ev.count = count;
+  ev.ph    = ph;
+
+  buf->cnt.store(n+1,std::memory_order_release);
+}
+
+//---------------------------------------------------------------------------
+/** Switches recording on or off. Already recorded events are kept.
+*/
+
+void Trace::enable(bool enable)
+{
+  on.store(enable,std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------
+/** Records the begin of operation \c name in the buffer of this thread.
+    Normally called through TraceScope.
+*/
+
+void Trace::begin(const char *name, long count)
+{
+  record(name,'B',count);
+}
+
+//---------------------------------------------------------------------------
+/** Records the end of operation \c name in the buffer of this thread.
+*/
+
+void Trace::end(const char *name, long count)
+{
+  record(name,'E',count);
+}
+
+//---------------------------------------------------------------------------
+/** Discards all recorded events.
+    \note Must not be called while other threads are recording.
+*/
+
+void Trace::clear()
+{
+  TraceBuf *buf = traceBufs.load(std::memory_order_acquire);
+
+  for (;buf;buf = buf->next) {
+    buf->cnt.store(0,std::memory_order_release);
+
+    for (int i=1; i<TraceMaxChunks; ++i) { // Keep the first chunk
+      if (buf->chunks[i]) delete[] buf->chunks[i];
+      buf->chunks[i] = NULL;
+    }
+  }
+
+  traceDropped.store(0,std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------
+
+long Trace::dropped()
+{
+  return traceDropped.load(std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------
+
+static void writeJsonStr(FILE *fp, const char *s)
+{
+  fputc('"',fp);
+
+  for (;s && *s;++s) {
+    if (*s == '"' || *s == '\\') fprintf(fp,"\\%c",*s);
+    else if ((unsigned char)*s < 0x20) fprintf(fp,"\\u%04x",*s);
+    else fputc(*s,fp);
+  }
+
+  fputc('"',fp);
+}
+
+//---------------------------------------------------------------------------
+/** Writes all recorded events as a Chrome/Perfetto trace (JSON object
+    format) to \c fp.
+    \return \c false on a write error.
+*/
+
+bool Trace::writeJson(FILE *fp)
+{
+  if (!fp) return false;
+
+  fprintf(fp,"{\"traceEvents\":[");
+
+  bool first = true;
+
+  TraceBuf *buf = traceBufs.load(std::memory_order_acquire);
+
+  for (;buf;buf = buf->next) {
+    int n = buf->cnt.load(std::memory_order_acquire);
+
+    for (int i=0; i<n; ++i) {
+      const TraceEvent& ev = buf->chunks[i / TraceChunkSz]
+                                        [i % TraceChunkSz];
+
+      fprintf(fp,first ? "\n{\"name\":" : ",\n{\"name\":");
+      writeJsonStr(fp,ev.name);
+
+      fprintf(fp,",\"cat\":\"ino\",\"ph\":\"%c\",\"ts\":%.3f,"
+                 "\"pid\":1,\"tid\":%d",ev.ph,ev.ts,buf->tid);
+
+      if (ev.count >= 0) fprintf(fp,",\"args\":{\"count\":%ld}",ev.count);
+
+      fputc('}',fp);
+
+      first = false;
+    }
+  }
+
+  fprintf(fp,"\n],\"displayTimeUnit\":\"ms\"}\n");
+
+  return ferror(fp) == 0;
+}
+
+//---------------------------------------------------------------------------
+/** Writes all recorded events to file \c fileName, see writeJson(FILE *).
+*/
+
+bool Trace::writeJson(const char *fileName)
+{
+  FILE *fp = fopen(fileName,"w");
+  if (!fp) return false;
+
+  bool ok = writeJson(fp);
+
+  if (fclose(fp) != 0) ok = false;
+
+  return ok;
+}
+
+} // namespace Ino
+
+//---------------------------------------------------------------------------
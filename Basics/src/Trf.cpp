@@ -416,7 +416,8 @@ Trf2& Trf2::preMultWith(const Trf2& mt)
 }
 
 // -------------------------------------------------------------------------
-/** \ref Ino::Vec2 "2D Vector" transformation.
+/** \fn Vec2 Trf2::operator* (const Vec2& p) const
+  \ref Ino::Vec2 "2D Vector" transformation.
   \param p the vector to be transformed.
   \return The transformed vector.
 
@@ -432,23 +433,6 @@ Trf2& Trf2::preMultWith(const Trf2& mt)
   \ref Ino::Vec2 Vec2 instead of this method whenever possible.
 */
 
-Vec2 Trf2::operator* (const Vec2& p) const      // Transform vector
-{
-  Vec2 v;
-
-  v.x = m[0][0] * p.x + m[0][1] * p.y;
-  v.y = m[1][0] * p.x + m[1][1] * p.y;
-
-  if (!p.isDerivative) {
-    v.x += m[0][2];
-    v.y += m[1][2];
-  }
-
-  v.isDerivative = isDerivative || p.isDerivative;
-
-  return v;
-}
-
 // -------------------------------------------------------------------------
 /** Matrix addition.
   \param mt The transform to add to this one.
@@ -932,7 +916,8 @@ Trf3& Trf3::preMultWith(const Trf3& mt)
 }
 
 // -------------------------------------------------------------------------
-/** \ref Ino::Vec3 "3D Vector" transformation.
+/** \fn Vec3 Trf3::operator* (const Vec3& p) const
+  \ref Ino::Vec3 "3D Vector" transformation.
   \param p the vector to be transformed.
   \return The transformed vector.
 
@@ -948,25 +933,6 @@ Trf3& Trf3::preMultWith(const Trf3& mt)
   \ref Ino::Vec3 Vec3 instead of this method whenever possible.
 */
 
-Vec3 Trf3::operator* (const Vec3& p) const      // Transform vector
-{
-  Vec3 v;
-
-  v.x = m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z;
-  v.y = m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z;
-  v.z = m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z;
-
-  if (!p.isDerivative) {
-    v.x += m[0][3];
-    v.y += m[1][3];
-    v.z += m[2][3];
-  }
-
-  v.isDerivative = isDerivative || p.isDerivative;
-
-  return v;
-}
-
 // -------------------------------------------------------------------------
 /** Matrix addition.
   \param mt The transform to add to this one.
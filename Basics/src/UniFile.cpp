@@ -1525,18 +1525,41 @@ void UniFile::cancelFind() const
 
 //---------------------------------------------------------------------------
 
-static int cmpFiles(const void *vf1, const void *vf2)
+// Sorts on the alpha numerical keys of the paths, then moves the files
+// along the cycles of the permutation.
+
+static void sortFiles(UniFile *lst, int sz)
 {
-  if (!vf1) {
-    if (!vf2) return 0;
-    else return -1;
-  }
-  else if (!vf2) return 1;
+  const wchar_t **paths = new const wchar_t *[sz];
+  int *order = new int[sz];
+
+  for (int i=0; i<sz; ++i) paths[i] = lst[i].getPath();
+
+  sortAlphaNum(paths,sz,order);
+
+  delete[] paths;
+
+  for (int i=0; i<sz; ++i) {
+    if (order[i] < 0 || order[i] == i) continue;
+
+    UniFile hold(lst[i]);
 
-  const UniFile *uf1 = (const UniFile *)vf1;
-  const UniFile *uf2 = (const UniFile *)vf2;
+    int j = i;
+
+    while (order[j] != i) {
+      int nxt = order[j];
+
+      lst[j] = lst[nxt];
+      order[j] = -1;
+
+      j = nxt;
+    }
+
+    lst[j] = hold;
+    order[j] = -1;
+  }
 
-  return compareAlphaNum(uf1->getPath(),uf2->getPath());
+  delete[] order;
 }
 
 //---------------------------------------------------------------------------
@@ -1611,7 +1634,7 @@ UniFile *UniFile::getFileList(int& listSz, bool sort,
 
     listSz = fCnt;
 
-    if (sort && listSz > 1) qsort(fileLst,listSz,sizeof(UniFile),cmpFiles);
+    if (sort && listSz > 1) sortFiles(fileLst,listSz);
   }
 
   fndHdl  = oldFndHdl;
@@ -1694,7 +1717,7 @@ UniFile *UniFile::getDirList(int& listSz, bool sort,
 
     listSz = fCnt;
     
-    if (sort && listSz > 1) qsort(fileLst,listSz,sizeof(UniFile),cmpFiles);
+    if (sort && listSz > 1) sortFiles(fileLst,listSz);
   }
 
   fndHdl  = oldFndHdl;
@@ -1777,7 +1800,7 @@ UniFile *UniFile::getList(int& listSz, bool sort,
 
     listSz = fCnt;
     
-    if (sort && listSz > 1) qsort(fileLst,listSz,sizeof(UniFile),cmpFiles);
+    if (sort && listSz > 1) sortFiles(fileLst,listSz);
   }
 
   fndHdl  = oldFndHdl;
@@ -52,7 +52,8 @@ namespace Ino
 
     Since this static field is public its value may be changed.\n
     It should however be changed only at the beginning of a program, since
-    various methods depend on its value.
+    various methods depend on its value. It is the default for threads
+    without a \ref Ino::TolScope "TolScope", read it with identDist().
 */
 double Vec2::IdentDist = 1.0E-04;
 
@@ -61,10 +62,16 @@ double Vec2::IdentDist = 1.0E-04;
 
     Since this static field is public its value may be changed.\n
     It should however be changed only at the beginning of a program, since
-    various methods depend on its value.
+    various methods depend on its value. It is the default for threads
+    without a \ref Ino::TolScope "TolScope", read it with identDir().
 */
 double Vec2::IdentDir  = 1.0E-03;
 
+/** The tolerances of this thread, \c NULL for the defaults. Set by
+    \ref Ino::TolScope "TolScope" only.
+*/
+thread_local const TolContext *Vec2::curTol = NULL;
+
 /// The value of \c Pi, i.e. \c 3.1415926535...
 const double Vec2::Pi  = 3.141592653589793238462643383279502884197169;
 
@@ -108,13 +115,10 @@ const double Vec2::Pi2 = 2.0 * 3.141592653589793238462643383279502884197169;
 // --------------------------------------------------------------------------
 // ------- Return length of vector ------------------------------------------
 // --------------------------------------------------------------------------
-/** Returns the length of this vector.
+/** \fn double Vec2::len2() const
+  Returns the length of this vector.
   \return This vectors length.
 */
-double Vec2::len2() const
-{
-  return sqrt(x*x + y*y);
-}
 
 // --------------------------------------------------------------------------
 /** \fn double Vec2::lenSq2() const
@@ -182,32 +186,22 @@ double Vec2::angle() const
 // --------------------------------------------------------------------------
 // ----------- Return distance of two vectors -------------------------------
 // --------------------------------------------------------------------------
-/** Returns the distance of this vector to another vector.
+/** \fn double Vec2::distTo2(const Vec2& v) const
+  Returns the distance of this vector to another vector.
   \param v The vector to calculate the distance to.
   \return The distance between this vector and vector \c v.
 */
-double Vec2::distTo2(const Vec2& v) const
-{
-  Vec2 lv(v.x-x,v.y-y);
-
-  return lv.len2();
-}
 
 // --------------------------------------------------------------------------
 // ----------- Return square of distance of two vectors ---------------------
 // --------------------------------------------------------------------------
-/** Returns the <b> square of</b> the distance of this vector to another vector.
+/** \fn double Vec2::sqDistTo2(const Vec2& v) const
+  Returns the <b> square of</b> the distance of this vector to another vector.
   This method avoids the calculation of a square root.
   (May be advantageous for performance reasons).
   \param v The vector to calculate the squared distance to.
   \return The square of the distance between this vector and vector \c v.
 */
-double Vec2::sqDistTo2(const Vec2& v) const
-{
-  Vec2 lv(v.x-x,v.y-y);
-
-  return lv.x*lv.x + lv.y*lv.y;
-}
 
 // -------------------------------------------------------------------------
 // ----------- Return angle between vectors (anticlkwise to v) -------------
@@ -222,8 +216,8 @@ double Vec2::sqDistTo2(const Vec2& v) const
 */
 double Vec2::angleTo2(const Vec2& v) const
 {
-  double yy = x*v.y - y*v.x;
-  double xx = x*v.x + y*v.y;
+  double yy = cross2(v);
+  double xx = operator*(v);
 
   if (fabs(xx) <= DBL_MIN && fabs(yy) <= DBL_MIN) return 0.0;
 
@@ -238,10 +232,32 @@ double Vec2::angleTo2(const Vec2& v) const
   \return The inner product of this vector and vector \c v.
 */
 
+// --------------------------------------------------------------------------
+/** \fn double Vec2::cross2(const Vec2& v) const
+  Calculates the z component of the outer product of this vector and
+  another vector, i.e. <tt>x*v.y - y*v.x</tt>.
+
+  \param v The vector to calculate the outer product with.
+  \return Positive if \c v lies counterclockwise from this vector.
+*/
+
+// --------------------------------------------------------------------------
+// ----------- Square of distance to a line segment -------------------------
+// --------------------------------------------------------------------------
+/** \fn double Vec2::sqDistToSeg2(const Vec2& s, const Vec2& e) const
+  Returns the <b> square of</b> the distance of this vector (point) to
+  the line segment from \c s to \c e.
+  If the segment has zero length the squared distance to \c s is returned.
+  \param s The start point of the segment.
+  \param e The end point of the segment.
+  \return The squared distance to the nearest point of the segment.
+*/
+
 // --------------------------------------------------------------------------
 // ------------- Multiply by a factor ---------------------------------------
 // --------------------------------------------------------------------------
-/** Scalar multiply operator, scales this vector by a factor.
+/** \fn Vec2 Vec2::operator * (double fact) const
+  Scalar multiply operator, scales this vector by a factor.
    \param fact The factor by which to multiply this vector.
    \return The scaled vector.
 
@@ -249,17 +265,12 @@ double Vec2::angleTo2(const Vec2& v) const
     whenever possible.\n
     Returning a vector object is an expensive operation.
 */
-Vec2 Vec2::operator * (double fact) const
-{
-  Vec2 v(x*fact, y*fact);
-
-  return v;
-}
 
 // --------------------------------------------------------------------------
 // ------------- Divide by a factor -----------------------------------------
 // --------------------------------------------------------------------------
-/** Scalar divide operator, scales this vector by division.
+/** \fn Vec2 Vec2::operator / (double fact) const
+  Scalar divide operator, scales this vector by division.
    \param fact The factor by which to divide this vector.
    \return The scaled vector.
 
@@ -267,17 +278,12 @@ Vec2 Vec2::operator * (double fact) const
     whenever possible.\n
     Returning a vector object is an expensive operation.
 */
-Vec2 Vec2::operator / (double fact) const
-{
-  Vec2 v(x/fact, y/fact);
-
-  return v;
-}
 
 // --------------------------------------------------------------------------
 // ------------- Sum of two vectors -----------------------------------------
 // --------------------------------------------------------------------------
-/** Vector addition, adds this vector to another vector.
+/** \fn Vec2 Vec2::operator + (const Vec2& v) const
+  Vector addition, adds this vector to another vector.
     \param v The vector to add to this vector.
     \return The sum of this vector and vector \c v.
 
@@ -285,15 +291,12 @@ Vec2 Vec2::operator / (double fact) const
     whenever possible.\n
     Returning a vector object is an expensive operation.
 */
-Vec2 Vec2::operator + (const Vec2& v) const
-{
-  return Vec2(x+v.x,y+v.y);
-}
 
 // --------------------------------------------------------------------------
 // ------------- Difference of two vectors ----------------------------------
 // --------------------------------------------------------------------------
-/** Vector difference, subtracts another vector from this vector.
+/** \fn Vec2 Vec2::operator - (const Vec2& v) const
+  Vector difference, subtracts another vector from this vector.
     \param v The vector to subtract from this vector.
     \return The difference between this vector and vector \c v.
 
@@ -301,10 +304,6 @@ Vec2 Vec2::operator + (const Vec2& v) const
     whenever possible.\n
     Returning a vector object is an expensive operation.
 */
-Vec2 Vec2::operator - (const Vec2& v) const
-{
-  return Vec2(x-v.x,y-v.y);
-}
 
 // --------------------------------------------------------------------------
 /** \fn void Vec2::operator *= (double fact)
@@ -335,50 +334,41 @@ Vec2 Vec2::operator - (const Vec2& v) const
 /** \fn bool Vec2::operator == (const Vec2& v) const
    Equality operator.
 
-   Uses static field \ref IdentDist to determine the result.
+   Uses identDist() to determine the result.
    \param v The vector to compare this vector with.
-   \return \c true if <tt>distTo2(v) <= IdentDist</tt>.
+   \return \c true if <tt>distTo2(v) <= identDist()</tt>.
 */
 
 // --------------------------------------------------------------------------
 /** \fn bool Vec2::operator != (const Vec2& v) const
    Inequality operator.
 
-   Uses static field \ref IdentDist to determine the result.
+   Uses identDist() to determine the result.
    \param v The vector to compare this vector with.
-   \return \c true if <tt>distTo2(v) > IdentDist</tt>.
+   \return \c true if <tt>distTo2(v) > identDist()</tt>.
 */
 
 // --------------------------------------------------------------------------
 // ------------ Rotate vector 90 degrees anticlockwise ----------------------
 // --------------------------------------------------------------------------
-/** Rotates this vector 90 degrees counterclockwise.
+/** \fn void Vec2::rot90()
+  Rotates this vector 90 degrees counterclockwise.
 */
-void Vec2::rot90()
-{
-  double h = x; x = -y; y = h;
-}
 
 // --------------------------------------------------------------------------
 // ------------ Rotate vector 180 degrees -----------------------------------
 // --------------------------------------------------------------------------
-/** Rotates this vector 180 degrees.
+/** \fn void Vec2::rot180()
+  Rotates this vector 180 degrees.
 */
-void Vec2::rot180()
-{
-  x = -x; y = -y;
-}
 
 // --------------------------------------------------------------------------
 // ------------ Rotate vector 270 degrees anticlockwise ---------------------
 // --------------------------------------------------------------------------
-/** Rotates this vector 270 degrees counterclockwise.
+/** \fn void Vec2::rot270()
+  Rotates this vector 270 degrees counterclockwise.
     The rotation is equivalent to 90 degrees clockwise (off course).
 */
-void Vec2::rot270()
-{
-  double h = x; x = y; y = -h;
-}
 
 // --------------------------------------------------------------------------
 // ------------ Find bisectrice from this to v according to acw -------------
@@ -562,13 +552,10 @@ void Vec2::transform2(const Trf2& trf)
 // --------------------------------------------------------------------------
 // ------- Return length of vector ------------------------------------------
 // --------------------------------------------------------------------------
-/** Returns the length of this vector.
+/** \fn double Vec3::len3() const
+  Returns the length of this vector.
   \return This vectors length.
 */
-double Vec3::len3() const
-{
-  return sqrt(x*x + y*y + z*z);
-}
 
 // --------------------------------------------------------------------------
 /** \fn double Vec3::lenSq3() const
@@ -622,32 +609,22 @@ double Vec3::len3(double newLen)
 // --------------------------------------------------------------------------
 // ----------- Return distance of two vectors -------------------------------
 // --------------------------------------------------------------------------
-/** Returns the distance of this vector to another vector.
+/** \fn double Vec3::distTo3(const Vec3& v) const
+  Returns the distance of this vector to another vector.
   \param v The vector to calculate the distance to.
   \return The distance between this vector and vector \c v.
 */
-double Vec3::distTo3(const Vec3& v) const
-{
-  Vec3 lv(v.x-x,v.y-y,v.z-z);
-
-  return lv.len3();
-}
 
 // --------------------------------------------------------------------------
 // ----------- Return square of distance of two vectors ---------------------
 // --------------------------------------------------------------------------
-/** Returns the <b> square of</b> the distance of this vector to another vector.
+/** \fn double Vec3::sqDistTo3(const Vec3& v) const
+  Returns the <b> square of</b> the distance of this vector to another vector.
   This method avoids the calculation of a square root.
   (May be advantageous for performance reasons).
   \param v The vector to calculate the squared distance to.
   \return The square of the distance between this vector and vector \c v.
 */
-double Vec3::sqDistTo3(const Vec3& v) const
-{
-  Vec3 lv(v.x-x,v.y-y,v.z-z);
-
-  return lv.x*lv.x + lv.y*lv.y + lv.z*lv.z;
-}
 
 // --------------------------------------------------------------------------
 /** Calculates the angle between this and another 3D vector.
@@ -685,28 +662,20 @@ double Vec3::angleTo3(const Vec3& v) const
 // --------------------------------------------------------------------------
 // ------- Inner product ----------------------------------------------------
 // --------------------------------------------------------------------------
-/** Calculates the inner product of this vector and another vector.
+/** \fn double Vec3::operator * (const Vec3& v) const
+  Calculates the inner product of this vector and another vector.
   \param v The vector to calculate the inner product with.
   \return The inner product of this vector and vector \c v.
 */
-double Vec3::operator * (const Vec3& v) const
-{
-  return x*v.x + y*v.y + z*v.z;
-}
 
 // --------------------------------------------------------------------------
 // ------- Outer product ----------------------------------------------------
 // --------------------------------------------------------------------------
-/** Calculates the outer product of this vector and another vector.
+/** \fn Vec3 Vec3::outer(const Vec3& b) const
+  Calculates the outer product of this vector and another vector.
   \param b The vector to calculate the outer product with.
   \return The outer product of this vector and vector \c v.
 */
-Vec3 Vec3::outer(const Vec3& b) const
-{
-  Vec3 r(y*b.z-z*b.y,z*b.x-x*b.z,x*b.y-y*b.x);
-
-  return r;
-}
 
 // --------------------------------------------------------------------------
 /** \fn void Vec3::operator *= (double fact)
@@ -737,24 +706,25 @@ Vec3 Vec3::outer(const Vec3& b) const
 /** \fn bool Vec3::operator == (const Vec3& v) const
    Equality operator.
 
-   Uses static field \ref IdentDist to determine the result.
+   Uses identDist() to determine the result.
    \param v The vector to compare this vector with.
-   \return \c true if <tt>distTo3(v) <= IdentDist</tt>.
+   \return \c true if <tt>distTo3(v) <= identDist()</tt>.
 */
 
 // --------------------------------------------------------------------------
 /** \fn bool Vec3::operator != (const Vec3& v) const
    Inequality operator.
 
-   Uses static field \ref IdentDist to determine the result.
+   Uses identDist() to determine the result.
    \param v The vector to compare this vector with.
-   \return \c true if <tt>distTo3(v) > IdentDist</tt>.
+   \return \c true if <tt>distTo3(v) > identDist()</tt>.
 */
 
 // --------------------------------------------------------------------------
 // ------------- Multiply by a factor ---------------------------------------
 // --------------------------------------------------------------------------
-/** Scalar multiply operator, scales this vector by a factor.
+/** \fn Vec3 Vec3::operator * (double fact) const
+  Scalar multiply operator, scales this vector by a factor.
    \param fact The factor by which to multiply this vector.
    \return The scaled vector.
 
@@ -762,17 +732,12 @@ Vec3 Vec3::outer(const Vec3& b) const
     whenever possible.\n
     Returning a vector object is an expensive operation.
 */
-Vec3 Vec3::operator * (double fact) const
-{
-  Vec3 v(x*fact, y*fact, z*fact);
-
-  return v;
-}
 
 // --------------------------------------------------------------------------
 // ------------- Divide by a factor -----------------------------------------
 // --------------------------------------------------------------------------
-/** Scalar divide operator, scales this vector by division.
+/** \fn Vec3 Vec3::operator / (double fact) const
+  Scalar divide operator, scales this vector by division.
    \param fact The factor by which to divide this vector.
    \return The scaled vector.
 
@@ -780,17 +745,12 @@ Vec3 Vec3::operator * (double fact) const
     whenever possible.\n
     Returning a vector object is an expensive operation.
 */
-Vec3 Vec3::operator / (double fact) const
-{
-  Vec3 v(x/fact, y/fact, z/fact);
-
-  return v;
-}
 
 // --------------------------------------------------------------------------
 // ------------- Sum of two vectors -----------------------------------------
 // --------------------------------------------------------------------------
-/** Vector addition, adds this vector to another vector.
+/** \fn Vec3 Vec3::operator + (const Vec3& v) const
+  Vector addition, adds this vector to another vector.
     \param v The vector to add to this vector.
     \return The sum of this vector and vector \c v.
 
@@ -798,15 +758,12 @@ Vec3 Vec3::operator / (double fact) const
     whenever possible.\n
     Returning a vector object is an expensive operation.
 */
-Vec3 Vec3::operator + (const Vec3& v) const
-{
-  return Vec3(x+v.x,y+v.y,z+v.z);
-}
 
 // --------------------------------------------------------------------------
 // ------------- Difference of two vectors ----------------------------------
 // --------------------------------------------------------------------------
-/** Vector difference, subtracts another vector from this vector.
+/** \fn Vec3 Vec3::operator - (const Vec3& v) const
+  Vector difference, subtracts another vector from this vector.
     \param v The vector to subtract from this vector.
     \return The difference between this vector and vector \c v.
 
@@ -814,10 +771,6 @@ Vec3 Vec3::operator + (const Vec3& v) const
     whenever possible.\n
     Returning a vector object is an expensive operation.
 */
-Vec3 Vec3::operator - (const Vec3& v) const
-{
-  return Vec3(x-v.x,y-v.y,z-v.z);
-}
 
 // --------------------------------------------------------------------------
 // --------------------------------------------------------------------------
@@ -847,6 +800,56 @@ void Vec3::transform3(const Trf3& trf)
   }
 }
 
+// --------------------------------------------------------------------------
+// ------- Geometric tolerances ---------------------------------------------
+// --------------------------------------------------------------------------
+/** \class TolContext
+    The tolerances of one job, such as a job in inch next to one in mm.
+    Made current for a thread with a \ref Ino::TolScope "TolScope", the
+    default tolerances Vec2::IdentDist and Vec2::IdentDir are not changed.
+*/
+
+/** Takes the tolerances that are current for this thread.
+*/
+TolContext::TolContext()
+ : identDist(Vec2::identDist()), identDir(Vec2::identDir())
+{
+}
+
+/** \param dist Replaces Vec2::IdentDist.
+    \param dir  Replaces Vec2::IdentDir.
+*/
+TolContext::TolContext(double dist, double dir)
+ : identDist(dist), identDir(dir)
+{
+}
+
+// --------------------------------------------------------------------------
+/** \class TolScope
+    Makes a TolContext current for this thread until the scope ends, the
+    previous context is restored then. Scopes may be nested.\n
+    Threads started by the library take over the context of the thread
+    that starts them.
+*/
+
+TolScope::TolScope(const TolContext& ctx) : prev(Vec2::curTol)
+{
+  Vec2::curTol = &ctx;
+}
+
+/** A \c NULL \c ctx keeps the current context, so a worker thread can
+    pass on the context of its starter without testing.
+*/
+TolScope::TolScope(const TolContext *ctx) : prev(Vec2::curTol)
+{
+  if (ctx) Vec2::curTol = ctx;
+}
+
+TolScope::~TolScope()
+{
+  Vec2::curTol = prev;
+}
+
 } // namespace Ino
 
 // --------------------------------------------------------------------------
@@ -13,6 +13,7 @@
 #include "Matrix.h"
 
 #include "Geo.h"
+#include "Trace.h"
 
 #include <cstdlib>
 #include <cmath>
@@ -32,13 +33,14 @@ static const double Double_Precision = 4.440892098500626E-16;
 // Weight[i] is supposed to be the length of the line ending in i
 
 //---------------------------------------------------------------------------
-//---- Work matrices and vectors --------------------------------------------
+//---- Work matrices and vectors, one set per thread ------------------------
 //---------------------------------------------------------------------------
 
-static Matrix mat(20,3); // Initial guess for the rows
-static Matrix vt(3,3);
-static Matrix b(20,1);
-static Matrix solMat(4,1);
+static thread_local Matrix mat(20,3); // Initial guess for the rows
+static thread_local Matrix vt(3,3);
+static thread_local Matrix b(20,1);
+static thread_local Matrix solMat(4,1);
+static thread_local Matrix outl(20,1); // 1.0 for the outliers of configureArc
 
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
@@ -52,7 +54,7 @@ double LsAprxEl::iSectTol = 1.41;
 
 LsAprxEl::LsAprxEl(const LsAprxCnt& contour)
 : parent(contour), cnt(contour.msrCnt), bIdx(0), eIdx(0),
-  p1(), p2(), maxRes(0.0), tangent(false)
+  p1(), p2(), maxRes(0.0), outliers(0), tangent(false)
 {
 }
 
@@ -62,7 +64,7 @@ LsAprxEl::LsAprxEl(const LsAprxCnt& contour)
 
 LsAprxEl::LsAprxEl(const LsAprxEl& cp)
 : parent(cp.parent), cnt(cp.cnt), bIdx(cp.bIdx), eIdx(cp.eIdx),
-  p1(cp.p1), p2(cp.p2), maxRes(cp.maxRes), 
+  p1(cp.p1), p2(cp.p2), maxRes(cp.maxRes), outliers(cp.outliers),
   tangent(cp.tangent)
 {
 }
@@ -82,6 +84,7 @@ LsAprxEl& LsAprxEl::operator=(const LsAprxEl& src)
   p1          = src.p1;
   p2          = src.p2;
   maxRes      = src.maxRes;
+  outliers    = src.outliers;
 
   tangent     = src.tangent;
 
@@ -209,6 +212,46 @@ int LsAprxEl::insIdx(double par) const
   return -1;
 }
 
+//---------------------------------------------------------------------------
+//------- Average of n points from fstIdx, weighted on their distance -------
+//------- to the line through pol with unit normal nrm ----------------------
+//---------------------------------------------------------------------------
+
+bool LsAprxEl::robustAvg(int fstIdx, int n, const Vec2& pol, const Vec2& nrm,
+                                                          Vec2& avgPt) const
+{
+  double sw = 0.0;
+  Vec2 sp;
+
+  int i = fstIdx;
+  for (int k=0; k<n; k++) {
+    Vec2 dp(cnt[i]); dp -= pol;
+
+    double w = parent.weight(dp*nrm);
+
+    sp += dp*w;
+    sw += w;
+
+    i = cnt.nxtIdx(i);
+  }
+
+  if (sw < 1e-6) return false;
+
+  avgPt = pol; avgPt += sp/sw;
+
+  return true;
+}
+
+//---------------------------------------------------------------------------
+//------- Outliers are allowed in the robust modes, up to a quarter ---------
+//------- of the points -----------------------------------------------------
+//---------------------------------------------------------------------------
+
+bool LsAprxEl::outliersOk(int n) const
+{
+  return outliers < 1 || (parent.robust() && outliers*4 <= n);
+}
+
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 //----- Approximated Line Element -------------------------------------------
@@ -340,11 +383,15 @@ static void calcAvg(const MsrCont& cnt, int fstIdx, int n, Vec2& avgPt)
 // dir of nrm is normal to line
 // so: ip + nrm*dist = point on line
 
+// If robust, inner points off by more than tol are outliers, they are
+// left out of maxRes and the ends, unless more than
+// LsAprxCnt::maxOutlierRun of them follow each other.
+
 static void configureLine(const MsrCont& cnt, int lwb, int upb,
                           const Vec2& ip, const Vec2& nrm, double dist,
-                          double tol,
+                          double tol, bool robust,
                           Vec2& p1, Vec2& p2, double& maxRes,
-                          int& minIdx, int& maxIdx)
+                          int& outliers, int& minIdx, int& maxIdx)
 {
   Vec2 dir(nrm); dir.unitLen2(); dir.rot270();
 
@@ -369,8 +416,27 @@ static void configureLine(const MsrCont& cnt, int lwb, int upb,
   maxIdx = upb;
   maxRes = 0.0;
 
+  outliers = 0;
+  int run = 0;
+
   int i = lwb;
   for (int k=0; k<n; k++) {
+    Vec2 dp = (Vec2 &)cnt[i]; dp -= pol;
+
+    double res = fabs(dp*norm);
+
+    if (robust && res > tol && k > 0 && k < n-1 &&
+                                     run < LsAprxCnt::maxOutlierRun) {
+      outliers++;
+      run++;
+
+      i = cnt.nxtIdx(i);
+      continue;
+    }
+
+    run = 0;
+    if (res > maxRes) maxRes = res;
+
     Vec2 pt = (Vec2 &)cnt[i]; pt -= pMin;
 
     if (pt*dir < -2.0*tol) {
@@ -385,11 +451,6 @@ static void configureLine(const MsrCont& cnt, int lwb, int upb,
       pMax = cnt[i];
     }
 
-    Vec2 dp = (Vec2 &)cnt[i]; dp -= pol;
-
-    double res = fabs(dp*norm);
-    if (res > maxRes) maxRes = res;
-
     i = cnt.nxtIdx(i);
   }
 
@@ -442,6 +503,154 @@ int LsAprxLine::intersect(const LsAprxEl& el, Vec2& ipa, Vec2& ipb,
   return sols;
 }
 
+//---------------------------------------------------------------------------
+//------ Minimax: the least squares fit is only refined when its maximum ----
+//------ residual is above the tolerance but below minimaxReach times it ----
+//---------------------------------------------------------------------------
+
+static const double minimaxReach = 2.0;
+
+//---------------------------------------------------------------------------
+//------ Compass search for the minimum of a band width. Steps along the ----
+//------ axes and diagonals (along x only if oneDim), halved when no step ---
+//------ helps. The band width is not smooth, so no derivatives are used. ---
+//---------------------------------------------------------------------------
+
+template <class Band>
+static double compassMin(const Band& band, Vec2& x, double step,
+                                           double minStep, bool oneDim)
+{
+  static const double dirs[8][2] = { { 1.0, 0.0}, {-1.0, 0.0},
+                                     { 0.0, 1.0}, { 0.0,-1.0},
+                                     { 0.7071067811865476, 0.7071067811865476},
+                                     {-0.7071067811865476,-0.7071067811865476},
+                                     { 0.7071067811865476,-0.7071067811865476},
+                                     {-0.7071067811865476, 0.7071067811865476} };
+  int dirCnt = oneDim ? 2 : 8;
+
+  double best = band(x);
+
+  for (int evals=0; step > minStep && evals < 400; ) {
+    bool moved = false;
+
+    for (int d=0; d<dirCnt; d++) {
+      Vec2 tx(x.x + dirs[d][0]*step, x.y + dirs[d][1]*step);
+
+      double v = band(tx); evals++;
+
+      if (v < best) {
+        best = v;
+        x = tx;
+        moved = true;
+        break;
+      }
+    }
+
+    if (!moved) step /= 2.0;
+  }
+
+  return best;
+}
+
+//---------------------------------------------------------------------------
+//------ Maximum distance of the points to a line with normal angle x.x -----
+//------ Free: the line halfway the extremes, ThruPoint: through a, ---------
+//------ Tangent: tangent to the circle (a,rad), a + nrm*rad on it ----------
+//---------------------------------------------------------------------------
+
+class LineBand
+{
+public:
+  enum Kind { Free, ThruPoint, Tangent };
+
+private:
+  const MsrCont& cnt;
+  int lwb, n;
+  Kind kind;
+  Vec2 a;
+  double rad;
+
+public:
+  LineBand(const MsrCont& msrCnt, int fstIdx, int len, Kind k,
+                                          const Vec2& org, double r = 0.0)
+  : cnt(msrCnt), lwb(fstIdx), n(len), kind(k), a(org), rad(r) {}
+
+  double at(double ang, Vec2& pol, Vec2& nrm) const;
+  double operator()(const Vec2& x) const { Vec2 pol, nrm; return at(x.x,pol,nrm); }
+
+  double reach() const;
+};
+
+//---------------------------------------------------------------------------
+
+double LineBand::at(double ang, Vec2& pol, Vec2& nrm) const
+{
+  nrm = Vec2(cos(ang),sin(ang));
+
+  double sMin = Max_Double, sMax = -Max_Double;
+
+  int i = lwb;
+  for (int k=0; k<n; k++) {
+    Vec2 dp(cnt[i]); dp -= a;
+    double sd = dp*nrm;
+
+    if (sd < sMin) sMin = sd;
+    if (sd > sMax) sMax = sd;
+
+    i = cnt.nxtIdx(i);
+  }
+
+  double offs = 0.0;
+  if      (kind == Free)    offs = (sMin + sMax) / 2.0;
+  else if (kind == Tangent) offs = rad;
+
+  pol = nrm; pol *= offs; pol += a;
+
+  return max(sMax - offs, offs - sMin);
+}
+
+//---------------------------------------------------------------------------
+
+// Largest distance of the points to a, turning by 1/reach moves them
+// at most 1 across the line
+
+double LineBand::reach() const
+{
+  double r = 0.0;
+
+  int i = lwb;
+  for (int k=0; k<n; k++) {
+    r = max(r, a.distTo2(cnt[i]));
+
+    i = cnt.nxtIdx(i);
+  }
+
+  return r;
+}
+
+//---------------------------------------------------------------------------
+
+// Turns nrm (and moves pol) to the minimax line of band, if the least
+// squares line with residual lsRes is near enough. False if unchanged.
+
+static bool minimaxLine(const LineBand& band, double tol, double lsRes,
+                                                    Vec2& pol, Vec2& nrm)
+{
+  if (lsRes <= tol || lsRes > minimaxReach*tol) return false;
+
+  double reach = band.reach();
+  if (reach < tol) return false;
+
+  Vec2 x(atan2(nrm.y,nrm.x),0.0);
+
+  double step = lsRes / reach;
+  compassMin(band,x,step,step*1e-2,true);
+
+  band.at(x.x,pol,nrm);
+
+  return true;
+}
+
 //---------------------------------------------------------------------------
 //------ Compute free least squares line from lwb to upb --------------------
 //---------------------------------------------------------------------------
@@ -456,10 +665,13 @@ bool LsAprxLine::computeLs()
     p2 = cnt[eIdx];
 
     maxRes = 0.0;
+    outliers = 0;
 
     return true;
   }
 
+  if (parent.robust()) return computeRobustLs();
+
   if (mat.getRows() < n) mat.setRows(n*2);
 
   Vec2 avgPt;
@@ -490,14 +702,133 @@ bool LsAprxLine::computeLs()
   Vec2 nrm(-vt(j,1),vt(j,0));
   int minIdx, maxIdx;
 
-  configureLine(cnt,bIdx,eIdx,avgPt,nrm,0.0,parent.tol,p1,p2,maxRes,minIdx,maxIdx);
+  configureLine(cnt,bIdx,eIdx,avgPt,nrm,0.0,parent.tol,parent.robust(),
+                p1,p2,maxRes,outliers,minIdx,maxIdx);
+
+  if (parent.minimax()) {
+    LineBand band(cnt,bIdx,n,LineBand::Free,avgPt);
+
+    Vec2 pol;
+    if (minimaxLine(band,parent.tol,maxRes,pol,nrm))
+      configureLine(cnt,bIdx,eIdx,pol,nrm,0.0,parent.tol,false,
+                    p1,p2,maxRes,outliers,minIdx,maxIdx);
+  }
 
   tangent = false;
 
   if (maxRes > parent.tol || minIdx != bIdx || maxIdx != eIdx) return false;
 //  if (maxRes > parent.tol) return false;
 
-  return true;
+  return outliersOk(n);
+}
+
+//---------------------------------------------------------------------------
+//------ Sampled consensus seed: of the lines through a few pairs of --------
+//------ points, the one with the most points within tolerance --------------
+//---------------------------------------------------------------------------
+
+static int offsIdx(const MsrCont& cnt, int idx, int offs)
+{
+  return (idx + offs) % cnt.size();
+}
+
+//---------------------------------------------------------------------------
+
+bool LsAprxLine::seedRobust(Vec2& pol, Vec2& nrm) const
+{
+  int n = rangeLen();
+
+  const int pairs[6][2] = { {0,4}, {0,2}, {2,4}, {1,3}, {0,1}, {3,4} };
+
+  int bestCnt = -1;
+
+  for (int s=0; s<6; s++) {
+    const Vec2& a = cnt[offsIdx(cnt,bIdx,(pairs[s][0]*(n-1))/4)];
+    const Vec2& e = cnt[offsIdx(cnt,bIdx,(pairs[s][1]*(n-1))/4)];
+
+    if (a.distTo2(e) <= parent.tol) continue;
+
+    Vec2 sn(e); sn -= a; sn.unitLen2(); sn.rot90();
+
+    int inCnt = 0;
+
+    int i = bIdx;
+    for (int k=0; k<n; k++) {
+      Vec2 dp(cnt[i]); dp -= a;
+      if (fabs(dp*sn) <= parent.tol) inCnt++;
+
+      i = cnt.nxtIdx(i);
+    }
+
+    if (inCnt > bestCnt) {
+      bestCnt = inCnt;
+      pol = a;
+      nrm = sn;
+    }
+  }
+
+  return bestCnt >= 0;
+}
+
+//---------------------------------------------------------------------------
+//------ Robust free line: least squares reweighted on the distances --------
+//------ to the previous line, starting at the consensus seed ---------------
+//---------------------------------------------------------------------------
+
+bool LsAprxLine::computeRobustLs()
+{
+  int n = rangeLen();
+
+  Vec2 pol, nrm;
+  if (!seedRobust(pol,nrm)) return false;
+
+  for (int iter=0; iter<8; iter++) {
+    Vec2 avgPt;
+    if (!robustAvg(bIdx,n,pol,nrm,avgPt)) return false;
+
+    // Weighted moments around the weighted average
+
+    double cxx = 0.0, cxy = 0.0, cyy = 0.0;
+
+    int i = bIdx;
+    for (int k=0; k<n; k++) {
+      Vec2 dp(cnt[i]); dp -= pol;
+      double w = parent.weight(dp*nrm);
+
+      dp = cnt[i]; dp -= avgPt;
+
+      cxx += w * dp.x * dp.x;
+      cxy += w * dp.x * dp.y;
+      cyy += w * dp.y * dp.y;
+
+      i = cnt.nxtIdx(i);
+    }
+
+    double ang = atan2(2.0*cxy, cxx - cyy) / 2.0;
+
+    Vec2 newNrm(cos(ang),sin(ang)); newNrm.rot90();
+
+    Vec2 dp(avgPt); dp -= pol;
+
+    double shift = fabs(dp*newNrm);
+    double turn  = fabs(newNrm.x*nrm.y - newNrm.y*nrm.x);
+
+    pol = avgPt;
+    nrm = newNrm;
+
+    if (shift < parent.tol*1e-4 && turn < 1e-9) break;
+  }
+
+  int minIdx, maxIdx;
+
+  configureLine(cnt,bIdx,eIdx,pol,nrm,0.0,parent.tol,true,
+                p1,p2,maxRes,outliers,minIdx,maxIdx);
+
+  tangent = false;
+
+  if (maxRes > parent.tol || minIdx != bIdx || maxIdx != eIdx) return false;
+
+  return outliersOk(n);
 }
 
 //---------------------------------------------------------------------------
@@ -546,7 +877,17 @@ bool LsAprxLine::computeLongestLs(int lwb, int uLim)
 
       newLine.eIdx = cnt.nxtIdx(newLine.eIdx);
 
-      if (!newLine.computeLs()) {
+      bool ok = newLine.computeLs();
+
+      // Robust: a glitch at the end, try to get past it
+
+      for (int k=0; !ok && parent.robust() && k<LsAprxCnt::maxOutlierRun &&
+                                    newLine.rangeLen() < maxRange; k++) {
+        newLine.eIdx = cnt.nxtIdx(newLine.eIdx);
+        ok = newLine.computeLs();
+      }
+
+      if (!ok) {
         newLine.eIdx = oldIdx;
 
         if (newLine.computeLs()) *this = newLine;
@@ -576,6 +917,7 @@ bool LsAprxLine::computePointLs(const Vec2& p)
     p2 = cnt[eIdx];
 
     maxRes = 0.0;
+    outliers = 0;
     tangent = false;
 
     return true;
@@ -595,13 +937,36 @@ bool LsAprxLine::computePointLs(const Vec2& p)
   int minIdx, maxIdx;
   int fstIdx = cnt.nxtIdx(bIdx);
 
-  configureLine(cnt,fstIdx,eIdx,avgPt,norm,0.0,parent.tol,p1,p2,maxRes,minIdx,maxIdx);
+  if (parent.robust()) { // Reweight on the distances to the line
+    for (int iter=0; iter<3; iter++) {
+      if (!robustAvg(fstIdx,n-1,p,norm,avgPt)) return false;
+
+      dx = avgPt.x - p.x;
+      dy = avgPt.y - p.y;
+
+      if (sqr(dx) + sqr(dy) < sqr(1000*Double_Precision)) return false;
+
+      norm = Vec2(dy,-dx); norm.unitLen2();
+    }
+  }
+
+  configureLine(cnt,fstIdx,eIdx,avgPt,norm,0.0,parent.tol,parent.robust(),
+                p1,p2,maxRes,outliers,minIdx,maxIdx);
+
+  if (parent.minimax()) {
+    LineBand band(cnt,fstIdx,n-1,LineBand::ThruPoint,p);
+
+    Vec2 pol;
+    if (minimaxLine(band,parent.tol,maxRes,pol,norm))
+      configureLine(cnt,fstIdx,eIdx,pol,norm,0.0,parent.tol,false,
+                    p1,p2,maxRes,outliers,minIdx,maxIdx);
+  }
 
   p1 = p;
   tangent = false;
 
 //  if (maxRes > parent.tol || minIdx != fstIdx || maxIdx != eIdx) return false;
-  if (maxRes > parent.tol) return false;
+  if (maxRes > parent.tol || !outliersOk(n-1)) return false;
 
   return true;
 }
@@ -639,32 +1004,53 @@ bool LsAprxLine::computeTangentLs(const LsAprxEl& prvEl)
   Vec2 avgPt;
   calcAvg(cnt,bIdx,n,avgPt);
 
-  Vec2 da(avgPt); da -= c;
+  Vec2 norm, pt;
+
+  int passes = parent.robust() ? 4 : 1;
+
+  for (int pass=0; pass<passes; pass++) {
+    if (pass > 0) { // Reweight on the distances to the last line
+      Vec2 nrm(norm); nrm.unitLen2();
+      if (!robustAvg(bIdx,n,pt,nrm,avgPt)) return false;
+    }
+
+    Vec2 da(avgPt); da -= c;
 
-  double lAc = da.len2();
-  if (lAc < rad+parent.tol) return false;
+    double lAc = da.len2();
+    if (lAc < rad+parent.tol) return false;
 
-  da.unitLen2();
-  Vec2 da2(da); da2.rot90();
+    da.unitLen2();
+    Vec2 da2(da); da2.rot90();
 
-  double lA1 = rad*rad/lAc;
-  double lA2 = sqrt(sqr(rad) - sqr(lA1));
+    double lA1 = rad*rad/lAc;
+    double lA2 = sqrt(sqr(rad) - sqr(lA1));
 
-  Vec2 norm(da*lA1);
-  if (prvArc.getCcw()) norm -= da2*lA2;
-  else                 norm += da2*lA2;
+    norm = da*lA1;
+    if (prvArc.getCcw()) norm -= da2*lA2;
+    else                 norm += da2*lA2;
 
-  Vec2 pt(norm); pt +=c;
+    pt = norm; pt +=c;
+  }
 
   int minIdx, maxIdx;
 
-  configureLine(cnt,bIdx,eIdx,avgPt,norm,0.0,parent.tol,p1,p2,maxRes,minIdx,maxIdx);
+  configureLine(cnt,bIdx,eIdx,avgPt,norm,0.0,parent.tol,parent.robust(),
+                p1,p2,maxRes,outliers,minIdx,maxIdx);
+
+  if (parent.minimax()) {
+    LineBand band(cnt,bIdx,n,LineBand::Tangent,c,rad);
+
+    Vec2 nrm(norm); nrm.unitLen2();
+    if (minimaxLine(band,parent.tol,maxRes,pt,nrm))
+      configureLine(cnt,bIdx,eIdx,pt,nrm,0.0,parent.tol,false,
+                    p1,p2,maxRes,outliers,minIdx,maxIdx);
+  }
 
   p1 = pt;
   tangent = true;
 
 //  if (maxRes > parent.tol || minIdx != bIdx || maxIdx != eIdx) return false;
-  if (maxRes > parent.tol) return false;
+  if (maxRes > parent.tol || !outliersOk(n)) return false;
 
   Vec2 pp;
   double pr1, pr2, dst;
@@ -890,6 +1276,120 @@ double LsAprxArc::getR() const
   return p1.distTo2(cntr);
 }
 
+//---------------------------------------------------------------------------
+//------ Maximum radial distance of the points to a circle with centre x. ---
+//------ The radius follows from the centre: Free: halfway the extremes, ----
+//------ ThruPoint: through a, TangentLine: tangent to line (a,b), ----------
+//------ TangentArc: tangent to circle (a,rad) -----------------------------
+//---------------------------------------------------------------------------
+
+class ArcBand
+{
+public:
+  enum Kind { Free, ThruPoint, TangentLine, TangentArc };
+
+private:
+  const MsrCont& cnt;
+  int lwb, n;
+  Kind kind;
+  Vec2 a, b;
+  double rad;
+
+public:
+  ArcBand(const MsrCont& msrCnt, int fstIdx, int len, Kind k,
+          const Vec2& pa = Vec2(), const Vec2& pb = Vec2(), double r = 0.0)
+  : cnt(msrCnt), lwb(fstIdx), n(len), kind(k), a(pa), b(pb), rad(r) {}
+
+  double radiusAt(const Vec2& c, Vec2& tp) const;
+  double bandAt(const Vec2& c, double r) const;
+
+  double operator()(const Vec2& c) const {
+    Vec2 tp;
+    return bandAt(c,radiusAt(c,tp));
+  }
+};
+
+//---------------------------------------------------------------------------
+
+double ArcBand::radiusAt(const Vec2& c, Vec2& tp) const
+{
+  switch (kind) {
+    case ThruPoint:
+      tp = a;
+      return c.distTo2(a);
+
+    case TangentLine: {
+      double pr, dist;
+      Geo_Project_P_on_Line(c,a,b,false,1e-12,tp,pr,dist);
+      return fabs(dist);
+    }
+
+    case TangentArc: {
+      Vec2 dc(c); dc -= a;
+      if (dc.len2() < Vec2::identDist()) {
+        dc = cnt[lwb]; dc -= a;
+      }
+
+      dc.unitLen2(); dc *= rad;
+
+      tp = a; tp += dc;
+      Vec2 tp2(a); tp2 -= dc;
+
+      if (tp2.distTo2(cnt[lwb]) < tp.distTo2(cnt[lwb])) tp = tp2;
+
+      return tp.distTo2(c);
+    }
+
+    default: {
+      double dMin = Max_Double, dMax = 0.0;
+
+      int i = lwb;
+      for (int k=0; k<n; k++) {
+        double d = c.distTo2(cnt[i]);
+
+        if (d < dMin) dMin = d;
+        if (d > dMax) dMax = d;
+
+        i = cnt.nxtIdx(i);
+      }
+
+      return (dMin + dMax) / 2.0;
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+
+double ArcBand::bandAt(const Vec2& c, double r) const
+{
+  double res = 0.0;
+
+  int i = lwb;
+  for (int k=0; k<n; k++) {
+    res = max(res, fabs(c.distTo2(cnt[i]) - r));
+
+    i = cnt.nxtIdx(i);
+  }
+
+  return res;
+}
+
+//---------------------------------------------------------------------------
+
+// Moves the centre c (and radius r) to the minimax circle of band, if the
+// least squares circle is near enough; tp is the new tangent point.
+
+static void minimaxCntr(const ArcBand& band, double tol,
+                                           Vec2& c, double& r, Vec2& tp)
+{
+  double lsRes = band.bandAt(c,r);
+  if (lsRes <= tol || lsRes > minimaxReach*tol) return;
+
+  compassMin(band,c,lsRes,tol*1e-2,false);
+
+  r = band.radiusAt(c,tp);
+}
+
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
@@ -934,28 +1434,125 @@ bool LsAprxArc::estimate(Vec2& c, double& r) const
 }
 
 //---------------------------------------------------------------------------
+//------ Circle through 3 points, false if they are (nearly) collinear ------
+//---------------------------------------------------------------------------
+
+static bool circleThrough(const Vec2& pa, const Vec2& pb, const Vec2& pc,
+                          Vec2& c, double& r)
+{
+  double bx = pb.x - pa.x, by = pb.y - pa.y;
+  double cx = pc.x - pa.x, cy = pc.y - pa.y;
+
+  double d = 2.0 * (bx*cy - by*cx);
+
+  double bb = sqr(bx) + sqr(by), cc = sqr(cx) + sqr(cy);
+  if (fabs(d) <= (bb + cc) * 1000 * Double_Precision) return false;
+
+  double ux = (cy*bb - by*cc) / d;
+  double uy = (bx*cc - cx*bb) / d;
+
+  c.x = pa.x + ux;
+  c.y = pa.y + uy;
+  r = sqrt(sqr(ux) + sqr(uy));
+
+  return true;
+}
+
 //---------------------------------------------------------------------------
+//------ Sampled consensus seed: of the algebraic estimate and the ----------
+//------ circles through a few point triples, the one with the most ---------
+//------ points within tolerance --------------------------------------------
 //---------------------------------------------------------------------------
 
+bool LsAprxArc::seedRobust(Vec2& c, double& r) const
+{
+  int n = cnt.rangeLen(bIdx,eIdx);
+
+  const int triples[6][3] = { {0,6,12}, {0,3,6}, {6,9,12},
+                              {3,6,9},  {0,4,8}, {4,8,12} };
+
+  int bestCnt = -1;
+
+  for (int s=-1; s<6; s++) {
+    Vec2 sc; double sr;
+
+    if (s < 0) {
+      if (!estimate(sc,sr)) continue;
+    }
+    else {
+      const Vec2& pa = cnt[offsIdx(cnt,bIdx,(triples[s][0]*(n-1))/12)];
+      const Vec2& pb = cnt[offsIdx(cnt,bIdx,(triples[s][1]*(n-1))/12)];
+      const Vec2& pc = cnt[offsIdx(cnt,bIdx,(triples[s][2]*(n-1))/12)];
+
+      if (!circleThrough(pa,pb,pc,sc,sr)) continue;
+    }
+
+    if (sr < 10.0*parent.tol || sr > parent.maxRad) continue;
+
+    int inCnt = 0;
+
+    int i = bIdx;
+    for (int k=0; k<n; k++) {
+      const Vec2& pt = cnt[i];
+      if (fabs(pt.distTo2(sc) - sr) <= parent.tol) inCnt++;
+
+      i = cnt.nxtIdx(i);
+    }
+
+    if (inCnt > bestCnt) {
+      bestCnt = inCnt;
+      c = sc;
+      r = sr;
+    }
+  }
+
+  return bestCnt >= 0;
+}
+
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
+// Outliers as in configureLine, they are also left out of the rotation
+
 static void configureArc(const MsrCont& cnt, int lwb, int upb,
-                         const Vec2& c, double rad, double tol,
+                         const Vec2& c, double rad, double tol, bool robust,
                          Vec2& p1, Vec2& p2, bool& ccw, double& maxRes,
-                         int& minIdx, int& maxIdx)
+                         int& outliers, int& minIdx, int& maxIdx)
 {
   int n = cnt.rangeLen(lwb,upb);
 
+  if (outl.getRows() < n) outl.setRows(n*2);
+
   Vec2 dr0;
   double rotAng = 0.0;
   maxRes = 0.0;
 
+  outliers = 0;
+  int run = 0;
+
   int k, i = lwb, lastI = lwb;
   for (k=0; k<n; k++) {
     Vec2 dr(cnt[i]); dr -= c;
 
+    double res = fabs(dr.len2() - rad);
+
+    if (robust && res > tol && k > 0 && k < n-1 &&
+                                     run < LsAprxCnt::maxOutlierRun) {
+      outl(k,0) = 1.0;
+      outliers++;
+      run++;
+
+      i = cnt.nxtIdx(i);
+      continue;
+    }
+
+    outl(k,0) = 0.0;
+    run = 0;
+
     if (k > 0) rotAng += dr0.angleTo2(dr);
     dr0 = dr;
 
-    double res = fabs(dr.len2() - rad);
     if (res > maxRes) maxRes = res;
 
     if (k > 0) { // Residu between points (allowed to be 2.0 * tol)
@@ -983,7 +1580,7 @@ static void configureArc(const MsrCont& cnt, int lwb, int upb,
     Vec2 pp;
     double pr,dst;
 
-    if (!Geo_Project_P_on_Arc(cnt[i],p1,p2,c,ccw,true,2.0*tol,pp,pr,dst)) {
+    if (outl(k,0) == 0.0 && !Geo_Project_P_on_Arc(cnt[i],p1,p2,c,ccw,true,2.0*tol,pp,pr,dst)) {
       if (pr <= 0.0) {
         p1 = cnt[i]; p1 -= c; p1.unitLen2(); p1 *= rad; p1 += c;
         minIdx = i;
@@ -1048,6 +1645,18 @@ int LsAprxArc::intersect(const LsAprxEl& el, Vec2& ipa, Vec2& ipb,
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 
+// Scales row k of the linearised system by the root of the robust weight
+
+static void weighRow(int k, int cols, double w)
+{
+  double sw = sqrt(w);
+
+  for (int j=0; j<cols; j++) mat(k,j) *= sw;
+  b(k,0) *= sw;
+}
+
+//---------------------------------------------------------------------------
+
 static void checkArcSizes(int n)
 {
   if (mat.getRows() < n) mat.setRows(n*2);
@@ -1066,7 +1675,10 @@ bool LsAprxArc::computeLs()
   checkArcSizes(n);
 
   double r0;
-  if (!estimate(cntr,r0)) return false;
+  if (parent.robust()) {
+    if (!seedRobust(cntr,r0)) return false;
+  }
+  else if (!estimate(cntr,r0)) return false;
 
   bool done = false;
   int tries = 16;
@@ -1094,6 +1706,8 @@ bool LsAprxArc::computeLs()
       mat(k,2) = -1.0;
       b(k,0)   = r0 - r;
 
+      if (parent.robust()) weighRow(k,3,parent.weight(r - r0));
+
       i = cnt.nxtIdx(i);
     }
 
@@ -1128,14 +1742,22 @@ bool LsAprxArc::computeLs()
   }
 
   if (!done) return false; // No convergence
-  else if (r0 < 10.0*parent.tol || r0 > parent.maxRad) return false;
+
+  if (parent.minimax()) {
+    Vec2 tp;
+    minimaxCntr(ArcBand(cnt,bIdx,n,ArcBand::Free),parent.tol,cntr,r0,tp);
+  }
+
+  if (r0 < 10.0*parent.tol || r0 > parent.maxRad) return false;
   else {
     int minIdx, maxIdx;
 
-    configureArc(cnt,bIdx,eIdx,cntr,r0,parent.tol,p1,p2,ccw,maxRes,minIdx,maxIdx);
+    configureArc(cnt,bIdx,eIdx,cntr,r0,parent.tol,parent.robust(),
+                 p1,p2,ccw,maxRes,outliers,minIdx,maxIdx);
 
     if (maxRes > parent.tol || minIdx != bIdx || maxIdx != eIdx) return false;
 //    if (maxRes > parent.tol) return false;
+    if (!outliersOk(n)) return false;
   }
 
   tangent = false;
@@ -1167,7 +1789,17 @@ bool LsAprxArc::computeLongestLs(int lwb, int uLim)
       int oldIdx = newArc.eIdx;
       newArc.eIdx = cnt.nxtIdx(newArc.eIdx);
 
-      if (!newArc.computeLs()) {
+      bool ok = newArc.computeLs();
+
+      // Robust: a glitch at the end, try to get past it
+
+      for (int k=0; !ok && parent.robust() && k<LsAprxCnt::maxOutlierRun &&
+                                     newArc.rangeLen() < maxRange; k++) {
+        newArc.eIdx = cnt.nxtIdx(newArc.eIdx);
+        ok = newArc.computeLs();
+      }
+
+      if (!ok) {
         newArc.eIdx = oldIdx;
 
         if (newArc.computeLs()) *this = newArc;         
@@ -1223,6 +1855,8 @@ bool LsAprxArc::computePointLs(const Vec2& p)
       mat(k,1) = -y/r + (p.y-cntr.y)/r0;
       b(k,0) = r0 - r;
 
+      if (parent.robust()) weighRow(k,2,parent.weight(r - r0));
+
       i = cnt.nxtIdx(i);
     }
 
@@ -1254,15 +1888,23 @@ bool LsAprxArc::computePointLs(const Vec2& p)
   double r0 = dc.len2();
 
   if (!done) return false; // No convergence
-  else if (r0 < 10.0*parent.tol || r0 > parent.maxRad) return false;
+
+  if (parent.minimax()) {
+    Vec2 tp;
+    minimaxCntr(ArcBand(cnt,cnt.nxtIdx(bIdx),n-1,ArcBand::ThruPoint,p),
+                parent.tol,cntr,r0,tp);
+  }
+
+  if (r0 < 10.0*parent.tol || r0 > parent.maxRad) return false;
   else {
     int minIdx, maxIdx;
     int fstIdx = cnt.nxtIdx(bIdx);
 
-    configureArc(cnt,fstIdx,eIdx,cntr,r0,parent.tol,p1,p2,ccw,maxRes,minIdx,maxIdx);
+    configureArc(cnt,fstIdx,eIdx,cntr,r0,parent.tol,parent.robust(),
+                 p1,p2,ccw,maxRes,outliers,minIdx,maxIdx);
 
 //    if (maxRes > parent.tol || minIdx != fstIdx || maxIdx != eIdx) return false;
-    if (maxRes > parent.tol) return false;
+    if (maxRes > parent.tol || !outliersOk(n-1)) return false;
   }
 
   p1 = p;
@@ -1332,6 +1974,8 @@ bool LsAprxArc::computeTangentToLineLs(const LsAprxEl& prvEl,
       mat(k,1) = -y/r;
       b(k,0)   = r0 - r;
 
+      if (parent.robust()) weighRow(k,2,parent.weight(r - r0));
+
       i = cnt.nxtIdx(i);
     }
 
@@ -1371,13 +2015,19 @@ bool LsAprxArc::computeTangentToLineLs(const LsAprxEl& prvEl,
   }
 
   if (!done) return false; // No convergence
+
+  if (parent.minimax())
+    minimaxCntr(ArcBand(cnt,bIdx,n,ArcBand::TangentLine,
+                        prvEl.getP1(),prvEl.getP2()),parent.tol,cntr,r0,tp);
+
   if (r0 < 10.0*parent.tol || r0 > parent.maxRad) return false;
 
   int minIdx, maxIdx;
-  configureArc(cnt,bIdx,eIdx,cntr,r0,parent.tol,p1,p2,ccw,maxRes,minIdx,maxIdx);
+  configureArc(cnt,bIdx,eIdx,cntr,r0,parent.tol,parent.robust(),
+               p1,p2,ccw,maxRes,outliers,minIdx,maxIdx);
 
 //  if (maxRes > parent.tol || minIdx != bIdx || maxIdx != eIdx) return false;
-  if (maxRes > parent.tol) return false;
+  if (maxRes > parent.tol || !outliersOk(n)) return false;
 
   p1 = tp;
   tangent = true;
@@ -1407,7 +2057,7 @@ bool LsAprxArc::computeTangentToArcLs(const LsAprxEl& prvEl,
   const LsAprxArc& prvArc = (LsAprxArc&)prvEl;
 
   Vec2 dc(cntr); dc -= prvArc.cntr;
-  if (dc.len2() < Vec2::IdentDist) {
+  if (dc.len2() < Vec2::identDist()) {
     dc = cnt[bIdx]; dc -= prvArc.cntr;
   }
 
@@ -1444,6 +2094,8 @@ bool LsAprxArc::computeTangentToArcLs(const LsAprxEl& prvEl,
       mat(k,1) = -y/r;
       b(k,0)   = r0 - r;
 
+      if (parent.robust()) weighRow(k,2,parent.weight(r - r0));
+
       i = cnt.nxtIdx(i);
     }
 
@@ -1461,7 +2113,7 @@ bool LsAprxArc::computeTangentToArcLs(const LsAprxEl& prvEl,
     cntr.y += upd1;
 
     dc = cntr; dc -= prvArc.cntr;
-    if (dc.len2() < Vec2::IdentDist) {
+    if (dc.len2() < Vec2::identDist()) {
       dc = cnt[bIdx]; dc -= prvArc.cntr;
     }
 
@@ -1491,13 +2143,19 @@ bool LsAprxArc::computeTangentToArcLs(const LsAprxEl& prvEl,
   }
 
   if (!done) return false; // No convergence
+
+  if (parent.minimax())
+    minimaxCntr(ArcBand(cnt,bIdx,n,ArcBand::TangentArc,
+                        prvArc.cntr,Vec2(),prvArc.getR()),parent.tol,cntr,r0,tp);
+
   if (r0 < 10.0*parent.tol || r0 > parent.maxRad) return false;
 
   int minIdx, maxIdx;
-  configureArc(cnt,bIdx,eIdx,cntr,r0,parent.tol,p1,p2,ccw,maxRes,minIdx,maxIdx);
+  configureArc(cnt,bIdx,eIdx,cntr,r0,parent.tol,parent.robust(),
+               p1,p2,ccw,maxRes,outliers,minIdx,maxIdx);
 
 //  if (maxRes > parent.tol || minIdx != bIdx || maxIdx != eIdx) return false;
-  if (maxRes > parent.tol) return false;
+  if (maxRes > parent.tol || !outliersOk(n)) return false;
 
   p1 = tp;
   tangent = true;
@@ -1659,6 +2317,29 @@ void LsAprxCnt::append(LsAprxEl& newElem)
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 
+void LsAprxCnt::appendOutlier(int idx)
+{
+  if (olSz >= olCap) {
+    int newCap = olCap < 10 ? 10 : olCap*2;
+
+    int *newLst = new int[newCap];
+
+    if (olList) {
+      for (int i=0; i<olSz; i++) newLst[i] = olList[i];
+      delete[] olList;
+    }
+
+    olList = newLst;
+    olCap = newCap;
+  }
+
+  olList[olSz++] = idx;
+}
+
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
 void LsAprxCnt::clear()
 {
   if (elList) {
@@ -1669,6 +2350,12 @@ void LsAprxCnt::clear()
   elList = 0;
   sz = 0;
   cap = 0;
+
+  if (olList) delete[] olList;
+
+  olList = 0;
+  olSz = 0;
+  olCap = 0;
 }
 
 //---------------------------------------------------------------------------
@@ -1677,8 +2364,9 @@ void LsAprxCnt::clear()
 
 LsAprxCnt::LsAprxCnt(MsrCont& mCnt, double tolerance, double maxRadius,
                                                                bool noArcs)
-: elList(NULL), cap(0), sz(0),
-  msrCnt(mCnt), tol(tolerance), maxRad(maxRadius), genNoArcs(noArcs)
+: elList(NULL), cap(0), sz(0), olList(NULL), olCap(0), olSz(0),
+  msrCnt(mCnt), tol(tolerance), maxRad(maxRadius), genNoArcs(noArcs),
+  fitMode(FitLs)
 {
   if (tolerance <= 0.0 || maxRadius <= 0.0)
                   throw IllegalArgumentException("LsAprxCnt::LsAprxCnt");
@@ -1709,6 +2397,64 @@ const LsAprxEl& LsAprxCnt::operator[](int idx) const
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 
+int LsAprxCnt::outlierIdx(int idx) const
+{
+  if (!olList) throw NullPointerException("LsAprxCnt::outlierIdx");
+  if (idx < 0 || idx >= olSz) throw IndexOutOfBoundsException("LsAprxCnt::outlierIdx");
+
+  return olList[idx];
+}
+
+//---------------------------------------------------------------------------
+//------ Weight of a residual in the reweighted fits. Huber: linear ---------
+//------ beyond the tolerance. Tukey biweight: zero beyond twice it ---------
+//---------------------------------------------------------------------------
+
+double LsAprxCnt::weight(double res) const
+{
+  double ar = fabs(res);
+
+  switch (fitMode) {
+    case FitHuber: return ar <= tol ? 1.0 : tol/ar;
+
+    case FitTukey: {
+      double c = 2.0*tol;
+      if (ar >= c) return 0.0;
+
+      return sqr(1.0 - sqr(ar/c));
+    }
+
+    default: return 1.0;
+  }
+}
+
+//---------------------------------------------------------------------------
+//------ Gathers the inner points the elements did not fit ------------------
+//---------------------------------------------------------------------------
+
+void LsAprxCnt::collectOutliers()
+{
+  for (int e=0; e<sz; e++) {
+    const LsAprxEl& el = *elList[e];
+    if (el.outliers < 1) continue;
+
+    int i = msrCnt.nxtIdx(el.bIdx);
+
+    while (i != el.eIdx) {
+      Vec2 pp; double pr, dist;
+
+      if (el.project(msrCnt[i],pp,pr,dist) && fabs(dist) > tol)
+                                                        appendOutlier(i);
+
+      i = msrCnt.nxtIdx(i);
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
 bool LsAprxCnt::approxLine(const LsAprxEl& prvEl, LsAprxLine& line, int uLim)
 {
   if (!line.computeLongestLs(prvEl.eIdx,uLim)) return false;
@@ -1897,6 +2643,8 @@ bool LsAprxCnt::arcCandidate(const LsAprxLine& line)
 
 bool LsAprxCnt::interpolate()
 {
+  TraceScope trc("LsAprxCnt::interpolate",msrCnt.size());
+
   clear();
 
   if (msrCnt.size() < 2) return false;
@@ -1972,10 +2720,15 @@ bool LsAprxCnt::interpolate()
     prvEl = elList[sz-1];
   }
 
-  if (!msrClosed) return true;
+  if (!msrClosed) {
+    collectOutliers();
+    return true;
+  }
 
   msrCnt.close();
 
+  collectOutliers();
+
   // Now connect the last to the first.
 
   // For the time being we solve this in a simple manner
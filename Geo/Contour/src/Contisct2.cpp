@@ -362,7 +362,7 @@ static void delete2_identical(Cont_Isect_D_List& ilist)
   // Delete identical intersections,
 
   // Tol slightly more than the maximum possible difference
-  double tol = 4.2 * Vec2::IdentDist;
+  double tol = 4.2 * Vec2::identDist();
 
   bool modified = true;
   
@@ -429,7 +429,7 @@ static void delete2_close(Cont_Isect_D_List& ilist)
   // where at least one is out of range
 
   // Tol slightly more than the maximum possible difference
-  double tol = 4.2 * Vec2::IdentDist;
+  double tol = 4.2 * Vec2::identDist();
 
   bool modified = true;
   
@@ -864,7 +864,7 @@ void Cont2_Isect_List::cleanup()
   // contour stretch, this is also done for out-of-range intersections
   // and very short stretches between intersections
 
-  analyze_tangent_stretches(fd,2.0*Vec2::IdentDist);
+  analyze_tangent_stretches(fd,2.0*Vec2::identDist());
 
 
 #ifdef DEBUG_PRINT
@@ -982,7 +982,7 @@ void Cont2_Isect_List::intersect_xy(Cont_Ref& cntref1,
   Elem_Cursor el2(cnt2.el_list);
 
   if (!el1 || !el2 ||
-      !cnt1.Rect_Ax::Intersects_XY(cnt2,Vec2::IdentDist)) return;
+      !cnt1.Rect_Ax::Intersects_XY(cnt2,Vec2::identDist())) return;
 
   Sub_Rect_C_Cursor rc1(cnt1.el_rect_list->Begin());
   Sub_Rect_C_Cursor rc2(cnt2.el_rect_list->Begin());
@@ -998,7 +998,7 @@ void Cont2_Isect_List::intersect_xy(Cont_Ref& cntref1,
     for (;rc2;++rc2) {
       const Rect_Ax& rct2 = rc2->Rect;
 
-      if (rct1.Intersects_XY(rct2,Vec2::IdentDist)) {
+      if (rct1.Intersects_XY(rct2,Vec2::identDist())) {
 
         Elem_Cursor curel1(el1);
 
@@ -1007,8 +1007,8 @@ void Cont2_Isect_List::intersect_xy(Cont_Ref& cntref1,
 
           const Elem &locel1 = curel1->El();
 
-          if (locel1.Len_XY() >= Vec2::IdentDist &&
-              locel1.Rect().Intersects_XY(rct2,Vec2::IdentDist)) {
+          if (locel1.Len_XY() >= Vec2::identDist() &&
+              locel1.Rect().Intersects_XY(rct2,Vec2::identDist())) {
 
             Elem_Cursor curel2(el2);
 
@@ -1021,7 +1021,7 @@ void Cont2_Isect_List::intersect_xy(Cont_Ref& cntref1,
 
               const Elem &locel2 = curel2->El();
 
-              if (locel2.Len_XY() >= Vec2::IdentDist) {
+              if (locel2.Len_XY() >= Vec2::identDist()) {
                 intersect_el(cntref1,cntref2,curel1,curel2);
 
                 if (one_only && ilist1) return;
@@ -1280,7 +1280,7 @@ void Cont2_Isect_List::extract_combine(Cont_Clsd_D_List& cnt_list)
 
     if (!atang && !newc.Empty()) {
 
-      Remove_Short_Elems(newc.el_list, 5.0*Vec2::IdentDist,true);
+      Remove_Short_Elems(newc.el_list, 5.0*Vec2::identDist(),true);
 
       newc.calc_invar();
 
@@ -1292,7 +1292,7 @@ void Cont2_Isect_List::extract_combine(Cont_Clsd_D_List& cnt_list)
       cc->calc_invar();
         
       // If area is very small, just delete the contour
-      if (fabs(cc->Area_XY()) < Vec2::IdentDist/100.0/Vec2::Pi)
+      if (fabs(cc->Area_XY()) < Vec2::identDist()/100.0/Vec2::Pi)
                                                           cc.Delete(); 
     }
 
@@ -1354,7 +1354,7 @@ void Cont2_Isect_List::extract_comb_rest(Cont_D_List *cnt_list1,
 
           if (!newpiece.Empty()) {
             Remove_Short_Elems(newpiece.el_list,
-                                   5.0*Vec2::IdentDist,newpiece.Closed());
+                                   5.0*Vec2::identDist(),newpiece.Closed());
             if (on_list1) {
               if (cnt_list1) cnt_list1->End().Insert(newpiece);
             }
@@ -0,0 +1,456 @@
+/* ---------------------------------------------------------------------- */
+/* ---------------- Contour Element Attribute Table --------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ------------- Copyright Inofor Hoek Aut BV 2026, C. Wolters ---------- */
+/* ---------------------------------------------------------------------- */
+
+#include "Cont_Attr.h"
+
+#include "Exceptions.h"
+
+#include <string.h>
+
+namespace Ino
+{
+
+/* ---------------------------------------------------------------------- */
+/* ------- Allocate a column on first non default value ----------------- */
+/* ---------------------------------------------------------------------- */
+
+template <class T>
+T *Cont_Attr_Table::column(T*& col, T dfltVal)
+{
+  if (col) return col;
+
+  col = new T[cap > 0 ? cap : 1];
+
+  for (int i=0; i<sz; ++i) col[i] = dfltVal;
+
+  return col;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+template <class T>
+void Cont_Attr_Table::grow(T*& col, int newCap, T dfltVal)
+{
+  if (!col) return;
+
+  T *newCol = new T[newCap];
+  memcpy(newCol,col,sz*sizeof(T));
+
+  for (int i=sz; i<newCap; ++i) newCol[i] = dfltVal;
+
+  delete[] col;
+  col = newCol;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+template <class T>
+static void copy_column(T*& dst, const T *src, int cap)
+{
+  if (dst) delete[] dst;
+  dst = NULL;
+
+  if (!src) return;
+
+  dst = new T[cap];
+  memcpy(dst,src,cap*sizeof(T));
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+template <class T>
+static void drop_column(T*& col)
+{
+  if (col) delete[] col;
+  col = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Attr_Table::Cont_Attr_Table()
+ : sz(0), cap(0), el_ids(NULL), cnt_ids(NULL), p_cnt_ids(NULL),
+   cam_infs(NULL), colors(NULL), ins_arcs(NULL), dflt()
+{
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Attr_Table::Cont_Attr_Table(int elems, const Elem_Attr& defAttr)
+ : sz(0), cap(0), el_ids(NULL), cnt_ids(NULL), p_cnt_ids(NULL),
+   cam_infs(NULL), colors(NULL), ins_arcs(NULL), dflt(defAttr)
+{
+  Resize(elems);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Attr_Table::Cont_Attr_Table(const Cont_Attr_Table& cp)
+ : sz(0), cap(0), el_ids(NULL), cnt_ids(NULL), p_cnt_ids(NULL),
+   cam_infs(NULL), colors(NULL), ins_arcs(NULL), dflt()
+{
+  copy_from(cp);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Attr_Table::~Cont_Attr_Table()
+{
+  free_columns();
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Attr_Table& Cont_Attr_Table::operator=(const Cont_Attr_Table& src)
+{
+  if (&src != this) copy_from(src);
+
+  return *this;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::free_columns()
+{
+  drop_column(el_ids);
+  drop_column(cnt_ids);
+  drop_column(p_cnt_ids);
+  drop_column(cam_infs);
+  drop_column(colors);
+  drop_column(ins_arcs);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::copy_from(const Cont_Attr_Table& src)
+{
+  sz   = src.sz;
+  cap  = src.cap;
+  dflt = src.dflt;
+
+  copy_column(el_ids,src.el_ids,cap);
+  copy_column(cnt_ids,src.cnt_ids,cap);
+  copy_column(p_cnt_ids,src.p_cnt_ids,cap);
+  copy_column(cam_infs,src.cam_infs,cap);
+  copy_column(colors,src.colors,cap);
+  copy_column(ins_arcs,src.ins_arcs,cap);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Resize(int elems)
+{
+  if (elems < 0)
+    throw IllegalArgumentException("Cont_Attr_Table::Resize");
+
+  if (elems > cap) {
+    int newCap = cap > 0 ? cap : 16;
+    while (newCap < elems) newCap *= 2;
+
+    grow(el_ids,newCap,dflt.el_id);
+    grow(cnt_ids,newCap,dflt.cnt_id);
+    grow(p_cnt_ids,newCap,dflt.p_cnt_id);
+    grow(cam_infs,newCap,dflt.cam_inf);
+    grow(colors,newCap,dflt.color);
+    grow(ins_arcs,newCap,dflt.insArc);
+
+    cap = newCap;
+  }
+  else {
+    // Shrinking or growing within capacity: reset the (re)used slots
+    for (int i=sz; i<elems; ++i) {
+      if (el_ids)    el_ids[i]    = dflt.el_id;
+      if (cnt_ids)   cnt_ids[i]   = dflt.cnt_id;
+      if (p_cnt_ids) p_cnt_ids[i] = dflt.p_cnt_id;
+      if (cam_infs)  cam_infs[i]  = dflt.cam_inf;
+      if (colors)    colors[i]    = dflt.color;
+      if (ins_arcs)  ins_arcs[i]  = dflt.insArc;
+    }
+  }
+
+  sz = elems;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Clear()
+{
+  free_columns();
+
+  sz  = 0;
+  cap = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Default(const Elem_Attr& defAttr)
+{
+  free_columns();
+
+  dflt = defAttr;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Single element updates --------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Id(int idx, int id)
+{
+  if (idx < 0 || idx >= sz)
+    throw IndexOutOfBoundsException("Cont_Attr_Table::Id");
+
+  if (!el_ids && id == dflt.el_id) return;
+
+  column(el_ids,dflt.el_id)[idx] = id;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Cnt_Id(int idx, int id)
+{
+  if (idx < 0 || idx >= sz)
+    throw IndexOutOfBoundsException("Cont_Attr_Table::Cnt_Id");
+
+  if (!cnt_ids && id == dflt.cnt_id) return;
+
+  column(cnt_ids,dflt.cnt_id)[idx] = id;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::P_Cnt_Id(int idx, int id)
+{
+  if (idx < 0 || idx >= sz)
+    throw IndexOutOfBoundsException("Cont_Attr_Table::P_Cnt_Id");
+
+  if (!p_cnt_ids && id == dflt.p_cnt_id) return;
+
+  column(p_cnt_ids,dflt.p_cnt_id)[idx] = id;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Cam_Inf(int idx, int camInf)
+{
+  if (idx < 0 || idx >= sz)
+    throw IndexOutOfBoundsException("Cont_Attr_Table::Cam_Inf");
+
+  if (!cam_infs && camInf == dflt.cam_inf) return;
+
+  column(cam_infs,dflt.cam_inf)[idx] = camInf;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Color(int idx, long color)
+{
+  if (idx < 0 || idx >= sz)
+    throw IndexOutOfBoundsException("Cont_Attr_Table::Color");
+
+  if (!colors && color == dflt.color) return;
+
+  column(colors,dflt.color)[idx] = color;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Ins_Arc(int idx, bool insArc)
+{
+  if (idx < 0 || idx >= sz)
+    throw IndexOutOfBoundsException("Cont_Attr_Table::Ins_Arc");
+
+  if (!ins_arcs && insArc == dflt.insArc) return;
+
+  column(ins_arcs,dflt.insArc)[idx] = insArc;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Get(int idx, Elem_Attr& attr) const
+{
+  if (idx < 0 || idx >= sz)
+    throw IndexOutOfBoundsException("Cont_Attr_Table::Get");
+
+  attr.el_id    = Id(idx);
+  attr.cnt_id   = Cnt_Id(idx);
+  attr.p_cnt_id = P_Cnt_Id(idx);
+  attr.cam_inf  = Cam_Inf(idx);
+  attr.color    = Color(idx);
+  attr.insArc   = Ins_Arc(idx);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Set(int idx, const Elem_Attr& attr)
+{
+  Id(idx,attr.el_id);
+  Cnt_Id(idx,attr.cnt_id);
+  P_Cnt_Id(idx,attr.p_cnt_id);
+  Cam_Inf(idx,attr.cam_inf);
+  Color(idx,attr.color);
+  Ins_Arc(idx,attr.insArc);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Bulk updates: just set the default --------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Fill_Ids(int id)
+{
+  drop_column(el_ids);
+  dflt.el_id = id;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Fill_Cnt_Ids(int id)
+{
+  drop_column(cnt_ids);
+  dflt.cnt_id = id;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Fill_P_Cnt_Ids(int id)
+{
+  drop_column(p_cnt_ids);
+  dflt.p_cnt_id = id;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Fill_Cam_Infs(int camInf)
+{
+  drop_column(cam_infs);
+  dflt.cam_inf = camInf;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Fill_Colors(long color)
+{
+  drop_column(colors);
+  dflt.color = color;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Fill_Ins_Arcs(bool insArc)
+{
+  drop_column(ins_arcs);
+  dflt.insArc = insArc;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Sequence_Ids(int start_id)
+{
+  int *ids = column(el_ids,dflt.el_id);
+
+  for (int i=0; i<sz; ++i) ids[i] = start_id++;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Increment_Cnt_Ids(int diffid)
+{
+  dflt.cnt_id += diffid;
+
+  if (!cnt_ids) return;
+
+  for (int i=0; i<sz; ++i) cnt_ids[i] += diffid;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Attr_Table::Increment_P_Cnt_Ids(int diffid)
+{
+  dflt.p_cnt_id += diffid;
+
+  if (!p_cnt_ids) return;
+
+  for (int i=0; i<sz; ++i) p_cnt_ids[i] += diffid;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+long Cont_Attr_Table::Mem_Size() const
+{
+  long bytes = 0;
+
+  if (el_ids)    bytes += cap * sizeof(int);
+  if (cnt_ids)   bytes += cap * sizeof(int);
+  if (p_cnt_ids) bytes += cap * sizeof(int);
+  if (cam_infs)  bytes += cap * sizeof(int);
+  if (colors)    bytes += cap * sizeof(long);
+  if (ins_arcs)  bytes += cap * sizeof(bool);
+
+  return bytes;
+}
+
+} // namespace Ino
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
@@ -0,0 +1,1083 @@
+/* ---------------------------------------------------------------------- */
+/* ---------------- Area from Overlapping Contours (Fill Rules) --------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ------------- Copyright Inofor Hoek Aut BV 2026, C. Wolters ---------- */
+/* ---------------------------------------------------------------------- */
+
+#include "Contour.h"
+#include "El_Arc.h"
+#include "cntpanic.hi"
+#include "Trace.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace Ino
+{
+
+/* ---------------------------------------------------------------------- */
+/* ------- Planar arrangement of the closed contours of a list ---------- */
+/* ------- Every element is split at its intersections with all others, - */
+/* ------- the pieces only meet at shared vertices. Equal pieces form --- */
+/* ------- one group with a net direction count, the winding number ----- */
+/* ------- changes by that count across the group. Each group has two --- */
+/* ------- half edges, the faces left of them are traced by taking the -- */
+/* ------- sharpest left turn at every vertex. -------------------------- */
+/* ---------------------------------------------------------------------- */
+
+class Fill_Graph
+{
+  struct Split
+  {
+    double pos;      // Along the element (length or angle)
+    int vtx;
+
+    bool operator<(const Split& s) const { return pos < s.pos; }
+  };
+
+  struct Piece
+  {
+    Elem *el;        // Runs from va to vb
+    int va, vb;
+    int sgn;         // +1 if va < vb (the canonical direction), else -1
+    Vec2 mid;
+  };
+
+  struct Group       // Half edge 2*g runs lo -> hi, 2*g+1 hi -> lo
+  {
+    int piece;       // Representative
+    int cnt;         // Net count in the canonical direction, not 0
+    int lo, hi;
+    double area;     // Area term of the canonical direction
+  };
+
+  struct Bands       // Groups bucketed on horizontal bands
+  {
+    double y0, bh;
+    int nb;
+
+    std::vector<int> first;     // Per band, into grps
+    std::vector<int> grps;      // Sorted on increasing xmin per band
+    std::vector<double> xmin, ymin, ymax;
+
+    void build(const Fill_Graph& gr);
+    int  winding(const Fill_Graph& gr, const Vec2& p, int comp) const;
+  };
+
+  double tol;
+
+  std::vector<Elem *> src;
+  std::vector<std::vector<Split> > splits;
+  std::vector<int> end_vtx;
+
+  std::vector<Vec2> vtx;
+  std::unordered_map<long long,int> vhead;
+  std::vector<int> vnext;
+
+  std::vector<Piece> pieces;
+  std::vector<Group> groups;
+
+  std::vector<int> out_first;   // Per vertex, into outs
+  std::vector<int> outs;        // Outgoing half edges, counterclockwise
+  std::vector<int> he_pos;      // Index of a half edge in outs
+
+  std::vector<int> he_face;
+  std::vector<int> face_wind;
+  std::vector<int> vtx_comp;
+
+  std::vector<bool> he_keep;
+
+  void add_src(const Elem& el);
+
+  long long vkey(long long ix, long long iy) const
+                           { return ix * 73856093LL ^ iy * 19349663LL; }
+  int  vertex(const Vec2& p);
+
+  void add_split(int el, const Vec2& p);
+  void intersect(int el1, int el2, Isect_Lst& isl);
+  void intersect_all();
+
+  void make_pieces();
+  void make_groups();
+  void make_faces();
+  void wind_faces();
+
+  int he_org(int he) const
+           { return (he & 1) ? groups[he >> 1].hi : groups[he >> 1].lo; }
+  int he_dst(int he) const { return he_org(he ^ 1); }
+
+  double he_key(int he) const;
+  int    he_next(int he) const;
+
+  Vec2 leftmost(int grp) const;
+  static int crossings(const Elem& el, const Vec2& m);
+
+  Fill_Graph(const Fill_Graph& cp);             // No copying
+  Fill_Graph& operator=(const Fill_Graph& src); // No assignment
+
+ public:
+  Fill_Graph(const Cont_List& lst);
+  ~Fill_Graph();
+
+  void Select(Cont_Area::Fill_Rule rule);
+  bool Link(std::vector<std::vector<int> >& loops) const;
+  Elem *Edge_Elem(int he) const;
+};
+
+/* ---------------------------------------------------------------------- */
+
+static bool fill_is_filled(Cont_Area::Fill_Rule rule, int wind)
+{
+  switch (rule) {
+    case Cont_Area::Fill_Even_Odd: return (wind & 1) != 0;
+    case Cont_Area::Fill_Positive: return wind > 0;
+    default:                       return wind != 0;
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Position of p along el, only used for ordering splits -------- */
+/* ---------------------------------------------------------------------- */
+
+static double fill_elem_pos(const Elem& el, const Vec2& p)
+{
+  const Vec2& p1 = el.P1();
+
+  if (el.isArc()) {
+    const Elem_Arc& arc = (const Elem_Arc&)el;
+
+    Vec2 a = p1 - arc.C(), b = p - arc.C();
+
+    double ang = atan2(a.cross2(b), a * b);
+
+    return arc.Ccw() ? ang : -ang;
+  }
+
+  const Vec2& p2 = el.P2();
+
+  return (p2 - p1) * (p - p1);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Circles and arcs of more than half a circle are split, no ---- */
+/* ------- piece then has coinciding end points. ------------------------ */
+/* ---------------------------------------------------------------------- */
+
+void Fill_Graph::add_src(const Elem& el)
+{
+  if (el.Len_XY() < tol) return;
+
+  if (el.isCircle() || (el.isArc() && fabs(el.Span_Angle()) > Vec2::Pi)) {
+    Elem_List spl;
+
+    el.Split(el.Mid_Par(),spl);
+
+    Elem_C_Cursor elc(spl);
+    for (;elc;++elc) src.push_back(elc->El().Clone());
+  }
+  else src.push_back(el.Clone());
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Vertex within tol of p, new if none -------------------------- */
+/* ---------------------------------------------------------------------- */
+
+int Fill_Graph::vertex(const Vec2& p)
+{
+  long long ix = (long long)floor(p.x/tol);
+  long long iy = (long long)floor(p.y/tol);
+
+  double sqtol = tol*tol;
+
+  for (long long dy=-1; dy<=1; ++dy) {
+    for (long long dx=-1; dx<=1; ++dx) {
+      std::unordered_map<long long,int>::const_iterator it =
+                                            vhead.find(vkey(ix+dx,iy+dy));
+      if (it == vhead.end()) continue;
+
+      for (int v=it->second; v>=0; v=vnext[v]) {
+        if (vtx[v].sqDistTo2(p) <= sqtol) return v;
+      }
+    }
+  }
+
+  int v = (int)vtx.size();
+  vtx.push_back(p);
+
+  long long key = vkey(ix,iy);
+
+  std::unordered_map<long long,int>::iterator it = vhead.find(key);
+
+  if (it == vhead.end()) { vnext.push_back(-1); vhead[key] = v; }
+  else { vnext.push_back(it->second); it->second = v; }
+
+  return v;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Fill_Graph::add_split(int el, const Vec2& p)
+{
+  Split s;
+  s.vtx = vertex(p);
+
+  if (s.vtx == splits[el][0].vtx || s.vtx == end_vtx[el]) return;
+
+  s.pos = fill_elem_pos(*src[el],p);
+
+  splits[el].push_back(s);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Crossings and touching end points of two elements ------------ */
+/* ------- End points lying on the other element catch T-joints and ----- */
+/* ------- overlapping parts, which Intersect_XY does not report. ------- */
+/* ---------------------------------------------------------------------- */
+
+void Fill_Graph::intersect(int el1, int el2, Isect_Lst& isl)
+{
+  const Elem& e1 = *src[el1];
+  const Elem& e2 = *src[el2];
+
+  e1.Intersect_XY(e2,true,isl);
+
+  Isect_C_Cursor ic(isl);
+
+  for (;ic;++ic) {
+    add_split(el1,ic->P);
+    add_split(el2,ic->P);
+  }
+
+  for (int i=0; i<4; ++i) {
+    const Elem& on  = i < 2 ? e1 : e2;
+    const Elem& oth = i < 2 ? e2 : e1;
+
+    const Vec2& p = (i & 1) ? oth.P2() : oth.P1();
+
+    Vec3 pp; double parm, dist;
+
+    if (on.Project_Pnt_XY(p,tol,true,pp,parm,dist) && fabs(dist) <= tol)
+                                           add_split(i < 2 ? el1 : el2,p);
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Candidate pairs from a uniform grid on the element rects. ---- */
+/* ------- A pair is handled only in the cell holding the lower left ---- */
+/* ------- corner of the overlap of both rects. ------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Fill_Graph::intersect_all()
+{
+  int n = (int)src.size();
+  if (n < 2) return;
+
+  Rect_Ax all;
+  double ext = 0.0;
+
+  for (int i=0; i<n; ++i) {
+    const Rect_Ax& r = src[i]->Rect();
+    all += r;
+
+    ext += std::max(r.Ur().x - r.Ll().x, r.Ur().y - r.Ll().y);
+  }
+
+  double x0 = all.Ll().x - 2.0*tol, y0 = all.Ll().y - 2.0*tol;
+  double w  = all.Ur().x - x0 + 2.0*tol;
+  double h  = all.Ur().y - y0 + 2.0*tol;
+
+  double cell = std::max(sqrt(w*h/n), ext/n);
+  if (cell < 10.0*tol) cell = 10.0*tol;
+
+  int nx = (int)(w/cell) + 1;
+  int ny = (int)(h/cell) + 1;
+
+  std::vector<int> cells(n*4);       // ix1,iy1,ix2,iy2 per element
+  std::vector<int> first(nx*ny+1,0);
+
+  for (int i=0; i<n; ++i) {
+    const Rect_Ax& r = src[i]->Rect();
+
+    int *c = &cells[i*4];
+
+    c[0] = std::min(nx-1,std::max(0,(int)((r.Ll().x - tol - x0)/cell)));
+    c[1] = std::min(ny-1,std::max(0,(int)((r.Ll().y - tol - y0)/cell)));
+    c[2] = std::min(nx-1,std::max(0,(int)((r.Ur().x + tol - x0)/cell)));
+    c[3] = std::min(ny-1,std::max(0,(int)((r.Ur().y + tol - y0)/cell)));
+
+    for (int iy=c[1]; iy<=c[3]; ++iy)
+      for (int ix=c[0]; ix<=c[2]; ++ix) first[iy*nx+ix+1]++;
+  }
+
+  for (int c=0; c<nx*ny; ++c) first[c+1] += first[c];
+
+  std::vector<int> els(first[nx*ny]);
+  std::vector<int> fill(first.begin(),first.end()-1);
+
+  for (int i=0; i<n; ++i) {
+    const int *c = &cells[i*4];
+
+    for (int iy=c[1]; iy<=c[3]; ++iy)
+      for (int ix=c[0]; ix<=c[2]; ++ix) els[fill[iy*nx+ix]++] = i;
+  }
+
+  Isect_Lst isl;
+
+  for (int iy=0; iy<ny; ++iy) {
+    for (int ix=0; ix<nx; ++ix) {
+      int c = iy*nx + ix;
+
+      for (int a=first[c]; a<first[c+1]; ++a) {
+        int i = els[a];
+        const int *ci = &cells[i*4];
+
+        for (int b=a+1; b<first[c+1]; ++b) {
+          int j = els[b];
+          const int *cj = &cells[j*4];
+
+          if (std::max(ci[0],cj[0]) != ix || std::max(ci[1],cj[1]) != iy)
+                                                                 continue;
+
+          if (!src[i]->Rect().Intersects_XY(src[j]->Rect(),tol)) continue;
+
+          intersect(i,j,isl);
+        }
+      }
+    }
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Split each element at its (merged) split vertices ------------ */
+/* ---------------------------------------------------------------------- */
+
+void Fill_Graph::make_pieces()
+{
+  for (size_t i=0; i<src.size(); ++i) {
+    std::vector<Split>& spl = splits[i];
+
+    std::sort(spl.begin(),spl.end());
+
+    const Elem& el = *src[i];
+
+    int prv = 0;
+
+    for (size_t s=1; s<spl.size(); ++s) {
+      int va = spl[prv].vtx, vb = spl[s].vtx;
+
+      if (va == vb) continue;
+
+      Piece pc;
+      pc.el = el.Clone();
+      pc.el->Stretch_Begin_XY(vtx[va],false);
+      pc.el->Stretch_End_XY(vtx[vb],false);
+
+      pc.va  = va;
+      pc.vb  = vb;
+      pc.sgn = va < vb ? 1 : -1;
+
+      pc.el->Mid_Par_XY(pc.mid);
+
+      pieces.push_back(pc);
+
+      prv = (int)s;
+    }
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Pieces between the same vertices with the same mid point ----- */
+/* ------- form a group, groups that cancel out are dropped ------------- */
+/* ---------------------------------------------------------------------- */
+
+struct Fill_Piece_Key
+{
+  int lo, hi, idx;
+
+  bool operator<(const Fill_Piece_Key& k) const
+  {
+    if (lo != k.lo) return lo < k.lo;
+    if (hi != k.hi) return hi < k.hi;
+    return idx < k.idx;
+  }
+};
+
+void Fill_Graph::make_groups()
+{
+  int n = (int)pieces.size();
+
+  std::vector<Fill_Piece_Key> keys(n);
+
+  for (int i=0; i<n; ++i) {
+    keys[i].lo  = std::min(pieces[i].va,pieces[i].vb);
+    keys[i].hi  = std::max(pieces[i].va,pieces[i].vb);
+    keys[i].idx = i;
+  }
+
+  std::sort(keys.begin(),keys.end());
+
+  double sqtol = 100.0*tol*tol;
+
+  std::vector<bool> done(n,false);
+
+  for (int b=0; b<n;) {
+    int e = b+1;
+    while (e < n && keys[e].lo == keys[b].lo && keys[e].hi == keys[b].hi) ++e;
+
+    for (int i=b; i<e; ++i) {
+      if (done[i]) continue;
+
+      const Piece& pc = pieces[keys[i].idx];
+
+      Group g;
+      g.piece = keys[i].idx;
+      g.cnt   = 0;
+      g.lo    = keys[i].lo;
+      g.hi    = keys[i].hi;
+
+      for (int j=i; j<e; ++j) {
+        const Piece& pj = pieces[keys[j].idx];
+
+        if (!done[j] && pj.mid.sqDistTo2(pc.mid) <= sqtol) {
+          done[j] = true;
+          g.cnt += pj.sgn;
+        }
+      }
+
+      if (g.cnt == 0) continue;
+
+      // Area between the piece and the origin, of the circle segment
+      // for an arc
+
+      const Vec2& p1 = pc.el->P1();
+      const Vec2& p2 = pc.el->P2();
+
+      g.area = p1.cross2(p2) / 2.0;
+
+      if (pc.el->isArc()) {
+        const Elem_Arc& arc = (const Elem_Arc&)*pc.el;
+
+        double ang = fabs(arc.Span_Angle());
+        double seg = arc.R() * arc.R() * (ang - sin(ang)) / 2.0;
+
+        g.area += arc.Ccw() ? seg : -seg;
+      }
+
+      if (pc.sgn < 0) g.area = -g.area;
+
+      groups.push_back(g);
+    }
+
+    b = e;
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Direction of a half edge seen from its begin vertex. For ----- */
+/* ------- arcs that of a point a little along it, so tangent pieces ---- */
+/* ------- are ordered on their curvature. ------------------------------ */
+/* ---------------------------------------------------------------------- */
+
+double Fill_Graph::he_key(int he) const
+{
+  const Group& g  = groups[he >> 1];
+  const Piece& pc = pieces[g.piece];
+
+  bool along = he_org(he) == pc.va;
+
+  Vec2 tg;
+  double curve;
+
+  if (along) {
+    pc.el->Start_Tangent_XY(tg);
+    curve = pc.el->Start_Curve();
+  }
+  else {
+    pc.el->End_Tangent_XY(tg); tg *= -1.0;
+    curve = -pc.el->End_Curve();
+  }
+
+  double ang = atan2(tg.y,tg.x);
+
+  if (pc.el->isArc()) {
+    double step = std::min(pc.el->Len_XY()/2.0, 1000.0*tol);
+
+    ang += curve * step / 2.0;
+
+    if (ang >  Vec2::Pi) ang -= Vec2::Pi2;
+    if (ang < -Vec2::Pi) ang += Vec2::Pi2;
+  }
+
+  return ang;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Next half edge around the face left of he -------------------- */
+/* ---------------------------------------------------------------------- */
+
+int Fill_Graph::he_next(int he) const
+{
+  int v   = he_dst(he);
+  int deg = out_first[v+1] - out_first[v];
+
+  int i = he_pos[he ^ 1] - 1;
+  if (i < 0) i += deg;
+
+  return outs[out_first[v] + i];
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Half edges sorted around their vertices, faces traced -------- */
+/* ---------------------------------------------------------------------- */
+
+struct Fill_He_Key
+{
+  double key;
+  int he;
+
+  bool operator<(const Fill_He_Key& k) const
+  {
+    if (key != k.key) return key < k.key;
+    return he < k.he;
+  }
+};
+
+void Fill_Graph::make_faces()
+{
+  int nv = (int)vtx.size();
+  int nh = 2 * (int)groups.size();
+
+  out_first.assign(nv+1,0);
+  outs.resize(nh);
+  he_pos.resize(nh);
+
+  for (int he=0; he<nh; ++he) out_first[he_org(he)+1]++;
+  for (int v=0; v<nv; ++v) out_first[v+1] += out_first[v];
+
+  std::vector<Fill_He_Key> keys(nh);
+  std::vector<int> fill(out_first.begin(),out_first.end()-1);
+
+  for (int he=0; he<nh; ++he) {
+    Fill_He_Key& k = keys[fill[he_org(he)]++];
+
+    k.key = he_key(he);
+    k.he  = he;
+  }
+
+  for (int v=0; v<nv; ++v) {
+    std::sort(keys.begin()+out_first[v],keys.begin()+out_first[v+1]);
+
+    for (int i=out_first[v]; i<out_first[v+1]; ++i) {
+      outs[i] = keys[i].he;
+      he_pos[keys[i].he] = i - out_first[v];
+    }
+  }
+
+  he_face.assign(nh,-1);
+
+  int nf = 0;
+
+  for (int he=0; he<nh; ++he) {
+    if (he_face[he] >= 0) continue;
+
+    int h = he;
+
+    do {
+      he_face[h] = nf;
+      h = he_next(h);
+    } while (h != he);
+
+    nf++;
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Leftmost point of a group ------------------------------------ */
+/* ---------------------------------------------------------------------- */
+
+Vec2 Fill_Graph::leftmost(int grp) const
+{
+  const Elem& el = *pieces[groups[grp].piece].el;
+
+  const Vec2& a = el.P1();
+  const Vec2& b = el.P2();
+
+  if (el.isArc()) {
+    const Elem_Arc& arc = (const Elem_Arc&)el;
+
+    const Vec2& c = arc.C();
+
+    double ya = arc.Ccw() ? a.y - c.y : b.y - c.y;  // Counterclockwise
+    double yb = arc.Ccw() ? b.y - c.y : a.y - c.y;
+
+    if (ya > 0.0 && yb < 0.0) return Vec2(c.x - a.distTo2(c), c.y);
+  }
+
+  return a.x <= b.x ? a : b;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Signed crossings of el with the ray from m along -x, end ----- */
+/* ------- points count on the half open rule (y > m.y). A contour ------ */
+/* ------- running counterclockwise around m counts +1. ----------------- */
+/* ---------------------------------------------------------------------- */
+
+int Fill_Graph::crossings(const Elem& el, const Vec2& m)
+{
+  const Vec2& a = el.P1();
+  const Vec2& b = el.P2();
+
+  if (!el.isArc()) {
+    if ((a.y > m.y) == (b.y > m.y)) return 0;
+
+    double x = a.x + (m.y - a.y) * (b.x - a.x) / (b.y - a.y);
+
+    if (x >= m.x) return 0;
+
+    return b.y > a.y ? -1 : 1;
+  }
+
+  // Arc (at most half a circle): split at the top or bottom of the
+  // circle into y monotone parts
+
+  const Elem_Arc& arc = (const Elem_Arc&)el;
+
+  const Vec2& c = arc.C();
+  double r = a.distTo2(c);
+  bool ccw = arc.Ccw();
+
+  Vec2 ca = ccw ? a - c : b - c;     // Counterclockwise from ca to cb
+  Vec2 cb = ccw ? b - c : a - c;
+
+  Vec2 pts[3]; int np = 0;
+
+  pts[np++] = a;
+
+  if (ca.x < 0.0 && cb.x > 0.0) pts[np++] = Vec2(c.x,c.y - r); // Bottom
+  if (ca.x > 0.0 && cb.x < 0.0) pts[np++] = Vec2(c.x,c.y + r); // Top
+
+  pts[np++] = b;
+
+  int cross = 0;
+
+  for (int i=0; i<np-1; ++i) {
+    const Vec2& u = pts[i];
+    const Vec2& w = pts[i+1];
+
+    if ((u.y > m.y) == (w.y > m.y)) continue;
+
+    bool up    = w.y > u.y;
+    bool right = up == ccw;
+
+    double dy = m.y - c.y;
+    double sq = r*r - dy*dy;
+    double x  = c.x + (right ? 1.0 : -1.0) * (sq > 0.0 ? sqrt(sq) : 0.0);
+
+    if (x < m.x) cross += up ? -1 : 1;
+  }
+
+  return cross;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Fill_Graph::Bands::build(const Fill_Graph& gr)
+{
+  int ng = (int)gr.groups.size();
+
+  xmin.resize(ng); ymin.resize(ng); ymax.resize(ng);
+
+  double lo = 0.0, hi = 0.0, hsum = 0.0;
+
+  for (int g=0; g<ng; ++g) {
+    const Rect_Ax& r = gr.pieces[gr.groups[g].piece].el->Rect();
+
+    xmin[g] = r.Ll().x; ymin[g] = r.Ll().y; ymax[g] = r.Ur().y;
+
+    if (g == 0 || ymin[g] < lo) lo = ymin[g];
+    if (g == 0 || ymax[g] > hi) hi = ymax[g];
+
+    hsum += ymax[g] - ymin[g];
+  }
+
+  y0 = lo;
+
+  double span = hi - lo;
+  double avgh = ng > 0 ? hsum/ng : 0.0;
+
+  int maxnb = ng/2 + 1;
+
+  nb = avgh > 0.0 ? (int)(span/avgh) + 1 : maxnb;
+  if (nb > maxnb) nb = maxnb;
+  if (nb < 1) nb = 1;
+
+  bh = span > 0.0 ? span/nb : 1.0;
+
+  first.assign(nb+1,0);
+
+  for (int pass=0; pass<2; ++pass) {
+    std::vector<int> fill;
+    if (pass == 1) fill.assign(first.begin(),first.end()-1);
+
+    for (int g=0; g<ng; ++g) {
+      int b1 = std::max(0,   (int)((ymin[g] - y0)/bh));
+      int b2 = std::min(nb-1,(int)((ymax[g] - y0)/bh));
+
+      for (int b=b1; b<=b2; ++b) {
+        if (pass == 0) first[b+1]++;
+        else grps[fill[b]++] = g;
+      }
+    }
+
+    if (pass == 0) {
+      for (int b=0; b<nb; ++b) first[b+1] += first[b];
+      grps.resize(first[nb]);
+    }
+  }
+
+  for (int b=0; b<nb; ++b) {
+    const std::vector<double>& xm = xmin;
+
+    std::sort(grps.begin()+first[b],grps.begin()+first[b+1],
+              [&xm](int g1, int g2) { return xm[g1] < xm[g2]; });
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Winding number at p of the groups not in component comp ------ */
+/* ---------------------------------------------------------------------- */
+
+int Fill_Graph::Bands::winding(const Fill_Graph& gr,
+                                          const Vec2& p, int comp) const
+{
+  int b = (int)((p.y - y0)/bh);
+  if (b < 0) b = 0;
+  if (b >= nb) b = nb-1;
+
+  int wind = 0;
+
+  for (int i=first[b]; i<first[b+1]; ++i) {
+    int g = grps[i];
+
+    if (xmin[g] >= p.x) break;
+    if (ymin[g] > p.y || ymax[g] < p.y) continue;
+
+    const Group& grp = gr.groups[g];
+    if (gr.vtx_comp[grp.lo] == comp) continue;
+
+    const Piece& pc = gr.pieces[grp.piece];
+
+    int cr = crossings(*pc.el,p);
+
+    if (cr != 0) wind += cr * pc.sgn * grp.cnt;
+  }
+
+  return wind;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Winding numbers of all faces. The outer face of a connected -- */
+/* ------- component gets its number from a ray left of the component, -- */
+/* ------- the others follow from the counts of the groups crossed. ----- */
+/* ---------------------------------------------------------------------- */
+
+void Fill_Graph::wind_faces()
+{
+  int nv = (int)vtx.size();
+  int ng = (int)groups.size();
+  int nh = 2*ng;
+
+  int nf = 0;
+  for (int he=0; he<nh; ++he) nf = std::max(nf,he_face[he]+1);
+
+  // Connected components of the vertices
+
+  std::vector<int> par(nv);
+  for (int v=0; v<nv; ++v) par[v] = v;
+
+  for (int g=0; g<ng; ++g) {
+    int a = groups[g].lo, b = groups[g].hi;
+
+    while (par[a] != a) a = par[a] = par[par[a]];
+    while (par[b] != b) b = par[b] = par[par[b]];
+
+    if (a != b) par[std::max(a,b)] = std::min(a,b);
+  }
+
+  vtx_comp.resize(nv);
+  for (int v=0; v<nv; ++v) {
+    int a = v;
+    while (par[a] != a) a = par[a];
+    vtx_comp[v] = a;
+  }
+
+  // Per component the face of least (most negative) area is the outer
+  // one and the leftmost point
+
+  std::vector<double> face_area(nf,0.0);
+  std::vector<int> face_he(nf,-1);
+
+  for (int he=0; he<nh; ++he) {
+    double ar = groups[he >> 1].area;
+
+    face_area[he_face[he]] += (he & 1) ? -ar : ar;
+    face_he[he_face[he]] = he;
+  }
+
+  std::vector<int>  outer(nv,-1), left_grp(nv,-1);
+  std::vector<Vec2> left_pnt(nv);
+
+  for (int f=0; f<nf; ++f) {
+    int c = vtx_comp[he_org(face_he[f])];
+
+    if (outer[c] < 0 || face_area[f] < face_area[outer[c]]) outer[c] = f;
+  }
+
+  for (int g=0; g<ng; ++g) {
+    int c = vtx_comp[groups[g].lo];
+
+    Vec2 p = leftmost(g);
+
+    if (left_grp[c] < 0 || p.x < left_pnt[c].x) {
+      left_grp[c] = g; left_pnt[c] = p;
+    }
+  }
+
+  Bands bands;
+  bands.build(*this);
+
+  face_wind.assign(nf,0);
+
+  std::vector<bool> done(nf,false);
+  std::vector<int> queue;
+
+  for (int c=0; c<nv; ++c) {
+    if (outer[c] < 0) continue;
+
+    int f = outer[c];
+
+    face_wind[f] = bands.winding(*this,left_pnt[c],c);
+    done[f] = true;
+
+    queue.clear();
+    queue.push_back(f);
+
+    for (size_t q=0; q<queue.size(); ++q) {
+      int cf = queue[q];
+      int h  = face_he[cf];
+
+      do {
+        int of = he_face[h ^ 1];
+
+        if (!done[of]) {
+          int cnt = groups[h >> 1].cnt;
+
+          face_wind[of] = face_wind[cf] - ((h & 1) ? -cnt : cnt);
+          done[of] = true;
+
+          queue.push_back(of);
+        }
+
+        h = he_next(h);
+      } while (h != face_he[cf]);
+    }
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Builds the split and grouped pieces of all closed contours --- */
+/* ---------------------------------------------------------------------- */
+
+Fill_Graph::Fill_Graph(const Cont_List& lst)
+ : tol(Vec2::identDist())
+{
+  Cont_C_Cursor cc(lst.List());
+
+  for (;cc;++cc) {
+    if (!cc->Closed()) continue;
+
+    Elem_C_Cursor elc(cc->List());
+    for (;elc;++elc) add_src(elc->El());
+  }
+
+  // All end points are vertices before any intersection point is merged
+
+  int n = (int)src.size();
+
+  splits.resize(n);
+  end_vtx.resize(n);
+
+  for (int i=0; i<n; ++i) {
+    Split s;
+    s.pos = -1e300; s.vtx = vertex(src[i]->P1());
+
+    splits[i].push_back(s);
+    end_vtx[i] = vertex(src[i]->P2());
+  }
+
+  intersect_all();
+
+  for (int i=0; i<n; ++i) {
+    Split s;
+    s.pos = 1e300; s.vtx = end_vtx[i];
+
+    splits[i].push_back(s);
+  }
+
+  make_pieces();
+  make_groups();
+  make_faces();
+  wind_faces();
+}
+
+/* ---------------------------------------------------------------------- */
+
+Fill_Graph::~Fill_Graph()
+{
+  for (size_t i=0; i<src.size(); ++i) delete src[i];
+  for (size_t i=0; i<pieces.size(); ++i) delete pieces[i].el;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Keeps the half edge with the filled face on its left of ------ */
+/* ------- groups between a filled and a non filled face ---------------- */
+/* ---------------------------------------------------------------------- */
+
+void Fill_Graph::Select(Cont_Area::Fill_Rule rule)
+{
+  int ng = (int)groups.size();
+
+  he_keep.assign(2*ng,false);
+
+  for (int g=0; g<ng; ++g) {
+    bool fl = fill_is_filled(rule,face_wind[he_face[2*g]]);
+    bool fr = fill_is_filled(rule,face_wind[he_face[2*g+1]]);
+
+    if (fl != fr) he_keep[fl ? 2*g : 2*g+1] = true;
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Links the kept half edges into closed loops. At each vertex -- */
+/* ------- the sharpest left turn is taken, so loops touching in a ------ */
+/* ------- vertex stay separate. Returns false if a walk dead ends or --- */
+/* ------- runs into a used half edge: a boundary would be missing. ----- */
+/* ---------------------------------------------------------------------- */
+
+bool Fill_Graph::Link(std::vector<std::vector<int> >& loops) const
+{
+  int nh = (int)he_keep.size();
+
+  std::vector<bool> used(nh,false);
+
+  for (int start=0; start<nh; ++start) {
+    if (!he_keep[start] || used[start]) continue;
+
+    loops.push_back(std::vector<int>());
+    std::vector<int>& loop = loops.back();
+
+    int he = start;
+
+    for (;;) {
+      used[he] = true;
+      loop.push_back(he);
+
+      int v   = he_dst(he);
+      int deg = out_first[v+1] - out_first[v];
+      int pos = he_pos[he ^ 1];
+
+      int nxt = -1;
+
+      for (int k=1; k<deg; ++k) {
+        int o = outs[out_first[v] + (pos - k + deg) % deg];
+
+        if (he_keep[o]) { nxt = o; break; }
+      }
+
+      if (nxt == start) break;
+
+      if (nxt < 0 || used[nxt]) return false;
+
+      he = nxt;
+    }
+  }
+
+  return true;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- New element of half edge he, in its direction ---------------- */
+/* ---------------------------------------------------------------------- */
+
+Elem *Fill_Graph::Edge_Elem(int he) const
+{
+  const Piece& pc = pieces[groups[he >> 1].piece];
+
+  Elem *el = pc.el->Clone();
+  if (he_org(he) != pc.va) el->Reverse();
+
+  return el;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Builds this area from the closed contours of lst, which ------ */
+/* ------- may overlap themselves and each other. A point is inside ----- */
+/* ------- when its winding number satisfies rule, counterclockwise ----- */
+/* ------- contours count positive. Open contours are ignored. ---------- */
+/* ------- Returns false, with this area empty, if there is nothing ----- */
+/* ------- filled or a boundary could not be traced. -------------------- */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Area::Fill_From(const Cont_List& lst, Fill_Rule rule)
+{
+  TraceScope trc("Cont_Area::Fill_From",
+                           Trace::enabled() ? lst.Elem_Count() : -1);
+
+  nestlst.Delete();
+  calc_invar();
+  inert.invalidate();
+
+  Fill_Graph graph(lst);
+  graph.Select(rule);
+
+  std::vector<std::vector<int> > loops;
+  if (!graph.Link(loops)) return false;
+
+  Cont_Clsd_D_List clsd;
+
+  for (size_t l=0; l<loops.size(); ++l) {
+    Cont_Clsd_Cursor clc(clsd); clc.To_End();
+    clc.Insert(Cont_Clsd());
+
+    Contour& cnt = clc->cont;
+    Elem_Cursor elc(cnt.el_list);
+
+    for (size_t i=0; i<loops[l].size(); ++i) {
+      elc.To_End(); elc.Insert(Elem_Ref()); // Owns the element at once
+      elc->setElem(graph.Edge_Elem(loops[l][i]));
+    }
+
+    cnt.calc_invar();
+    cnt.is_closed = true;
+
+    clc->calc_invar();
+  }
+
+  if (!clsd) return false;
+
+  bool ok = build_from(clsd);
+
+  Begin_Par(0.0);
+
+  return ok;
+}
+
+} // namespace Ino
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
@@ -0,0 +1,702 @@
+/* ---------------------------------------------------------------------- */
+/* ---------------- Corner Rounding and Chamfering ---------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ------------- Copyright Inofor Hoek Aut BV 2026, C. Wolters ---------- */
+/* ---------------------------------------------------------------------- */
+
+#include "Contour.h"
+#include "El_Line.h"
+#include "El_Arc.h"
+#include "El_Cir.h"
+#include "Geo.h"
+#include "TaskPool.h"
+#include "Trace.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace Ino
+{
+
+/* ---------------------------------------------------------------------- */
+/* ------- A corner to round, el is the element ending at it ------------ */
+/* ---------------------------------------------------------------------- */
+
+struct Round_Corner
+{
+  int cont, el;
+  Vec2 corner;
+  Vec2 t1, t2, fc;     // Tangent points and centre of the fillet
+  bool acw;
+  bool dropped;
+  Vec2 ll, ur;         // Around the corner and the tangent points
+
+  Rect_Ax Rect() const { return Rect_Ax(Vec3(ll),Vec3(ur)); }
+};
+
+/* ---------------------------------------------------------------------- */
+/* ------- Finds the corners of each nest on its own thread, only ------- */
+/* ------- reading the contours and without list allocations. The ------- */
+/* ------- fillets of different corners are then checked against each -- */
+/* ------- other and inserted by the calling thread. --------------------- */
+/* ---------------------------------------------------------------------- */
+
+const int Cont_Round_Chunk_Elems = 16;
+
+class Cont_Round
+{
+  struct Cont_Elems    // Elements of a contour, rectangles per chunk
+  {
+    Contour *cnt;
+    std::vector<Elem *> els;
+    std::vector<Rect_Ax> chunks;
+  };
+
+  double rad, min_rad, min_ang, max_ang;
+  int sides;
+  bool chamfer;
+
+  double tol;
+
+  std::vector<Cont_Elems> conts;
+  std::vector<int> nest_first;       // Per nest, into conts
+  std::vector<Rect_Ax> nest_rects;
+
+  double gx0, gy0, gcell;            // Uniform grid of the nests
+  int gnx, gny;
+  std::vector<int> grid_first, grid_nests;
+
+  std::vector<std::vector<Round_Corner> > found;   // Per contour
+
+  bool fits(const Cont_Elems& ce, int el, double allow1, double allow2,
+                                                 Round_Corner& rc) const;
+  bool clear_of(const Cont_Elems& ce, int el, int cei,
+                                          const Round_Corner& rc) const;
+  bool crosses(const Round_Corner& rc, const Elem& el) const;
+  bool inside(const Round_Corner& rc, const Vec2& p) const;
+
+  void build_grid();
+  void cells(const Rect_Ax& rct, int& ix1, int& iy1,
+                                 int& ix2, int& iy2) const;
+
+  void find(int ci);
+  void resolve();
+  int  apply(int ci);
+
+  Cont_Round(const Cont_Round& cp);            // No copying
+  Cont_Round& operator=(const Cont_Round& src); // No assignment
+
+ public:
+  Cont_Round(double rd, double minrd, double minang, double maxang,
+                                      int sds, Contour::Corner_Type tp);
+
+  void Add(Contour& cnt);     // To the current nest
+  void End_Nest();
+
+  int Run(int thread_cnt);
+};
+
+/* ---------------------------------------------------------------------- */
+
+Cont_Round::Cont_Round(double rd, double minrd, double minang,
+                       double maxang, int sds, Contour::Corner_Type tp)
+ : rad(fabs(rd)), min_rad(fabs(minrd)),
+   min_ang(fabs(minang)), max_ang(fabs(maxang)),
+   sides(sds), chamfer(tp == Contour::Corner_Chamfer),
+   tol(Vec2::identDist()),
+   conts(), nest_first(1,0), nest_rects(),
+   gx0(0.0), gy0(0.0), gcell(1.0), gnx(1), gny(1),
+   grid_first(), grid_nests(), found()
+{
+  if (min_rad < 10.0*tol) min_rad = 10.0*tol;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Cont_Round::Add(Contour& cnt)
+{
+  conts.push_back(Cont_Elems());
+
+  Cont_Elems& ce = conts.back();
+  ce.cnt = &cnt;
+
+  Elem_Cursor elc(cnt.el_list);
+
+  for (int i=0;elc;++elc,++i) {
+    Elem& el = elc->El();
+
+    if (i % Cont_Round_Chunk_Elems == 0) ce.chunks.push_back(el.Rect());
+    else ce.chunks.back() += el.Rect();
+
+    ce.els.push_back(&el);
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Cont_Round::End_Nest()
+{
+  int first = nest_first.back();
+  int last  = (int)conts.size();
+
+  if (last == first) return;
+
+  nest_rects.push_back(conts[first].cnt->Rect());
+  for (int i=first+1; i<last; ++i) nest_rects.back() += conts[i].cnt->Rect();
+
+  nest_first.push_back(last);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Cells of about the average nest size, a nest is listed in ---- */
+/* ------- all cells its rectangle overlaps ------------------------------ */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Round::cells(const Rect_Ax& rct, int& ix1, int& iy1,
+                                           int& ix2, int& iy2) const
+{
+  ix1 = (int)floor((rct.Ll().x - tol - gx0)/gcell);
+  iy1 = (int)floor((rct.Ll().y - tol - gy0)/gcell);
+  ix2 = (int)floor((rct.Ur().x + tol - gx0)/gcell);
+  iy2 = (int)floor((rct.Ur().y + tol - gy0)/gcell);
+
+  ix1 = std::max(ix1,0); ix2 = std::min(ix2,gnx-1);
+  iy1 = std::max(iy1,0); iy2 = std::min(iy2,gny-1);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Cont_Round::build_grid()
+{
+  int nests = (int)nest_rects.size();
+  if (nests < 1) return;
+
+  Rect_Ax all;
+  double sz = 0.0;
+
+  for (int ns=0; ns<nests; ++ns) {
+    const Rect_Ax& r = nest_rects[ns];
+
+    all += r;
+    sz += std::max(r.Ur().x - r.Ll().x, r.Ur().y - r.Ll().y);
+  }
+
+  gx0 = all.Ll().x;
+  gy0 = all.Ll().y;
+
+  double w = all.Ur().x - gx0, h = all.Ur().y - gy0;
+
+  gcell = std::max(sz/nests, 10.0*tol);
+  gcell = std::max(gcell, std::max(w,h)/1024.0);
+
+  gnx = (int)(w/gcell) + 1;
+  gny = (int)(h/gcell) + 1;
+
+  grid_first.assign(gnx*gny + 1,0);
+
+  for (int pass=0; pass<2; ++pass) {
+    std::vector<int> fill;
+    if (pass == 1) fill.assign(grid_first.begin(),grid_first.end()-1);
+
+    for (int ns=0; ns<nests; ++ns) {
+      int ix1,iy1,ix2,iy2;
+      cells(nest_rects[ns],ix1,iy1,ix2,iy2);
+
+      for (int iy=iy1; iy<=iy2; ++iy) {
+        for (int ix=ix1; ix<=ix2; ++ix) {
+          if (pass == 0) grid_first[iy*gnx + ix + 1]++;
+          else grid_nests[fill[iy*gnx + ix]++] = ns;
+        }
+      }
+    }
+
+    if (pass == 0) {
+      for (int c=0; c<gnx*gny; ++c) grid_first[c+1] += grid_first[c];
+      grid_nests.resize(grid_first[gnx*gny]);
+    }
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Distance along el from the tangent point to the corner ------- */
+/* ---------------------------------------------------------------------- */
+
+static double round_setback(const Elem& el, const Vec2& t, bool at_end)
+{
+  const Vec2& p = at_end ? el.P2() : el.P1();
+
+  if (t.distTo2(p) < Vec2::identDist()) return 0.0;
+
+  if (!el.isArc()) return t.distTo2(p);
+
+  const Elem_Arc& arc = (const Elem_Arc&)el;
+
+  double span = at_end ? Geo_Arc_Span(t,p,arc.C(),arc.Ccw())
+                       : Geo_Arc_Span(p,t,arc.C(),arc.Ccw());
+
+  return fabs(span) * arc.R();
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Largest radius up to rad whose tangent points stay within ---- */
+/* ------- allow1 of the end of el and allow2 of the start of the next -- */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Round::fits(const Cont_Elems& ce, int el, double allow1,
+                                    double allow2, Round_Corner& rc) const
+{
+  int n = (int)ce.els.size();
+
+  const Elem& el1 = *ce.els[el];
+  const Elem& el2 = *ce.els[(el+1) % n];
+
+  double r = rad;
+
+  for (int iter=0; iter<30 && r >= min_rad; ++iter) {
+    Elem_Arc fil;
+
+    if (!el1.Fillet(el2,r,fil)) {
+      r *= 0.5;
+      continue;
+    }
+
+    double sb1 = round_setback(el1,fil.P1(),true);
+    double sb2 = round_setback(el2,fil.P2(),false);
+
+    double fact = 1.0;
+    if (sb1 > allow1 + tol) fact = allow1/sb1;
+    if (sb2 > allow2 + tol) fact = std::min(fact,allow2/sb2);
+
+    if (fact >= 1.0) {
+      rc.corner = el1.P2();
+      rc.t1  = fil.P1();
+      rc.t2  = fil.P2();
+      rc.fc  = fil.C();
+      rc.acw = fil.Ccw();
+
+      Rect_Ax rct(Vec3(rc.t1),Vec3(rc.t2));
+      rct += Vec3(rc.corner);
+
+      rc.ll = rct.Ll();
+      rc.ur = rct.Ur();
+
+      return true;
+    }
+
+    r *= fact;
+  }
+
+  return false;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Does the fillet (chord) of rc cross el? ---------------------- */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Round::crosses(const Round_Corner& rc, const Elem& el) const
+{
+  Vec2 ipa,ipb;
+  double pr1a,pr1b,pr2a,pr2b;
+
+  const Vec2& s = el.P1();
+  const Vec2& e = el.P2();
+
+  int sols = 0;
+
+  if (el.isLine()) {
+    if (chamfer)
+      sols = Geo_Isct_Lines(rc.t1,rc.t2,s,e,true,tol,ipa,pr1a,pr2a);
+    else
+      sols = Geo_Isct_Line_Arc(s,e,rc.t1,rc.t2,rc.fc,rc.acw,true,true,tol,
+                                        ipa,ipb,pr1a,pr1b,pr2a,pr2b);
+  }
+  else if (el.isArc()) {
+    const Elem_Arc& arc = (const Elem_Arc&)el;
+
+    if (chamfer)
+      sols = Geo_Isct_Line_Arc(rc.t1,rc.t2,s,e,arc.C(),arc.Ccw(),true,true,
+                                    tol,ipa,ipb,pr1a,pr1b,pr2a,pr2b);
+    else
+      sols = Geo_Isct_Arc_Arc(rc.t1,rc.t2,rc.fc,rc.acw,
+                              s,e,arc.C(),arc.Ccw(),true,true,tol,
+                              ipa,ipb,pr1a,pr1b,pr2a,pr2b);
+  }
+  else {
+    const Elem_Circle& cir = (const Elem_Circle&)el;
+
+    if (chamfer)
+      sols = Geo_Isct_Line_Circle(rc.t1,rc.t2,s,cir.C(),cir.Ccw(),true,true,
+                                      tol,ipa,ipb,pr1a,pr1b,pr2a,pr2b);
+    else
+      sols = Geo_Isct_Arc_Circle(rc.t1,rc.t2,rc.fc,rc.acw,s,cir.C(),
+                                      cir.Ccw(),true,true,tol,
+                                      ipa,ipb,pr1a,pr1b,pr2a,pr2b);
+  }
+
+  return sols > 0;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Is p strictly in the part cut off (or added) at the corner? -- */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Round::inside(const Round_Corner& rc, const Vec2& p) const
+{
+  // Within the triangle of the tangent points and the corner
+
+  double o1 = Geo_Orient(rc.t1,rc.t2,p);
+  double o2 = Geo_Orient(rc.t2,rc.corner,p);
+  double o3 = Geo_Orient(rc.corner,rc.t1,p);
+
+  if (rc.acw) {
+    if (o1 >= 0.0 || o2 >= 0.0 || o3 >= 0.0) return false;
+  }
+  else if (o1 <= 0.0 || o2 <= 0.0 || o3 <= 0.0) return false;
+
+  // And not on the inside of the fillet
+
+  return chamfer || p.distTo2(rc.fc) > rc.t1.distTo2(rc.fc) + tol;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- No element of the contours of ce (but the two of the corner) - */
+/* ------- crosses the fillet or lies in the part cut off ---------------- */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Round::clear_of(const Cont_Elems& ce, int el, int cei,
+                                            const Round_Corner& rc) const
+{
+  Rect_Ax rct(rc.Rect());
+
+  if (!ce.cnt->Rect().Intersects_XY(rct,tol)) return true;
+
+  int n  = (int)ce.els.size();
+  int el2 = (el+1) % n;
+
+  for (int ch=0; ch<(int)ce.chunks.size(); ++ch) {
+    if (!ce.chunks[ch].Intersects_XY(rct,tol)) continue;
+
+    int last = std::min(n,(ch+1)*Cont_Round_Chunk_Elems);
+
+    for (int i=ch*Cont_Round_Chunk_Elems; i<last; ++i) {
+      if (cei == rc.cont && (i == el || i == el2)) continue;
+
+      const Elem& oel = *ce.els[i];
+
+      if (!oel.Rect().Intersects_XY(rct,tol)) continue;
+
+      if (crosses(rc,oel) || inside(rc,oel.P1())) return false;
+    }
+  }
+
+  return true;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Corners of contour ci, reads all contours -------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Round::find(int ci)
+{
+  const Cont_Elems& ce = conts[ci];
+  std::vector<Round_Corner>& res = found[ci];
+
+  int n = (int)ce.els.size();
+  if (n < 2) return;
+
+  bool closed = ce.cnt->Closed();
+  int jnts = closed ? n : n-1;
+
+  // Candidate joints, joint j is between element j and j+1
+
+  std::vector<bool> cand(n,false);
+
+  for (int j=0; j<jnts; ++j) {
+    const Elem& el1 = *ce.els[j];
+    const Elem& el2 = *ce.els[(j+1) % n];
+
+    if (el1.isCircle() || el2.isCircle()) continue;
+
+    Vec2 tg1, tg2;
+    el1.End_Tangent_XY(tg1);
+    el2.Start_Tangent_XY(tg2);
+
+    double ang = atan2(tg1.cross2(tg2),tg1 * tg2);
+
+    if (sides > 0 && ang <= 0.0) continue;
+    if (sides < 0 && ang >= 0.0) continue;
+
+    ang = fabs(ang);
+
+    cand[j] = ang >= min_ang && ang <= max_ang && ang > Vec2::identDir();
+  }
+
+  // An element between two rounded corners gives each half its length
+
+  for (int j=0; j<jnts; ++j) {
+    if (!cand[j]) continue;
+
+    int nxt = (j+1) % n;
+
+    double len1 = ce.els[j]->Len_XY();
+    double len2 = ce.els[nxt]->Len_XY();
+
+    bool shr1 = (j > 0 || closed) && cand[(j+n-1) % n];
+    bool shr2 = (nxt < jnts) && cand[nxt];
+
+    double allow1 = shr1 ? len1/2.0 : len1 - 10.0*tol;
+    double allow2 = shr2 ? len2/2.0 : len2 - 10.0*tol;
+
+    Round_Corner rc;
+    rc.cont = ci; rc.el = j; rc.dropped = false;
+
+    if (!fits(ce,j,allow1,allow2,rc)) continue;
+
+    // Against the other elements of all nests near the corner
+
+    bool clear = true;
+
+    int ix1,iy1,ix2,iy2;
+    Rect_Ax rct(rc.Rect());
+    cells(rct,ix1,iy1,ix2,iy2);
+
+    for (int iy=iy1; clear && iy<=iy2; ++iy) {
+      for (int ix=ix1; clear && ix<=ix2; ++ix) {
+        int cell = iy*gnx + ix;
+
+        for (int g=grid_first[cell]; clear && g<grid_first[cell+1]; ++g) {
+          int ns = grid_nests[g];
+
+          // Once, in the first cell shared by the nest and the corner
+
+          int nx1,ny1,nx2,ny2;
+          cells(nest_rects[ns],nx1,ny1,nx2,ny2);
+
+          if (std::max(nx1,ix1) != ix || std::max(ny1,iy1) != iy) continue;
+
+          if (!nest_rects[ns].Intersects_XY(rct,tol)) continue;
+
+          for (int k=nest_first[ns]; clear && k<nest_first[ns+1]; ++k)
+                                        clear = clear_of(conts[k],j,k,rc);
+        }
+      }
+    }
+
+    if (clear) res.push_back(rc);
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Of two fillets that cross the later one is dropped ----------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Round::resolve()
+{
+  std::vector<Round_Corner *> all;
+
+  for (size_t ci=0; ci<found.size(); ++ci)
+    for (size_t i=0; i<found[ci].size(); ++i) all.push_back(&found[ci][i]);
+
+  std::sort(all.begin(),all.end(),
+            [](const Round_Corner *a, const Round_Corner *b) {
+              return a->ll.x < b->ll.x;
+            });
+
+  for (size_t i=0; i<all.size(); ++i) {
+    Round_Corner& a = *all[i];
+    if (a.dropped) continue;
+
+    for (size_t k=i+1; k<all.size(); ++k) {
+      Round_Corner& b = *all[k];
+
+      if (b.ll.x > a.ur.x + tol) break;
+      if (b.dropped || !a.Rect().Intersects_XY(b.Rect(),tol)) continue;
+
+      // Neighbours on a contour only share an end point
+
+      if (a.cont == b.cont) {
+        int n = (int)conts[a.cont].els.size();
+        if ((a.el+1) % n == b.el || (b.el+1) % n == a.el) continue;
+      }
+
+      Vec3 p1(b.t1), p2(b.t2);
+      bool cross;
+
+      if (chamfer) {
+        Elem_Line chord(p1,p2);
+        cross = crosses(a,chord);
+      }
+      else {
+        Elem_Arc fil(p1,p2,b.fc,b.acw);
+        cross = crosses(a,fil);
+      }
+
+      if (cross || inside(a,b.t1) || inside(b,a.t1)) b.dropped = true;
+    }
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Trims the elements and inserts the fillets of contour ci ----- */
+/* ---------------------------------------------------------------------- */
+
+int Cont_Round::apply(int ci)
+{
+  Cont_Elems& ce = conts[ci];
+  std::vector<Round_Corner>& res = found[ci];
+
+  int n = (int)ce.els.size();
+  int cnt = 0;
+
+  std::vector<Elem_Cursor> curs;
+  std::vector<bool> trimmed(n,false);
+
+  Elem_Cursor elc(ce.cnt->el_list);
+  for (;elc;++elc) curs.push_back(elc);
+
+  double bpar = ce.cnt->Begin_Par();
+
+  for (size_t i=0; i<res.size(); ++i) {
+    const Round_Corner& rc = res[i];
+    if (rc.dropped) continue;
+
+    Elem& el1 = curs[rc.el]->El();
+    Elem& el2 = curs[(rc.el+1) % n]->El();
+
+    double z = el1.P2().z;
+
+    el1.Stretch_End_XY(rc.t1,false);
+    el2.Stretch_Begin_XY(rc.t2,false);
+
+    trimmed[rc.el] = trimmed[(rc.el+1) % n] = true;
+
+    Elem_Cursor insc(curs[(rc.el+1) % n]);
+    if (rc.el == n-1) insc.To_End();   // Closing corner, keep the start
+
+    if (chamfer) {
+      Elem_Line chord(Vec3(rc.t1,z),Vec3(rc.t2,z));
+      chord.Id(el1.Id());
+      chord.Cnt_Id(el1.Cnt_Id());
+      chord.P_Cnt_Id(el1.P_Cnt_Id());
+      chord.Cam_Inf(el1.Cam_Inf());
+
+      insc.Insert(chord);
+    }
+    else {
+      Elem_Arc fil(Vec3(rc.t1,z),Vec3(rc.t2,z),rc.fc,rc.acw);
+      fil.Id(el1.Id());
+      fil.Cnt_Id(el1.Cnt_Id());
+      fil.P_Cnt_Id(el1.P_Cnt_Id());
+      fil.Cam_Inf(el1.Cam_Inf());
+      fil.setInsArc(true);
+
+      insc.Insert(fil);
+    }
+
+    cnt++;
+  }
+
+  // An element between two fillets may be used up
+
+  for (int i=0; i<n; ++i) {
+    if (trimmed[i] && curs[i]->El().Len_XY() < 2.0*tol) curs[i].Delete();
+  }
+
+  if (cnt > 0) {
+    ce.cnt->inval_rects();
+    ce.cnt->calc_invar();
+    ce.cnt->Begin_Par(bpar);
+  }
+
+  return cnt;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int Cont_Round::Run(int thread_cnt)
+{
+  End_Nest();
+
+  int nests = (int)nest_rects.size();
+
+  found.assign(conts.size(),std::vector<Round_Corner>());
+
+  build_grid();
+
+  parallelFor(nests,thread_cnt,[&](int ns) {
+    for (int ci=nest_first[ns]; ci<nest_first[ns+1]; ++ci) find(ci);
+  });
+
+  resolve();
+
+  int cnt = 0;
+  for (int ci=0; ci<(int)conts.size(); ++ci) cnt += apply(ci);
+
+  return cnt;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+int Contour::Round_Corners(double rad, double min_rad, double min_ang,
+                           double max_ang, int sides, Corner_Type tp)
+{
+  TraceScope trc("Contour::Round_Corners",Elem_Count());
+
+  Cont_Round rnd(rad,min_rad,min_ang,max_ang,sides,tp);
+
+  rnd.Add(*this);
+
+  return rnd.Run(1);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+int Cont_Area::Round_Corners(double rad, double min_rad, double min_ang,
+                             double max_ang, int sides,
+                             Contour::Corner_Type tp, int thread_cnt)
+{
+  TraceScope trc("Cont_Area::Round_Corners",Elem_Count());
+
+  Cont_Round rnd(rad,min_rad,min_ang,max_ang,sides,tp);
+
+  Cont_Nest_D_List::Cursor nsc(nestlst);
+
+  for (;nsc;++nsc) {
+    Cont_Clsd_Cursor cc(nsc->contlst);
+
+    for (;cc;++cc) rnd.Add(cc->cont);
+
+    rnd.End_Nest();
+  }
+
+  double bpar = Begin_Par();
+
+  int cnt = rnd.Run(thread_cnt);
+
+  if (cnt > 0) {
+    for (nsc.To_Begin();nsc;++nsc) {
+      nsc->calc_invar();
+      nsc->inert.invalidate();
+    }
+
+    calc_invar();
+    inert.invalidate();
+
+    Begin_Par(bpar);
+  }
+
+  return cnt;
+}
+
+} // namespace Ino
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
@@ -0,0 +1,283 @@
+/* ---------------------------------------------------------------------- */
+/* ---------------- Recoverable Contour Operations ---------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ------------- Copyright Inofor Hoek Aut BV 2026, C. Wolters ---------- */
+/* ---------------------------------------------------------------------- */
+
+#include "Cont_Safe.h"
+#include "Trf.h"
+#include "Trace.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <new>
+
+#include "Exceptions.h"
+
+namespace Ino
+{
+
+/* ---------------------------------------------------------------------- */
+/* ------- Keeps the Cont_On_Error handler quiet on this thread --------- */
+/* ---------------------------------------------------------------------- */
+
+static void quiet_panic(int /*error_no*/)
+{
+}
+
+class Quiet_Panic
+{
+   Cont_Error_Handler prev;
+
+   Quiet_Panic(const Quiet_Panic& cp);             // No Copying
+   Quiet_Panic& operator=(const Quiet_Panic& src); // No Assignment
+
+  public:
+   Quiet_Panic() : prev(Cont_On_Thread_Error(quiet_panic)) {}
+   ~Quiet_Panic() { Cont_On_Thread_Error(prev); }
+};
+
+/* ---------------------------------------------------------------------- */
+/* ------- Records an attempt in err ------------------------------------ */
+/* ---------------------------------------------------------------------- */
+
+static void note(Cont_Error *err, Cont_Status st, int attempt,
+                 double ident_dist, double nudge, const char *what)
+{
+  if (!err) return;
+
+  err->status     = st;
+  err->panic_no   = st == Cont_Failed ? Cont_Last_Panic() : 0;
+  err->attempts   = attempt + 1;
+  err->ident_dist = ident_dist;
+  err->nudge      = nudge;
+
+  if (what) {
+    strncpy(err->what,what,sizeof(err->what)-1);
+    err->what[sizeof(err->what)-1] = '\0';
+  }
+  else err->what[0] = '\0';
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Runs op(k, step) for k = 0..retries until it does not throw -- */
+/* ------- step is nudge * identDist of attempt k, 0 for the first one. - */
+/* ------- op builds its result in locals and moves it to the outputs --- */
+/* ------- as its last, non throwing, action. --------------------------- */
+/* ---------------------------------------------------------------------- */
+
+template <class Op>
+static Cont_Status attempt(const char *name, Op& op,
+                           Cont_Error *err, const Cont_Retry& retry)
+{
+  TraceScope trc(name);
+
+  if (err) {
+    *err = Cont_Error();
+    err->op = name;
+  }
+
+  Quiet_Panic quiet;
+
+  const double dist = Vec2::identDist(), dir = Vec2::identDir();
+  double fact = 1.0;
+
+  for (int k=0; k <= retry.retries; ++k) {
+    TolContext ctx(dist * fact, dir * fact);
+    TolScope scope(ctx);
+
+    double step = k > 0 ? retry.nudge * ctx.identDist : 0.0;
+
+    Cont_Reset_Panic();
+
+    try {
+      Cont_Status st = op(k,step) ? Cont_Ok : Cont_No_Result;
+      note(err,st,k,ctx.identDist,step,NULL);
+
+      return st;
+    }
+    catch (const OutOfMemoryException& ex) {
+      note(err,Cont_Failed,k,ctx.identDist,step,ex.what());
+      return Cont_Failed;
+    }
+    catch (const std::bad_alloc& ex) {
+      note(err,Cont_Failed,k,ctx.identDist,step,ex.what());
+      return Cont_Failed;
+    }
+    catch (const std::exception& ex) {
+      note(err,Cont_Failed,k,ctx.identDist,step,ex.what());
+    }
+
+    fact *= retry.tol_factor;
+  }
+
+  return Cont_Failed;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Retry k moves by k steps, alternating sign ------------------- */
+/* ---------------------------------------------------------------------- */
+
+static double nudge_dist(int k, double step)
+{
+  return (k & 1) ? (k+1)/2 * step : -(k/2) * step;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Retry k moves k steps in a direction turning 120 deg each ---- */
+/* ---------------------------------------------------------------------- */
+
+static Vec2 nudge_vec(int k, double step)
+{
+  double ang = k * Vec2::Pi2 / 3.0;
+
+  return Vec2(cos(ang),sin(ang)) * (k * step);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Status Cont_Try_Offset(const Contour& cnt, double offdist,
+                            Cont_List& into, Cont_Error *err,
+                            const Cont_Retry& retry)
+{
+  auto op = [&](int k, double step) {
+    Cont_List lst;
+    bool ok = cnt.Offset_Into(offdist + nudge_dist(k,step),lst);
+    lst.Move_To(into);
+
+    return ok;
+  };
+
+  return attempt("Cont_Try_Offset",op,err,retry);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Status Cont_Try_Offset(const Cont_Area& ar, double offdist,
+                            Cont_Area& into, Cont_Error *err,
+                            const Cont_Retry& retry)
+{
+  auto op = [&](int k, double step) {
+    Cont_Area res;
+    bool ok = ar.Offset_Into(offdist + nudge_dist(k,step),res);
+    res.Move_To(into);
+
+    return ok;
+  };
+
+  return attempt("Cont_Try_Offset",op,err,retry);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- A retry moves a copy of the second area. The result is ------- */
+/* ------- built aside, so into may here be ar1 or ar2 ------------------ */
+/* ---------------------------------------------------------------------- */
+
+Cont_Status Cont_Try_Combine(const Cont_Area& ar1, bool rev1,
+                             const Cont_Area& ar2, bool rev2,
+                             bool to_left, Cont_Area& into,
+                             Cont_List *rest1, Cont_List *rest2,
+                             Cont_Error *err, const Cont_Retry& retry)
+{
+  auto op = [&](int k, double step) {
+    Cont_Area res;
+    Cont_List r1, r2;
+    bool ok;
+
+    if (k > 0) {
+      Vec2 mv = nudge_vec(k,step);
+
+      Cont_Area moved(ar2);
+      moved.Transform(Trf2(1.0,0.0,mv.x, 0.0,1.0,mv.y));
+
+      ok = ar1.Combine_With(rev1,moved,rev2,to_left,res,
+                            rest1 ? &r1 : NULL, rest2 ? &r2 : NULL);
+    }
+    else ok = ar1.Combine_With(rev1,ar2,rev2,to_left,res,
+                               rest1 ? &r1 : NULL, rest2 ? &r2 : NULL);
+
+    res.Move_To(into);
+    if (rest1) r1.Move_To(*rest1);
+    if (rest2) r2.Move_To(*rest2);
+
+    return ok;
+  };
+
+  return attempt("Cont_Try_Combine",op,err,retry);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Status Cont_Try_Extract_Via(const Cont_Area& ar,
+                                 const Vec2& p1, const Vec2& probedir1,
+                                 const Vec2& p2, const Vec2& probedir2,
+                                 Contour& path, double& pathlen,
+                                 Cont_Error *err, const Cont_Retry& retry)
+{
+  auto op = [&](int k, double step) {
+    Contour res;
+    double len = 0.0;
+
+    Vec2 mv = nudge_vec(k,step);
+
+    bool ok = ar.Extract_Via(p1 + mv,probedir1,p2 + mv,probedir2,res,len);
+    res.Move_To(path);
+    pathlen = len;
+
+    return ok;
+  };
+
+  return attempt("Cont_Try_Extract_Via",op,err,retry);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Status Cont_Try_Intersect_XY(const Contour& cnt1, const Contour& cnt2,
+                                  Cont_PPair_List& isct_lst, bool cleanup,
+                                  Cont_Error *err, const Cont_Retry& retry)
+{
+  auto op = [&](int, double) {
+    Cont_PPair_List lst;
+    cnt1.Intersect_With_XY(cnt2,lst,cleanup);
+    lst.Move_To(isct_lst);
+
+    return true;
+  };
+
+  return attempt("Cont_Try_Intersect_XY",op,err,retry);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Status Cont_Try_Make_Non_Intersecting(Contour& cnt, bool left,
+                                           Cont_Error *err,
+                                           const Cont_Retry& retry)
+{
+  auto op = [&](int, double) {
+    Contour res(cnt);
+    res.MakeNonIntersecting(left);
+    res.Move_To(cnt);
+
+    return true;
+  };
+
+  return attempt("Cont_Try_Make_Non_Intersecting",op,err,retry);
+}
+
+} // namespace Ino
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
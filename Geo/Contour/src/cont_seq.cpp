@@ -0,0 +1,993 @@
+/* ---------------------------------------------------------------------- */
+/* ---------------- Toolpath Sequencing of Contours --------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ------------- Copyright Inofor Hoek Aut BV 2026, C. Wolters ---------- */
+/* ---------------------------------------------------------------------- */
+
+#include "Cont_Seq.h"
+#include "El_Arc.h"
+#include "El_Cir.h"
+#include "Trace.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace Ino
+{
+
+/* ---------------------------------------------------------------------- */
+/* ------- Crossing of the ray from p in +x direction, half open in y --- */
+/* ---------------------------------------------------------------------- */
+
+static bool line_crosses(const Vec2& s, const Vec2& e, const Vec2& p)
+{
+  if ((s.y > p.y) == (e.y > p.y)) return false;
+
+  return s.x + (p.y - s.y) * (e.x - s.x) / (e.y - s.y) > p.x;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Odd crossings of that ray with an arc of signed span. The ---- */
+/* ------- arc is split at the top and bottom of its circle, so every --- */
+/* ------- piece is monotone in y and lies left or right of the centre -- */
+/* ---------------------------------------------------------------------- */
+
+static bool arc_crosses(const Vec2& s, const Vec2& e, const Vec2& c,
+                                         double span, const Vec2& p)
+{
+  double r   = c.distTo2(s);
+  double a0  = atan2(s.y - c.y, s.x - c.x);
+  double dir = span < 0.0 ? -1.0 : 1.0;
+  double len = fabs(span);
+
+  double ts[4]; int tcnt = 0;
+
+  for (int k=-4;k<=4 && tcnt<4;++k) {
+    double t = dir * (Vec2::Pi/2.0 + k*Vec2::Pi - a0);
+    if (t > 0.0 && t < len) ts[tcnt++] = t;
+  }
+
+  std::sort(ts,ts+tcnt);
+
+  bool odd = false;
+
+  Vec2 ps(s);
+  double ta = 0.0;
+
+  for (int i=0;i<=tcnt;++i) {
+    double tb = i < tcnt ? ts[i] : len;
+
+    Vec2 pe(e);
+    if (i < tcnt) pe = Vec2(c.x + r*cos(a0 + dir*tb),
+                            c.y + r*sin(a0 + dir*tb));
+
+    if ((ps.y > p.y) != (pe.y > p.y)) {
+      double dy = p.y - c.y;
+      double dx = r*r - dy*dy;
+      dx = dx > 0.0 ? sqrt(dx) : 0.0;
+
+      double x = cos(a0 + dir*(ta+tb)/2.0) < 0.0 ? c.x - dx : c.x + dx;
+      if (x > p.x) odd = !odd;
+    }
+
+    ps = pe;
+    ta = tb;
+  }
+
+  return odd;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Uniform grid of point or rectangle indices ------------------- */
+/* ---------------------------------------------------------------------- */
+
+struct Seq_Grid
+{
+  double x0, y0, cell;
+  int nx, ny;
+
+  std::vector<std::vector<int> > cells;
+
+  Seq_Grid() : x0(0.0), y0(0.0), cell(1.0), nx(1), ny(1), cells() {}
+
+  void Init(const Rect_Ax& rct, int cnt);
+
+  int Ix(double x) const;
+  int Iy(double y) const;
+
+  std::vector<int>& At(int ix, int iy) { return cells[iy*nx + ix]; }
+
+  void Add(const Vec2& p, int idx) { At(Ix(p.x),Iy(p.y)).push_back(idx); }
+  void Add(const Rect_Ax& rct, int idx);
+};
+
+/* ---------------------------------------------------------------------- */
+
+void Seq_Grid::Init(const Rect_Ax& rct, int cnt)
+{
+  x0 = rct.Ll().x; y0 = rct.Ll().y;
+
+  double w = rct.Ur().x - x0, h = rct.Ur().y - y0;
+
+  cell = sqrt(w*h/(cnt < 1 ? 1 : cnt));
+  cell = std::max(cell,std::max(w,h)/1024.0);
+  cell = std::max(cell,Vec2::identDist());
+
+  nx = int(w/cell) + 1;
+  ny = int(h/cell) + 1;
+
+  cells.assign(size_t(nx)*ny,std::vector<int>());
+}
+
+/* ---------------------------------------------------------------------- */
+
+int Seq_Grid::Ix(double x) const
+{
+  int ix = int(floor((x - x0)/cell));
+  return ix < 0 ? 0 : (ix >= nx ? nx-1 : ix);
+}
+
+/* ---------------------------------------------------------------------- */
+
+int Seq_Grid::Iy(double y) const
+{
+  int iy = int(floor((y - y0)/cell));
+  return iy < 0 ? 0 : (iy >= ny ? ny-1 : iy);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Seq_Grid::Add(const Rect_Ax& rct, int idx)
+{
+  int ix1 = Ix(rct.Ll().x), ix2 = Ix(rct.Ur().x);
+  int iy1 = Iy(rct.Ll().y), iy2 = Iy(rct.Ur().y);
+
+  for (int iy=iy1;iy<=iy2;++iy) {
+    for (int ix=ix1;ix<=ix2;++ix) At(ix,iy).push_back(idx);
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- The tour: contours, their entry points and the order. -------- */
+/* ------- An open contour has its begin and end point, the second ------ */
+/* ------- picked means reversed. A closed contour has the begin of ----- */
+/* ------- each element, entry and exit are the same point. ------------- */
+/* ---------------------------------------------------------------------- */
+
+const int Cont_Seq_Near_Cnt = 8;
+
+class Cont_Sequencer::Tour
+{
+  struct Item
+  {
+    Cont_Cursor cntc;
+    bool closed;
+    int first, pts;      // Points in pnts
+    int cands;           // The first cands points are entry candidates
+    int pick;            // Entry point, index into pnts
+    int parent;          // Smallest closed contour around it, -1: none
+    int kids_left;
+    bool done;
+  };
+
+  const Cont_Seq_Opts& opts;
+  double eps;
+
+  std::vector<Item> items;
+  std::vector<Vec2> pnts;
+  std::vector<int> pnt_item;
+
+  std::vector<int> kid_first, kids;    // Contained items, per item
+
+  std::vector<int> order, pos;
+  std::vector<std::vector<int> > near; // Nearest other items
+
+  Seq_Grid grid;
+
+  static bool inside(const Contour& cnt, const Vec2& p);
+
+  const Vec2& ent(int it) const { return pnts[items[it].pick]; }
+  const Vec2& ext(int it) const;
+
+  bool reversible(int it) const
+                        { return items[it].closed || opts.reverse_open; }
+  void flip(int it);
+
+  const Vec2& from(int p) const
+                        { return p > 0 ? ext(order[p-1]) : opts.home; }
+  double leg(const Vec2& a, int p) const;
+
+  void set_pos(int p1, int p2);
+
+  void nest();
+  void activate(int it);
+  int  nearest(const Vec2& p);
+  void build();
+  void build_near();
+
+  bool two_opt(double& gain);
+  bool or_opt(int seglen, double& gain);
+  bool repick(double& gain);
+
+  Tour(const Tour& cp);             // No copying
+  Tour& operator=(const Tour& src); // No assignment
+
+ public:
+  Tour(const Cont_Seq_Opts& options);
+
+  std::chrono::steady_clock::time_point deadline;
+  int moves;
+
+  void Add(const Cont_Cursor& cntc);
+
+  double Travel() const;
+
+  double Given();
+  void Find();
+  bool Improve();
+
+  void Apply(Cont_List& lst);
+};
+
+/* ---------------------------------------------------------------------- */
+
+Cont_Sequencer::Tour::Tour(const Cont_Seq_Opts& options)
+ : opts(options), eps(Vec2::identDist()/100.0),
+   items(), pnts(), pnt_item(), kid_first(), kids(),
+   order(), pos(), near(), grid(),
+   deadline(), moves(0)
+{
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Cont_Sequencer::Tour::Add(const Cont_Cursor& cntc)
+{
+  const Contour& cnt = *cntc;
+  if (cnt.Empty()) return;
+
+  Item it;
+  it.cntc      = cntc;
+  it.closed    = cnt.Closed();
+  it.first     = int(pnts.size());
+  it.pick      = it.first;
+  it.parent    = -1;
+  it.kids_left = 0;
+  it.done      = false;
+
+  Elem_C_Cursor elc(cnt.el_list);
+
+  if (it.closed) {
+    for (;elc;++elc) pnts.push_back(elc->El().P1());
+
+    it.pts   = int(pnts.size()) - it.first;
+    it.cands = opts.pick_starts ? it.pts : 1;
+  }
+  else {
+    pnts.push_back(elc->El().P1());
+    elc.To_Last();
+    pnts.push_back(elc->El().P2());
+
+    it.pts   = 2;
+    it.cands = opts.reverse_open ? 2 : 1;
+  }
+
+  pnt_item.resize(pnts.size(),int(items.size()));
+  items.push_back(it);
+}
+
+/* ---------------------------------------------------------------------- */
+
+const Vec2& Cont_Sequencer::Tour::ext(int it) const
+{
+  const Item& item = items[it];
+  if (item.closed) return pnts[item.pick];
+
+  return pnts[item.pick == item.first ? item.first+1 : item.first];
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Cont_Sequencer::Tour::flip(int it)
+{
+  Item& item = items[it];
+  if (!item.closed) item.pick = item.pick == item.first ? item.first+1
+                                                        : item.first;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Travel from a into position p, p == order.size() is home ----- */
+/* ---------------------------------------------------------------------- */
+
+double Cont_Sequencer::Tour::leg(const Vec2& a, int p) const
+{
+  if (p < int(order.size())) return a.distTo2(ent(order[p]));
+
+  return opts.back_home ? a.distTo2(opts.home) : 0.0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+double Cont_Sequencer::Tour::Travel() const
+{
+  double sum = 0.0;
+
+  for (int p=0;p<=int(order.size());++p) sum += leg(from(p),p);
+
+  return sum;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Cont_Sequencer::Tour::set_pos(int p1, int p2)
+{
+  for (int p=p1;p<=p2;++p) pos[order[p]] = p;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Even-odd inside test of the closed contour cnt --------------- */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Sequencer::Tour::inside(const Contour& cnt, const Vec2& p)
+{
+  if (!cnt.Rect().Point_Inside_XY(p,0.0)) return false;
+
+  bool odd = false;
+
+  Elem_C_Cursor elc(cnt.el_list);
+
+  for (;elc;++elc) {
+    const Elem& el = elc->El();
+
+    if (el.isArc()) {
+      const Elem_Arc& arc = (const Elem_Arc&)el;
+      if (arc_crosses(arc.P1(),arc.P2(),arc.C(),arc.Span_Angle(),p))
+                                                                 odd = !odd;
+    }
+    else if (el.isCircle()) {
+      const Elem_Circle& cir = (const Elem_Circle&)el;
+      if (arc_crosses(cir.P1(),cir.P1(),cir.C(),cir.Span_Angle(),p))
+                                                                 odd = !odd;
+    }
+    else if (line_crosses(el.P1(),el.P2(),p)) odd = !odd;
+  }
+
+  return odd;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Finds for every item the smallest closed contour around it. -- */
+/* ------- The closed contours are put in a grid by rectangle, an item -- */
+/* ------- is tested with the middle of its first element. -------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Sequencer::Tour::nest()
+{
+  int cnt = int(items.size());
+
+  std::vector<double> areas(cnt,0.0);
+  std::vector<int> clsd;
+
+  Rect_Ax all;
+
+  for (int i=0;i<cnt;++i) {
+    const Contour& cont = *items[i].cntc;
+
+    if (i == 0) all = cont.Rect();
+    else all += cont.Rect();
+
+    if (!items[i].closed) continue;
+
+    areas[i] = fabs(cont.Area_XY());
+    clsd.push_back(i);
+  }
+
+  kid_first.assign(cnt+1,0);
+  if (clsd.empty()) return;
+
+  Seq_Grid cgrid;
+  cgrid.Init(all,int(clsd.size()));
+
+  for (size_t c=0;c<clsd.size();++c)
+                     cgrid.Add(items[clsd[c]].cntc->Rect(),clsd[c]);
+
+  double tol = Vec2::identDist();
+
+  std::vector<int> cands;
+
+  for (int i=0;i<cnt;++i) {
+    const Contour& cont = *items[i].cntc;
+    const Rect_Ax& rct = cont.Rect();
+
+    Vec2 tp;
+    cont.el_list.Begin()->El().Mid_Par_XY(tp);
+
+    const std::vector<int>& cell = cgrid.At(cgrid.Ix(tp.x),cgrid.Iy(tp.y));
+
+    cands.clear();
+
+    for (size_t c=0;c<cell.size();++c) {
+      int j = cell[c];
+      if (j == i || areas[j] <= areas[i]) continue;
+
+      const Rect_Ax& outer = items[j].cntc->Rect();
+
+      if (rct.Ll().x < outer.Ll().x - tol || rct.Ll().y < outer.Ll().y - tol ||
+          rct.Ur().x > outer.Ur().x + tol || rct.Ur().y > outer.Ur().y + tol)
+                                                                   continue;
+      cands.push_back(j);
+    }
+
+    std::sort(cands.begin(),cands.end(),
+              [&areas](int a, int b) { return areas[a] < areas[b]; });
+
+    for (size_t c=0;c<cands.size();++c) {
+      if (inside(*items[cands[c]].cntc,tp)) {
+        items[i].parent = cands[c];
+        break;
+      }
+    }
+  }
+
+  for (int i=0;i<cnt;++i) {
+    if (items[i].parent >= 0) ++kid_first[items[i].parent+1];
+  }
+
+  for (int i=0;i<cnt;++i) {
+    items[i].kids_left = kid_first[i+1];
+    kid_first[i+1] += kid_first[i];
+  }
+
+  kids.resize(kid_first[cnt]);
+
+  std::vector<int> fill(kid_first.begin(),kid_first.end()-1);
+
+  for (int i=0;i<cnt;++i) {
+    if (items[i].parent >= 0) kids[fill[items[i].parent]++] = i;
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Cont_Sequencer::Tour::activate(int it)
+{
+  const Item& item = items[it];
+
+  for (int p=item.first;p<item.first+item.cands;++p) grid.Add(pnts[p],p);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Nearest entry point of an active item, in rings of cells ----- */
+/* ------- around p. Points of done items are dropped on the way. ------- */
+/* ---------------------------------------------------------------------- */
+
+int Cont_Sequencer::Tour::nearest(const Vec2& p)
+{
+  int cx = grid.Ix(p.x), cy = grid.Iy(p.y);
+
+  int best = -1;
+  double bestd = 0.0;
+
+  int maxr = std::max(grid.nx,grid.ny);
+
+  for (int r=0;r<=maxr;++r) {
+    // Points in ring r are at least (r-1) cells away
+
+    if (best >= 0 && bestd <= (r-1)*grid.cell) break;
+
+    for (int iy=cy-r;iy<=cy+r;++iy) {
+      if (iy < 0 || iy >= grid.ny) continue;
+
+      int step = (iy == cy-r || iy == cy+r) ? 1 : 2*r;
+      if (step < 1) step = 1;
+
+      for (int ix=cx-r;ix<=cx+r;ix+=step) {
+        if (ix < 0 || ix >= grid.nx) continue;
+
+        std::vector<int>& cell = grid.At(ix,iy);
+
+        for (size_t k=0;k<cell.size();) {
+          int pi = cell[k];
+
+          if (items[pnt_item[pi]].done) {
+            cell[k] = cell.back();
+            cell.pop_back();
+            continue;
+          }
+
+          double d = p.distTo2(pnts[pi]);
+          if (best < 0 || d < bestd) {
+            best  = pi;
+            bestd = d;
+          }
+
+          ++k;
+        }
+      }
+    }
+  }
+
+  return best;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Nearest neighbour tour, an item is available once all items -- */
+/* ------- inside it are done -------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Sequencer::Tour::build()
+{
+  int cnt = int(items.size());
+
+  Rect_Ax all(Vec3(opts.home,0.0),Vec3(opts.home,0.0));
+  for (int i=0;i<cnt;++i) all += items[i].cntc->Rect();
+
+  grid.Init(all,int(pnts.size()));
+
+  for (int i=0;i<cnt;++i) {
+    items[i].pick = items[i].first;
+    items[i].done = false;
+
+    if (items[i].kids_left == 0) activate(i);
+  }
+
+  order.clear();
+
+  Vec2 cur(opts.home);
+
+  for (int step=0;step<cnt;++step) {
+    int pi = nearest(cur), it = -1;
+
+    if (pi >= 0) {
+      it = pnt_item[pi];
+      items[it].pick = pi;
+    }
+    else {
+      for (it=0;items[it].done;++it);  // Cannot happen, nesting is acyclic
+    }
+
+    items[it].done = true;
+    order.push_back(it);
+
+    cur = ext(it);
+
+    int par = items[it].parent;
+    if (par >= 0 && --items[par].kids_left == 0) activate(par);
+  }
+
+  pos.assign(cnt,0);
+  set_pos(0,cnt-1);
+
+  grid.cells.clear();
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- The items with an entry or exit point nearest to those of ---- */
+/* ------- each item, for the candidate moves ---------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Sequencer::Tour::build_near()
+{
+  int cnt = int(items.size());
+
+  Rect_Ax all;
+  for (int i=0;i<cnt;++i) {
+    if (i == 0) all = items[i].cntc->Rect();
+    else all += items[i].cntc->Rect();
+  }
+
+  std::vector<Vec2> ends;
+  std::vector<int> end_item;
+
+  for (int i=0;i<cnt;++i) {
+    ends.push_back(ent(i)); end_item.push_back(i);
+
+    if (!items[i].closed) {
+      ends.push_back(ext(i)); end_item.push_back(i);
+    }
+  }
+
+  Seq_Grid egrid;
+  egrid.Init(all,int(ends.size()));
+
+  for (size_t e=0;e<ends.size();++e) egrid.Add(ends[e],int(e));
+
+  near.assign(cnt,std::vector<int>());
+
+  int k = std::min(Cont_Seq_Near_Cnt,cnt-1);
+  int maxr = std::max(egrid.nx,egrid.ny);
+
+  std::vector<std::pair<double,int> > found;
+
+  for (int i=0;i<cnt;++i) {
+    found.clear();
+
+    for (int side=0;side<(items[i].closed ? 1 : 2);++side) {
+      const Vec2& p = side ? ext(i) : ent(i);
+      int cx = egrid.Ix(p.x), cy = egrid.Iy(p.y);
+
+      int seen = 0;
+
+      for (int r=0;r<=maxr;++r) {
+        if (seen >= 2*k+2 && r > 1) break;
+
+        for (int iy=cy-r;iy<=cy+r;++iy) {
+          if (iy < 0 || iy >= egrid.ny) continue;
+
+          int step = (iy == cy-r || iy == cy+r) ? 1 : 2*r;
+          if (step < 1) step = 1;
+
+          for (int ix=cx-r;ix<=cx+r;ix+=step) {
+            if (ix < 0 || ix >= egrid.nx) continue;
+
+            const std::vector<int>& cell = egrid.At(ix,iy);
+
+            for (size_t c=0;c<cell.size();++c) {
+              int j = end_item[cell[c]];
+              if (j == i) continue;
+
+              found.push_back(std::make_pair(p.distTo2(ends[cell[c]]),j));
+              ++seen;
+            }
+          }
+        }
+      }
+    }
+
+    std::sort(found.begin(),found.end());
+
+    std::vector<int>& nb = near[i];
+
+    for (size_t f=0;f<found.size() && int(nb.size())<k;++f) {
+      if (std::find(nb.begin(),nb.end(),found[f].second) == nb.end())
+                                             nb.push_back(found[f].second);
+    }
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- 2-opt: reverse positions i..j, the new first being a near ---- */
+/* ------- item of the one before i. Reversing flips open items, so the - */
+/* ------- travel inside the range does not change. ---------------------- */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Sequencer::Tour::two_opt(double& gain)
+{
+  int cnt = int(order.size());
+  bool any = false;
+
+  for (int i=1;i<cnt;++i) {
+    if (std::chrono::steady_clock::now() > deadline) return any;
+
+    const std::vector<int>& nb = near[order[i-1]];
+
+    for (size_t c=0;c<nb.size();++c) {
+      int j = pos[nb[c]];
+      if (j <= i) continue;
+
+      const Vec2& a = from(i);
+
+      double delta = a.distTo2(ext(order[j])) + leg(ent(order[i]),j+1)
+                   - leg(a,i) - leg(ext(order[j]),j+1);
+
+      if (delta >= -eps) continue;
+
+      bool ok = true;
+
+      for (int p=i;p<=j && ok;++p) {
+        int it = order[p], par = items[it].parent;
+        ok = reversible(it) && (par < 0 || pos[par] < i || pos[par] > j);
+      }
+
+      if (!ok) continue;
+
+      std::reverse(order.begin()+i,order.begin()+j+1);
+      for (int p=i;p<=j;++p) flip(order[p]);
+      set_pos(i,j);
+
+      gain -= delta;
+      ++moves;
+      any = true;
+    }
+  }
+
+  return any;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Or-opt: move seglen items, maybe reversed, next to a near ---- */
+/* ------- item of its first or last one --------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Sequencer::Tour::or_opt(int seglen, double& gain)
+{
+  int cnt = int(order.size());
+  bool any = false;
+
+  for (int i=0;i+seglen<=cnt;++i) {
+    if (std::chrono::steady_clock::now() > deadline) return any;
+
+    int l = i + seglen - 1;
+
+    bool can_rev = true;
+    for (int p=i;p<=l && can_rev;++p) {
+      int it = order[p], par = items[it].parent;
+      can_rev = reversible(it) && (par < 0 || pos[par] < i || pos[par] > l);
+    }
+
+    double cut = leg(from(i),i) + leg(ext(order[l]),l+1)
+               - leg(from(i),l+1);
+
+    int best_q = -1;
+    bool best_rev = false;
+    double best_delta = -eps;
+
+    for (int side=0;side<2;++side) {
+      const std::vector<int>& nb = near[order[side ? l : i]];
+
+      for (size_t c=0;c<nb.size();++c) {
+        for (int after=0;after<2;++after) {
+          int q = pos[nb[c]] + after;   // Insert before position q
+          if (q >= i && q <= l+1) continue;
+
+          const Vec2& a = from(q);
+
+          for (int rev=0;rev<2;++rev) {
+            if (rev && !can_rev) continue;
+
+            const Vec2& se = rev ? ext(order[l]) : ent(order[i]);
+            const Vec2& sx = rev ? ent(order[i]) : ext(order[l]);
+
+            double delta = a.distTo2(se) + leg(sx,q) - leg(a,q) - cut;
+
+            if (delta < best_delta) {
+              best_q     = q;
+              best_rev   = rev != 0;
+              best_delta = delta;
+            }
+          }
+        }
+      }
+    }
+
+    if (best_q < 0) continue;
+
+    int q = best_q;
+    bool ok = true;
+
+    for (int p=i;p<=l && ok;++p) {
+      int it = order[p];
+
+      if (q > l) {    // Items in l+1..q-1 come before it
+        int par = items[it].parent;
+        ok = par < 0 || pos[par] < l+1 || pos[par] > q-1;
+      }
+      else {          // Items in q..i-1 come after it
+        for (int k=kid_first[it];k<kid_first[it+1] && ok;++k)
+                           ok = pos[kids[k]] < q || pos[kids[k]] > i-1;
+      }
+    }
+
+    if (!ok) continue;
+
+    int p1, p2;
+
+    if (q > l) {
+      std::rotate(order.begin()+i,order.begin()+l+1,order.begin()+q);
+      p1 = i; p2 = q-1;
+
+      if (best_rev) {
+        std::reverse(order.begin()+q-seglen,order.begin()+q);
+        for (int p=q-seglen;p<q;++p) flip(order[p]);
+      }
+    }
+    else {
+      std::rotate(order.begin()+q,order.begin()+i,order.begin()+l+1);
+      p1 = q; p2 = l;
+
+      if (best_rev) {
+        std::reverse(order.begin()+q,order.begin()+q+seglen);
+        for (int p=q;p<q+seglen;++p) flip(order[p]);
+      }
+    }
+
+    set_pos(p1,p2);
+
+    gain -= best_delta;
+    ++moves;
+    any = true;
+  }
+
+  return any;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Best start of each closed and direction of each open item ---- */
+/* ------- for its neighbours in the order -------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Sequencer::Tour::repick(double& gain)
+{
+  int cnt = int(order.size());
+  bool any = false;
+
+  for (int p=0;p<cnt;++p) {
+    Item& item = items[order[p]];
+    if (item.cands < 2) continue;
+
+    const Vec2& a = from(p);
+
+    double cur = leg(a,p) + leg(ext(order[p]),p+1);
+
+    int old = item.pick, best = old;
+    double bestc = cur - eps;
+
+    for (int c=item.first;c<item.first+item.cands;++c) {
+      item.pick = c;
+
+      double cost = leg(a,p) + leg(ext(order[p]),p+1);
+      if (cost < bestc) {
+        best  = c;
+        bestc = cost;
+      }
+    }
+
+    item.pick = best;
+
+    if (best != old) {
+      gain += cur - bestc;
+      ++moves;
+      any = true;
+    }
+  }
+
+  return any;
+}
+
+/* ---------------------------------------------------------------------- */
+
+double Cont_Sequencer::Tour::Given()
+{
+  int cnt = int(items.size());
+
+  order.resize(cnt);
+  for (int i=0;i<cnt;++i) {
+    order[i] = i;
+    items[i].pick = items[i].first;
+  }
+
+  return Travel();
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Cont_Sequencer::Tour::Find()
+{
+  if (opts.inner_first) nest();
+  else kid_first.assign(items.size()+1,0);
+
+  build();
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Improves until no move helps, false if stopped by the time --- */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Sequencer::Tour::Improve()
+{
+  if (order.size() < 2) return true;
+
+  build_near();
+
+  double gain = 0.0;
+
+  for (;;) {
+    bool any = two_opt(gain);
+
+    for (int seglen=1;seglen<=3;++seglen) {
+      if (or_opt(seglen,gain)) any = true;
+    }
+
+    if (repick(gain)) any = true;
+
+    if (std::chrono::steady_clock::now() > deadline) return false;
+    if (!any) return true;
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Restarts and reverses the contours, then moves them to the --- */
+/* ------- end of the list in tour order ---------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Sequencer::Tour::Apply(Cont_List& lst)
+{
+  for (size_t i=0;i<items.size();++i) {
+    Item& item = items[i];
+    if (item.pick == item.first) continue;
+
+    Contour& cnt = *item.cntc;
+
+    if (!item.closed) {
+      cnt.Reverse();
+      continue;
+    }
+
+    double stpar = cnt.Begin_Par();
+    cnt.inval_rects();
+
+    Elem_Cursor elc(cnt.el_list);
+    for (int k=item.first;k<item.pick;++k) ++elc;
+
+    elc.Become_First();
+
+    cnt.Begin_Par(stpar);
+  }
+
+  Cont_Cursor endc(lst.contlst);
+
+  for (size_t p=0;p<order.size();++p) {
+    endc.To_End();
+    endc.Re_Insert(items[order[p]].cntc);
+  }
+
+  lst.calc_invar();
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+double Cont_Sequencer::Sequence(Cont_List& lst, Cont_Seq_Stats *stats) const
+{
+  TraceScope trace("Cont_Sequencer::Sequence",long(lst.contlst.Length()));
+
+  Tour tour(opts);
+
+  Cont_Cursor cntc(lst.contlst);
+  for (;cntc;++cntc) tour.Add(cntc);
+
+  double before = tour.Given();
+
+  tour.Find();
+
+  tour.deadline = std::chrono::steady_clock::now() +
+         std::chrono::microseconds((long long)(opts.budget_ms*1000.0));
+
+  bool done = tour.Improve();
+
+  double after = tour.Travel();
+
+  tour.Apply(lst);
+
+  if (stats) {
+    stats->travel_before = before;
+    stats->travel_after  = after;
+    stats->moves         = tour.moves;
+    stats->budget_used   = !done;
+  }
+
+  return after;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+double Cont_Sequencer::Sequence(const Cont_Area& ar, Cont_List& into,
+                                              Cont_Seq_Stats *stats) const
+{
+  into = ar;
+
+  return Sequence(into,stats);
+}
+
+} // namespace Ino
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
@@ -0,0 +1,411 @@
+/* ---------------------------------------------------------------------- */
+/* ---------------- Batched Path Queries on an Area --------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ------------- Copyright Inofor Hoek Aut BV 2026, C. Wolters ---------- */
+/* ---------------------------------------------------------------------- */
+
+#include "Cont_Via.h"
+#include "cntpanic.hi"
+#include "sub_rect.hi"
+#include "TaskPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace Ino
+{
+
+/* ---------------------------------------------------------------------- */
+/* ------- Element table of one contour --------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+struct Cont_Via_Query::Cont_Tbl
+{
+   const Contour *cnt;
+   int elems;
+
+   double *bpars;     // Begin parameter of each element
+   double *lens;      // XY length of each element
+   double *cums;      // XY length of the elements before, elems+1 values
+
+   int Index(const Elem& el) const;
+   double Sum(int from, int cnt) const;
+};
+
+/* ---------------------------------------------------------------------- */
+
+int Cont_Via_Query::Cont_Tbl::Index(const Elem& el) const
+{
+  const double *bp = std::lower_bound(bpars,bpars+elems,el.Begin_Par());
+
+  if (bp == bpars+elems || *bp != el.Begin_Par())
+                                       Cont_Panic(Cont_Area_Cant_Extract);
+
+  return (int)(bp - bpars);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Length of cnt elements from from on, wraps around ------------ */
+/* ---------------------------------------------------------------------- */
+
+double Cont_Via_Query::Cont_Tbl::Sum(int from, int cnt) const
+{
+  if (from + cnt <= elems) return cums[from+cnt] - cums[from];
+
+  return (cums[elems] - cums[from]) + cums[from+cnt-elems];
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- The lengths of a path as Cont_Pnt::Extract_Upto builds it ---- */
+/* ---------------------------------------------------------------------- */
+
+struct Via_Path
+{
+   int cnt;
+   double sum, first, last;
+
+   Via_Path() : cnt(0), sum(0.0), first(0.0), last(0.0) {}
+
+   void Add(double len);
+   void Add(int elems, double len, double first_len, double last_len);
+
+   void Stretch_First(double len);
+   void Stretch_Last(double len);
+
+   void Reverse() { std::swap(first,last); }
+};
+
+/* ---------------------------------------------------------------------- */
+
+void Via_Path::Add(double len)
+{
+  if (!cnt) first = len;
+  last = len;
+
+  sum += len;
+  ++cnt;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Via_Path::Add(int elems, double len, double first_len, double last_len)
+{
+  if (elems < 1) return;
+
+  if (!cnt) first = first_len;
+  last = last_len;
+
+  sum += len;
+  cnt += elems;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Via_Path::Stretch_First(double len)
+{
+  if (cnt < 1) return;
+
+  first += len;
+  if (cnt == 1) last = first;
+
+  sum += len;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Via_Path::Stretch_Last(double len)
+{
+  if (cnt < 1) return;
+
+  last += len;
+  if (cnt == 1) first = last;
+
+  sum += len;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Split test and piece length as in the element Split ---------- */
+/* ---------------------------------------------------------------------- */
+
+static bool split_ok(const Elem& el, double rpar)
+{
+  return rpar >= Vec2::identDist() && rpar <= el.Len() - Vec2::identDist();
+}
+
+/* ---------------------------------------------------------------------- */
+
+static double piece_len(const Elem& el, double rpar1, double rpar2)
+{
+  double len = el.Len();
+
+  if (len <= 0.0 || (rpar1 <= 0.0 && rpar2 >= len)) return el.Len_XY();
+
+  return el.Len_XY() * (rpar2 - rpar1) / len;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Length change when the piece of el starting (ending) at ------ */
+/* ------- rpar is stretched to p, to first order ----------------------- */
+/* ---------------------------------------------------------------------- */
+
+static double stretch_begin(const Elem& el, double rpar, const Vec3& p)
+{
+  Vec3 bp(el.P1());
+  if (rpar > 0.0) el.At_Par(el.Begin_Par() + rpar,bp);
+
+  Vec2 dp(p.x - bp.x,p.y - bp.y);
+
+  return -(dp * el.Start_Tangent_XY());
+}
+
+/* ---------------------------------------------------------------------- */
+
+static double stretch_end(const Elem& el, double rpar, const Vec3& p)
+{
+  Vec3 ep(el.P2());
+  if (rpar < el.Len()) el.At_Par(el.Begin_Par() + rpar,ep);
+
+  Vec2 dp(p.x - ep.x,p.y - ep.y);
+
+  return dp * el.End_Tangent_XY();
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Path from pnt1 upto pnt2, see Cont_Pnt::Extract_Upto --------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Via_Query::add_upto(const Cont_Tbl& tbl, const Cont_Pnt& pnt1,
+                              const Cont_Pnt& pnt2, Via_Path& pth)
+{
+  if (!pnt1.Cursor() || !pnt2.Cursor()) Cont_Panic(Cont_Area_Cant_Extract);
+
+  const Elem& el1 = pnt1.Cursor()->El();
+  const Elem& el2 = pnt2.Cursor()->El();
+
+  double rpar1 = pnt1.Rel_Par();
+  double rpar2 = pnt2.Rel_Par();
+
+  int idx1 = tbl.Index(el1);
+  int idx2 = tbl.Index(el2);
+
+  bool split1 = split_ok(el1,rpar1);
+  bool split2 = split_ok(el2,rpar2);
+
+  if (idx1 == idx2 && rpar1 < rpar2) {
+    double bpar = split1 ? rpar1 : 0.0;
+    double epar = el1.Len();
+
+    if (rpar2 - bpar >= Vec2::identDist() &&
+        rpar2 - bpar <= epar - bpar - Vec2::identDist()) epar = rpar2;
+
+    pth.Add(piece_len(el1,bpar,epar));
+
+    pth.Stretch_First(stretch_begin(el1,bpar,pnt1.P()));
+    pth.Stretch_Last(stretch_end(el1,epar,pnt2.P()));
+
+    return;
+  }
+
+  // The element at a point is split, taken whole or skipped
+
+  bool fst = split1 || rpar1 < el1.Par_Len()/2.0;
+  bool lst = split2 || rpar2 > el2.Par_Len()/2.0;
+
+  if (fst) pth.Add(piece_len(el1,split1 ? rpar1 : 0.0,el1.Len()));
+
+  int from  = (idx1+1) % tbl.elems;
+  int elems = (idx2-idx1-1+tbl.elems) % tbl.elems;
+
+  if (elems > 0) pth.Add(elems,tbl.Sum(from,elems),tbl.lens[from],
+                         tbl.lens[(from + elems - 1) % tbl.elems]);
+
+  if (lst) pth.Add(piece_len(el2,0.0,split2 ? rpar2 : el2.Len()));
+
+  // Then the ends are stretched to the points
+
+  Elem_C_Cursor felc(pnt1.Cursor());
+  if (!fst) { ++felc; if (!felc) felc.To_Begin(); }
+
+  double bpar = fst && split1 ? rpar1 : 0.0;
+  pth.Stretch_First(stretch_begin(felc->El(),bpar,pnt1.P()));
+
+  Elem_C_Cursor lelc(pnt2.Cursor());
+  if (!lst) { --lelc; if (!lelc) lelc.To_Last(); }
+
+  double epar = lst && split2 ? rpar2 : lelc->El().Len();
+  pth.Stretch_Last(stretch_end(lelc->El(),epar,pnt2.P()));
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Via_Query::Cont_Via_Query(const Cont_Area& ar)
+ : area(ar), tbls(NULL), tbl_cnt(0)
+{
+  int cnt = 0;
+
+  Cont_Nest_C_Cursor nsc(area.List());
+
+  for (;nsc;++nsc) cnt += nsc->List().Length();
+
+  tbls = new Cont_Tbl[cnt > 0 ? cnt : 1];
+
+  for (nsc.To_Begin();nsc;++nsc) {
+    Cont_Clsd_C_Cursor cc(nsc->List());
+
+    for (;cc;++cc) {
+      const Contour& cont = *cc;
+
+      // Projecting builds these on demand, not thread safe
+      if (!cont.el_rect_list && cont.el_list) cont.build_rect_list();
+
+      Cont_Tbl& tbl = tbls[tbl_cnt++];
+
+      tbl.cnt   = &cont;
+      tbl.elems = cont.Elem_Count();
+      tbl.bpars = new double[3*tbl.elems + 1];
+      tbl.lens  = tbl.bpars + tbl.elems;
+      tbl.cums  = tbl.lens  + tbl.elems;
+
+      tbl.cums[0] = 0.0;
+
+      Elem_C_Cursor elc(cont.List());
+
+      for (int i=0;elc;++elc,++i) {
+        const Elem& el = elc->El();
+
+        tbl.bpars[i]  = el.Begin_Par();
+        tbl.lens[i]   = el.Len_XY();
+        tbl.cums[i+1] = tbl.cums[i] + tbl.lens[i];
+      }
+    }
+  }
+
+  std::sort(tbls,tbls+tbl_cnt,[](const Cont_Tbl& t1, const Cont_Tbl& t2) {
+    return std::less<const Contour *>()(t1.cnt,t2.cnt);
+  });
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Via_Query::~Cont_Via_Query()
+{
+  for (int i=0; i<tbl_cnt; ++i) delete[] tbls[i].bpars;
+
+  delete[] tbls;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+const Cont_Via_Query::Cont_Tbl *Cont_Via_Query::find_tbl
+                                             (const Contour *cnt) const
+{
+  const Cont_Tbl *tbl = std::lower_bound(tbls,tbls+tbl_cnt,cnt,
+                              [](const Cont_Tbl& t, const Contour *c) {
+    return std::less<const Contour *>()(t.cnt,c);
+  });
+
+  if (tbl == tbls+tbl_cnt || tbl->cnt != cnt) return NULL;
+
+  return tbl;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- The decisions are those of Cont_Area::Extract_Via ------------ */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Via_Query::Path_Len(const Cont_Via_Req& req, double& pathlen) const
+{
+  pathlen = 0.0;
+
+  Cont_Pnt from, upto;
+  bool rev, along;
+
+  if (!area.via_ends(req.p1,req.probedir1,req.p2,req.probedir2,
+                                          from,upto,rev,along)) return false;
+
+  const Cont_Tbl *tbl = find_tbl(from.Parent_Contour());
+  if (!tbl) Cont_Panic(Cont_Area_Cant_Extract);
+
+  Via_Path pth;
+
+  if (along) {
+    add_upto(*tbl,from,upto,pth);
+    if (rev) pth.Reverse();
+  }
+
+  // Extract_Via drops a short first and then a short last element
+
+  if (pth.cnt > 0 && Cont_Area::via_drop(pth.first)) {
+    pth.sum -= pth.first;
+    --pth.cnt;
+  }
+
+  if (pth.cnt > 0 && Cont_Area::via_drop(pth.last)) {
+    pth.sum -= pth.last;
+    --pth.cnt;
+  }
+
+  if (pth.cnt > 0) pathlen = pth.sum;
+
+  return true;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Each request is answered by exactly one thread --------------- */
+/* ---------------------------------------------------------------------- */
+
+int Cont_Via_Query::Path_Lens(const Cont_Via_Req *reqs, int cnt,
+                      double *pathlens, bool *found, int thread_cnt) const
+{
+  if (cnt < 1) return 0;
+
+  std::atomic<int> foundCnt(0);
+
+  parallelFor(cnt,thread_cnt,[&](int i) {
+    bool ok = Path_Len(reqs[i],pathlens[i]);
+
+    if (found) found[i] = ok;
+    if (ok) ++foundCnt;
+  });
+
+  return foundCnt;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Via_Query::Path(const Cont_Via_Req& req, Contour& path,
+                                                   double& pathlen) const
+{
+  return area.Extract_Via(req.p1,req.probedir1,req.p2,req.probedir2,
+                                                            path,pathlen);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+size_t Cont_Via_Query::Mem_Size() const
+{
+  size_t sz = sizeof(*this) + tbl_cnt * sizeof(Cont_Tbl);
+
+  for (int i=0; i<tbl_cnt; ++i) sz += (3*tbls[i].elems + 1) * sizeof(double);
+
+  return sz;
+}
+
+} // namespace Ino
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
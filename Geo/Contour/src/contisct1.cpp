@@ -16,10 +16,13 @@
 #include "sub_rect.hi"
 
 #include "cntpanic.hi"
+#include "Trace.h"
 
 #include <math.h>
 #include <stdio.h>
 
+#include <vector>
+
 namespace Ino
 {
 
@@ -250,7 +253,7 @@ bool Cont_Isect::Near_Elem_Start() const
 {
   if (!Pnt.Cursor()) return false;
 
-  if (Pnt.Rel_Par() <= Vec2::IdentDist) return true;
+  if (Pnt.Rel_Par() <= Vec2::identDist()) return true;
 
   return false;
 }
@@ -265,7 +268,7 @@ bool Cont_Isect::Near_Elem_End() const
 
   const Elem& curel = Pnt.Cursor()->El();
 
-  if (Pnt.Rel_Par() >= curel.Par_Len() - Vec2::IdentDist) return true;
+  if (Pnt.Rel_Par() >= curel.Par_Len() - Vec2::identDist()) return true;
 
   return false;
 }
@@ -377,10 +380,10 @@ void Cont_Isect::Eval_Sides()
 
   // Determine arrival side
 
-  if (fabs(inprod_bef) < Vec2::IdentDir &&
+  if (fabs(inprod_bef) < Vec2::identDir() &&
                          (tg_bef * o_tg_bef) > 0.0) arrive = tang;
 
-  else if (fabs(inprod_aft) < Vec2::IdentDir &&
+  else if (fabs(inprod_aft) < Vec2::identDir() &&
                          (tg_aft * o_tg_bef) < 0.0) arrive = a_tang;
 
   else if (nrm_bef * tg_aft >= 0.0) { // Transition to the left
@@ -398,9 +401,9 @@ void Cont_Isect::Eval_Sides()
   inprod_bef = nrm_bef * o_tg_aft;
   inprod_aft = nrm_aft * o_tg_aft;
 
-  if (fabs(inprod_bef) < Vec2::IdentDir &&
+  if (fabs(inprod_bef) < Vec2::identDir() &&
                        (tg_bef * o_tg_aft) < 0.0) depart = a_tang;
-  else if (fabs(inprod_aft) < Vec2::IdentDir &&
+  else if (fabs(inprod_aft) < Vec2::identDir() &&
                        (tg_aft * o_tg_bef) > 0.0) depart = tang;
 
   else if (nrm_bef * tg_aft >= 0.0) { // Transition to the left
@@ -442,10 +445,10 @@ void Cont_Isect::Eval2_Sides()
 
   // Determine arrival side
 
-  if (fabs(inprod_bef) < Vec2::IdentDir &&
+  if (fabs(inprod_bef) < Vec2::identDir() &&
                          (tg_bef * o_tg_bef) > 0.0) arrive = tang;
 
-  else if (fabs(inprod_aft) < Vec2::IdentDir &&
+  else if (fabs(inprod_aft) < Vec2::identDir() &&
                          (tg_aft * o_tg_bef) < 0.0) arrive = a_tang;
 
   else if (nrm_bef * tg_aft >= 0.0) { // Transition to the left
@@ -463,9 +466,9 @@ void Cont_Isect::Eval2_Sides()
   inprod_bef = nrm_bef * o_tg_aft;
   inprod_aft = nrm_aft * o_tg_aft;
 
-  if (fabs(inprod_bef) < Vec2::IdentDir &&
+  if (fabs(inprod_bef) < Vec2::identDir() &&
                        (tg_bef * o_tg_aft) < 0.0) depart = a_tang;
-  else if (fabs(inprod_aft) < Vec2::IdentDir &&
+  else if (fabs(inprod_aft) < Vec2::identDir() &&
                        (tg_aft * o_tg_bef) > 0.0) depart = tang;
 
   else if (nrm_bef * tg_aft >= 0.0) { // Transition to the left
@@ -743,7 +746,7 @@ void Cont1_Isect_List::delete_phantom_intersections()
       double pdist;
       is.Pnt.Min_Par_Dist_To(is.Other->Pnt,pdist);
 
-      if (fabs(pdist) < 2.1*Vec2::IdentDist) {
+      if (fabs(pdist) < 2.1*Vec2::identDist()) {
         isbc1->Other.Delete();
         isbc1.Delete();
         
@@ -844,7 +847,7 @@ bool Cont1_Isect_List::set_analysis_range_before(
   
   Elem_C_Cursor curc(is.Pnt);
 
-  double tol = sqr(Vec2::IdentDist);
+  double tol = sqr(Vec2::identDist());
 
   while (curc != is.St_Pt) {
     Elem_C_Cursor prvc(curc); --prvc; if (!prvc) prvc.To_Last();
@@ -865,7 +868,7 @@ bool Cont1_Isect_List::set_analysis_range_before(
   
   bool has_length = true;
   
-  if (curc == is.Pnt && is.Pnt.Rel_Par() < Vec2::IdentDist) has_length=false;
+  if (curc == is.Pnt && is.Pnt.Rel_Par() < Vec2::identDist()) has_length=false;
 
   if (!prv_is.End_Pt && is.Full_Range_Arrive) {
     prv_is.End_Pt = is.Pnt;
@@ -908,7 +911,7 @@ bool Cont1_Isect_List::set_analysis_range_after(
   
   Elem_C_Cursor curc(is.Pnt);
 
-  double tol = sqr(Vec2::IdentDist);
+  double tol = sqr(Vec2::identDist());
 
   while (curc != is.End_Pt) {
     Elem_C_Cursor nxtc(curc); ++nxtc; if (!nxtc) nxtc.To_Begin();
@@ -929,7 +932,7 @@ bool Cont1_Isect_List::set_analysis_range_after(
   
   bool has_length = true;
   if (curc == is.Pnt &&
-      is.Pnt.Rel_Par() >= curc->El().Par_Len()-Vec2::IdentDist)
+      is.Pnt.Rel_Par() >= curc->El().Par_Len()-Vec2::identDist())
                                                       has_length = false;
   
   if (!nxt_is.St_Pt && is.Full_Range_Depart) {
@@ -1045,7 +1048,7 @@ bool Cont1_Isect_List::find_rel_pos_arrive(const Cont_PPair& p1,
   else {
     upb_par = p2.two.Par();
     relc    = p2.two;
-    if (p2.two.Rel_Par() < Vec2::IdentDist) {
+    if (p2.two.Rel_Par() < Vec2::identDist()) {
       --relc; if (!relc) relc.To_Last();
       upb_par = relc->El().End_Par();
     }
@@ -1059,7 +1062,7 @@ bool Cont1_Isect_List::find_rel_pos_arrive(const Cont_PPair& p1,
 
   const Elem& el= relc->El();
 
-  while (lwb_par < upb_par - Vec2::IdentDist) {
+  while (lwb_par < upb_par - Vec2::identDist()) {
     double mpar = (lwb_par + upb_par)/2.0;
 
     Vec3 mp;
@@ -1209,7 +1212,7 @@ bool Cont1_Isect_List::find_rel_pos_depart(const Cont_PPair& p1,
   else {
     lwb_par = p2.one.Par();
     relc    = p2.one;
-    if (p2.one.Rel_Par() > relc->El().Par_Len()-Vec2::IdentDist) {
+    if (p2.one.Rel_Par() > relc->El().Par_Len()-Vec2::identDist()) {
       ++relc; if (!relc) relc.To_Begin();
       lwb_par = relc->El().Begin_Par();
     }
@@ -1223,7 +1226,7 @@ bool Cont1_Isect_List::find_rel_pos_depart(const Cont_PPair& p1,
 
   const Elem& el = relc->El();
 
-  while (lwb_par < upb_par - Vec2::IdentDist) {
+  while (lwb_par < upb_par - Vec2::identDist()) {
     double mpar = (lwb_par + upb_par)/2.0;
 
     Vec3 mp;
@@ -1307,7 +1310,7 @@ void Cont1_Isect_List::analyze_arrive(FILE * /*fd*/,int /*il*/,
   }
   
   if (!find_rel_pos_arrive(my_range, isc->Pnt.Par(), oth_range,
-                                Vec2::IdentDist, is.arrive)) {
+                                Vec2::identDist(), is.arrive)) {
 
 #ifdef DEBUG_PRINT
     fprintf(fd,"Arrive: Na find_rel_pos(false): \n");
@@ -1398,7 +1401,7 @@ void Cont1_Isect_List::analyze_depart(FILE * /*fd*/,int /*il*/,
   }
   
   if (!find_rel_pos_depart(my_range, isc->Pnt.Par(), oth_range,
-                                Vec2::IdentDist, is.depart)) {
+                                Vec2::identDist(), is.depart)) {
 
 #ifdef DEBUG_PRINT
     fprintf(fd,"depart, Na find_rel_pos (false): \n");
@@ -1534,7 +1537,7 @@ void Cont1_Isect_List::sort_offset_coincident()
     
       double dist;
       if (is.Pnt.Min_Par_Dist_To(prv_is.Pnt,dist) &&
-                                        fabs(dist) < Vec2::IdentDist) {
+                                        fabs(dist) < Vec2::identDist()) {
 
         double dist1, dist2;
 
@@ -1608,7 +1611,7 @@ void Cont1_Isect_List::special_offset_analyze()
 
       // Now clip the elements
       
-      if (prvis.Pnt.Rel_Par() < 3.0 * Vec2::IdentDist) {
+      if (prvis.Pnt.Rel_Par() < 3.0 * Vec2::identDist()) {
         celc = prvelc;
         --prvelc; if (!prvelc) prvelc.To_Last();
         
@@ -1629,7 +1632,7 @@ void Cont1_Isect_List::special_offset_analyze()
       }
       else prvelc->El().Stretch_End_XY(is.Pnt.P(),false);
       
-      if (is.Pnt.Rel_Par() > elc->El().Par_Len() - 3.0 * Vec2::IdentDist) {
+      if (is.Pnt.Rel_Par() > elc->El().Par_Len() - 3.0 * Vec2::identDist()) {
 
         Cont_Isect_D_Cursor lisc(ilist);
         while (lisc) {
@@ -1718,7 +1721,7 @@ void Cont1_Isect_List::cleanup_self(bool closed, bool make_consistent)
 
   // Delete identical intersections
   
-  delete_identical(2.0*Vec2::IdentDist);
+  delete_identical(2.0*Vec2::identDist());
 
   // Define sort order of coincident intersections
   sort_offset_coincident();
@@ -1742,7 +1745,7 @@ void Cont1_Isect_List::cleanup_self(bool closed, bool make_consistent)
    fprintf(fd,"\nNa Eval_Sides:\n\n");
 #endif
 
-  analyze_tangent_stretches(fd,2.0*Vec2::IdentDist);
+  analyze_tangent_stretches(fd,2.0*Vec2::identDist());
 
 #ifdef DEBUG_PRINT
      fprintf(fd,"\nNa Analyze:\n\n");
@@ -1956,8 +1959,8 @@ void Cont1_Isect_List::
 
   if (adjacent) {
     plc.To_Begin();
-    if (plc->First.Par < el1.Begin_Par() + Vec2::IdentDist &&
-        plc->Last.Par  > el2.End_Par()   - Vec2::IdentDist)
+    if (plc->First.Par < el1.Begin_Par() + Vec2::identDist() &&
+        plc->Last.Par  > el2.End_Par()   - Vec2::identDist())
     {
       el1.Stretch_Begin_XY(plc->P);
       el2.Stretch_End_XY(plc->P);
@@ -1967,8 +1970,8 @@ void Cont1_Isect_List::
 
     plc.To_Last(); if (!plc) return;
 
-    if (plc->First.Par > el1.End_Par()   - Vec2::IdentDist &&
-        plc->Last.Par  < el2.Begin_Par() + Vec2::IdentDist)
+    if (plc->First.Par > el1.End_Par()   - Vec2::identDist() &&
+        plc->Last.Par  < el2.Begin_Par() + Vec2::identDist())
     {
       el1.Stretch_End_XY(plc->P);
       el2.Stretch_Begin_XY(plc->P);
@@ -2029,7 +2032,7 @@ void Cont1_Isect_List::intersect_xy(Cont_Ref& cntref, bool one_only)
     for (;rc2;++rc2) {
       const Rect_Ax& rct2 = rc2->Rect;
 
-      if (rct1.Intersects_XY(rct2,Vec2::IdentDist)) {
+      if (rct1.Intersects_XY(rct2,Vec2::identDist())) {
 
         Elem_Cursor curel1(el1);
 
@@ -2038,8 +2041,8 @@ void Cont1_Isect_List::intersect_xy(Cont_Ref& cntref, bool one_only)
 
           const Elem &locel1 = curel1->El();
 
-          if (locel1.Len_XY() >= Vec2::IdentDist &&
-              locel1.Rect().Intersects_XY(rct2,Vec2::IdentDist)) {
+          if (locel1.Len_XY() >= Vec2::identDist() &&
+              locel1.Rect().Intersects_XY(rct2,Vec2::identDist())) {
 
             Elem_Cursor curel2(el2);
 
@@ -2052,7 +2055,7 @@ void Cont1_Isect_List::intersect_xy(Cont_Ref& cntref, bool one_only)
 
               const Elem &locel2 = curel2->El();
 
-              if (locel2.Len_XY() >= Vec2::IdentDist) {
+              if (locel2.Len_XY() >= Vec2::identDist()) {
                 intersect_el(cntref,curel1,curel2,parlen);
 
                 if (one_only && ilist) return;
@@ -2120,6 +2123,8 @@ void Cont1_Isect_List::unmark_arrive_depart()
 Cont1_Isect_List::Cont1_Isect_List(Cont_Ref& cntref, bool one_only)
   : ilist(), left(true), offsetref(&cntref), rlist(NULL)
 {
+  TraceScope trc("Cont1_Isect_List",cntref.Cont.Elem_Count());
+
   if (cntref.Cont.Empty()) return;
 
   intersect_xy(cntref, one_only);
@@ -2133,6 +2138,8 @@ Cont1_Isect_List::Cont1_Isect_List(Cont_Ref& cntref, bool closed,
                                        bool go_left, bool make_consistent)
   : ilist(), left(go_left), offsetref(&cntref), rlist(NULL)
 {
+  TraceScope trc("Cont1_Isect_List",cntref.Cont.Elem_Count());
+
   if (cntref.Cont.Empty()) return;
 
   intersect_xy(cntref);
@@ -2213,7 +2220,7 @@ static bool check_contiguous(const Elem_List& ellst, bool closed)
 void Cont1_Isect_List::Check_Against_Cont(const Cont_Clsd& org_cont,
                                                          double offdist)
 {
-  if (fabs(offdist) < Vec2::IdentDist) return;
+  if (fabs(offdist) < Vec2::identDist()) return;
   
   Cont_Isect_Cursor isc; isc = ilist.Begin();
   
@@ -2223,7 +2230,7 @@ void Cont1_Isect_List::Check_Against_Cont(const Cont_Clsd& org_cont,
     if (!org_cont.Project_Pnt_XY(isc->Pnt.P(),pnt,dist))
                                      Cont_Panic(ContIsect_Cant_Project);
 
-    if (fabs(dist - offdist) > 2.0 * Vec2::IdentDist) {
+    if (fabs(dist - offdist) > 2.0 * Vec2::identDist()) {
       // Remove this intersection
       isc->Other.Delete();
       isc.Delete();
@@ -2236,9 +2243,433 @@ void Cont1_Isect_List::Check_Against_Cont(const Cont_Clsd& org_cont,
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
-void Cont1_Isect_List::Extract_Offset_Open(Cont_D_List& /*cnt_list*/)
+/* ---------------------------------------------------------------------- */
+/* ------- Uniform grid over the elements of the original, each cell ---- */
+/* ------- lists the elements within offdist of it. Tells whether a ----- */
+/* ------- point of the raw offset is too close to the original without - */
+/* ------- projecting it on the whole contour. -------------------------- */
+/* ---------------------------------------------------------------------- */
+
+class Open_Off_Grid
+{
+  double x0, y0, cell;
+  int nx, ny;
+
+  std::vector<int> first;          // Per cell, into els
+  std::vector<const Elem *> els;
+
+  void cell_range(const Rect_Ax& rct, double ext,
+                                 int& ix1, int& iy1, int& ix2, int& iy2) const;
+
+ public:
+  Open_Off_Grid(const Contour& org, double offdist);
+
+  bool Closer(const Vec3& p, double lim) const;
+};
+
+/* ---------------------------------------------------------------------- */
+
+void Open_Off_Grid::cell_range(const Rect_Ax& rct, double ext,
+                                  int& ix1, int& iy1, int& ix2, int& iy2) const
+{
+  ix1 = (int)((rct.Ll().x - ext - x0)/cell);
+  iy1 = (int)((rct.Ll().y - ext - y0)/cell);
+  ix2 = (int)((rct.Ur().x + ext - x0)/cell);
+  iy2 = (int)((rct.Ur().y + ext - y0)/cell);
+
+  if (ix1 < 0) ix1 = 0;
+  if (iy1 < 0) iy1 = 0;
+  if (ix2 >= nx) ix2 = nx-1;
+  if (iy2 >= ny) iy2 = ny-1;
+}
+
+/* ---------------------------------------------------------------------- */
+
+Open_Off_Grid::Open_Off_Grid(const Contour& org, double offdist)
+ : x0(0.0), y0(0.0), cell(1.0), nx(0), ny(0)
+{
+  double absdist = fabs(offdist);
+
+  int elcnt = org.Elem_Count();
+  if (elcnt < 1) return;
+
+  const Rect_Ax& rct = org.Rect();
+
+  x0 = rct.Ll().x - absdist;
+  y0 = rct.Ll().y - absdist;
+
+  double w = rct.Ur().x - rct.Ll().x + 2.0*absdist;
+  double h = rct.Ur().y - rct.Ll().y + 2.0*absdist;
+
+  // About four cells per element, not smaller than offdist
+
+  cell = sqrt(w*h/(4.0*elcnt));
+  if (cell < absdist) cell = absdist;
+  if (cell < Vec2::identDist()) cell = Vec2::identDist();
+
+  nx = (int)(w/cell) + 1;
+  ny = (int)(h/cell) + 1;
+
+  std::vector<int> cnt(nx*ny+1,0);
+
+  Elem_C_Cursor elc(org.List());
+
+  for (int pass=0; pass<2; ++pass) {
+    for (elc.To_Begin(); elc; ++elc) {
+      int ix1,iy1,ix2,iy2;
+      cell_range(elc->El().Rect(),absdist,ix1,iy1,ix2,iy2);
+
+      for (int iy=iy1; iy<=iy2; ++iy) {
+        for (int ix=ix1; ix<=ix2; ++ix) {
+          int c = iy*nx + ix;
+
+          if (pass == 0) cnt[c+1]++;
+          else els[first[c] + cnt[c]++] = &elc->El();
+        }
+      }
+    }
+
+    if (pass == 0) {
+      for (int c=0; c<nx*ny; ++c) cnt[c+1] += cnt[c];
+
+      first.swap(cnt);
+      els.resize(first[nx*ny]);
+      cnt.assign(nx*ny,0);
+    }
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- True if an element of the original is closer than lim to p --- */
+/* ---------------------------------------------------------------------- */
+
+bool Open_Off_Grid::Closer(const Vec3& p, double lim) const
+{
+  int ix = (int)floor((p.x - x0)/cell);
+  int iy = (int)floor((p.y - y0)/cell);
+
+  if (ix < 0 || iy < 0 || ix >= nx || iy >= ny) return false;
+
+  int c = iy*nx + ix;
+
+  for (int i=first[c]; i<first[c+1]; ++i) {
+    const Elem& el = *els[i];
+
+    if (el.Rect().Dist_To_XY(p) >= lim) continue;
+
+    Vec3 pp;
+    double parm, dist;
+
+    if (el.Project_Pnt_XY(p,Sub_Rect_Project_Tol,true,pp,parm,dist) &&
+                                              fabs(dist) < lim) return true;
+  }
+
+  return false;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Point of el at par, its end points exactly ------------------- */
+/* ---------------------------------------------------------------------- */
+
+static Vec3 open_offset_pnt(const Elem& el, double par)
+{
+  if (par <= el.Begin_Par()) return el.P1();
+  if (par >= el.End_Par())   return el.P2();
+
+  Vec3 p;
+  el.At_Par(par,p);
+
+  return p;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Bisect el for the transition between a valid and an ---------- */
+/* ------- invalid parameter, returns the valid side -------------------- */
+/* ---------------------------------------------------------------------- */
+
+static double open_offset_bisect(const Open_Off_Grid& grid, double absdist,
+                                 const Elem& el, double good, double bad)
 {
-  // Hier verder
+  // Far below the sampling tolerance, else the transition drifts along
+  // the element if it runs at a small angle to the offset. Not zero: the
+  // element el is the offset of is itself offdist away, with rounding.
+
+  double lim = absdist - 1.0e-3*Vec2::identDist();
+
+  while (fabs(good - bad) > Vec2::identDist()/2.0) {
+    double mid = (good + bad)/2.0;
+
+    if (!grid.Closer(open_offset_pnt(el,mid),lim)) good = mid;
+    else                                                bad  = mid;
+  }
+
+  return good;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Valid stretch of a piece of the raw offset ------------------- */
+/* ---------------------------------------------------------------------- */
+
+struct Open_Off_Seg
+{
+  int piece;
+  Elem_C_Cursor belc, eelc;
+  double bpar, epar;
+  bool at_beg, at_end;   // Starts/ends at the intersection of the piece
+  int next;
+  bool has_pred, used;
+};
+
+/* ---------------------------------------------------------------------- */
+/* ------- Collects the stretches of piece that are offdist away -------- */
+/* ------- from the original. Elements are sampled at a quarter of ------ */
+/* ------- offdist at most, a gap always ends a stretch. ---------------- */
+/* ---------------------------------------------------------------------- */
+
+static void open_offset_segs(const Open_Off_Grid& grid, double offdist,
+                             const Contour& piece, int pidx,
+                             bool isct_beg, bool isct_end,
+                             std::vector<Open_Off_Seg>& segs)
+{
+  Open_Off_Seg seg;
+  seg.piece = pidx;
+  seg.next = -1;
+  seg.has_pred = seg.used = false;
+
+  double absdist = fabs(offdist);
+  double lim = absdist - 2.0 * Vec2::identDist();
+
+  bool in = false, first = true;
+  double prv_par = 0.0;
+
+  Elem_C_Cursor elc(piece.List()), prv_elc;
+
+  for (;elc;++elc) {
+    const Elem& el = elc->El();
+
+    if (in && el.P1().distTo2(prv_elc->El().P2()) > Vec2::identDist()) {
+      seg.eelc = prv_elc; seg.epar = prv_par;
+      seg.at_end = false;
+      segs.push_back(seg);
+      in = false;
+    }
+
+    int steps = 2 + (int)(4.0 * el.Len_XY()/absdist);
+    if (steps > 256) steps = 256;
+
+    double prv_smp = el.Begin_Par();
+
+    for (int k=0; k<=steps; ++k) {
+      double par = el.Begin_Par() + el.Par_Len()*k/steps;
+
+      bool valid = !grid.Closer(k == steps ? el.P2() :
+                                       open_offset_pnt(el,par),lim);
+
+      if (valid && !in) {
+        if (k == 0) seg.bpar = par;
+        else seg.bpar = open_offset_bisect(grid,absdist,el,par,prv_smp);
+        seg.belc = elc;
+        seg.at_beg = isct_beg && first && k == 0;
+        in = true;
+      }
+      else if (!valid && in) {
+        if (k == 0) {
+          seg.eelc = prv_elc; seg.epar = prv_par;
+        }
+        else {
+          seg.eelc = elc;
+          seg.epar = open_offset_bisect(grid,absdist,el,prv_smp,par);
+        }
+        seg.at_end = false;
+        segs.push_back(seg);
+        in = false;
+      }
+
+      prv_smp = par;
+    }
+
+    prv_elc = elc;
+    prv_par = el.End_Par();
+    first = false;
+  }
+
+  if (in) {
+    seg.eelc = prv_elc; seg.epar = prv_par;
+    seg.at_end = isct_end;
+    segs.push_back(seg);
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- The raw offset is split at all intersections, from each ------ */
+/* ------- piece the stretches far enough from the original are kept. --- */
+/* ------- A stretch ending at an intersection continues with the next -- */
+/* ------- piece, or if that one is gone, with the piece after the ------ */
+/* ------- partner intersection. Other ends continue with the stretch --- */
+/* ------- that starts there (the raw offset may run through a ---------- */
+/* ------- discarded part without intersecting). ------------------------ */
+/* ---------------------------------------------------------------------- */
+
+void Cont1_Isect_List::Extract_Offset_Open(const Contour& org,
+                                       double offdist, Cont_D_List& cnt_list)
+{
+  cnt_list.Delete();
+
+  if (!offsetref || offsetref->Cont.Empty()) return;
+
+  const Contour& raw = offsetref->Cont;
+
+  int icnt = ilist.Length();
+  int pcnt = icnt + 1;
+
+  Contour *pieces = new Contour[pcnt];
+  int *other = new int[pcnt];
+  bool *jump = new bool[pcnt];
+  int *first_seg = new int[pcnt];
+
+  Cont_Isect_D_Cursor isc(ilist);
+  for (int i=0; isc; ++isc, ++i) isc->id_no = i;
+
+  isc.To_Begin();
+
+  for (int i=0; isc; ++isc, ++i) {
+    other[i] = isc->Other->id_no;
+    jump[i]  = isc->To_Left == left;  // As in Extract_Offset_Closed
+  }
+
+  Cont_Pnt begpnt(raw,raw.Begin_Par()), endpnt(raw,raw.End_Par());
+
+  const Cont_Pnt *from = &begpnt;
+
+  Open_Off_Grid grid(org,offdist);
+
+  std::vector<Open_Off_Seg> segs;
+
+  isc.To_Begin();
+
+  for (int j=0; j<pcnt; ++j) {
+    const Cont_Pnt *upto = isc ? &isc->Pnt : &endpnt;
+
+    from->Extract_Upto(*upto,pieces[j]);
+    from = upto;
+
+    if (isc) ++isc;
+
+    int fseg = (int)segs.size();
+
+    open_offset_segs(grid,offdist,pieces[j],j,j > 0,j < icnt,segs);
+
+    // Of the four branches at an intersection pair one arrives and
+    // one departs on the offset, the others can only hold slivers
+    // that are within tolerance
+
+    if (j < icnt && !jump[j] && (int)segs.size() > fseg &&
+                                             segs.back().at_end) segs.pop_back();
+
+    if (j > 0 && jump[j-1] && (int)segs.size() > fseg &&
+                          segs[fseg].at_beg) segs.erase(segs.begin()+fseg);
+
+    first_seg[j] = (int)segs.size() > fseg ? fseg : -1;
+  }
+
+  // Link the stretches
+
+  int scnt = (int)segs.size();
+  double tol = 10.0 * Vec2::identDist();
+
+  std::vector<Vec3> bps, eps;  // Their end points
+  bps.reserve(scnt); eps.reserve(scnt);
+
+  for (int s=0; s<scnt; ++s) {
+    bps.push_back(open_offset_pnt(segs[s].belc->El(),segs[s].bpar));
+    eps.push_back(open_offset_pnt(segs[s].eelc->El(),segs[s].epar));
+  }
+
+  for (int s=0; s<scnt; ++s) {
+    Open_Off_Seg& seg = segs[s];
+
+    if (seg.at_end) {
+      int e = seg.piece;
+
+      int t = first_seg[other[e]+1];
+
+      if (t >= 0 && segs[t].at_beg && !segs[t].has_pred) seg.next = t;
+    }
+
+    if (seg.next < 0) {
+      double mindist = tol;
+
+      for (int t=0; t<scnt; ++t) {
+        if (t == s || segs[t].has_pred) continue;
+
+        double dist = eps[s].distTo2(bps[t]);
+
+        if (dist < mindist) {
+          mindist = dist;
+          seg.next = t;
+        }
+      }
+    }
+
+    if (seg.next >= 0) segs[seg.next].has_pred = true;
+  }
+
+  // Chain them, first from the stretches without predecessor
+
+  Cont_Cursor cc(cnt_list);
+
+  for (int pass=0; pass<2; ++pass) {
+    for (int s=0; s<scnt; ++s) {
+      if (segs[s].used || (pass == 0 && segs[s].has_pred)) continue;
+
+      Contour newc;
+      Elem_Cursor elc(newc.el_list);
+
+      for (int cur=s; cur >= 0 && !segs[cur].used; cur = segs[cur].next) {
+        Open_Off_Seg& seg = segs[cur];
+        seg.used = true;
+
+        const Contour& piece = pieces[seg.piece];
+
+        // Points by element, a parameter is ambiguous at a gap
+
+        Cont_Pnt bpnt(piece,seg.belc,seg.bpar-seg.belc->El().Begin_Par(),
+                                                                 bps[cur]);
+        Cont_Pnt epnt(piece,seg.eelc,seg.epar-seg.eelc->El().Begin_Par(),
+                                                                 eps[cur]);
+        Contour newpiece;
+        bpnt.Extract_Upto(epnt,newpiece);
+        elc.To_Last();
+
+        if (!newpiece.Empty()) {
+          newpiece.el_list.Append_To(newc.el_list);
+
+          if (elc && elc.Succ()) elc->El().Join_To_XY(elc.Succ()->El());
+        }
+      }
+
+      Remove_Short_Elems(newc.el_list, 5.0*Vec2::identDist(),false);
+
+      newc.calc_invar();
+
+      // Slivers left near intersections by the distance tolerance
+
+      if (newc.Len_XY() < 10.0*tol) continue;
+
+      cc.To_End();
+      cc.Insert(Contour());
+
+      newc.Move_To(*cc);
+
+      cc->calc_invar();
+      cc->Begin_Par(0.0);
+    }
+  }
+
+  delete[] first_seg;
+  delete[] jump;
+  delete[] other;
+  delete[] pieces;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -2257,10 +2688,10 @@ static bool repair_forward(Elem_Cursor& lelc, Elem_Cursor& felc)
     Vec3 pp;
     double parm, dist_xy;
     
-    if (el.Project_Pnt_XY(endp, Vec2::IdentDist, true, pp, parm, dist_xy) &&
-                                  fabs(dist_xy) < 2.0 * Vec2::IdentDist) {
+    if (el.Project_Pnt_XY(endp, Vec2::identDist(), true, pp, parm, dist_xy) &&
+                                  fabs(dist_xy) < 2.0 * Vec2::identDist()) {
 
-      if (parm > el.End_Par()-Vec2::IdentDist) {
+      if (parm > el.End_Par()-Vec2::identDist()) {
         felc.Delete();
         if (!felc) lelc->El().Stretch_End_XY(el.P2(),true);
         else {
@@ -2320,10 +2751,10 @@ static bool repair_backward(Elem_Cursor& lelc, Elem_Cursor& felc)
     Vec3 pp;
     double parm, dist_xy;
     
-    if (el.Project_Pnt_XY(begp, Vec2::IdentDist, true, pp, parm, dist_xy) &&
-                                  fabs(dist_xy) < 2.0 * Vec2::IdentDist) {
+    if (el.Project_Pnt_XY(begp, Vec2::identDist(), true, pp, parm, dist_xy) &&
+                                  fabs(dist_xy) < 2.0 * Vec2::identDist()) {
 
-      if (parm < el.Begin_Par()+Vec2::IdentDist) {
+      if (parm < el.Begin_Par()+Vec2::identDist()) {
         lelc.Delete(); lelc.To_Last();
 
         if (!lelc) felc->El().Stretch_Begin_XY(el.P1(),true);
@@ -2401,13 +2832,13 @@ bool Cont1_Isect_List::analyze_contiguous(const Cont_Clsd& org,
       Elem& el1 = lelc->El();
       Elem& el2 = felc->El();
       
-      if (el1.P2().distTo2(el2.P1()) > Vec2::IdentDist) {
+      if (el1.P2().distTo2(el2.P1()) > Vec2::identDist()) {
 
         Cont_Pnt pp;
         double dist_xy;
 
         if (org.Project_Pnt_XY(el1.P2(),pp,dist_xy) &&
-                    fabs(dist_xy-offdist) < 2.0*Vec2::IdentDist) {
+                    fabs(dist_xy-offdist) < 2.0*Vec2::identDist()) {
 
           if (repair_forward(lelc,felc)) {
             repaired = true;
@@ -2415,7 +2846,7 @@ bool Cont1_Isect_List::analyze_contiguous(const Cont_Clsd& org,
           }
         }
         else if (org.Project_Pnt_XY(el2.P1(),pp,dist_xy) &&
-                    fabs(dist_xy-offdist) < 2.0*Vec2::IdentDist) {
+                    fabs(dist_xy-offdist) < 2.0*Vec2::identDist()) {
 
           if (repair_backward(lelc,felc)) {
             repaired = true;
@@ -2434,7 +2865,7 @@ bool Cont1_Isect_List::analyze_contiguous(const Cont_Clsd& org,
     lelc.Re_Insert(felc);
   }
 
-  if (lelc->El().P2().distTo2(pnt2.P()) > Vec2::IdentDist) {
+  if (lelc->El().P2().distTo2(pnt2.P()) > Vec2::identDist()) {
     newpiece.Delete();
 
     return false;
@@ -2518,7 +2949,7 @@ void Cont1_Isect_List::Extract_Closed(Cont_Clsd_D_List& cnt_list)
     if (elc) elc->El().Join_To_XY(elc.Succ()->El());
 
     if (!newc.Empty()) {
-      Remove_Short_Elems(newc.el_list, 5.0*Vec2::IdentDist,true);
+      Remove_Short_Elems(newc.el_list, 5.0*Vec2::identDist(),true);
 
       newc.calc_invar();
 
@@ -2530,7 +2961,7 @@ void Cont1_Isect_List::Extract_Closed(Cont_Clsd_D_List& cnt_list)
       cc->calc_invar();
       
       // If area is very small, just delete the contour
-      if (fabs(cc->Area_XY()) < Vec2::IdentDist/100.0/Vec2::Pi)
+      if (fabs(cc->Area_XY()) < Vec2::identDist()/100.0/Vec2::Pi)
                                                         cc.Delete(); 
     }
 
@@ -2629,7 +3060,7 @@ void Cont1_Isect_List::Extract_Offset_Closed(const Cont_Clsd& org,
       if (elc) elc->El().Join_To_XY(elc.Succ()->El());
 
       if (!newc.Empty() && check_contiguous(newc.el_list,true)) {
-        Remove_Short_Elems(newc.el_list, 5.0*Vec2::IdentDist,true);
+        Remove_Short_Elems(newc.el_list, 5.0*Vec2::identDist(),true);
 
         newc.calc_invar();
 
@@ -2641,7 +3072,7 @@ void Cont1_Isect_List::Extract_Offset_Closed(const Cont_Clsd& org,
         cc->calc_invar();
         
         // If area is very small, just delete the contour
-        if (fabs(cc->Area_XY()) < Vec2::IdentDist/100.0/Vec2::Pi)
+        if (fabs(cc->Area_XY()) < Vec2::identDist()/100.0/Vec2::Pi)
                                                           cc.Delete(); 
       }
     }
@@ -2662,10 +3093,10 @@ static bool repair_gap(Elem_Cursor& elc, double tol)
   Vec3 pp;
   double parm, dist_xy;
 
-  if (prvel.Project_Pnt_XY(curel.P1(),Vec2::IdentDist,true,
+  if (prvel.Project_Pnt_XY(curel.P1(),Vec2::identDist(),true,
                                    pp,parm,dist_xy) && fabs(dist_xy) < tol) {
 
-    if (parm < prvel.Begin_Par()+2.0*Vec2::IdentDist) {
+    if (parm < prvel.Begin_Par()+2.0*Vec2::identDist()) {
       Vec3 begp = prvel.P1();
 
       Elem_Cursor pelc(elc); --pelc; pelc.Delete();
@@ -2676,10 +3107,10 @@ static bool repair_gap(Elem_Cursor& elc, double tol)
       curel.Stretch_Begin_XY(pp,false);
     }
   }
-  else if (curel.Project_Pnt_XY(prvel.P2(),Vec2::IdentDist,true,
+  else if (curel.Project_Pnt_XY(prvel.P2(),Vec2::identDist(),true,
                                    pp,parm,dist_xy) && fabs(dist_xy) < tol) {
 
-    if (parm > curel.End_Par()-2.0*Vec2::IdentDist) {
+    if (parm > curel.End_Par()-2.0*Vec2::identDist()) {
       Vec3 endp = curel.P2();
 
       Elem_Cursor pelc(elc); --pelc; elc.Delete(); elc = pelc;
@@ -2714,7 +3145,7 @@ bool Cont1_Isect_List::compile_closed_cont(double tol, Cont_Clsd& cnt)
 
     double dist = prvel.P2().distTo2(curel.P1());
 
-    if (dist < 2.0 * Vec2::IdentDist) prvel.Join_To_XY(curel,false);
+    if (dist < 2.0 * Vec2::identDist()) prvel.Join_To_XY(curel,false);
     else if (!repair_gap(elc,tol)) contiguous = false;
     
     ++elc;
@@ -2748,7 +3179,7 @@ bool Cont1_Isect_List::get_contiguous_piece(const Cont_Isect_Cursor& isc,
 
     double dist = prvel.P2().distTo2(curel.P1());
 
-    if (dist < 2.0 * Vec2::IdentDist) prvel.Join_To_XY(curel,false);
+    if (dist < 2.0 * Vec2::identDist()) prvel.Join_To_XY(curel,false);
     else if (!repair_gap(elc,tol)) contiguous = false;
     
     ++elc;
@@ -2780,9 +3211,9 @@ bool Cont1_Isect_List::Extract_Offset_Closed_Special(double tol,
     if (!compile_closed_cont(tol,cnt)) return false;
 
     // If area is very small, just delete the contour
-    if (fabs(cnt.Area_XY()) < Vec2::IdentDist/100.0/Vec2::Pi) return true;
+    if (fabs(cnt.Area_XY()) < Vec2::identDist()/100.0/Vec2::Pi) return true;
 
-    Remove_Short_Elems(cnt.cont.el_list,100.0*Vec2::IdentDist,true);
+    Remove_Short_Elems(cnt.cont.el_list,100.0*Vec2::identDist(),true);
 
     cnt.cont.inval_rects();
     cnt.calc_invar();
@@ -2854,7 +3285,7 @@ bool Cont1_Isect_List::Extract_Offset_Closed_Special(double tol,
       if (elc) elc->El().Join_To_XY(elc.Succ()->El());
 
       if (!newc.Empty() && check_contiguous(newc.el_list,true)) {
-        Remove_Short_Elems(newc.el_list, 5.0*Vec2::IdentDist,true);
+        Remove_Short_Elems(newc.el_list, 5.0*Vec2::identDist(),true);
 
         newc.inval_rects();
         newc.calc_invar();
@@ -2867,7 +3298,7 @@ bool Cont1_Isect_List::Extract_Offset_Closed_Special(double tol,
         cc->calc_invar();
         
         // If area is very small, just delete the contour
-        if (fabs(cc->Area_XY()) < Vec2::IdentDist/100.0/Vec2::Pi)
+        if (fabs(cc->Area_XY()) < Vec2::identDist()/100.0/Vec2::Pi)
                                                           cc.Delete(); 
       }
     }
@@ -7,6 +7,7 @@
 /* ---------------------------------------------------------------------- */
 
 #include "Contour.h"
+#include "Cont_Attr.h"
 #include "contouri.hi"
 #include "cntpanic.hi"
 
@@ -22,12 +23,18 @@
 #include "El_Arc.h"
 #include "El_Cir.h"
 #include "Geo.h"
+#include "TaskPool.h"
+#include "Trace.h"
 
 // #include "base_arr.h"
 
 #include <math.h>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 #include "Exceptions.h"
 
 namespace Ino
@@ -77,21 +84,152 @@ void Contour::CleanupMem()
   Elem_Line::CleanupStore();
   Elem_Arc::CleanupStore();
   Elem_Circle::CleanupStore();
+
+  Elem::CleanupAttrStore();
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+typedef void   (*Alloc_Stats_Func)(IT_Alloc_Stats&);
+typedef size_t (*Alloc_Trim_Func)(size_t);
+
+static const Alloc_Stats_Func allocStatsFuncs[] = {
+  Elem_Line::StoreStats, Elem_Arc::StoreStats, Elem_Circle::StoreStats,
+  Elem::AttrStoreStats,
+  Elem_Alloc::Stats, Elem_Cursor_Alloc::Stats, Sub_Rect_Alloc::Stats,
+  Isect_Alloc::Stats, Cont_PPair_Alloc::Stats, Cont_Ref_Alloc::Stats,
+  Cont_Isect_Alloc::Stats,
+  IT_Chain_Alloc<IT_D_Item<Cont_Isect_Cursor> >::Stats,
+  Cont_Alloc::Stats, Cont_Clsd_Alloc::Stats, Cont_Nest_Alloc::Stats,
+  Cont_Area_Alloc::Stats
+};
+
+static const Alloc_Trim_Func allocTrimFuncs[] = {
+  Elem_Line::TrimStore, Elem_Arc::TrimStore, Elem_Circle::TrimStore,
+  Elem::TrimAttrStore,
+  Elem_Alloc::Trim, Elem_Cursor_Alloc::Trim, Sub_Rect_Alloc::Trim,
+  Isect_Alloc::Trim, Cont_PPair_Alloc::Trim, Cont_Ref_Alloc::Trim,
+  Cont_Isect_Alloc::Trim,
+  IT_Chain_Alloc<IT_D_Item<Cont_Isect_Cursor> >::Trim,
+  Cont_Alloc::Trim, Cont_Clsd_Alloc::Trim, Cont_Nest_Alloc::Trim,
+  Cont_Area_Alloc::Trim
+};
+
+const int allocFuncCnt = sizeof(allocStatsFuncs)/sizeof(Alloc_Stats_Func);
+
+/* ---------------------------------------------------------------------- */
+
+void Contour::Alloc_Stats(IT_Alloc_Stats& st)
+{
+  st = IT_Alloc_Stats();
+  st.item_size = 1;
+
+  for (int i=0; i<allocFuncCnt; i++) {
+    IT_Alloc_Stats ast;
+    allocStatsFuncs[i](ast);
+
+    st += ast;
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Release free items, at most keep_bytes remain in total ----- */
+/* ------- The element stores come first in the budget. --------------- */
+/* ---------------------------------------------------------------------- */
+
+size_t Contour::TrimMem(size_t keep_bytes)
+{
+  size_t released = 0;
+
+  for (int i=0; i<allocFuncCnt; i++) {
+    IT_Alloc_Stats ast;
+    allocStatsFuncs[i](ast);
+
+    size_t keep = ast.Free_Bytes();
+    if (keep > keep_bytes) keep = keep_bytes;
+
+    released += allocTrimFuncs[i](keep);
+
+    allocStatsFuncs[i](ast);
+    keep_bytes -= ast.Free_Bytes();
+  }
+
+  return released;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Contour::Mem_Usage(Cont_Mem_Usage& usage) const
+{
+  Elem_C_Cursor elc(el_list);
+
+  for (;elc;++elc) {
+    const Elem& el = elc->El();
+
+    if (el.isLine())     usage.elems += sizeof(Elem_Line);
+    else if (el.isArc()) usage.elems += sizeof(Elem_Arc);
+    else                 usage.elems += sizeof(Elem_Circle);
+
+    usage.nodes += sizeof(IT_D_Item<Elem_Ref>);
+    usage.attrs += el.Attr_Mem_Size();
+    usage.infos += el.Info_Mem_Size();
+  }
+
+  if (el_rect_list) usage.rect_lists += el_rect_list->Mem_Size();
+
+  if (persistLst) usage.caches += persistLstLen * sizeof(Elem *);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+static std::atomic<Cont_Error_Handler> Panic(NULL);
+
+static thread_local Cont_Error_Handler threadPanic = NULL;
+static thread_local int lastPanic = 0;
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_On_Error(Cont_Error_Handler Error_Handler)
+{
+  Panic.store(Error_Handler);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Overrides the handler above on the calling thread only ------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Error_Handler Cont_On_Thread_Error(Cont_Error_Handler Error_Handler)
+{
+  Cont_Error_Handler prev = threadPanic;
+  threadPanic = Error_Handler;
+
+  return prev;
 }
 
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
-static void (*Panic)(int error_no) = NULL;
+int Cont_Last_Panic()
+{
+  return lastPanic;
+}
 
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
-void Cont_On_Error(void (*Error_Handler)(int error_no))
+void Cont_Reset_Panic()
 {
-  Panic = Error_Handler;
+  lastPanic = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -100,7 +238,11 @@ void Cont_On_Error(void (*Error_Handler)(int error_no))
 
 void Cont_Panic(int error_no)
 {
-  if (Panic) Panic(error_no);
+  lastPanic = error_no;
+
+  Cont_Error_Handler hnd = threadPanic ? threadPanic : Panic.load();
+
+  if (hnd) hnd(error_no);
 
   throw IllegalStateException("Cont_Panic");
   // exit(1);
@@ -112,7 +254,7 @@ void Cont_Panic(int error_no)
 
 Cont_Inert::Cont_Inert()
  : area_valid(false), inert_valid(false),
-   area(0.0), cogx(0.0), cogy(0.0), ix(0.0), iy(0.0), ixy(0.0)
+   area(0.0), cogx(0.0), cogy(0.0), ix(0.0), iy(0.0), ixy(0.0), geom()
 {
 }
 
@@ -123,7 +265,7 @@ Cont_Inert::Cont_Inert()
 Cont_Inert::Cont_Inert(const Cont_Inert& cp)
  : area_valid(cp.area_valid), inert_valid(cp.inert_valid),
    area(cp.area), cogx(cp.cogx), cogy(cp.cogy),
-   ix(cp.ix), iy(cp.iy), ixy(cp.ixy)
+   ix(cp.ix), iy(cp.iy), ixy(cp.ixy), geom()
 {
 }
 
@@ -142,6 +284,8 @@ Cont_Inert& Cont_Inert::operator=(const Cont_Inert& src)
   iy          = src.iy;
   ixy         = src.ixy;
 
+  geom.invalidate();
+
   return *this;
 }
 
@@ -202,6 +346,8 @@ void Cont_Inert::invalidate()
   ix   = 0.0;
   iy   = 0.0;
   ixy  = 0.0;  
+
+  geom.invalidate();
 }
 
 /* ---------------------------------------------------------------------- */
@@ -485,6 +631,260 @@ void Cont_Inert::calc_inert(const Cont_Area& ar)
   inert_valid = true;
 }
 
+/* ---------------------------------------------------------------------- */
+/* -------- Curvature Summary ------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Geom::Cont_Geom()
+ : valid(false), lrad_found(false), rrad_found(false),
+   min_lrad(0.0), min_rrad(0.0), min_len(0.0), turning(0.0),
+   elem_cnt(0), corner_cnt(0), corners(NULL)
+{
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- The corners refer to the source, so copies start invalid ----- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Geom::Cont_Geom(const Cont_Geom& /*cp*/)
+ : valid(false), lrad_found(false), rrad_found(false),
+   min_lrad(0.0), min_rrad(0.0), min_len(0.0), turning(0.0),
+   elem_cnt(0), corner_cnt(0), corners(NULL)
+{
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Geom::~Cont_Geom()
+{
+  if (corners) delete[] corners;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Geom& Cont_Geom::operator=(const Cont_Geom& src)
+{
+  if (&src != this) invalidate();
+
+  return *this;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Geom::invalidate()
+{
+  valid      = false;
+  lrad_found = false;
+  rrad_found = false;
+
+  min_lrad = 0.0;
+  min_rrad = 0.0;
+  min_len  = 0.0;
+  turning  = 0.0;
+
+  elem_cnt   = 0;
+  corner_cnt = 0;
+
+  if (corners) delete[] corners;
+  corners = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Combine the summary of a contour or nest, corners excepted --- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Geom::add(const Cont_Geom& src)
+{
+  if (src.lrad_found && (!lrad_found || src.min_lrad < min_lrad)) {
+    min_lrad   = src.min_lrad;
+    lrad_found = true;
+  }
+
+  if (src.rrad_found && (!rrad_found || src.min_rrad < min_rrad)) {
+    min_rrad   = src.min_rrad;
+    rrad_found = true;
+  }
+
+  if (src.elem_cnt > 0) {
+    if (elem_cnt < 1 || src.min_len < min_len) min_len = src.min_len;
+    elem_cnt += src.elem_cnt;
+  }
+
+  turning    += src.turning;
+  corner_cnt += src.corner_cnt;
+}
+
+/* ---------------------------------------------------------------------- */
+
+static bool corner_sharper(const Cont_Corner& c1, const Cont_Corner& c2)
+{
+  return fabs(c1.angle) > fabs(c2.angle);
+}
+
+void Cont_Geom::sort_corners()
+{
+  std::stable_sort(corners,corners+corner_cnt,corner_sharper);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Calculate the summary of a contour --------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Geom::calc(const Contour& cont)
+{
+  invalidate();
+
+  Elem_C_Cursor elc(cont.List());
+
+  std::vector<Cont_Corner> crnlst;
+
+  Vec2 prv_tg, tg;
+
+  for (;elc;++elc) {
+    const Elem& el = elc->El();
+
+    if (elem_cnt < 1 || el.Len() < min_len) min_len = el.Len();
+
+    if (el.Type() == Elem_Type_Arc) {
+      const Elem_Arc& elarc = (const Elem_Arc&) el;
+      double r = elarc.R();
+
+      if (elarc.Ccw()) {
+        if (!lrad_found || r < min_lrad) min_lrad = r;
+        lrad_found = true;
+      }
+      else {
+        if (!rrad_found || r < min_rrad) min_rrad = r;
+        rrad_found = true;
+      }
+    }
+
+    turning += el.Span_Angle();
+
+    if (elem_cnt > 0) {
+      double ang = prv_tg.angleTo2(el.Start_Tangent_XY(tg));
+
+      turning += ang;
+
+      if (fabs(ang) > Vec2::identDir()) {
+        Cont_Corner crn = { &cont, el.Begin_Par(), ang };
+        crnlst.push_back(crn);
+      }
+    }
+
+    el.End_Tangent_XY(prv_tg);
+    ++elem_cnt;
+  }
+
+  if (cont.Closed() && elem_cnt > 0) {
+    elc.To_Begin();
+    const Elem& el = elc->El();
+
+    double ang = prv_tg.angleTo2(el.Start_Tangent_XY(tg));
+
+    turning += ang;
+
+    if (fabs(ang) > Vec2::identDir()) {
+      Cont_Corner crn = { &cont, el.Begin_Par(), ang };
+      crnlst.push_back(crn);
+    }
+  }
+
+  corner_cnt = (int)crnlst.size();
+
+  if (corner_cnt > 0) {
+    corners = new Cont_Corner[corner_cnt];
+    std::copy(crnlst.begin(),crnlst.end(),corners);
+    sort_corners();
+  }
+
+  valid = true;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Combine the summaries of the contours of a nest -------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Geom::calc(const Cont_Nest& nest)
+{
+  invalidate();
+
+  Cont_Clsd_C_Cursor cc(nest.List());
+
+  for (;cc;++cc) add(cc->Geom());
+
+  if (corner_cnt > 0) {
+    corners = new Cont_Corner[corner_cnt];
+
+    int cnt = 0;
+
+    for (cc.To_Begin();cc;++cc) {
+      const Cont_Geom& cg = cc->Geom();
+
+      std::copy(cg.corners,cg.corners+cg.corner_cnt,corners+cnt);
+      cnt += cg.corner_cnt;
+    }
+
+    sort_corners();
+  }
+
+  valid = true;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Combine the summaries of the nests of an area ---------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Geom::calc(const Cont_Area& ar)
+{
+  invalidate();
+
+  Cont_Nest_C_Cursor nsc(ar);
+
+  for (;nsc;++nsc) add(nsc->Geom());
+
+  if (corner_cnt > 0) {
+    corners = new Cont_Corner[corner_cnt];
+
+    int cnt = 0;
+
+    for (nsc.To_Begin();nsc;++nsc) {
+      const Cont_Geom& ng = nsc->Geom();
+
+      std::copy(ng.corners,ng.corners+ng.corner_cnt,corners+cnt);
+      cnt += ng.corner_cnt;
+    }
+
+    sort_corners();
+  }
+
+  valid = true;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Number of corners turning more than min_ang ------------------ */
+/* ---------------------------------------------------------------------- */
+
+int Cont_Geom::Corner_Cnt(double min_ang) const
+{
+  int lo = 0, hi = corner_cnt;
+
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+
+    if (fabs(corners[mid].angle) > min_ang) lo = mid + 1;
+    else hi = mid;
+  }
+
+  return lo;
+}
+
 /* ---------------------------------------------------------------------- */
 /* ------- Calculate tangents etc. -------------------------------------- */
 /* ---------------------------------------------------------------------- */
@@ -493,7 +893,7 @@ bool Cont_Pnt::calc_point_attr()
 {
   const Elem& el = elemc->El();
 
-  if (rel_par < Vec2::IdentDist) {
+  if (rel_par < Vec2::identDist()) {
     at_joint = true;
 
     el.Start_Tangent(tg_aft);
@@ -505,13 +905,13 @@ bool Cont_Pnt::calc_point_attr()
     curve_bef = curve_aft;
 
     const Elem& prvel = elemc.Pred()->El();
-    if (prvel.P2().distTo2(el.P1()) < Vec2::IdentDist) {
+    if (prvel.P2().distTo2(el.P1()) < Vec2::identDist()) {
       prvel.End_Tangent(tg_bef);
       prvel.End_Tangent_XY(tg_bef_xy);
       curve_bef = prvel.End_Curve();
     }
   }
-  else if (el.Par_Len() - rel_par < Vec2::IdentDist) {
+  else if (el.Par_Len() - rel_par < Vec2::identDist()) {
     at_joint = true;
 
     el.End_Tangent(tg_bef);
@@ -519,7 +919,7 @@ bool Cont_Pnt::calc_point_attr()
     curve_bef = el.End_Curve();
 
     const Elem& nxtel = elemc.Succ()->El();
-    if (nxtel.P1().distTo2(el.P2()) < Vec2::IdentDist) {
+    if (nxtel.P1().distTo2(el.P2()) < Vec2::identDist()) {
       nxtel.Start_Tangent(tg_aft);
       nxtel.Start_Tangent_XY(tg_aft_xy);
       curve_aft = nxtel.Start_Curve();
@@ -558,8 +958,8 @@ bool Cont_Pnt::to_par(double par)
   double begpar = mycnt->Begin_Par();
   double endpar = mycnt->End_Par();
 
-  if (par < begpar-Vec2::IdentDist ||
-                             par > endpar + Vec2::IdentDist) return false;
+  if (par < begpar-Vec2::identDist() ||
+                             par > endpar + Vec2::identDist()) return false;
 
   if (par < begpar) par = begpar;
   else if (par >= endpar) {
@@ -792,9 +1192,9 @@ bool Cont_Pnt::operator==(const Cont_Pnt& pnt) const
 {
   double pdist;
 
-  if (Par_Dist_To(pnt,pdist) && fabs(pdist) < Vec2::IdentDist) return true;
+  if (Par_Dist_To(pnt,pdist) && fabs(pdist) < Vec2::identDist()) return true;
   if (pnt.Par_Dist_To(*this,pdist) &&
-                                fabs(pdist) < Vec2::IdentDist) return true;
+                                fabs(pdist) < Vec2::identDist()) return true;
 
   return false;
 }
@@ -917,7 +1317,7 @@ bool Cont_Pnt::Contiguous_Upto(const Cont_Pnt& upto, double tol) const
   if (!elemc || !upto.elemc)
                                       return false;
 
-  if (fabs(pardist) <= Vec2::IdentDist)
+  if (fabs(pardist) <= Vec2::identDist())
                                        return true;
 
   if (elemc == upto.elemc) return true;
@@ -957,7 +1357,7 @@ bool Cont_Pnt::Contiguous_Upto(const Cont_Pnt& upto, double tol,
 
   elc = elemc;
 
-  if (fabs(pardist) <= Vec2::IdentDist) return true;
+  if (fabs(pardist) <= Vec2::identDist()) return true;
 
   if (elemc == upto.elemc) return true;
 
@@ -993,7 +1393,7 @@ bool Cont_Pnt::Extract_Upto(const Cont_Pnt& upto, Contour& into) const
 
   if (!elemc || !upto.elemc) return false;
 
-  if (fabs(pardist) >= Vec2::IdentDist) {
+  if (fabs(pardist) >= Vec2::identDist()) {
 
     Elem_Cursor intoc(into.el_list);
 
@@ -1964,7 +2364,7 @@ bool Contour::FindClosedRange(const Elem_C_Cursor& elc,
 {
   if (!elc || elc.Container() != &el_list) return false;
 
-  double sqTol = sqr(Vec2::IdentDist * 2.0);
+  double sqTol = sqr(Vec2::identDist() * 2.0);
 
   if (elc->El().Type() == Elem_Type_Circle) {
     bElc = elc;
@@ -2488,6 +2888,8 @@ double Contour::End_Par() const
 
 void Contour::Begin_Par(double par)
 {
+  inert.geom.invalidate(); // Corner parameters
+
   Elem_Cursor elc(el_list);
 
   for (;elc;++elc) {
@@ -2509,10 +2911,10 @@ bool Contour::At_Par(double par, Vec3& p) const
   Elem_C_Cursor elc(el_list); elc.To_Last();
   if (!elc) return false;
 
-  double epar = elc->El().End_Par() + Vec2::IdentDist;
+  double epar = elc->El().End_Par() + Vec2::identDist();
 
   elc.To_Begin();
-  double spar = elc->El().Begin_Par() - Vec2::IdentDist;
+  double spar = elc->El().Begin_Par() - Vec2::identDist();
   
   if (par < spar || par > epar) return false;
 
@@ -2576,6 +2978,17 @@ const Cont_Inert& Contour::Inert() const
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
+const Cont_Geom& Contour::Geom() const
+{
+  if (!inert.geom.valid) inert.geom.calc(*this);
+
+  return inert.geom;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
 bool Contour::Set_Elem_Id(const Elem_C_Cursor& elc, int newId)
 {
   if (!elc) return false;
@@ -2736,6 +3149,54 @@ void Contour::Find_First_Cnt_Id_With(int id, Elem_Cursor& elc) const
   }
 }
 
+/* ---------------------------------------------------------------------- */
+/* ------- Element attribute table -------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Contour::Get_Attrs(Cont_Attr_Table& tbl) const
+{
+  tbl.Default(Elem_Attr());
+  tbl.Resize(el_list.Length());
+
+  Elem_C_Cursor elc(el_list);
+
+  for (int idx=0; elc; ++elc, ++idx) {
+    const Elem& el = elc->El();
+    if (el.Has_Attr()) tbl.Set(idx,el.Attr());
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Contour::Set_Attrs(const Cont_Attr_Table& tbl)
+{
+  Elem_Cursor elc(el_list);
+
+  Elem_Attr attr;
+
+  for (int idx=0; elc; ++elc, ++idx) {
+    if (idx < tbl.Size()) tbl.Get(idx,attr);
+    else attr = tbl.Default();
+
+    elc->El().Attr(attr);
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Contour::Strip_Attrs(Cont_Attr_Table& tbl)
+{
+  Get_Attrs(tbl);
+
+  Elem_Cursor elc(el_list);
+
+  for (;elc;++elc) elc->El().Del_Attr();
+}
+
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
@@ -2820,7 +3281,7 @@ bool Contour::Project_Pnt_XY(const Vec2& p, Cont_Pnt& cntp,
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
-static void join_to_prv(Elem_Cursor& olc, double tol = 10.0 * Vec2::IdentDist)
+static void join_to_prv(Elem_Cursor& olc, double tol = 10.0 * Vec2::identDist())
 {
   if (!olc) return;
 
@@ -2843,7 +3304,7 @@ static void connect_begin(Elem_Cursor& olc)
 
   Elem& prvel = olc.Pred()->El();
 
-  if (olc->El().P1().distTo2(prvel.P2()) > 10.0 * Vec2::IdentDist)
+  if (olc->El().P1().distTo2(prvel.P2()) > 10.0 * Vec2::identDist())
                                        Cont_Panic(Cont_Large_Connect_Gap);
 
   olc->El().Stretch_Begin_XY(prvel.P2());
@@ -2873,20 +3334,20 @@ static void connect_up(Elem_C_Cursor& ilc, Elem_Cursor& olc,
 
   if (tg_bef.oppositeTo2(tg_aft)) {
     if (offdist > 0.0)
-         insert_arc = curel.Start_Curve() > -prvel.End_Curve()-Vec2::IdentDist;
-    else insert_arc = curel.Start_Curve() < -prvel.End_Curve()+Vec2::IdentDist; 
+         insert_arc = curel.Start_Curve() > -prvel.End_Curve()-Vec2::identDist();
+    else insert_arc = curel.Start_Curve() < -prvel.End_Curve()+Vec2::identDist(); 
   }
   else {
     arclen_est = nrm_bef * tg_aft * offdist;
 
-    if (arclen_est < -5.0 * Vec2::IdentDist) insert_arc = true;
-    else if (arclen_est < 5.0 * Vec2::IdentDist) stretch = true;
+    if (arclen_est < -5.0 * Vec2::identDist()) insert_arc = true;
+    else if (arclen_est < 5.0 * Vec2::identDist()) stretch = true;
     
     if (stretch && tg_bef * tg_aft < 0.0) {
       stretch = false;
       
       if (arclen_est < 0.0) {
-        if (fabs(Vec2::Pi*offdist) > 5.0*Vec2::IdentDist) insert_arc = true;
+        if (fabs(Vec2::Pi*offdist) > 5.0*Vec2::identDist()) insert_arc = true;
         else stretch = true;
       }
     }
@@ -2906,7 +3367,7 @@ static void connect_up(Elem_C_Cursor& ilc, Elem_Cursor& olc,
     if (missing) {
       Elem_Cursor olc2(olc); olc2.To_Begin();
       if (olc2 != olc) {  // This new arc is not the first element
-        double tol = 10.0 * Vec2::IdentDist;
+        double tol = 10.0 * Vec2::identDist();
         if (missing_len < tol) join_to_prv(olc,3.0*tol);
       }
       else {
@@ -3214,8 +3675,8 @@ static bool check_join(Elem_Cursor& olc, double minlen,
 
 static void process_adjacent(Elem_List& olst, bool closed)
 {
-  double ident_sq = sqr(Vec2::IdentDist);
-  double minlen   = 3.0 * Vec2::IdentDist; // Minimum element length
+  double ident_sq = sqr(Vec2::identDist());
+  double minlen   = 3.0 * Vec2::identDist(); // Minimum element length
 
   Elem_Cursor olc(olst);
 
@@ -3238,10 +3699,10 @@ static void process_adjacent(Elem_List& olst, bool closed)
 
     if (!prvel.Project_Pnt_Strict_XY(curel.P1(),0.0,prvpp,
                                               prvparm,prvdist_xy) ||
-                              fabs(prvdist_xy) > Vec2::IdentDist) continue;
+                              fabs(prvdist_xy) > Vec2::identDist()) continue;
     
     if (!curel.Project_Pnt_Strict_XY(prvel.P2(),0.0,curpp,curparm,curdist_xy) ||
-                              fabs(curdist_xy) > Vec2::IdentDist) continue;
+                              fabs(curdist_xy) > Vec2::identDist()) continue;
                                  
 
     // Check halfway prvparm and curparm as well
@@ -3253,7 +3714,7 @@ static void process_adjacent(Elem_List& olst, bool closed)
 
     if (!curel.At_Par(midparm1,pt1)) continue;
     if (!prvel.Project_Pnt_Strict_XY(pt1,0.0,pp1,midparm1,dist_xy1) ||
-                               fabs(dist_xy1) > Vec2::IdentDist) continue;
+                               fabs(dist_xy1) > Vec2::identDist()) continue;
 
     double dist_xy2;
     Vec3 pt2,pp2;
@@ -3262,7 +3723,7 @@ static void process_adjacent(Elem_List& olst, bool closed)
 
     if (!prvel.At_Par(midparm2,pt2)) continue;
     if (!curel.Project_Pnt_Strict_XY(pt2,0.0,pp2,midparm2,dist_xy2) ||
-                               fabs(dist_xy2) > Vec2::IdentDist) continue;
+                               fabs(dist_xy2) > Vec2::identDist()) continue;
 
 
     if (check_join(olc, minlen, prvparm, curparm)) continue;
@@ -3325,20 +3786,20 @@ static void connect_up_last(Elem_C_Cursor& ilc, Elem_Cursor& olc,
 
   if (tg_bef.oppositeTo2(tg_aft)) {
     if (offdist > 0.0)
-         insert_arc = curel.Start_Curve() > -prvel.End_Curve()-Vec2::IdentDist;
-    else insert_arc = curel.Start_Curve() < -prvel.End_Curve()+Vec2::IdentDist; 
+         insert_arc = curel.Start_Curve() > -prvel.End_Curve()-Vec2::identDist();
+    else insert_arc = curel.Start_Curve() < -prvel.End_Curve()+Vec2::identDist(); 
   }
   else {
     arclen_est = nrm_bef * tg_aft * offdist;
 
-    if (arclen_est < -5.0 * Vec2::IdentDist) insert_arc = true;
-    else if (arclen_est < 5.0 * Vec2::IdentDist) stretch = true;
+    if (arclen_est < -5.0 * Vec2::identDist()) insert_arc = true;
+    else if (arclen_est < 5.0 * Vec2::identDist()) stretch = true;
     
     if (stretch && tg_bef * tg_aft < 0.0) {
       stretch = false;
       
       if (arclen_est < 0.0) {
-        if (fabs(Vec2::Pi*offdist) > 5.0*Vec2::IdentDist) insert_arc = true;
+        if (fabs(Vec2::Pi*offdist) > 5.0*Vec2::identDist()) insert_arc = true;
         else stretch = true;
       }
     }
@@ -3360,7 +3821,7 @@ static void connect_up_last(Elem_C_Cursor& ilc, Elem_Cursor& olc,
 
     if (missing) {
       if (listlen > 1) {  // This new arc is not the first element
-        double tol = 10.0 * Vec2::IdentDist;
+        double tol = 10.0 * Vec2::identDist();
         if (missing_len < tol) join_to_prv(olc2,2.0*tol);
       }
     }
@@ -3390,9 +3851,10 @@ static void connect_up_last(Elem_C_Cursor& ilc, Elem_Cursor& olc,
 static Elem_List last_offset1, last_offset2;
 
 static void offset_elems(const Elem_List& ilst, bool closed,
-                                            double offdist, Elem_List& olst)
+                         double offdist, Elem_List& olst,
+                         bool open_ends = false)
 {
-  double tol = 10.0 * Vec2::IdentDist;
+  double tol = 10.0 * Vec2::identDist();
 
   olst.Delete();
   Elem_Cursor olc(olst);
@@ -3469,23 +3931,24 @@ static void offset_elems(const Elem_List& ilst, bool closed,
     lastpt = nextpt;
   }
 
-  ilc.To_Begin();
-  if (first_missing) olc.To_End();
-  else               olc.To_Begin();
+  if (!open_ends) { // Offset_Open_Into caps the ends instead
+    ilc.To_Begin();
+    if (first_missing) olc.To_End();
+    else               olc.To_Begin();
 
-  connect_up_last(ilc,olc,lastpt,first_curpt,offdist,missing,missing_len);
+    connect_up_last(ilc,olc,lastpt,first_curpt,offdist,missing,missing_len);
 
-  if (missing || first_missing) {
-     missing_len += first_missing_len;
-     missing = true;
-  }
+    if (missing || first_missing) {
+       missing_len += first_missing_len;
+       missing = true;
+    }
   
-  if (missing && missing_len < tol) {
-    olc.To_Begin();
-    if (olst.Length() > 1) join_to_prv(olc,2.0*tol);
+    if (missing && missing_len < tol) {
+      olc.To_Begin();
+      if (olst.Length() > 1) join_to_prv(olc,2.0*tol);
+    }
   }
 
-
 //Tijdelijk
    last_offset1 = olst;
    
@@ -3504,12 +3967,14 @@ static void offset_elems(const Elem_List& ilst, bool closed,
 
 bool Contour::Offset_Into(double offdist, Cont_List& cnt_list) const
 {
+  TraceScope trc("Contour::Offset_Into",Elem_Count());
+
   cnt_list.contlst.Delete();
   cnt_list.calc_invar();
 
   if (Empty()) return false;
 
-  if (fabs(offdist) < Vec2::IdentDist) {
+  if (fabs(offdist) < Vec2::identDist()) {
     Cont_Cursor cc(cnt_list.contlst);
 
     cc.Insert(*this);
@@ -3552,6 +4017,138 @@ bool Contour::Offset_Into(double offdist, Cont_List& cnt_list) const
   return true;
 }
 
+/* ---------------------------------------------------------------------- */
+/* ------- Caps at both ends of the offset of an open contour ----------- */
+/* ---------------------------------------------------------------------- */
+
+static void copy_cap_attrs(const Elem& src, Elem& cap)
+{
+  cap.Id(src.Id());
+  cap.Cnt_Id(src.Cnt_Id());
+  cap.P_Cnt_Id(src.P_Cnt_Id());
+  cap.Cam_Inf(src.Cam_Inf());
+  cap.setInsArc(true);
+}
+
+static void add_offset_caps(const Elem_List& ilst, double offdist,
+                            Contour::Cap_Type cap, Elem_List& olst)
+{
+  if (cap == Contour::Cap_Butt || ilst.Length() < 1 || olst.Length() < 1)
+                                                                     return;
+  double absdist = fabs(offdist);
+
+  // Begin cap, from behind the first input point up to the offset
+
+  const Elem& iel1 = ilst.Begin()->El();
+  Vec2 tg1; iel1.Start_Tangent_XY(tg1);
+
+  Elem_Cursor olc(olst);
+  Vec3 begp = olc->El().P1();
+  Vec3 capp(Vec2(begp) - tg1 * absdist, begp.z);
+
+  if (cap == Contour::Cap_Extended) {
+    Elem_Line newln(capp,begp);
+    copy_cap_attrs(iel1,newln);
+
+    olc.Insert(newln);
+  }
+  else {
+    Vec3 cntr = iel1.P1();
+    Vec3 arcp(Vec2(cntr) - tg1 * absdist, begp.z);
+
+    Elem_Arc newarc(arcp,begp,cntr,offdist < 0.0);
+    newarc.Stretch_End_XY(begp,true);
+    copy_cap_attrs(iel1,newarc);
+
+    olc.Insert(newarc);
+  }
+
+  // End cap, from the offset to beyond the last input point
+
+  Elem_C_Cursor ilc(ilst); ilc.To_Last();
+  const Elem& ieln = ilc->El();
+  Vec2 tgn; ieln.End_Tangent_XY(tgn);
+
+  olc.To_Last();
+  Vec3 endp = olc->El().P2();
+
+  olc.To_End();
+
+  if (cap == Contour::Cap_Extended) {
+    Elem_Line newln(endp,Vec3(Vec2(endp) + tgn * absdist, endp.z));
+    copy_cap_attrs(ieln,newln);
+
+    olc.Insert(newln);
+  }
+  else {
+    Vec3 cntr = ieln.P2();
+    Vec3 arcp(Vec2(cntr) + tgn * absdist, endp.z);
+
+    Elem_Arc newarc(endp,arcp,cntr,offdist < 0.0);
+    newarc.Stretch_Begin_XY(endp,true);
+    copy_cap_attrs(ieln,newarc);
+
+    olc.Insert(newarc);
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+bool Contour::Offset_Open_Into(double offdist, Cont_List& cnt_list,
+                                                      Cap_Type cap) const
+{
+  TraceScope trc("Contour::Offset_Open_Into",Elem_Count());
+
+  cnt_list.contlst.Delete();
+  cnt_list.calc_invar();
+
+  if (Empty()) return false;
+
+  if (fabs(offdist) < Vec2::identDist()) {
+    Cont_Cursor cc(cnt_list.contlst);
+
+    cc.Insert(*this);
+
+    cnt_list.calc_invar();
+    
+    return true;
+  }
+
+  Contour offcnt;
+
+  offset_elems(el_list, false, offdist, offcnt.el_list, true);
+  add_offset_caps(el_list, offdist, cap, offcnt.el_list);
+
+  offcnt.calc_invar();
+  offcnt.is_closed = false;
+
+  offcnt.Begin_Par(0.0);
+
+  Cont_Ref offref(offcnt,false);
+
+  Cont1_Isect_List isect(offref, false, offdist > 0.0, false);
+
+  Cont_D_List offlist;
+  isect.Extract_Offset_Open(*this,offdist,offlist);
+
+  Cont_Cursor cc(cnt_list.contlst);
+  Cont_Cursor oc(offlist);
+
+  for (;oc;++oc) {
+    cc.To_End();
+    cc.Insert(Contour());
+
+    oc->Move_To(*cc);
+    cc->calc_invar();
+  }
+
+  cnt_list.calc_invar();
+
+  return true;
+}
+
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
@@ -3575,7 +4172,7 @@ bool Contour::Offset_Into(double offdist, Cont_List& cnt_list,
 static void offsetElemsSingle(const Elem_List& ilst, bool closed,
                                             double offdist, Elem_List& olst)
 {
-  double tol = 10.0 * Vec2::IdentDist;
+  double tol = 10.0 * Vec2::identDist();
 
   olst.Delete();
   Elem_Cursor olc(olst);
@@ -3793,7 +4390,7 @@ bool Contour::OffsetSingle_Into(double offdist, Contour& cnt,
 
   if (Empty()) return false;
 
-  if (fabs(offdist) < Vec2::IdentDist) {
+  if (fabs(offdist) < Vec2::identDist()) {
     cnt = *this;
     return true;
   }
@@ -3824,7 +4421,7 @@ bool Contour::Offset_Back(double offdist, Contour& bcnt) const
 
   if (Empty()) return false;
 
-  if (fabs(offdist) < Vec2::IdentDist) {
+  if (fabs(offdist) < Vec2::identDist()) {
     bcnt = *this;
     
     return true;
@@ -3850,7 +4447,7 @@ bool Contour::Split_At(Cont_Pnt& p)
 
   if (p.At_Joint()) {
     const Elem& el = p.elemc->El();
-    if (el.Par_Len() - p.rel_par < Vec2::IdentDist) {
+    if (el.Par_Len() - p.rel_par < Vec2::identDist()) {
       p.rel_par -= el.Par_Len();
       ++p.elemc; if (!p.elemc) p.elemc.To_Begin();
     }
@@ -3950,6 +4547,7 @@ void Contour::Reverse()
   inval_rects();
 
   if (inert.area_valid) inert.area = -inert.area;
+  inert.geom.invalidate();
 
   double beginpar = Begin_Par();
 
@@ -3995,67 +4593,112 @@ void Contour::Del_Info()
 }
 
 /* ---------------------------------------------------------------------- */
+/* ------- Merge Elements ----------------------------------------------- */
 /* ---------------------------------------------------------------------- */
+/* ------- A single pass: an element is merged into its predecessor ----- */
+/* ------- in place (collinear lines, co-circular arcs) and the grown --- */
+/* ------- predecessor is tried against its own predecessor again. ------ */
+/* ------- Then the short elements are removed. Both steps only move ---- */
+/* ------- list items, with dead given the removed items are parked ----- */
+/* ------- there instead of deleted, so the pass may run on any thread. - */
+/* ------- A merge into a circle needs a new element, with dead the ----- */
+/* ------- pass then stops; repeating it completes the merge, as all ---- */
+/* ------- element pairs before the stop were already tried. ------------ */
 /* ---------------------------------------------------------------------- */
 
-void Contour::Merge_Elems(bool limit_arcs)
+enum { Merge_Modified = 1, Merge_Short = 2, Merge_Arcs = 4,
+       Merge_Unfinished = 8 };
+
+int Contour::merge_pass(Elem_List *dead)
 {
-  double bpar = Begin_Par();
-  
-  bool modified = false;
+  double max_elem_len  = 500.0*Vec2::identDist();
+  double max_elem_dist = 10.0*Vec2::identDist();
+
+  int state = 0;
 
   Elem_Cursor elc(el_list);
 
   while (elc) {
+    Elem& el = elc->El();
+
+    // Every element is seen here in its final shape
+
+    if (el.Len_XY() < max_elem_len) state |= Merge_Short;
+    if (el.Type() != Elem_Type_Line) state |= Merge_Arcs;
+
     Elem_Cursor prvelc(elc);
-    --prvelc; if (!prvelc) prvelc.To_Last();
+    --prvelc;
+
+    bool wrap = !prvelc;
+    if (wrap) prvelc.To_Last();
     
     if (prvelc == elc) break;
 
-    Elem *newel = NULL;
+    Elem& prvel = prvelc->El();
 
-    if (elc->El().Type() == prvelc->El().Type()) {
+    bool merged = false;
 
-      switch (elc->El().Type()) {
+    if (el.Type() == prvel.Type()) {
+
+      switch (el.Type()) {
         case Elem_Type_Line:
-          { Elem_Line& lin    = (Elem_Line&)elc->El();
-            Elem_Line& prvlin = (Elem_Line&)prvelc->El();
+          { Elem_Line& lin    = (Elem_Line&)el;
+            Elem_Line& prvlin = (Elem_Line&)prvel;
 
-            newel = prvlin.Merge_With(lin);
+            merged = prvlin.Can_Merge(lin);
+            if (merged) prvlin.Absorb(lin);
           }
         break;
         
         case Elem_Type_Arc:
-          { Elem_Arc& arc    = (Elem_Arc&)elc->El();
-            Elem_Arc& prvarc = (Elem_Arc&)prvelc->El();
+          { Elem_Arc& arc    = (Elem_Arc&)el;
+            Elem_Arc& prvarc = (Elem_Arc&)prvel;
+
+            bool to_circle = false;
+            merged = prvarc.Can_Merge(arc,to_circle);
+
+            if (merged && to_circle) {
+              if (dead) return state | Merge_Unfinished;
 
-            newel = prvarc.Merge_With(arc);
+              prvelc->setElem(prvarc.Merge_With(arc));
+            }
+            else if (merged) prvarc.Absorb(arc);
           }
         break;
       }
     }
 
-    if (newel) {
-      modified = true;
-      
-      prvelc.Delete();
-      elc.Delete();
-      
-      elc.Insert(*newel);
-      
-      delete newel;
+    if (merged) {
+      state |= Merge_Modified;
+
+      if (dead) dead->End().Re_Insert(elc);
+      else elc.Delete();
+
+      if (wrap) prvelc.Become_First(); // Merged the first into the last
+
+      elc = prvelc;
     }
     else ++elc;
   }
 
-  // Now try to remove short elements
-  double max_elem_len  = 500.0*Vec2::IdentDist;
-  double max_elem_dist = 10.0*Vec2::IdentDist;
-  
-  if (Remove_Short_Elems(elc,max_elem_len,max_elem_dist)) modified = true;
-  
-  if (limit_arcs) {
-    elc.To_Begin();
+  if (state & Merge_Short) {
+    if (Remove_Short_Elems(elc,max_elem_len,max_elem_dist,dead))
+                                                    state |= Merge_Modified;
+  }
+
+  return state;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Arc limiting and invariants after merge_pass, allocates ------ */
+/* ---------------------------------------------------------------------- */
+
+void Contour::merge_finish(int state, bool limit_arcs, double bpar)
+{
+  bool modified = (state & Merge_Modified) != 0;
+
+  if (limit_arcs && (state & Merge_Arcs)) {
+    Elem_Cursor elc(el_list);
 
     while (elc) {
       if (elc->El().Type() == Elem_Type_Arc) {
@@ -4095,6 +4738,72 @@ void Contour::Merge_Elems(bool limit_arcs)
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
+void Contour::Merge_Elems(bool limit_arcs)
+{
+  double bpar = Begin_Par();
+
+  merge_finish(merge_pass(NULL),limit_arcs,bpar);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Merge the elements of cnt contours on the shared task pool --- */
+/* ---------------------------------------------------------------------- */
+/* ------- The passes run in parallel, each contour on one thread. ------ */
+/* ------- Deleting the parked items, unfinished passes and the arc ----- */
+/* ------- limiting are done after that by the calling thread, so the --- */
+/* ------- result is that of Merge_Elems on each contour. --------------- */
+/* ---------------------------------------------------------------------- */
+
+const long Cont_Merge_Par_Min_Elems = 16384;
+
+void Contour::merge_all(Contour **conts, int cnt, bool limit_arcs)
+{
+  long elemCnt = 0;
+  for (int i=0; i<cnt; ++i) elemCnt += conts[i]->Elem_Count();
+
+  long thrCnt = elemCnt / Cont_Merge_Par_Min_Elems;
+
+  if (thrCnt > cnt) thrCnt = cnt;
+
+  if (thrCnt < 2) {
+    for (int i=0; i<cnt; ++i) conts[i]->Merge_Elems(limit_arcs);
+    return;
+  }
+
+  TraceScope trc("Contour::Merge_Elems(parallel)",elemCnt);
+
+  std::vector<double> bpars(cnt);
+  std::vector<int> states(cnt,0);
+
+  Elem_List *dead = new Elem_List[cnt];
+
+  for (int i=0; i<cnt; ++i) bpars[i] = conts[i]->Begin_Par();
+
+  try {
+    parallelFor(cnt,(int)thrCnt,[&](int i) {
+      states[i] = conts[i]->merge_pass(dead + i);
+    });
+  }
+  catch (...) {
+    delete[] dead;
+    throw;
+  }
+
+  delete[] dead;
+
+  for (int i=0; i<cnt; ++i) {
+    int state = states[i];
+
+    if (state & Merge_Unfinished) state |= conts[i]->merge_pass(NULL);
+
+    conts[i]->merge_finish(state,limit_arcs,bpars[i]);
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
 void Contour::Set_Elem_Z(double newz)
 {
   Elem_Cursor elc(el_list);
@@ -4162,26 +4871,7 @@ void Contour::Start_Outside(const Rect_Ax& rct)
 
 bool Contour::Min_Left_Rad(double& min_rad) const
 {
-  min_rad = 0.0;
-  
-  Elem_C_Cursor elc(el_list);
-  
-  bool found = false;
-  
-  for (;elc;++elc) {
-    const Elem& el = (const Elem&) elc->El();
-    
-    if (el.Type() == Elem_Type_Arc) {
-      const Elem_Arc& elarc = (const Elem_Arc&) el;
-
-      if (!elarc.Ccw()) continue;
-      
-      if (!found || elarc.R() < min_rad) min_rad = elarc.R();
-      found = true;
-    }
-  }
-  
-  return found;
+  return Geom().Min_Left_Rad(min_rad);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -4191,26 +4881,7 @@ bool Contour::Min_Left_Rad(double& min_rad) const
 
 bool Contour::Min_Right_Rad(double& min_rad) const
 {
-  min_rad = 0.0;
-  
-  Elem_C_Cursor elc(el_list);
-  
-  bool found = false;
-  
-  for (;elc;++elc) {
-    const Elem& el = (const Elem&) elc->El();
-    
-    if (el.Type() == Elem_Type_Arc) {
-      const Elem_Arc& elarc = (const Elem_Arc&) el;
-
-      if (elarc.Ccw()) continue;
-      
-      if (!found || elarc.R() < min_rad) min_rad = elarc.R();
-      found = true;
-    }
-  }
-  
-  return found;
+  return Geom().Min_Right_Rad(min_rad);
 }
  
 //---------------------------------------------------------------------------
@@ -4327,7 +4998,7 @@ void Cont_Clsd::calc_invar()
     prvel->End_Tangent_XY(end_tg);
     curel->Start_Tangent_XY(st_tg);
 
-    if (end_tg.oppositeTo2(st_tg,10.0*Vec2::IdentDir)) {
+    if (end_tg.oppositeTo2(st_tg,10.0*Vec2::identDir())) {
 //      if (prvel->End_Curve() < curel->Start_Curve()) angle += Vec2::Pi;
 //      else angle -= Vec2::Pi;
 
@@ -4532,7 +5203,7 @@ bool Cont_Clsd::Offset_Into(double offdist, Cont_Area& ar) const
 
   if (Empty()) return false;
 
-  if (fabs(offdist) < Vec2::IdentDist) { // Just copy
+  if (fabs(offdist) < Vec2::identDist()) { // Just copy
     Cont_Nest_Cursor nstc(ar.nestlst);
     nstc.Insert(Cont_Nest());
 
@@ -4954,7 +5625,7 @@ bool Cont_List::Project_Pnt_XY(const Vec2& p, Cont_Pnt& cntp,
   ++cc; if (!cc) cc.To_Begin();
 
   while (cc != mincc) {
-    if (cc->Rect().Dist_To_XY(p) < fabs(dist_xy) + Vec2::IdentDist) {
+    if (cc->Rect().Dist_To_XY(p) < fabs(dist_xy) + Vec2::identDist()) {
       Cont_Pnt curpnt;
       double curdist;
 
@@ -5023,9 +5694,29 @@ void Cont_List::Del_Info()
 
 void Cont_List::Merge_Elems(bool limit_arcs)
 {
+  std::vector<Contour *> conts;
+  conts.reserve(contlst.Length());
+
   Cont_Cursor cc(contlst);
 
-  for (;cc;++cc) cc->Merge_Elems(limit_arcs);
+  for (;cc;++cc) conts.push_back(&*cc);
+
+  if (!conts.empty())
+      Contour::merge_all(&conts[0],(int)conts.size(),limit_arcs);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_List::Mem_Usage(Cont_Mem_Usage& usage) const
+{
+  Cont_C_Cursor cc(contlst);
+
+  for (;cc;++cc) {
+    usage.nodes += sizeof(IT_D_Item<Contour>);
+    cc->Mem_Usage(usage);
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -5282,6 +5973,8 @@ int Cont_Nest::Elem_Count() const
 
 void Cont_Nest::Begin_Par(double par)
 {
+  inert.geom.invalidate(); // Corner parameters
+
   Cont_Clsd_Cursor cc(contlst);
 
   for (;cc;++cc) {
@@ -5408,6 +6101,17 @@ const Cont_Inert& Cont_Nest::Inert() const
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
+const Cont_Geom& Cont_Nest::Geom() const
+{
+  if (!inert.geom.valid) inert.geom.calc(*this);
+
+  return inert.geom;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
 bool Cont_Nest::Project_Pnt_XY(const Vec2& p, Cont_Pnt& cntp,
                                                  double& dist_xy) const
 {
@@ -5440,7 +6144,7 @@ bool Cont_Nest::Project_Pnt_XY(const Vec2& p, Cont_Pnt& cntp,
   cc = mincc;
 
   do {
-    if (cc->Rect().Dist_To_XY(p) < fabs(dist_xy) + Vec2::IdentDist) {
+    if (cc->Rect().Dist_To_XY(p) < fabs(dist_xy) + Vec2::identDist()) {
       Cont_Pnt curpnt;
       double curdist;
 
@@ -5476,7 +6180,7 @@ bool Cont_Nest::Offset_Into(double offdist, Cont_Area& ar_list) const
 
   if (Empty()) return false;
 
-  if (fabs(offdist) < Vec2::IdentDist) {  // Just copy
+  if (fabs(offdist) < Vec2::identDist()) {  // Just copy
     Cont_Nest_Cursor nsc(ar_list.nestlst);
 
     nsc.Insert(*this);
@@ -5555,6 +6259,7 @@ void Cont_Nest::Reverse()
   lccw = !lccw;
 
   if (inert.area_valid) inert.area = -inert.area;
+  inert.geom.invalidate();
 }
 
 /* ---------------------------------------------------------------------- */
@@ -5574,9 +6279,29 @@ void Cont_Nest::Del_Info()
 
 void Cont_Nest::Merge_Elems(bool limit_arcs)
 {
+  std::vector<Contour *> conts;
+  conts.reserve(contlst.Length());
+
   Cont_Clsd_Cursor cc(contlst);
 
-  for (;cc;++cc) cc->Merge_Elems(limit_arcs);
+  for (;cc;++cc) conts.push_back(&cc->cont);
+
+  if (!conts.empty())
+      Contour::merge_all(&conts[0],(int)conts.size(),limit_arcs);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Nest::Mem_Usage(Cont_Mem_Usage& usage) const
+{
+  Cont_Clsd_C_Cursor cc(contlst);
+
+  for (;cc;++cc) {
+    usage.nodes += sizeof(IT_D_Item<Cont_Clsd>);
+    cc->Mem_Usage(usage);
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -5590,6 +6315,21 @@ void Cont_Nest::Set_Elem_Z(double new_z)
   for (;cc;++cc) cc->Set_Elem_Z(new_z);
 }
 
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Nest::Transform(const Trf2& trf)
+{
+  Cont_Clsd_Cursor cc(contlst);
+
+  for (;cc;++cc) cc->Transform(trf);
+
+  calc_invar();
+
+  inert.invalidate();
+}
+
 /* ---------------------------------------------------------------------- */
 /* ----- Find Minimum Lefthand Arc Radius ------------------------------- */
 /* ----- Return true if found (sharp transitions may still be present!) - */
@@ -5597,22 +6337,7 @@ void Cont_Nest::Set_Elem_Z(double new_z)
 
 bool Cont_Nest::Min_Left_Rad(double& min_rad) const
 {
-  min_rad = 0.0;
-  
-  Cont_Clsd_C_Cursor cc(contlst);
-  
-  bool found = false;
-  
-  for (;cc;++cc) {
-    double crad;
-    
-    if (cc->Min_Left_Rad(crad)) {
-      if (!found || crad < min_rad) min_rad = crad;
-      found = true;
-    }
-  }
-  
-  return found;
+  return Geom().Min_Left_Rad(min_rad);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -5622,22 +6347,7 @@ bool Cont_Nest::Min_Left_Rad(double& min_rad) const
 
 bool Cont_Nest::Min_Right_Rad(double& min_rad) const
 {
-  min_rad = 0.0;
-  
-  Cont_Clsd_C_Cursor cc(contlst);
-  
-  bool found = false;
-  
-  for (;cc;++cc) {
-    double crad;
-    
-    if (cc->Min_Right_Rad(crad)) {
-      if (!found || crad < min_rad) min_rad = crad;
-      found = true;
-    }
-  }
-  
-  return found;
+  return Geom().Min_Right_Rad(min_rad);
 }
   
 /* ---------------------------------------------------------------------- */
@@ -6179,6 +6889,8 @@ int Cont_Area::Nest_Count() const
 
 void Cont_Area::Begin_Par(double par)
 {
+  inert.geom.invalidate(); // Corner parameters
+
   Cont_Nest_Cursor nsc(nestlst);
 
   for (;nsc;++nsc) {
@@ -6370,6 +7082,17 @@ const Cont_Inert& Cont_Area::Inert() const
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
+const Cont_Geom& Cont_Area::Geom() const
+{
+  if (!inert.geom.valid) inert.geom.calc(*this);
+
+  return inert.geom;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
 void Cont_Area::Remove_Inners()
 {
   Cont_Nest_Cursor nsc(nestlst);
@@ -6387,13 +7110,11 @@ void Cont_Area::Remove_Inners()
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
-bool Cont_Area::Extract_Via(const Vec2& p1, const Vec2& probedir1,
-                   const Vec2& p2, const Vec2& probedir2,
-                   Contour& path, double& pathlen) const
+bool Cont_Area::via_ends(const Vec2& p1, const Vec2& probedir1,
+                         const Vec2& p2, const Vec2& probedir2,
+                         Cont_Pnt& from, Cont_Pnt& upto, bool& rev,
+                                                   bool& along) const
 {
-  path.Delete();
-  pathlen = 0.0;
-
   Cont_Pnt pnt1, pnt2;
   double dist1, dist2, pdist1, pdist2;
 
@@ -6407,22 +7128,48 @@ bool Cont_Area::Extract_Via(const Vec2& p1, const Vec2& probedir1,
   pnt1.Par_Dist_To(pnt2,dist1);
   pnt2.Par_Dist_To(pnt1,dist2);
 
-  if (dist1 < dist2) {
-    if (dist1 > 3.0 * Vec2::IdentDist) {
-      if (!pnt1.Extract_Upto(pnt2,path)) Cont_Panic(Cont_Area_Cant_Extract);
-    }
-  }
-  else {
-    if (dist2 > 3.0 * Vec2::IdentDist) {
-      if (!pnt2.Extract_Upto(pnt1,path)) Cont_Panic(Cont_Area_Cant_Extract);
-      path.Reverse();
-    }
+  rev = dist1 >= dist2;
+
+  if (!rev) { from = pnt1; upto = pnt2; }
+  else      { from = pnt2; upto = pnt1; }
+
+  along = (rev ? dist2 : dist1) > 3.0 * Vec2::identDist();
+
+  return true;
+}
+
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Area::via_drop(double ellen)
+{
+  return ellen < 3.0 * Vec2::identDist();
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+bool Cont_Area::Extract_Via(const Vec2& p1, const Vec2& probedir1,
+                   const Vec2& p2, const Vec2& probedir2,
+                   Contour& path, double& pathlen) const
+{
+  path.Delete();
+  pathlen = 0.0;
+
+  Cont_Pnt from, upto;
+  bool rev, along;
+
+  if (!via_ends(p1,probedir1,p2,probedir2,from,upto,rev,along)) return false;
+
+  if (along) {
+    if (!from.Extract_Upto(upto,path)) Cont_Panic(Cont_Area_Cant_Extract);
+    if (rev) path.Reverse();
   }
 
   if (!path.Empty()) {
     Elem_Cursor pelc(path.el_list);
 
-    if (pelc->El().Len_XY() < 3.0 * Vec2::IdentDist) {
+    if (via_drop(pelc->El().Len_XY())) {
       pelc.Delete();
       path.inval_rects();
       path.calc_invar();
@@ -6433,9 +7180,7 @@ bool Cont_Area::Extract_Via(const Vec2& p1, const Vec2& probedir1,
 
   if (!path.Empty()) {
     Elem_Cursor pelc(path.el_list); pelc.To_Last();
-    double ellen = pelc->El().Len_XY();
-
-    if (ellen < 3.0 * Vec2::IdentDist) {
+    if (via_drop(pelc->El().Len_XY())) {
       pelc.Delete();
       path.inval_rects();
       path.calc_invar();
@@ -6451,16 +7196,16 @@ bool Cont_Area::Extract_Via(const Vec2& p1, const Vec2& probedir1,
     elc.Insert(line);
   }
   else {
-    dist1 = p1.distTo2(path.Begin_Point());
+    double dist1 = p1.distTo2(path.Begin_Point());
 
-    if (dist1 > 3.0 * Vec2::IdentDist) {
+    if (dist1 > 3.0 * Vec2::identDist()) {
       Elem_Line line1(p1,path.Begin_Point());
       elc.Insert(line1);
     }
 
-    dist2 = p2.distTo2(path.End_Point());
+    double dist2 = p2.distTo2(path.End_Point());
 
-    if (dist2 > 3.0 * Vec2::IdentDist) {
+    if (dist2 > 3.0 * Vec2::identDist()) {
       Elem_Line line2(path.Begin_Point(),p2);
       elc.To_End();
       elc.Insert(line2);
@@ -6572,13 +7317,16 @@ bool Cont_Area::Par_Dist_Along(const Vec2& sp, const Vec2& ep,
 
 bool Cont_Area::Offset_Into(double offdist, Cont_Area& ar_list) const
 {
+  TraceScope trc("Cont_Area::Offset_Into",
+                                    Trace::enabled() ? Elem_Count() : -1);
+
   ar_list.nestlst.Delete();
   ar_list.calc_invar();
   ar_list.inert.invalidate();
 
   if (Empty()) return false;
 
-  if (fabs(offdist) < Vec2::IdentDist) {  // Just copy
+  if (fabs(offdist) < Vec2::identDist()) {  // Just copy
 
     ar_list = *this;
 
@@ -6658,7 +7406,7 @@ bool Cont_Area::build_from(Cont_Clsd_D_List& cnt_list)
   while (srcc) {
     srcc->Begin_Par(0.0);
     
-    double artol = 10.0 * Vec2::IdentDist;
+    double artol = 10.0 * Vec2::identDist();
     
     if (srcc->End_Par() < artol ||
         fabs(srcc->Area_XY()/srcc->End_Par()*2.0) < artol) srcc.Delete();
@@ -6787,6 +7535,9 @@ bool Cont_Area::Combine_With(bool rev1, const Cont_Area& ar2, bool rev2,
                              bool to_left, Cont_Area& into,
                              Cont_List *rest1, Cont_List *rest2) const
 {
+  TraceScope trc("Cont_Area::Combine_With",
+           Trace::enabled() ? Elem_Count() + ar2.Elem_Count() : -1);
+
   if (&into == this || &into == &ar2) return false;
 
   into.nestlst.Delete();
@@ -6846,6 +7597,7 @@ void Cont_Area::Reverse()
   lccw = !lccw;
   
   if (inert.area_valid) inert.area = -inert.area;
+  inert.geom.invalidate();
 }
 
 /* ---------------------------------------------------------------------- */
@@ -6901,9 +7653,32 @@ void Cont_Area::Delete_Non_Unisource_Nests(int el_id)
 
 void Cont_Area::Merge_Elems(bool limit_arcs)
 {
+  std::vector<Contour *> conts;
+
   Cont_Nest_Cursor nsc(nestlst);
 
-  for (;nsc;++nsc) nsc->Merge_Elems(limit_arcs);
+  for (;nsc;++nsc) {
+    Cont_Clsd_Cursor cc(nsc->contlst);
+
+    for (;cc;++cc) conts.push_back(&cc->cont);
+  }
+
+  if (!conts.empty())
+      Contour::merge_all(&conts[0],(int)conts.size(),limit_arcs);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Cont_Area::Mem_Usage(Cont_Mem_Usage& usage) const
+{
+  Cont_Nest_C_Cursor nsc(nestlst);
+
+  for (;nsc;++nsc) {
+    usage.nodes += sizeof(IT_D_Item<Cont_Nest>);
+    nsc->Mem_Usage(usage);
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -6921,6 +7696,21 @@ void Cont_Area::Set_Elem_Z(double new_z)
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
+void Cont_Area::Transform(const Trf2& trf)
+{
+  Cont_Nest_Cursor nsc(nestlst);
+
+  for (;nsc;++nsc) nsc->Transform(trf);
+
+  calc_invar();
+
+  inert.invalidate();
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
 void Cont_Area::Start_Outside()
 {
   Cont_Nest_Cursor nsc(nestlst);
@@ -6984,22 +7774,7 @@ void Cont_Area::Filter_Arcs(bool ccw, double tol)
 
 bool Cont_Area::Min_Left_Rad(double& min_rad) const
 {
-  min_rad = 0.0;
-  
-  Cont_Nest_C_Cursor nsc(*this);
-  
-  bool found = false;
-  
-  for (;nsc;++nsc) {
-    double nrad;
-    
-    if (nsc->Min_Left_Rad(nrad)) {
-      if (!found || nrad < min_rad) min_rad = nrad;
-      found = true;
-    }
-  }
-  
-  return found;
+  return Geom().Min_Left_Rad(min_rad);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -7009,22 +7784,7 @@ bool Cont_Area::Min_Left_Rad(double& min_rad) const
 
 bool Cont_Area::Min_Right_Rad(double& min_rad) const
 {
-  min_rad = 0.0;
-  
-  Cont_Nest_C_Cursor nsc(*this);
-  
-  bool found = false;
-  
-  for (;nsc;++nsc) {
-    double nrad;
-    
-    if (nsc->Min_Right_Rad(nrad)) {
-      if (!found || nrad < min_rad) min_rad = nrad;
-      found = true;
-    }
-  }
-  
-  return found;
+  return Geom().Min_Right_Rad(min_rad);
 }
 
 } // namespace Ino
@@ -22,7 +22,7 @@ bool Pt_Inside(const Vec2& p, const Cont_Clsd& cnt, bool& on_cnt)
 {
   on_cnt = false;
 
-  if (cnt.Rect().Point_Inside(p,Vec2::IdentDist)) {
+  if (cnt.Rect().Point_Inside(p,Vec2::identDist())) {
     Cont_Pnt pnt;
     double   dist;
 
@@ -30,7 +30,7 @@ bool Pt_Inside(const Vec2& p, const Cont_Clsd& cnt, bool& on_cnt)
 
     bool inside = (dist > 0.0) == cnt.Ccw();
 
-    if (fabs(dist) <= Vec2::IdentDist) on_cnt = true;
+    if (fabs(dist) <= Vec2::identDist()) on_cnt = true;
 
     return inside;
   }
@@ -74,7 +74,7 @@ bool Cnt_Inside(const Contour& cnt1, const Cont_Clsd& cnt2,
     if (!cnt1.Project_Pnt_XY(p1,pnt,dist))
                                  Cont_Panic(Conti_Cant_Project);
 
-    if (fabs(dist) > Vec2::IdentDist) {
+    if (fabs(dist) > Vec2::identDist()) {
       bool on_cnt = true;
       bool inside = Pt_Inside(pnt.P(),cnt2,on_cnt);
 
@@ -117,7 +117,7 @@ bool Cnt_Inside(const Contour& cnt1, const Cont_Clsd& cnt2,
                                  Cont_Panic(Conti_Cant_Project);
 
 
-    if (fabs(dist) > Vec2::IdentDist) {
+    if (fabs(dist) > Vec2::identDist()) {
       bool on_cnt = true;
       bool inside = Pt_Inside(pnt.P(),cnt2,on_cnt);
 
@@ -137,7 +137,7 @@ bool Cnt_Inside(const Contour& cnt1, const Cont_Clsd& cnt2,
   double mean_dist  = (fabs(cnt1.Area_XY()) - fabs(cnt2.Area_XY()));
          mean_dist /= ((len1 + len2)/2.0);
 
-  if (fabs(mean_dist) <= Vec2::IdentDist) {
+  if (fabs(mean_dist) <= Vec2::identDist()) {
     colinear = &(const Contour &)cnt2;
     return false;
   }
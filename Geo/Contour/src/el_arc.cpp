@@ -28,6 +28,7 @@ namespace Ino
 /* ---------------------------------------------------------------------- */
 
 static void *store = NULL;
+static IT_Alloc_Stats storeStats;
 
 struct store_arc
 {
@@ -40,7 +41,16 @@ struct store_arc
 
 void *Elem_Arc::operator new(size_t)
 {
-  if (!store) return new char[sizeof(Elem_Arc)];
+  storeStats.live++;
+
+  if (!store) {
+    long total = storeStats.live + storeStats.free;
+    if (total > storeStats.high_water) storeStats.high_water = total;
+
+    return new char[sizeof(Elem_Arc)];
+  }
+
+  storeStats.free--;
 
   void *newl = store;
   store = ((store_arc *)store)->next;
@@ -54,6 +64,11 @@ void *Elem_Arc::operator new(size_t)
 
 void Elem_Arc::operator delete(void *old_arc)
 {
+  if (!old_arc) return;
+
+  storeStats.live--;
+  storeStats.free++;
+
   ((store_arc *)old_arc)->next = (store_arc *)store;
   store = old_arc;
 }
@@ -64,16 +79,43 @@ void Elem_Arc::operator delete(void *old_arc)
 
 void Elem_Arc::CleanupStore()
 {
+  TrimStore(0);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Elem_Arc::StoreStats(IT_Alloc_Stats& st)
+{
+  st = storeStats;
+  st.item_size = sizeof(Elem_Arc);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Release free elements until at most keep_bytes remain ------ */
+/* ---------------------------------------------------------------------- */
+
+size_t Elem_Arc::TrimStore(size_t keep_bytes)
+{
+  long keep = (long)(keep_bytes / sizeof(Elem_Arc));
+  size_t released = 0;
+
   store_arc *fst = (store_arc *)store;
 
-  while (fst) {
+  while (fst && storeStats.free > keep) {
     store_arc *nxt = fst->next;
 
     delete[] (char *)fst;
+    released += sizeof(Elem_Arc);
+
     fst = nxt;
+    storeStats.free--;
   }
 
-  store = NULL;
+  store = fst;
+
+  return released;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -519,7 +561,7 @@ void Elem_Arc::Intersect_XY(const Elem& el, Isect_Lst& isect_lst) const
 {
   isect_lst.Delete();
 
-  if (!Rect_Ax::Intersects_XY(el.Rect(),Vec2::IdentDist)) return;
+  if (!Rect_Ax::Intersects_XY(el.Rect(),Vec2::identDist())) return;
 
   int sols = 0;
   double pr1a=0, pr2a=0, pr1b=0, pr2b=0;
@@ -531,7 +573,7 @@ void Elem_Arc::Intersect_XY(const Elem& el, Isect_Lst& isect_lst) const
   switch (el.Type()) {
    case Elem_Type_Line:
       sols = Geo_Isct_Line_Arc(el.P1(),el.P2(),lp1,lp2,cntre,lccw,
-                               true,false,Vec2::IdentDist,
+                               true,false,Vec2::identDist(),
                                ipa,ipb,pr2a,pr2b,pr1a,pr1b);
    break;
 
@@ -540,7 +582,7 @@ void Elem_Arc::Intersect_XY(const Elem& el, Isect_Lst& isect_lst) const
 
       sols = Geo_Isct_Arc_Arc(lp1,lp2,cntre,lccw,
                                ela.lp1,ela.lp2,ela.cntre,ela.lccw,
-                               true,false,Vec2::IdentDist,
+                               true,false,Vec2::identDist(),
                                ipa,ipb,pr1a,pr1b,pr2a,pr2b);
 
       curve2 = 1/ela.R(); if (!lccw) curve2 = -curve2;
@@ -588,7 +630,7 @@ void Elem_Arc::Intersect_XY(const Elem& el, bool tang_ok,
 {
   isect_lst.Delete();
 
-  if (!Rect_Ax::Intersects_XY(el.Rect(),Vec2::IdentDist)) return;
+  if (!Rect_Ax::Intersects_XY(el.Rect(),Vec2::identDist())) return;
 
   int sols = 0;
   double pr1a=0, pr2a=0, pr1b=0, pr2b=0;
@@ -600,7 +642,7 @@ void Elem_Arc::Intersect_XY(const Elem& el, bool tang_ok,
   switch (el.Type()) {
    case Elem_Type_Line:
       sols = Geo_Isct_Line_Arc(el.P1(),el.P2(),lp1,lp2,cntre,lccw,
-                               true,tang_ok,Vec2::IdentDist,
+                               true,tang_ok,Vec2::identDist(),
                                ipa,ipb,pr2a,pr2b,pr1a,pr1b);
    break;
 
@@ -609,7 +651,7 @@ void Elem_Arc::Intersect_XY(const Elem& el, bool tang_ok,
 
       sols = Geo_Isct_Arc_Arc(lp1,lp2,cntre,lccw,
                                ela.lp1,ela.lp2,ela.cntre,ela.lccw,
-                               true,tang_ok,Vec2::IdentDist,
+                               true,tang_ok,Vec2::identDist(),
                                ipa,ipb,pr1a,pr1b,pr2a,pr2b);
 
       curve2 = 1/ela.R(); if (!lccw) curve2 = -curve2;
@@ -687,7 +729,7 @@ void Elem_Arc::Intersect_XY_Ext(const Elem& el, bool tang_ok,
   switch (el.Type()) {
    case Elem_Type_Line:
       sols = Geo_Isct_Line_Arc(el.P1(),el.P2(),lp1,lp2,cntre,lccw,
-                               false,tang_ok,Vec2::IdentDist,
+                               false,tang_ok,Vec2::identDist(),
                                ipa,ipb,pr2a,pr2b,pr1a,pr1b);
    break;
 
@@ -696,7 +738,7 @@ void Elem_Arc::Intersect_XY_Ext(const Elem& el, bool tang_ok,
 
       sols = Geo_Isct_Arc_Arc(lp1,lp2,cntre,lccw,
                                ela.lp1,ela.lp2,ela.cntre,ela.lccw,
-                               false,tang_ok,Vec2::IdentDist,
+                               false,tang_ok,Vec2::identDist(),
                                ipa,ipb,pr1a,pr1b,pr2a,pr2b);
 
       curve2 = 1/ela.R(); if (!lccw) curve2 = -curve2;
@@ -758,12 +800,12 @@ bool Elem_Arc::Offset_Into(double dist, Elem_List& offel,
 
   if (r < NumAccuracy * len_xy) return false;
 
-  if ((-dist -r) *len_xy/r > -Vec2::IdentDist/2.0) return false;
+  if ((-dist -r) *len_xy/r > -Vec2::identDist()/2.0) return false;
 
   Vec2 d1 = lp1 - cntre; d1.unitLen2(); d1 *= dist;
   Vec2 d2 = lp2 - cntre; d2.unitLen2(); d2 *= dist;
 
-  Elem_Arc newel(*this, keep_info); newel.p_cnt_id = cnt_id;
+  Elem_Arc newel(*this, keep_info); newel.P_Cnt_Id(Cnt_Id());
 
   newel.lp1 += d1; newel.lp2 += d2;
 
@@ -799,7 +841,7 @@ bool Elem_Arc::Offset_Into(double dist, double minlen, Elem_List& off_lst,
   Vec2 d1 = lp1 - cntre; d1.unitLen2(); d1 *= dist;
   Vec2 d2 = lp2 - cntre; d2.unitLen2(); d2 *= dist;
 
-  Elem_Arc newel(*this,false); newel.p_cnt_id = cnt_id;
+  Elem_Arc newel(*this,false); newel.P_Cnt_Id(Cnt_Id());
 
   newel.lp1 += d1; newel.lp2 += d2;
 
@@ -827,7 +869,7 @@ bool Elem_Arc::Split(double par, Elem_List& spl_lst) const
   double lpar = par - Begin_Par();
   Vec3 newp;
 
-  if (lpar < Vec2::IdentDist || lpar > Len()-Vec2::IdentDist ||
+  if (lpar < Vec2::identDist() || lpar > Len()-Vec2::identDist() ||
                                                    !At_Par(par,newp)) {
     spl_lst.Push_Back(*this);
     return false;
@@ -857,7 +899,7 @@ void Elem_Arc::Stretch_Begin_XY(const Vec2& isp, bool check)
 {
   double endpar = End_Par();
 
-  if (check && isp.distTo2(lp1) > 10.0 * Vec2::IdentDist) 
+  if (check && isp.distTo2(lp1) > 10.0 * Vec2::identDist()) 
                                        Cont_Panic(Elem_Large_Stretch);
 
   lp1.x = isp.x;
@@ -878,7 +920,7 @@ void Elem_Arc::Stretch_End_XY(const Vec2& isp, bool check)
 {
   if (check) {
     double dst = isp.distTo2(lp2);
-    if (dst > 10.0 * Vec2::IdentDist) Cont_Panic(Elem_Large_Stretch);
+    if (dst > 10.0 * Vec2::identDist()) Cont_Panic(Elem_Large_Stretch);
   }
 
   lp2.x = isp.x;
@@ -893,14 +935,42 @@ void Elem_Arc::Stretch_End_XY(const Vec2& isp, bool check)
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
+bool Elem_Arc::Can_Merge(const Elem_Arc& el, bool& to_circle) const
+{
+  if (lp2 != el.lp1 || lccw != el.lccw ||
+                               cntre != el.cntre) return false;
+
+  to_circle = lp1 == el.lp2;
+
+  return true;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Extend this arc over el, only if Can_Merge(el) and the ------- */
+/* ------- result is no circle ------------------------------------------ */
+/* ---------------------------------------------------------------------- */
+
+void Elem_Arc::Absorb(const Elem_Arc& el)
+{
+  lp2 = el.lp2;
+
+  Geo_Correct_Arc(lp1, lp2, cntre);
+
+  update();
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
 Elem *Elem_Arc::Merge_With(const Elem_Arc& el) const
 {
   Elem *newel = NULL;
 
-  if (lp2 != el.lp1 || lccw != el.lccw ||
-                               cntre != el.cntre) return NULL;
+  bool to_circle = false;
+  if (!Can_Merge(el,to_circle)) return NULL;
 
-  if (lp1 == el.lp2) {   // Insert Circle
+  if (to_circle) {   // Insert Circle
 
    newel = new Elem_Circle((lp1 + el.lp2)/2.0, el.lp2,
                                       (cntre + el.cntre)/2.0, lccw);
@@ -911,13 +981,9 @@ Elem *Elem_Arc::Merge_With(const Elem_Arc& el) const
   }
   else { // Insert Arc
 
-    newel = new Elem_Arc(*this); Elem_Arc *newarc = (Elem_Arc *)newel;
-
-    newarc->lp2 = el.lp2;
+    newel = new Elem_Arc(*this);
 
-    Geo_Correct_Arc(newarc->lp1, newarc->lp2, newarc->cntre);
-
-    newarc->update();
+    ((Elem_Arc *)newel)->Absorb(el);
   }
 
   return newel;
@@ -968,24 +1034,9 @@ void Elem_Arc::Transform(const Trf2& trf)
 /* ---------------------------------------------------------------------- */
 
 bool Elem_Arc::Fillet(const Elem& el2, double filletRad,
-                                               Elem_Arc& /*fillet*/) const
+                                                  Elem_Arc& fillet) const
 {
-  switch (el2.Type()) {
-    case Elem_Type_Line: {
-      if (filletRad < 0.0)
-           return false;
-      else return false;
-    }
-
-    case Elem_Type_Arc: {
-      // const Elem_Arc& arc = (const Elem_Arc&) el2;
-      return false;
-    }
-
-    case Elem_Type_Circle:
-    default:
-      return false; // Not implemented
-  }
+  return fillet_to(&cntre,lccw,el2,filletRad,fillet);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -1002,7 +1053,7 @@ bool Elem_Arc::From_3pt(const Vec2& p1, const Vec2& p2,
 
   double dirlen = dir.len2();
   
-  if (dirlen < Vec2::IdentDist) return false;
+  if (dirlen < Vec2::identDist()) return false;
 
   dir /= dirlen; dirlen /= 2.0;
     
@@ -1015,7 +1066,7 @@ bool Elem_Arc::From_3pt(const Vec2& p1, const Vec2& p2,
   
   Vec2 norm(hp3); norm -= hp2;
   
-  if (norm.len2() < Vec2::IdentDist) return false;
+  if (norm.len2() < Vec2::identDist()) return false;
   
   norm.rot90();
   
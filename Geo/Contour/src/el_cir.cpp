@@ -28,6 +28,7 @@ namespace Ino
 /* ---------------------------------------------------------------------- */
 
 static void *store = NULL;
+static IT_Alloc_Stats storeStats;
 
 struct store_cir
 {
@@ -40,7 +41,16 @@ struct store_cir
 
 void *Elem_Circle::operator new(size_t)
 {
-  if (!store) return new char[sizeof(Elem_Circle)];
+  storeStats.live++;
+
+  if (!store) {
+    long total = storeStats.live + storeStats.free;
+    if (total > storeStats.high_water) storeStats.high_water = total;
+
+    return new char[sizeof(Elem_Circle)];
+  }
+
+  storeStats.free--;
 
   void *newl = store;
   store = ((store_cir *)store)->next;
@@ -54,6 +64,11 @@ void *Elem_Circle::operator new(size_t)
 
 void Elem_Circle::operator delete(void *old_cir)
 {
+  if (!old_cir) return;
+
+  storeStats.live--;
+  storeStats.free++;
+
   ((store_cir *)old_cir)->next = (store_cir *)store;
   store = old_cir;
 }
@@ -64,16 +79,43 @@ void Elem_Circle::operator delete(void *old_cir)
 
 void Elem_Circle::CleanupStore()
 {
+  TrimStore(0);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Elem_Circle::StoreStats(IT_Alloc_Stats& st)
+{
+  st = storeStats;
+  st.item_size = sizeof(Elem_Circle);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Release free elements until at most keep_bytes remain ------ */
+/* ---------------------------------------------------------------------- */
+
+size_t Elem_Circle::TrimStore(size_t keep_bytes)
+{
+  long keep = (long)(keep_bytes / sizeof(Elem_Circle));
+  size_t released = 0;
+
   store_cir *fst = (store_cir *)store;
 
-  while (fst) {
+  while (fst && storeStats.free > keep) {
     store_cir *nxt = fst->next;
 
     delete[] (char *)fst;
+    released += sizeof(Elem_Circle);
+
     fst = nxt;
+    storeStats.free--;
   }
 
-  store = NULL;
+  store = fst;
+
+  return released;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -465,7 +507,7 @@ void Elem_Circle::Intersect_XY(const Elem& el, Isect_Lst& isect_lst) const
 {
   isect_lst.Delete();
 
-  if (!Rect_Ax::Intersects_XY(el.Rect(),Vec2::IdentDist)) return;
+  if (!Rect_Ax::Intersects_XY(el.Rect(),Vec2::identDist())) return;
 
   int sols = 0;
   double pr1a=0, pr2a=0, pr1b=0, pr2b=0;
@@ -479,7 +521,7 @@ void Elem_Circle::Intersect_XY(const Elem& el, Isect_Lst& isect_lst) const
   switch (el.Type()) {
    case Elem_Type_Line:
       sols = Geo_Isct_Line_Circle(el.P1(),el.P2(),lp1,cntre,lccw,
-                                  true,false,2.0*Vec2::IdentDist,
+                                  true,false,2.0*Vec2::identDist(),
 //                                  true,false,Vec2::Ident_Dist,
                                   ipa,ipb,pr2a,pr2b,pr1a,pr1b);
    break;
@@ -489,7 +531,7 @@ void Elem_Circle::Intersect_XY(const Elem& el, Isect_Lst& isect_lst) const
 
       sols = Geo_Isct_Arc_Circle(ela.P1(),ela.P2(),ela.C(),ela.Ccw(),
                                  lp1,cntre,lccw,
-                                 true,false,2.0*Vec2::IdentDist,
+                                 true,false,2.0*Vec2::identDist(),
 //                                 true,false,Vec2::Ident_Dist,
                                  ipa,ipb,pr2a,pr2b,pr1a,pr1b);
 
@@ -502,7 +544,7 @@ void Elem_Circle::Intersect_XY(const Elem& el, Isect_Lst& isect_lst) const
 
       sols = Geo_Isct_Circle_Circle(lp1,cntre,lccw,
                                     elc.P1(),elc.C(),elc.Ccw(),
-                                    false,2.0*Vec2::IdentDist,
+                                    false,2.0*Vec2::identDist(),
 //                                    false,Vec2::Ident_Dist,
                                     ipa,ipb,pr1a,pr1b,pr2a,pr2b);
 
@@ -551,7 +593,7 @@ void Elem_Circle::Intersect_XY(const Elem& el, bool tang_ok,
 {
   isect_lst.Delete();
 
-  if (!Rect_Ax::Intersects_XY(el.Rect(),Vec2::IdentDist)) return;
+  if (!Rect_Ax::Intersects_XY(el.Rect(),Vec2::identDist())) return;
 
   int sols = 0;
   double pr1a=0, pr2a=0, pr1b=0, pr2b=0;
@@ -563,7 +605,7 @@ void Elem_Circle::Intersect_XY(const Elem& el, bool tang_ok,
   switch (el.Type()) {
    case Elem_Type_Line:
       sols = Geo_Isct_Line_Circle(el.P1(),el.P2(),lp1,cntre,lccw,
-                                  true,tang_ok,Vec2::IdentDist,
+                                  true,tang_ok,Vec2::identDist(),
                                   ipa,ipb,pr2a,pr2b,pr1a,pr1b);
    break;
 
@@ -572,7 +614,7 @@ void Elem_Circle::Intersect_XY(const Elem& el, bool tang_ok,
 
       sols = Geo_Isct_Arc_Circle(ela.P1(),ela.P2(),ela.C(),ela.Ccw(),
                                  lp1,cntre,lccw,
-                                 true,tang_ok,Vec2::IdentDist,
+                                 true,tang_ok,Vec2::identDist(),
                                  ipa,ipb,pr2a,pr2b,pr1a,pr1b);
 
       curve2 = 1/ela.R(); if (!lccw) curve2 = -curve2;
@@ -584,7 +626,7 @@ void Elem_Circle::Intersect_XY(const Elem& el, bool tang_ok,
 
       sols = Geo_Isct_Circle_Circle(lp1,cntre,lccw,
                                     elc.P1(),elc.C(),elc.Ccw(),
-                                    tang_ok,Vec2::IdentDist,
+                                    tang_ok,Vec2::identDist(),
                                     ipa,ipb,pr1a,pr1b,pr2a,pr2b);
 
       curve2 = 1/elc.R(); if (!lccw) curve2 = -curve2;
@@ -642,7 +684,7 @@ void Elem_Circle::Intersect_XY_Ext(const Elem& el, bool tang_ok,
   switch (el.Type()) {
    case Elem_Type_Line:
       sols = Geo_Isct_Line_Circle(el.P1(),el.P2(),lp1,cntre,lccw,
-                                  false,tang_ok,Vec2::IdentDist,
+                                  false,tang_ok,Vec2::identDist(),
                                   ipa,ipb,pr2a,pr2b,pr1a,pr1b);
    break;
 
@@ -651,7 +693,7 @@ void Elem_Circle::Intersect_XY_Ext(const Elem& el, bool tang_ok,
 
       sols = Geo_Isct_Arc_Circle(ela.P1(),ela.P2(),ela.C(),ela.Ccw(),
                                  lp1,cntre,lccw,
-                                 false,tang_ok,Vec2::IdentDist,
+                                 false,tang_ok,Vec2::identDist(),
                                  ipa,ipb,pr2a,pr2b,pr1a,pr1b);
 
       curve2 = 1/ela.R(); if (!lccw) curve2 = -curve2;
@@ -663,7 +705,7 @@ void Elem_Circle::Intersect_XY_Ext(const Elem& el, bool tang_ok,
 
       sols = Geo_Isct_Circle_Circle(lp1,cntre,lccw,
                                     elc.P1(),elc.C(),elc.Ccw(),
-                                    tang_ok,Vec2::IdentDist,
+                                    tang_ok,Vec2::identDist(),
                                     ipa,ipb,pr1a,pr1b,pr2a,pr2b);
 
       curve2 = 1/elc.R(); if (!lccw) curve2 = -curve2;
@@ -713,11 +755,11 @@ bool Elem_Circle::Offset_Into(double dist, Elem_List& offel,
 
   if (lccw) dist = -dist;
 
-  if ((-dist -R()) * Vec2::Pi2 > -Vec2::IdentDist/2.0) return false;
+  if ((-dist -R()) * Vec2::Pi2 > -Vec2::identDist()/2.0) return false;
 
   Vec2 d1 = lp1 - cntre; d1.unitLen2(); d1 *= dist;
 
-  Elem_Circle newel(*this, keep_info); newel.p_cnt_id = cnt_id;
+  Elem_Circle newel(*this, keep_info); newel.P_Cnt_Id(Cnt_Id());
 
   newel.lp1 += d1; newel.lp2.x = newel.lp1.x; newel.lp2.y = newel.lp1.y;
 
@@ -748,7 +790,7 @@ bool Elem_Circle::Offset_Into(double dist, double minlen,
 
   Vec2 d1 = lp1 - cntre; d1.unitLen2(); d1 *= dist;
 
-  Elem_Circle newel(*this, false); newel.p_cnt_id = cnt_id;
+  Elem_Circle newel(*this, false); newel.P_Cnt_Id(Cnt_Id());
 
   newel.lp1 += d1; newel.lp2.x = newel.lp1.x; newel.lp2.y = newel.lp1.y;
 
@@ -773,7 +815,7 @@ bool Elem_Circle::Split(double par, Elem_List& spl_lst) const
   double lpar = par - bpar;
   Vec3 newp;
 
-  if (lpar < Vec2::IdentDist || lpar > len-Vec2::IdentDist || 
+  if (lpar < Vec2::identDist() || lpar > len-Vec2::identDist() || 
                                                   !At_Par(par,newp)) {
     spl_lst.Push_Back(*this);
     return false;
@@ -784,11 +826,11 @@ bool Elem_Circle::Split(double par, Elem_List& spl_lst) const
   Elem_Arc newarc2(newp,lp2,cntre,lccw);
 
   newarc1.Begin_Par(bpar);
-  newarc1.Id(el_id); newarc1.Cnt_Id(cnt_id); newarc1.P_Cnt_Id(p_cnt_id);
+  newarc1.Id(Id()); newarc1.Cnt_Id(Cnt_Id()); newarc1.P_Cnt_Id(P_Cnt_Id());
   newarc1.Cam_Inf(Cam_Inf());
 
   newarc2.Begin_Par(par);
-  newarc2.Id(el_id); newarc2.Cnt_Id(cnt_id); newarc2.P_Cnt_Id(p_cnt_id);
+  newarc2.Id(Id()); newarc2.Cnt_Id(Cnt_Id()); newarc2.P_Cnt_Id(P_Cnt_Id());
   newarc2.Cam_Inf(Cam_Inf());
 
   const Elem_Info *info = Info();
@@ -811,7 +853,7 @@ void Elem_Circle::Stretch_Begin_XY(const Vec2& isp, bool check)
 {
   double endpar = End_Par();
 
-  if (check && isp.distTo2(lp1) > 10.0 * Vec2::IdentDist) 
+  if (check && isp.distTo2(lp1) > 10.0 * Vec2::identDist()) 
                                        Cont_Panic(Elem_Large_Stretch);
 
   lp1.x = isp.x;
@@ -831,7 +873,7 @@ void Elem_Circle::Stretch_Begin_XY(const Vec2& isp, bool check)
 
 void Elem_Circle::Stretch_End_XY(const Vec2& isp, bool check)
 {
-  if (check && isp.distTo2(lp1) > 10.0 * Vec2::IdentDist) 
+  if (check && isp.distTo2(lp1) > 10.0 * Vec2::identDist()) 
                                        Cont_Panic(Elem_Large_Stretch);
 
   lp1.x = isp.x;
@@ -857,7 +899,7 @@ bool Elem_Circle::Limit_Span_180(Elem_Cursor& newpair) const
   if (!At_Par(midpar,midp)) return false;
 
   Elem_Arc newarc2(midp,lp2,cntre,lccw);
-  newarc2.Id(el_id); newarc2.Cnt_Id(cnt_id); newarc2.P_Cnt_Id(p_cnt_id);
+  newarc2.Id(Id()); newarc2.Cnt_Id(Cnt_Id()); newarc2.P_Cnt_Id(P_Cnt_Id());
   newarc2.Cam_Inf(Cam_Inf());
   newarc2.Begin_Par(midpar);
   if (Info()) newarc2.Add_Info(*Info());
@@ -865,7 +907,7 @@ bool Elem_Circle::Limit_Span_180(Elem_Cursor& newpair) const
   newpair.Insert(newarc2);
 
   Elem_Arc newarc1(lp1,midp,cntre,lccw);
-  newarc1.Id(el_id); newarc1.Cnt_Id(cnt_id); newarc1.P_Cnt_Id(p_cnt_id);
+  newarc1.Id(Id()); newarc1.Cnt_Id(Cnt_Id()); newarc1.P_Cnt_Id(P_Cnt_Id());
   newarc1.Cam_Inf(Cam_Inf());
   newarc1.Begin_Par(bpar);
   if (Info()) newarc1.Add_Info(*Info());
@@ -24,6 +24,7 @@ namespace Ino
 /* ---------------------------------------------------------------------- */
 
 static void *store = NULL;
+static IT_Alloc_Stats storeStats;
 
 struct store_line
 {
@@ -36,7 +37,16 @@ struct store_line
 
 void *Elem_Line::operator new(size_t)
 {
-  if (!store) return new char[sizeof(Elem_Line)];
+  storeStats.live++;
+
+  if (!store) {
+    long total = storeStats.live + storeStats.free;
+    if (total > storeStats.high_water) storeStats.high_water = total;
+
+    return new char[sizeof(Elem_Line)];
+  }
+
+  storeStats.free--;
 
   void *newl = store;
   store = ((store_line *)store)->next;
@@ -50,6 +60,11 @@ void *Elem_Line::operator new(size_t)
 
 void Elem_Line::operator delete(void *old_line)
 {
+  if (!old_line) return;
+
+  storeStats.live--;
+  storeStats.free++;
+
   ((store_line *)old_line)->next = (store_line *)store;
   store = old_line;
 }
@@ -60,16 +75,43 @@ void Elem_Line::operator delete(void *old_line)
 
 void Elem_Line::CleanupStore()
 {
+  TrimStore(0);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Elem_Line::StoreStats(IT_Alloc_Stats& st)
+{
+  st = storeStats;
+  st.item_size = sizeof(Elem_Line);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Release free elements until at most keep_bytes remain ------ */
+/* ---------------------------------------------------------------------- */
+
+size_t Elem_Line::TrimStore(size_t keep_bytes)
+{
+  long keep = (long)(keep_bytes / sizeof(Elem_Line));
+  size_t released = 0;
+
   store_line *fst = (store_line *)store;
 
-  while (fst) {
+  while (fst && storeStats.free > keep) {
     store_line *nxt = fst->next;
 
     delete[] (char *)fst;
+    released += sizeof(Elem_Line);
+
     fst = nxt;
+    storeStats.free--;
   }
 
-  store = NULL;
+  store = fst;
+
+  return released;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -380,7 +422,7 @@ void Elem_Line::Intersect_XY(const Elem& el, Isect_Lst& isect_lst) const
 {
   isect_lst.Delete();
 
-  if (!Rect_Ax::Intersects_XY(el.Rect(),Vec2::IdentDist)) return;
+  if (!Rect_Ax::Intersects_XY(el.Rect(),Vec2::identDist())) return;
 
   if (el.Type() > Elem_Type_Line) {
     el.Intersect_XY(*this,isect_lst);
@@ -399,7 +441,7 @@ void Elem_Line::Intersect_XY(const Elem& el, Isect_Lst& isect_lst) const
     Vec3 ipa;
     double pr1a, pr2a;
     int sols = Geo_Isct_Lines(lp1,lp2,el.P1(),el.P2(),true,
-                              Vec2::IdentDist,ipa,pr1a,pr2a);
+                              Vec2::identDist(),ipa,pr1a,pr2a);
 
     if (sols > 0) {
       pr1a += bpar; pr2a += el.Begin_Par();
@@ -430,7 +472,7 @@ void Elem_Line::Intersect_XY(const Elem& el, bool tang_ok,
 {
   isect_lst.Delete();
 
-  if (!Rect_Ax::Intersects_XY(el.Rect(),Vec2::IdentDist)) return;
+  if (!Rect_Ax::Intersects_XY(el.Rect(),Vec2::identDist())) return;
 
   if (el.Type() > Elem_Type_Line) {
     el.Intersect_XY(*this,tang_ok,isect_lst);
@@ -449,7 +491,7 @@ void Elem_Line::Intersect_XY(const Elem& el, bool tang_ok,
     Vec3 ipa;
     double pr1a, pr2a;
     int sols = Geo_Isct_Lines(lp1,lp2,el.P1(),el.P2(),true,
-                              Vec2::IdentDist,ipa,pr1a,pr2a);
+                              Vec2::identDist(),ipa,pr1a,pr2a);
 
     if (sols > 0) {
       pr1a += bpar; pr2a += el.Begin_Par();
@@ -497,7 +539,7 @@ void Elem_Line::Intersect_XY_Ext(const Elem& el, bool tang_ok,
     Vec3 ipa;
     double pr1a, pr2a;
     int sols = Geo_Isct_Lines(lp1,lp2,el.P1(),el.P2(),false,
-                              Vec2::IdentDist,ipa,pr1a,pr2a);
+                              Vec2::identDist(),ipa,pr1a,pr2a);
 
     if (sols > 0) {
       pr1a += bpar; pr2a += el.Begin_Par();
@@ -528,7 +570,7 @@ bool Elem_Line::Offset_Into(double dist, Elem_List& offel,
 {
   offel.Delete();
 
-  Elem_Line newel(*this, keep_info); newel.p_cnt_id = cnt_id;
+  Elem_Line newel(*this, keep_info); newel.P_Cnt_Id(Cnt_Id());
 
   Vec2 d = lp2 - lp1; d.unitLen2(); d.rot90(); d *= dist;
 
@@ -551,7 +593,7 @@ bool Elem_Line::Offset_Into(double dist, double /*minlen*/,
 {
   off_lst.Delete();
 
-  Elem_Line newel(*this, false); newel.p_cnt_id = cnt_id;
+  Elem_Line newel(*this, false); newel.P_Cnt_Id(Cnt_Id());
 
   Vec2 d = lp2 - lp1; d.unitLen2(); d.rot90(); d *= dist;
 
@@ -580,7 +622,7 @@ bool Elem_Line::Split(double par, Elem_List& spl_lst) const
   double lpar = par - bpar;
   Vec3 newp;
 
-  if (lpar < Vec2::IdentDist || lpar > len-Vec2::IdentDist ||
+  if (lpar < Vec2::identDist() || lpar > len-Vec2::identDist() ||
                                                  !At_Par(par,newp)) {
     spl_lst.Push_Back(*this);
     return false;
@@ -610,7 +652,7 @@ void Elem_Line::Stretch_Begin_XY(const Vec2& isp, bool check)
 {
   double endpar = End_Par();
 
-  if (check && isp.distTo2(lp1) > 10.0 * Vec2::IdentDist) 
+  if (check && isp.distTo2(lp1) > 10.0 * Vec2::identDist()) 
                                        Cont_Panic(Elem_Large_Stretch);
 
   lp1.x = isp.x;
@@ -627,7 +669,7 @@ void Elem_Line::Stretch_Begin_XY(const Vec2& isp, bool check)
 
 void Elem_Line::Stretch_End_XY(const Vec2& isp, bool check)
 {
-  if (check && isp.distTo2(lp2) > 10.0 * Vec2::IdentDist) 
+  if (check && isp.distTo2(lp2) > 10.0 * Vec2::identDist()) 
                                        Cont_Panic(Elem_Large_Stretch);
 
   lp2.x = isp.x;
@@ -640,25 +682,43 @@ void Elem_Line::Stretch_End_XY(const Vec2& isp, bool check)
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
-Elem *Elem_Line::Merge_With(const Elem_Line& el) const
+bool Elem_Line::Can_Merge(const Elem_Line& el) const
 {
-  Elem *newel = NULL;
-
-  if (lp2 != el.lp1) return NULL;
+  if (lp2 != el.lp1) return false;
 
   Vec2 dp = lp2 - lp1; dp.unitLen2();
   Vec2 ds = el.lp2 - el.lp1;
 
-  if (ds * dp < 0.0) return NULL;
+  if (ds * dp < 0.0) return false;
 
   dp.rot90();
-  if (fabs(ds * dp) > Vec2::IdentDist) return NULL;
+  if (fabs(ds * dp) > Vec2::identDist()) return false;
 
-  newel = new Elem_Line(*this);
+  return true;
+}
 
-  ((Elem_Line *)newel)->lp2 = el.lp2;
+/* ---------------------------------------------------------------------- */
+/* ------- Extend this line over el, only if Can_Merge(el) -------------- */
+/* ---------------------------------------------------------------------- */
 
-  ((Elem_Line *)newel)->update();
+void Elem_Line::Absorb(const Elem_Line& el)
+{
+  lp2 = el.lp2;
+
+  update();
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Elem *Elem_Line::Merge_With(const Elem_Line& el) const
+{
+  if (!Can_Merge(el)) return NULL;
+
+  Elem_Line *newel = new Elem_Line(*this);
+
+  newel->Absorb(el);
 
   return newel;
 }
@@ -680,13 +740,7 @@ void Elem_Line::Transform(const Trf2& trf)
 bool Elem_Line::Fillet(const Elem& el2, double filletRad,
                                                   Elem_Arc& fillet) const
 {
-  switch (el2.Type()) {
-    case Elem_Type_Line:
-      return false;
-
-    default:
-      return el2.Fillet(*this,-filletRad,fillet);
-  }
+  return fillet_to(NULL,false,el2,filletRad,fillet);
 }
 
 //---------------------------------------------------------------------------
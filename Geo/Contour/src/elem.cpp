@@ -9,14 +9,196 @@
 #include "Elem.h"
 
 #include "El_Info.h"
+#include "El_Arc.h"
+#include "Geo.h"
 
 #include <math.h>
 
+#include <atomic>
+#include <mutex>
+
 namespace Ino
 {
 
 long Elem::defaultColor = 0;
 
+const Elem_Attr Elem::defaultAttr;
+
+/* ---------------------------------------------------------------------- */
+/* ------- Shared default attributes ------------------------------------ */
+/* ---------------------------------------------------------------------- */
+
+// Elements made while the default color is not 0 all point to one shared
+// block holding just that color, they only get a block of their own when
+// an attribute is changed. There is one such block per default color
+// ever used, kept until exit.
+
+struct shared_attr
+{
+  Elem_Attr attr;
+  shared_attr *next;
+};
+
+static shared_attr *sharedAttrs = NULL;
+static Elem_Attr *colorAttr = NULL;  // Of defaultColor, NULL if that is 0
+
+/* ---------------------------------------------------------------------- */
+/* ------- Attribute store ---------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+// Locked: attributes are also created by the persistence constructors,
+// which may run on several threads (PersistentReader::setParallel()).
+
+static std::mutex attrMtx;
+static void *attrStore = NULL;
+static IT_Alloc_Stats attrStats;
+
+struct store_attr
+{
+  store_attr *next;
+};
+
+/* ---------------------------------------------------------------------- */
+
+void *Elem_Attr::operator new(size_t)
+{
+  {
+    std::lock_guard<std::mutex> lock(attrMtx);
+
+    if (attrStore) {
+      attrStats.live++;
+      attrStats.free--;
+
+      void *newa = attrStore;
+      attrStore = ((store_attr *)attrStore)->next;
+
+      return newa;
+    }
+  }
+
+  void *newa = new char[sizeof(Elem_Attr)];
+
+  std::lock_guard<std::mutex> lock(attrMtx);
+
+  attrStats.live++;
+
+  long total = attrStats.live + attrStats.free;
+  if (total > attrStats.high_water) attrStats.high_water = total;
+
+  return newa;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Elem_Attr::operator delete(void *old_attr)
+{
+  if (!old_attr) return;
+
+  std::lock_guard<std::mutex> lock(attrMtx);
+
+  attrStats.live--;
+  attrStats.free++;
+
+  ((store_attr *)old_attr)->next = (store_attr *)attrStore;
+  attrStore = old_attr;
+}
+
+/* ---------------------------------------------------------------------- */
+
+bool Elem_Attr::Is_Default() const
+{
+  return el_id == 0 && cnt_id == 0 && p_cnt_id == 0 && cam_inf == 0 &&
+         color == 0 && !insArc;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Elem::CleanupAttrStore()
+{
+  TrimAttrStore(0);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Elem::AttrStoreStats(IT_Alloc_Stats& st)
+{
+  std::lock_guard<std::mutex> lock(attrMtx);
+
+  st = attrStats;
+  st.item_size = sizeof(Elem_Attr);
+}
+
+/* ---------------------------------------------------------------------- */
+
+size_t Elem::TrimAttrStore(size_t keep_bytes)
+{
+  long keep = (long)(keep_bytes / sizeof(Elem_Attr));
+  size_t released = 0;
+
+  std::lock_guard<std::mutex> lock(attrMtx);
+
+  store_attr *fst = (store_attr *)attrStore;
+
+  while (fst && attrStats.free > keep) {
+    store_attr *nxt = fst->next;
+
+    delete[] (char *)fst;
+    released += sizeof(Elem_Attr);
+
+    fst = nxt;
+    attrStats.free--;
+  }
+
+  attrStore = fst;
+
+  return released;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Shared (reference counted) element info ---------------------- */
+/* ---------------------------------------------------------------------- */
+
+struct Elem_Info_Share
+{
+  Elem_Info *info;
+  std::atomic<long> refs;
+
+  Elem_Info_Share(Elem_Info *newInfo) : info(newInfo), refs(1) {}
+};
+
+static std::atomic<long> infoClones(0);
+static std::atomic<long> infoShares(0);
+static std::atomic<long> infoUnshares(0);
+static std::atomic<long> infoDeletes(0);
+
+/* ---------------------------------------------------------------------- */
+
+static Elem_Info_Share *share_info(Elem_Info_Share *shr)
+{
+  if (!shr) return NULL;
+
+  shr->refs.fetch_add(1,std::memory_order_relaxed);
+  infoShares.fetch_add(1,std::memory_order_relaxed);
+
+  return shr;
+}
+
+/* ---------------------------------------------------------------------- */
+
+static void release_info(Elem_Info_Share *shr)
+{
+  if (!shr) return;
+
+  if (shr->refs.fetch_sub(1,std::memory_order_acq_rel) != 1) return;
+
+  if (shr->info) {
+    Delete_Elem_Info(shr->info);
+    infoDeletes.fetch_add(1,std::memory_order_relaxed);
+  }
+
+  delete shr;
+}
+
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
@@ -38,6 +220,24 @@ void Delete_Elem_Info(Elem_Info * /*info*/)
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
+Elem_Info *Unshare_Elem_Info(const Elem_Info *from)
+{
+  return Clone_Elem_Info(from);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+size_t Size_Elem_Info(const Elem_Info * /*info*/)
+{
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
 double Elem_Calc_Par_Len(const Elem_List& ellst)
 {
   double curlen = 0.0;
@@ -49,6 +249,61 @@ double Elem_Calc_Par_Len(const Elem_List& ellst)
   return curlen;
 }
 
+/* ---------------------------------------------------------------------- */
+/* ------- Construction ------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Elem::Elem()
+ : Persistable(), Rect_Ax(), inf(NULL), attr(colorAttr), plen(0.0),
+   len(0.0), len_xy(0.0), bpar(0.0)
+{
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Elem_Attr& Elem::mod_attr()
+{
+  if (!attr) attr = new Elem_Attr;
+  else if (!own_attr()) attr = new Elem_Attr(*attr);
+
+  return *attr;
+}
+
+/* ---------------------------------------------------------------------- */
+
+bool Elem::own_attr() const
+{
+  if (!attr) return false;
+
+  for (shared_attr *sa = sharedAttrs; sa; sa = sa->next) {
+    if (attr == &sa->attr) return false;
+  }
+
+  return true;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Elem::Attr(const Elem_Attr& newAttr)
+{
+  if (newAttr.Is_Default()) Del_Attr();
+  else mod_attr() = newAttr;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Elem::Del_Attr()
+{
+  if (own_attr()) delete attr;
+  attr = NULL;
+}
+
 /* ---------------------------------------------------------------------- */
 /* ------- Cloning ------------------------------------------------------ */
 /* ---------------------------------------------------------------------- */
@@ -61,16 +316,20 @@ void Elem::clone_from(const Elem& from, bool keep_info)
   len      = from.len;
   len_xy   = from.len_xy;
   bpar     = from.bpar;
-  el_id    = from.el_id;
-  cnt_id   = from.cnt_id;
-  p_cnt_id = from.p_cnt_id;
-  cam_inf  = from.cam_inf;
-  insArc   = from.insArc;
-  color    = from.color;
-
-  if (inf) Delete_Elem_Info(inf);
-  if (keep_info && from.inf) inf = Clone_Elem_Info(from.inf);
+
+  if (from.own_attr()) mod_attr() = *from.attr;
+  else {
+    Del_Attr();
+    attr = from.attr; // NULL or shared
+  }
+
+  Elem_Info_Share *oldInf = inf;
+
+  // Share instead of Clone_Elem_Info, see Info()
+  if (keep_info) inf = share_info(from.inf);
   else inf = NULL;
+
+  release_info(oldInf);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -79,7 +338,8 @@ void Elem::clone_from(const Elem& from, bool keep_info)
 
 Elem::~Elem()
 {
-  if (inf) Delete_Elem_Info(inf);
+  release_info(inf);
+  if (own_attr()) delete attr;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -88,8 +348,13 @@ Elem::~Elem()
 
 void Elem::Add_Info(const Elem_Info& info)
 {
-  if (inf) Delete_Elem_Info(inf);
-  inf = Clone_Elem_Info(&info);
+  Elem_Info *newInf = Clone_Elem_Info(&info);
+  infoClones.fetch_add(1,std::memory_order_relaxed);
+
+  release_info(inf);
+  inf = NULL;
+
+  if (newInf) inf = new Elem_Info_Share(newInf);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -98,10 +363,89 @@ void Elem::Add_Info(const Elem_Info& info)
 
 void Elem::Del_Info()
 {
-  if (inf) Delete_Elem_Info(inf);
+  release_info(inf);
   inf = NULL;
 }
 
+/* ---------------------------------------------------------------------- */
+/* ------- Info access -------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+const Elem_Info *Elem::Info() const
+{
+  return inf ? inf->info : NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Modifiable info: copy on write ------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Elem_Info *Elem::Info()
+{
+  if (!inf) return NULL;
+
+  if (inf->refs.load(std::memory_order_acquire) > 1) {
+    Elem_Info *newInf = Unshare_Elem_Info(inf->info);
+    infoUnshares.fetch_add(1,std::memory_order_relaxed);
+
+    release_info(inf);
+    inf = NULL;
+
+    if (!newInf) return NULL;
+
+    inf = new Elem_Info_Share(newInf);
+  }
+
+  return inf->info;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+bool Elem::Info_Shared() const
+{
+  return inf && inf->refs.load(std::memory_order_acquire) > 1;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Memory accounting, a shared info is split over its users --- */
+/* ---------------------------------------------------------------------- */
+
+size_t Elem::Info_Mem_Size() const
+{
+  if (!inf) return 0;
+
+  size_t sz = sizeof(Elem_Info_Share) + Size_Elem_Info(inf->info);
+  long refs = inf->refs.load(std::memory_order_relaxed);
+
+  return refs > 1 ? sz / refs : sz;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Sharing statistics ------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Elem::Info_Stats(Elem_Info_Stats& stats)
+{
+  stats.clones   = infoClones.load(std::memory_order_relaxed);
+  stats.shares   = infoShares.load(std::memory_order_relaxed);
+  stats.unshares = infoUnshares.load(std::memory_order_relaxed);
+  stats.deletes  = infoDeletes.load(std::memory_order_relaxed);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+void Elem::Reset_Info_Stats()
+{
+  infoClones   = 0;
+  infoShares   = 0;
+  infoUnshares = 0;
+  infoDeletes  = 0;
+}
+
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
@@ -118,6 +462,22 @@ long Elem::getDefaultColor()
 void Elem::setDefaultColor(long newColor)
 {
   defaultColor = newColor;
+  colorAttr = NULL;
+
+  if (newColor == 0) return;
+
+  shared_attr *sa = sharedAttrs;
+  while (sa && sa->attr.color != newColor) sa = sa->next;
+
+  if (!sa) {
+    sa = new shared_attr;
+    sa->attr.color = newColor;
+
+    sa->next = sharedAttrs;
+    sharedAttrs = sa;
+  }
+
+  colorAttr = &sa->attr;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -126,9 +486,9 @@ void Elem::setDefaultColor(long newColor)
 
 bool Elem::setColor(long newColor)
 {
-  if (color == newColor) return false;
+  if (get_attr().color == newColor) return false;
 
-  color = newColor;
+  mod_attr().color = newColor;
 
   return true;
 }
@@ -141,8 +501,8 @@ bool Elem::Par_Valid(double par) const
 {
   par -= bpar;
 
-  if (par < -Vec2::IdentDist ||
-      par > plen+Vec2::IdentDist) return false;
+  if (par < -Vec2::identDist() ||
+      par > plen+Vec2::identDist()) return false;
 
   return true;
 }
@@ -261,11 +621,39 @@ void Elem::Join_To_XY(Elem& el, bool check)
   el.Stretch_Begin_XY(newp,check);
 }
 
+/* ---------------------------------------------------------------------- */
+/* ------- Fillet to el2, which begins where this element ends ---------- */
+/* ---------------------------------------------------------------------- */
+
+bool Elem::fillet_to(const Vec2 *c, bool acw, const Elem& el2,
+                                  double filletRad, Elem_Arc& fillet) const
+{
+  const Vec2 *c2 = NULL;
+  bool acw2 = false;
+
+  if (el2.isArc()) {
+    c2   = &((const Elem_Arc&)el2).C();
+    acw2 = ((const Elem_Arc&)el2).Ccw();
+  }
+  else if (!el2.isLine()) return false; // Circles have no corners
+
+  Vec2 t1,t2,fc;
+  bool facw;
+
+  if (!Geo_Fillet(P1(),P2(),c,acw,el2.P1(),el2.P2(),c2,acw2,
+                  fabs(filletRad),Vec2::identDist(),t1,t2,fc,facw))
+                                                              return false;
+
+  fillet = Elem_Arc(Vec3(t1,P2().z),Vec3(t2,P2().z),fc,facw);
+
+  return true;
+}
+
 //---------------------------------------------------------------------------
 
 void Elem::Sort(Elem_List& elLst)
 {
-  const double sqIdDist = sqr(Vec2::IdentDist);
+  const double sqIdDist = sqr(Vec2::identDist());
 
   Elem_List newLst;
   Elem_Cursor bElc(newLst), eElc(newLst);
@@ -390,12 +778,11 @@ void Elem::definePersistentFields(PersistentWriter& po) const
 //---------------------------------------------------------------------------
 
 Elem::Elem(PersistentReader& pi)
-: Rect_Ax(),inf(NULL),plen(0.0),len(0.0),len_xy(0.0),
-  bpar(pi.readDouble(fldBPar,0.0)),
-  el_id(pi.readInt(fldId,0)), cnt_id(0), p_cnt_id(0),
-  cam_inf(0), insArc(false),
-  color((long)pi.readInt(fldColor,defaultColor))
+: Rect_Ax(),inf(NULL),attr(colorAttr),plen(0.0),len(0.0),len_xy(0.0),
+  bpar(pi.readDouble(fldBPar,0.0))
 {
+  Id((int)pi.readInt(fldId,0));
+  setColor((long)pi.readInt(fldColor,defaultColor));
 }
 
 //---------------------------------------------------------------------------
@@ -403,8 +790,8 @@ Elem::Elem(PersistentReader& pi)
 void Elem::writePersistentObject(PersistentWriter& po) const
 {
   po.writeDouble(fldBPar,bpar);
-  po.writeInt(fldColor,color);
-  po.writeInt(fldId,el_id);
+  po.writeInt(fldColor,getColor());
+  po.writeInt(fldId,Id());
 }
 
 /* ---------------------------------------------------------------------- */
@@ -650,7 +1037,7 @@ static void bubble_up_closed(double tol, Elem_List& src, Elem_List& dst)
       if (ellen > tol) {
         dc.Re_Insert(sc); dc.To_End();
       }
-      else if (ellen < Vec2::IdentDist) sc.Delete();
+      else if (ellen < Vec2::identDist()) sc.Delete();
       else ++sc;
     }
     else ++sc;
@@ -812,10 +1199,12 @@ bool Elem_Sort::Chain(Elem_List& new_cont)
 }
 
 /* ---------------------------------------------------------------------- */
-/* ---------------------------------------------------------------------- */
+/* ------- Removed elements are moved to dead if given, the element ----- */
+/* ------- allocators are not thread safe ------------------------------- */
 /* ---------------------------------------------------------------------- */
 
-bool Remove_Short_Elems(Elem_Cursor& elc, double maxlen, double maxdist)
+bool Remove_Short_Elems(Elem_Cursor& elc, double maxlen, double maxdist,
+                                                          Elem_List *dead)
 {
   elc.To_Begin();
   if (!elc) return false;
@@ -847,9 +1236,9 @@ bool Remove_Short_Elems(Elem_Cursor& elc, double maxlen, double maxdist)
         Vec3 midp;
         prvel.Mid_Par(midp);
 
-        if (curel.Project_Pnt_XY(prvel.P1(),Vec2::IdentDist,false,
+        if (curel.Project_Pnt_XY(prvel.P1(),Vec2::identDist(),false,
                                   pnt,parm,dist) && fabs(dist) < maxdist &&
-            curel.Project_Pnt_XY(midp,Vec2::IdentDist,false,
+            curel.Project_Pnt_XY(midp,Vec2::identDist(),false,
                                   pnt,parm,dist) && fabs(dist) < maxdist) {
 
           // We take midp as the join point
@@ -861,7 +1250,8 @@ bool Remove_Short_Elems(Elem_Cursor& elc, double maxlen, double maxdist)
             break;
           }
 
-          predc.Delete();
+          if (dead) dead->End().Re_Insert(predc);
+          else predc.Delete();
 
           predc2->El().Stretch_End_XY(midp,false);
           curel.Stretch_Begin_XY(midp,false);
@@ -896,9 +1286,9 @@ bool Remove_Short_Elems(Elem_Cursor& elc, double maxlen, double maxdist)
         Vec3 midp;
         prvel.Mid_Par(midp);
 
-        if (curel.Project_Pnt_XY(prvel.P1(),Vec2::IdentDist,false,
+        if (curel.Project_Pnt_XY(prvel.P1(),Vec2::identDist(),false,
                                   pnt,parm,dist) && fabs(dist) < maxdist &&
-            curel.Project_Pnt_XY(midp,Vec2::IdentDist,false,
+            curel.Project_Pnt_XY(midp,Vec2::identDist(),false,
                                   pnt,parm,dist) && fabs(dist) < maxdist) {
 
           // We take midp as the join point
@@ -910,7 +1300,8 @@ bool Remove_Short_Elems(Elem_Cursor& elc, double maxlen, double maxdist)
             break;
           }
 
-          predc.Delete();
+          if (dead) dead->End().Re_Insert(predc);
+          else predc.Delete();
 
           predc2->El().Stretch_Begin_XY(midp,false);
           curel.Stretch_End_XY(midp,false);
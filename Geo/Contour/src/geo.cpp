@@ -9,6 +9,7 @@
 #include "Geo.h"
 
 #include <math.h>
+#include <float.h>
 
 #include "Trf.h"
 
@@ -25,7 +26,7 @@ void Geo_Correct_Arc(const Vec2& p1, const Vec2& p2, Vec2& c)
   Vec2 dir = p2 - p1;
   double len = dir.len2();
 
-  if (len < Vec2::IdentDist) return;
+  if (len < Vec2::identDist()) return;
 
   dir /= len;
 
@@ -67,20 +68,46 @@ double Geo_Norm_Angle(bool acw, double a)
 }
 
 /* --------------------------------------------------------------------- */
-/* ----------- Calculate arcspan of arc in radians (acw = positive) ---- */
+/* ----------- Angle from p1 to p2 around centre (help routine) -------- */
+/* --------------------------------------------------------------------- */
+/* ----------- One atan2 of (cross,dot), the sign of the cross product - */
+/* ----------- is taken from the robust orientation so points on or ---- */
+/* ----------- very near the start ray never flip to a full turn. ------ */
 /* --------------------------------------------------------------------- */
 
-double Geo_Arc_Span(const Vec2& p1, const Vec2& p2, const Vec2& centre,
-                                                              bool acw)
+static double span_angle(const Vec2& p1, const Vec2& p2,
+                                         const Vec2& centre, bool acw)
 {
   Vec2 dir1 = p1 - centre;
   Vec2 dir2 = p2 - centre;
 
-  double ang = Geo_Norm_Angle(acw,dir1.angleTo2(dir2));
+  double cr = Geo_Orient(centre,p1,p2);
+  double dt = dir1 * dir2;
+
+  if (cr == 0.0 && dt >= 0.0) return 0.0;
+
+  double ang = atan2(cr,dt);
+
+  if (acw) {
+    if (ang < 0.0) ang += Vec2::Pi2;
+  }
+  else {
+    if (ang > 0.0) ang -= Vec2::Pi2;
+  }
 
   return ang;
 }
 
+/* --------------------------------------------------------------------- */
+/* ----------- Calculate arcspan of arc in radians (acw = positive) ---- */
+/* --------------------------------------------------------------------- */
+
+double Geo_Arc_Span(const Vec2& p1, const Vec2& p2, const Vec2& centre,
+                                                              bool acw)
+{
+  return span_angle(p1,p2,centre,acw);
+}
+
 /* --------------------------------------------------------------------- */
 /* ----------- Calculate arclength of arc ------------------------------ */
 /* --------------------------------------------------------------------- */
@@ -88,11 +115,9 @@ double Geo_Arc_Span(const Vec2& p1, const Vec2& p2, const Vec2& centre,
 double Geo_Arc_Len(const Vec2& p1, const Vec2& p2, const Vec2& centre,
                                                               bool acw)
 {
-  Vec2 dir1 = p1 - centre;
-  Vec2 dir2 = p2 - centre;
   double r  = p1.distTo2(centre);
 
-  double ln = Geo_Norm_Angle(acw,dir1.angleTo2(dir2)) * r;
+  double ln = span_angle(p1,p2,centre,acw) * r;
   if (ln < 0) ln = -ln;
 
   return ln;
@@ -135,14 +160,132 @@ Vec2 Geo_Arc_Mid(const Vec2& p1, const Vec2& p2, const Vec2& centre,
 
 bool Geo_In_Between(const Vec2& a, const Vec2& b, const Vec2& c)
 {
-  bool ab = a.x*b.y - a.y*b.x >= 0.0;
-  bool ac = a.x*c.y - a.y*c.x >= 0.0;
-  bool cb = c.x*b.y - c.y*b.x >= 0.0;
+  bool ab = a.cross2(b) >= 0.0;
+  bool ac = a.cross2(c) >= 0.0;
+  bool cb = c.cross2(b) >= 0.0;
 
   if (ab) return (ac && cb);
   else    return (ac || cb);
 }
 
+/* --------------------------------------------------------------------- */
+/* ------------ Orientation of a, b, c (> 0 acw, < 0 cw, 0 on line) ---- */
+/* --------------------------------------------------------------------- */
+/* ------------ Returns (b-a) x (c-a). When the floating point result -- */
+/* ------------ is within its error bound the sign is determined ------- */
+/* ------------ exactly with expansion arithmetic (Shewchuk's adaptive - */
+/* ------------ orient2d), the returned value then is the leading ------ */
+/* ------------ component of the exact determinant. -------------------- */
+/* --------------------------------------------------------------------- */
+
+static inline void two_sum(double a, double b, double& x, double& y)
+{
+  x = a + b;
+  double bv = x - a; double av = x - bv;
+  y = (a - av) + (b - bv);
+}
+
+static inline void two_prod(double a, double b, double& x, double& y)
+{
+  x = a * b;
+  y = fma(a,b,-x);
+}
+
+static double orient_exact(const Vec2& a, const Vec2& b, const Vec2& c)
+{
+  // (a-c) x (b-c) expanded into six exact products
+
+  double trm[12];
+
+  two_prod( a.x,b.y,trm[0], trm[1]);
+  two_prod(-a.x,c.y,trm[2], trm[3]);
+  two_prod(-c.x,b.y,trm[4], trm[5]);
+  two_prod(-a.y,b.x,trm[6], trm[7]);
+  two_prod( a.y,c.x,trm[8], trm[9]);
+  two_prod( c.y,b.x,trm[10],trm[11]);
+
+  // Grow a nonoverlapping expansion, smallest component first
+
+  double exp[12]; int len = 0;
+
+  for (int i=0; i<12; ++i) {
+    double q = trm[i];
+    int nlen = 0;
+
+    for (int j=0; j<len; ++j) {
+      double h;
+      two_sum(q,exp[j],q,h);
+      if (h != 0.0) exp[nlen++] = h;
+    }
+
+    if (q != 0.0) exp[nlen++] = q;
+    len = nlen;
+  }
+
+  return len > 0 ? exp[len-1] : 0.0;
+}
+
+double Geo_Orient(const Vec2& a, const Vec2& b, const Vec2& c)
+{
+  static const double errBound = (3.0 + 16.0 * (DBL_EPSILON/2)) *
+                                                        (DBL_EPSILON/2);
+
+  double detl = (a.x - c.x) * (b.y - c.y);
+  double detr = (a.y - c.y) * (b.x - c.x);
+  double det  = detl - detr;
+
+  if (detl > 0.0) {
+    if (detr <= 0.0) return det;
+  }
+  else if (detl < 0.0) {
+    if (detr >= 0.0) return det;
+  }
+  else return det;
+
+  double bound = errBound * fabs(detl + detr);
+
+  if (det > bound || -det > bound) return det;
+
+  return orient_exact(a,b,c);
+}
+
+/* --------------------------------------------------------------------- */
+/* ------------ Is p within the span of arc s-e (centre c)? ------------ */
+/* --------------------------------------------------------------------- */
+/* ------------ Sector test on the directions from the centre, no ------ */
+/* ------------ angles. Points within tol of an endpoint are accepted -- */
+/* ------------ as well, the distance of p to the circle is ignored. --- */
+/* --------------------------------------------------------------------- */
+
+bool Geo_In_Arc_Span(const Vec2& p, const Vec2& s, const Vec2& e,
+                     const Vec2& c, bool acw, double tol)
+{
+  if (tol > 0.0) {
+    double sqtol = tol * tol;
+    if (p.sqDistTo2(s) <= sqtol || p.sqDistTo2(e) <= sqtol) return true;
+  }
+
+  const Vec2& a = acw ? s : e;       // Span from a to b is anticlockwise
+  const Vec2& b = acw ? e : s;
+
+  double ab = Geo_Orient(c,a,b);
+  double ap = Geo_Orient(c,a,p);
+
+  if (ab == 0.0) {
+    Vec2 da = a - c;
+
+    if (da * (b - c) > 0.0)                 // Zero span
+      return ap == 0.0 && da * (p - c) > 0.0;
+
+    return ap >= 0.0;                       // Half circle
+  }
+
+  double pb = Geo_Orient(c,p,b);
+
+  if (ab > 0.0) return ap >= 0.0 && pb >= 0.0;
+  else          return ap >= 0.0 || pb >= 0.0;
+}
+
 /* --------------------------------------------------------------------- */
 /* --------------------------------------------------------------------- */
 /* --------------------------------------------------------------------- */
@@ -167,6 +310,19 @@ static bool check_strict(double len1, double par1,
   return true;
 }
 
+/* --------------------------------------------------------------------- */
+/* --------------------------------------------------------------------- */
+/* --------------------------------------------------------------------- */
+
+static bool check_line_arc(double len1, double par1, const Vec2& ip,
+                           const Vec2& s2, const Vec2& e2, const Vec2& c2,
+                           bool acw2, double tol)
+{
+  if (par1 < -tol || par1 > len1 + tol) return false;
+
+  return Geo_In_Arc_Span(ip,s2,e2,c2,acw2,tol);
+}
+
 /* --------------------------------------------------------------------- */
 /* ------------ Project Point on a Line -------------------------------- */
 /* --------------------------------------------------------------------- */
@@ -194,16 +350,14 @@ bool Geo_Project_P_on_Line(const Vec2& p, const Vec2& s, const Vec2& e,
   else {
     dir /= len;
 
-    // Determine transform such that line is along x-axis starting in origin
-
-    Trf2 to_local(s,dir); Trf2 to_global; to_local.invertInto(to_global);
+    // Coordinates along and left of the line (as in a local system with
+    // the line along the x-axis starting in origin)
 
-    // Transform to local coordinate system
+    Vec2 sp = p - s;
 
-    pp = to_local * p; pr = pp.x; dist = pp.y; pp.y = 0;
+    pr = sp * dir; dist = dir.cross2(sp);
 
-    // Transform back to global
-    pp = to_global * pp;
+    pp = s + dir * pr;
 
     if (strict && (pr < -tol || pr > len+tol)) return false;
 
@@ -224,7 +378,7 @@ bool Geo_Project_P_on_Arc(const Vec2& p, const Vec2& s, const Vec2& e,
   
   double ex_dist = p.distTo2(c);
 
-  if (ex_dist < Vec2::IdentDist) {
+  if (ex_dist < Vec2::identDist()) {
     pp = s;
     pr = 0.0;
     dist = ex_dist - rad; if (acw) dist = -dist;
@@ -238,12 +392,10 @@ bool Geo_Project_P_on_Arc(const Vec2& p, const Vec2& s, const Vec2& e,
   pr = Geo_Arc_Len(s,pp,c,acw);
 
   if (strict) {
-    double arclen = Geo_Arc_Len(s,e,c,acw);
-
     double circum = Vec2::Pi2 * rad;
     correct_parm(pr,circum,tol);
 
-    if (pr < -tol || pr > arclen + tol) return false;
+    return Geo_In_Arc_Span(pp,s,e,c,acw,tol);
   }
 
   return true;
@@ -260,10 +412,11 @@ static int Isct_Line(const Vec2& b, const Vec2& dir, double len,
 {
   if (tol < NumAccuracy) tol = NumAccuracy;
 
-  Trf2 to_local(b,dir);
-  Trf2 to_global; to_local.invertInto(to_global);
+  // Local coordinates: line along x-axis starting in origin
+
+  Vec2 bs = s - b, be = e - b;
 
-  Vec2 ls = to_local * s; Vec2 le = to_local * e;
+  Vec2 ls(bs * dir, dir.cross2(bs)); Vec2 le(be * dir, dir.cross2(be));
 
   Vec2 d = le - ls;
 
@@ -284,7 +437,7 @@ static int Isct_Line(const Vec2& b, const Vec2& dir, double len,
   pr1 = ip.x;
   Vec2 dp = ip - ls; pr2 = dp * d/selen;
 
-  ip = to_global * ip;
+  ip = b + dir * pr1;
 
   if (strict && !check_strict(len,pr1,selen,pr2,tol)) return 0;
 
@@ -328,7 +481,6 @@ int Geo_Isct_Line_Arc(const Vec2& s1, const Vec2& e1,
   dir1 /= len1;
 
   double rad = s2.distTo2(c2);
-  double len2 = Geo_Arc_Len(s2, e2, c2, acw);
 
   Trf2 to_local(s1,dir1); Trf2 to_global; to_local.invertInto(to_global);
 
@@ -370,35 +522,37 @@ int Geo_Isct_Line_Arc(const Vec2& s1, const Vec2& e1,
     }
   }
 
-  pr1a = ipa.x; pr1b = ipb.x;
+  // ipa.x <= ipb.x, so the solutions are ordered along the line
 
-  pr2a = Geo_Arc_Len(ls2,ipa,lc2,acw);
-  pr2b = Geo_Arc_Len(ls2,ipb,lc2,acw);
+  Vec2 lipa = ipa, lipb = ipb;
+
+  pr1a = ipa.x; pr1b = ipb.x;
 
   ipa = to_global * ipa;
   ipb = to_global * ipb;
 
-  if (pr1a > pr1b) {
-    double hold;
-    hold = pr1a; pr1a = pr1b; pr1b = hold;
-    hold = pr2a; pr2a = pr2b; pr2b = hold;
+  if (strict) {   // Span test first, the arc parameter only if accepted
+    if (sols > 1 && !check_line_arc(len1,pr1b,ipb,s2,e2,c2,acw,tol)) sols--;
+    if (sols > 0 && !check_line_arc(len1,pr1a,ipa,s2,e2,c2,acw,tol)) {
+      sols--;
+      if (sols > 0) {
+        pr1a = pr1b; ipa = ipb; lipa = lipb;
+      }
+    }
 
-    Vec2 vhold = ipa; ipa = ipb; ipb = vhold;
+    if (sols < 1) return 0;
   }
 
+  pr2a = Geo_Arc_Len(ls2,lipa,lc2,acw);
+
+  if (sols > 1) pr2b = Geo_Arc_Len(ls2,lipb,lc2,acw);
+  else          pr2b = pr2a;
+
   if (strict) {
     double circum = Vec2::Pi2 * rad;
 
     correct_parm(pr2a,circum,tol);
     correct_parm(pr2b,circum,tol);
-
-    if (sols > 1 && !check_strict(len1,pr1b,len2,pr2b,tol)) sols--;
-    if (sols > 0 && !check_strict(len1,pr1a,len2,pr2a,tol)) {
-      sols--;
-      if (sols > 0) {
-        pr1a = pr1b; pr2a = pr2b; ipa = ipb;
-      }
-    }
   }
 
   return sols;
@@ -494,24 +648,39 @@ int Geo_Isct_Arc_Arc(const Vec2& s1, const Vec2& e1,
   ipa = to_global * ipa;
   ipb = to_global * ipb;
 
-  pr1a = Geo_Arc_Len(s1,ipa,c1,acw1);
-  pr1b = Geo_Arc_Len(s1,ipb,c1,acw1);
+  if (strict) {   // Span tests first, arc parameters only if accepted
+    if (sols > 1 && !(Geo_In_Arc_Span(ipb,s1,e1,c1,acw1,tol) &&
+                      Geo_In_Arc_Span(ipb,s2,e2,c2,acw2,tol))) sols--;
+
+    if (sols > 0 && !(Geo_In_Arc_Span(ipa,s1,e1,c1,acw1,tol) &&
+                      Geo_In_Arc_Span(ipa,s2,e2,c2,acw2,tol))) {
+      sols--;
+      if (sols > 0) ipa = ipb;
+    }
+
+    if (sols < 1) return 0;
+  }
 
+  pr1a = Geo_Arc_Len(s1,ipa,c1,acw1);
   pr2a = Geo_Arc_Len(s2,ipa,c2,acw2);
-  pr2b = Geo_Arc_Len(s2,ipb,c2,acw2);
 
-  if (pr1a > pr1b) {
-    double hold;
-    hold = pr1a; pr1a = pr1b; pr1b = hold;
-    hold = pr2a; pr2a = pr2b; pr2b = hold;
+  if (sols > 1) {
+    pr1b = Geo_Arc_Len(s1,ipb,c1,acw1);
+    pr2b = Geo_Arc_Len(s2,ipb,c2,acw2);
+
+    if (pr1a > pr1b) {
+      double hold;
+      hold = pr1a; pr1a = pr1b; pr1b = hold;
+      hold = pr2a; pr2a = pr2b; pr2b = hold;
 
-    Vec2 vhold = ipa; ipa = ipb; ipb = vhold;
+      Vec2 vhold = ipa; ipa = ipb; ipb = vhold;
+    }
+  }
+  else {
+    pr1b = pr1a; pr2b = pr2a;
   }
 
   if (strict) {
-    double len1 = Geo_Arc_Len(s1,e1,c1,acw1);
-    double len2 = Geo_Arc_Len(s2,e2,c2,acw2);
-
     double circum1 = Vec2::Pi2 * rad1;
     double circum2 = Vec2::Pi2 * rad2;
 
@@ -520,14 +689,6 @@ int Geo_Isct_Arc_Arc(const Vec2& s1, const Vec2& e1,
 
     correct_parm(pr2a,circum2,tol);
     correct_parm(pr2b,circum2,tol);
-
-    if (sols > 1 && !check_strict(len1,pr1b,len2,pr2b,tol)) sols--;
-    if (sols > 0 && !check_strict(len1,pr1a,len2,pr2a,tol)) {
-      sols--;
-      if (sols > 0) {
-        pr1a = pr1b; pr2a = pr2b; ipa = ipb;
-      }
-    }
   }
   return sols;
 }
@@ -582,11 +743,13 @@ int Geo_Isct_Arc_Circle(const Vec2& s1, const Vec2& e1,
                                               ipa,ipb,pr1a,pr1b,pr2a,pr2b);
 
   if (strict) {
-    double len1 = Geo_Arc_Len(s1,e1,c1,acw1);
     double len2 = s2.distTo2(c2) * Vec2::Pi2;
 
-    if (sols > 1 && !check_strict(len1,pr1b,len2,pr2b,tol)) sols--;
-    if (sols > 0 && !check_strict(len1,pr1a,len2,pr2a,tol)) {
+    if (sols > 1 && !(Geo_In_Arc_Span(ipb,s1,e1,c1,acw1,tol) &&
+                      pr2b >= -tol && pr2b <= len2 + tol)) sols--;
+
+    if (sols > 0 && !(Geo_In_Arc_Span(ipa,s1,e1,c1,acw1,tol) &&
+                      pr2a >= -tol && pr2a <= len2 + tol)) {
       sols--;
       if (sols > 0) {
         pr1a = pr1b; pr2a = pr2b; ipa = ipb;
@@ -616,6 +779,163 @@ int Geo_Isct_Circle_Circle(const Vec2& s1, const Vec2& c1, bool acw1,
   return sols;
 }
 
+/* --------------------------------------------------------------------- */
+/* ---------- Fillet between two elements ------------------------------ */
+/* --------------------------------------------------------------------- */
+
+static Vec2 fillet_tangent(const Vec2& p, const Vec2& s, const Vec2& e,
+                                               const Vec2 *c, bool acw)
+{
+  Vec2 tg;
+
+  if (c) {
+    tg = p - *c;
+    if (acw) tg.rot90(); else tg.rot270();
+  }
+  else tg = e - s;
+
+  tg.unitLen2();
+
+  return tg;
+}
+
+/* --------------------------------------------------------------------- */
+
+static bool fillet_on_elem(const Vec2& p, const Vec2& s, const Vec2& e,
+                                   const Vec2 *c, bool acw, double tol)
+{
+  if (c) return Geo_In_Arc_Span(p,s,e,*c,acw,tol);
+
+  Vec2 dir = e - s;
+  double len = dir.unitLen2();
+
+  double pr = (p - s) * dir;
+
+  return pr >= -tol && pr <= len + tol;
+}
+
+/* --------------------------------------------------------------------- */
+/* ---------- The centre lies on both elements offset by rad towards --- */
+/* ---------- the inside of the turn, the candidate nearest the -------- */
+/* ---------- corner is taken ------------------------------------------ */
+/* --------------------------------------------------------------------- */
+
+bool Geo_Fillet(const Vec2& s1, const Vec2& e1, const Vec2 *c1, bool acw1,
+                const Vec2& s2, const Vec2& e2, const Vec2 *c2, bool acw2,
+                double rad, double tol,
+                Vec2& t1, Vec2& t2, Vec2& fc, bool& facw)
+{
+  if (rad <= tol) return false;
+
+  Vec2 d1 = fillet_tangent(e1,s1,e1,c1,acw1);
+  Vec2 d2 = fillet_tangent(s2,s2,e2,c2,acw2);
+
+  double turn = d1.cross2(d2);
+
+  if (fabs(turn) < Vec2::identDir() && d1 * d2 > 0.0) return false;
+
+  facw = turn > 0.0;
+
+  double side = facw ? rad : -rad;    // Left of the elements if > 0
+
+  // Offsets: a line through q along dir, or a circle with radius orad
+
+  Vec2 q[2], dir[2];
+  double orad[2] = { 0.0, 0.0 };
+
+  const Vec2 *cs[2] = { c1, c2 };
+  const Vec2 *ss[2] = { &s1, &s2 };
+  bool acws[2] = { acw1, acw2 };
+
+  for (int i=0; i<2; ++i) {
+    if (cs[i]) {
+      double r = ss[i]->distTo2(*cs[i]);
+
+      orad[i] = acws[i] ? r - side : r + side;
+      if (orad[i] <= tol) return false;
+    }
+    else {
+      dir[i] = i == 0 ? d1 : d2;
+      Vec2 n(dir[i]); n.rot90();
+
+      q[i] = *ss[i] + n * side;
+    }
+  }
+
+  Vec2 cand[2];
+  int cnt = 0;
+
+  if (!c1 && !c2) {
+    double den = dir[0].cross2(dir[1]);
+    if (fabs(den) < NumAccuracy) return false;
+
+    double t = (q[1] - q[0]).cross2(dir[1]) / den;
+    cand[cnt++] = q[0] + dir[0] * t;
+  }
+  else if (!c1 || !c2) {
+    int li = c1 ? 1 : 0, ci = 1 - li;
+
+    const Vec2& c = *cs[ci];
+
+    Vec2 w = q[li] - c;
+    double b  = w * dir[li];
+    double dd = b*b - (w.lenSq2() - orad[ci]*orad[ci]);
+
+    if (dd < 0.0) {
+      if (dd < -tol*tol) return false;
+      dd = 0.0;
+    }
+
+    dd = sqrt(dd);
+
+    cand[cnt++] = q[li] + dir[li] * (-b - dd);
+    cand[cnt++] = q[li] + dir[li] * (-b + dd);
+  }
+  else {
+    Vec2 dc = *c2 - *c1;
+    double d = dc.len2();
+
+    if (d < NumAccuracy) return false;
+
+    double a  = (orad[0]*orad[0] - orad[1]*orad[1] + d*d) / (2.0*d);
+    double hh = orad[0]*orad[0] - a*a;
+
+    if (hh < 0.0) {
+      if (hh < -tol*tol) return false;
+      hh = 0.0;
+    }
+
+    Vec2 m = *c1 + dc * (a/d);
+    Vec2 n(dc); n.rot90(); n *= sqrt(hh)/d;
+
+    cand[cnt++] = m + n;
+    cand[cnt++] = m - n;
+  }
+
+  if (cnt > 1 && cand[1].sqDistTo2(e1) < cand[0].sqDistTo2(e1))
+                                                         cand[0] = cand[1];
+  fc = cand[0];
+
+  // Tangent points, on the elements and running the same way
+
+  if (c1) { t1 = fc - *c1; t1.len2(s1.distTo2(*c1)); t1 += *c1; }
+  else    t1 = s1 + d1 * ((fc - s1) * d1);
+
+  if (c2) { t2 = fc - *c2; t2.len2(s2.distTo2(*c2)); t2 += *c2; }
+  else    t2 = s2 + d2 * ((fc - s2) * d2);
+
+  if (!fillet_on_elem(t1,s1,e1,c1,acw1,tol)) return false;
+  if (!fillet_on_elem(t2,s2,e2,c2,acw2,tol)) return false;
+
+  Vec2 ft1 = fillet_tangent(t1,t1,t2,&fc,facw);
+  Vec2 ft2 = fillet_tangent(t2,t1,t2,&fc,facw);
+
+  if (ft1 * fillet_tangent(t1,s1,e1,c1,acw1) <= 0.0) return false;
+  if (ft2 * fillet_tangent(t2,s2,e2,c2,acw2) <= 0.0) return false;
+
+  return true;
+}
+
 } // namespace Ino
 
 /* --------------------------------------------------------------------- */
@@ -75,8 +75,8 @@ void Isect_Pair::Swap()
 
 int Isect_Cmp::Compare(const Isect_Pair& p1, const Isect_Pair& p2)
 {
-  if      (p1.First.Par < p2.First.Par - Vec2::IdentDist) return -1;
-  else if (p1.First.Par > p2.First.Par + Vec2::IdentDist) return 1;
+  if      (p1.First.Par < p2.First.Par - Vec2::identDist()) return -1;
+  else if (p1.First.Par > p2.First.Par + Vec2::identDist()) return 1;
   else if (p1.Last.Par  < p2.Last.Par) return -1;
   return 1;
 }
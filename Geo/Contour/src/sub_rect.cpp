@@ -182,7 +182,7 @@ bool Elem_Rect_List::Project_Pnt_XY(const Vec2& p, Elem_Cursor& nel,
 
   do {
     if (!first && crc->Rect.Dist_To_XY(p) >
-                                     fabs(dist_xy) + Vec2::IdentDist) {
+                                     fabs(dist_xy) + Vec2::identDist()) {
       cel = crc->Upto; if (!cel) cel.To_Begin();
       ++crc;           if (!crc) crc.To_Begin();
 
@@ -288,7 +288,7 @@ bool Elem_Rect_List::Project_Pnt_XY(const Vec2& p,
 
     if (!range_overlap(par1,par2,begin_par,end_par) ||
         (!first && crc->Rect.Dist_To_XY(p) >
-                                     fabs(dist_xy) + Vec2::IdentDist)) {
+                                     fabs(dist_xy) + Vec2::identDist())) {
       cel = upelc;
       ++crc; if (!crc) crc.To_Begin();
 
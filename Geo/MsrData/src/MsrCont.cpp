@@ -19,19 +19,20 @@
 
 #include "Vec.h"
 #include "Trf.h"
+#include "TaskPool.h"
 
 #include "Contour.h"
 #include "El_Line.h"
 #include "El_Arc.h"
 
 #include "LsGeo.h"
-#include "Matrix.h"
 
 #include "DxfOut.h"
 
 #include <cstdio>
 #include <cmath>
 #include <cstring>
+#include <vector>
 
 namespace Ino
 {
@@ -105,6 +106,214 @@ static void calcWireDirTo(double axDist, double rollRad,
   dir.transform3(trf);
 }
 
+//---------------------------------------------------------------------------
+//------ Parallel execution over points -------------------------------------
+//---------------------------------------------------------------------------
+// Calls fn(i) for i in [0,n) on the shared task pool, one thread per
+// ParMinPts points in total at most, so small jobs stay on the calling
+// thread. Every index is handled by exactly one thread, so the results
+// never depend on the thread count.
+
+enum { ParMinPts = 65536, ParBlockPts = 16384 };
+
+template <class Fn> static void forEachTask(int n, long pntCnt, Fn fn)
+{
+  long thrCnt = pntCnt / ParMinPts;
+
+  if (thrCnt < 2) {
+    for (int i=0; i<n; ++i) fn(i);
+    return;
+  }
+
+  parallelFor(n,thrCnt < n ? (int)thrCnt : n,fn);
+}
+
+//---------------------------------------------------------------------------
+// A contiguous range of points of one contour, the unit of parallel work.
+
+struct PtBlock
+{
+  int cont, lwb, upb;
+  PlaneMoments mom;
+
+  PtBlock(int contIdx, int lb, int ub) : cont(contIdx), lwb(lb), upb(ub) {}
+};
+
+static void addBlocks(vector<PtBlock>& blocks, int cont, int lwb, int upb)
+{
+  for (int i=lwb; i<upb; i += ParBlockPts) {
+    int ub = i + ParBlockPts;
+    if (ub > upb) ub = upb;
+
+    blocks.push_back(PtBlock(cont,i,ub));
+  }
+}
+
+//---------------------------------------------------------------------------
+//------ PlaneMoments Methods -----------------------------------------------
+//---------------------------------------------------------------------------
+// Count, mean and the sums of products of the deviations from the mean of
+// a set of points. Points are added one at a time (Welford) and partial
+// sums of disjoint sets are merged exactly (Chan et al.), so a plane fit
+// needs neither a second pass nor an n x 3 matrix.
+
+void PlaneMoments::add(const Vec3& p)
+{
+  cnt++;
+
+  double dx = p.x - mean.x, dy = p.y - mean.y, dz = p.z - mean.z;
+
+  double f = 1.0/cnt;
+
+  mean.x += dx*f; mean.y += dy*f; mean.z += dz*f;
+
+  double ex = p.x - mean.x, ey = p.y - mean.y, ez = p.z - mean.z;
+
+  cxx += dx*ex; cxy += dx*ey; cxz += dx*ez;
+  cyy += dy*ey; cyz += dy*ez;
+  czz += dz*ez;
+}
+
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
+void PlaneMoments::merge(const PlaneMoments& m)
+{
+  if (m.cnt < 1) return;
+
+  if (cnt < 1) {
+    *this = m;
+    return;
+  }
+
+  double n = (double)(cnt + m.cnt);
+  double f = (double)cnt * (double)m.cnt / n;
+
+  double dx = m.mean.x - mean.x, dy = m.mean.y - mean.y,
+                                 dz = m.mean.z - mean.z;
+
+  cxx += m.cxx + dx*dx*f; cxy += m.cxy + dx*dy*f; cxz += m.cxz + dx*dz*f;
+  cyy += m.cyy + dy*dy*f; cyz += m.cyz + dy*dz*f;
+  czz += m.czz + dz*dz*f;
+
+  double g = (double)m.cnt / n;
+
+  mean.x += dx*g; mean.y += dy*g; mean.z += dz*g;
+
+  cnt += m.cnt;
+}
+
+//---------------------------------------------------------------------------
+// The moments of the transformed points: mean' = T(mean) and C' = A C A^T
+// with A the linear part of trf (exact for any affine transformation).
+
+void PlaneMoments::transform(const Trf3& trf)
+{
+  if (cnt < 1) return;
+
+  mean.transform3(trf);
+
+  double c[3][3] = { { cxx, cxy, cxz }, { cxy, cyy, cyz },
+                     { cxz, cyz, czz } };
+  double ac[3][3];
+
+  for (int i=0; i<3; ++i) {
+    for (int j=0; j<3; ++j) {
+      ac[i][j] = trf(i,0)*c[0][j] + trf(i,1)*c[1][j] + trf(i,2)*c[2][j];
+    }
+  }
+
+  for (int i=0; i<3; ++i) {
+    for (int j=i; j<3; ++j) {
+      c[i][j] = ac[i][0]*trf(j,0) + ac[i][1]*trf(j,1) + ac[i][2]*trf(j,2);
+    }
+  }
+
+  cxx = c[0][0]; cxy = c[0][1]; cxz = c[0][2];
+  cyy = c[1][1]; cyz = c[1][2];
+  czz = c[2][2];
+}
+
+//---------------------------------------------------------------------------
+// Cyclic Jacobi rotations on a symmetric 3x3 matrix. On return the diagonal
+// of a holds the eigenvalues and the columns of v the eigenvectors.
+
+static void jacobiEigen3(double a[3][3], double v[3][3])
+{
+  for (int i=0; i<3; ++i) {
+    for (int j=0; j<3; ++j) v[i][j] = i == j ? 1.0 : 0.0;
+  }
+
+  for (int sweep=0; sweep<50; ++sweep) {
+    double off  = fabs(a[0][1]) + fabs(a[0][2]) + fabs(a[1][2]);
+    double diag = fabs(a[0][0]) + fabs(a[1][1]) + fabs(a[2][2]);
+
+    if (off <= 1e-18 * diag || off == 0.0) return;
+
+    for (int p=0; p<2; ++p) {
+      for (int q=p+1; q<3; ++q) {
+        if (a[p][q] == 0.0) continue;
+
+        double theta = (a[q][q] - a[p][p]) / (2.0*a[p][q]);
+        double t = fabs(theta) > 1e150 ? 0.5/theta
+                 : (theta >= 0.0 ? 1.0 : -1.0) /
+                                     (fabs(theta) + sqrt(theta*theta + 1.0));
+        double c = 1.0/sqrt(t*t + 1.0), s = t*c;
+
+        for (int k=0; k<3; ++k) {
+          double akp = a[k][p], akq = a[k][q];
+
+          a[k][p] = c*akp - s*akq;
+          a[k][q] = s*akp + c*akq;
+        }
+
+        for (int k=0; k<3; ++k) {
+          double apk = a[p][k], aqk = a[q][k];
+
+          a[p][k] = c*apk - s*aqk;
+          a[q][k] = s*apk + c*aqk;
+        }
+
+        for (int k=0; k<3; ++k) {
+          double vkp = v[k][p], vkq = v[k][q];
+
+          v[k][p] = c*vkp - s*vkq;
+          v[k][q] = s*vkp + c*vkq;
+        }
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+// The normal of the least squares plane through the points is the
+// eigenvector of the smallest eigenvalue of the scatter matrix (the same
+// vector as the smallest right singular vector of the centered points).
+
+bool PlaneMoments::fitPlane(Vec3& nrm) const
+{
+  if (cnt < 3) return false;
+
+  double a[3][3] = { { cxx, cxy, cxz }, { cxy, cyy, cyz },
+                     { cxz, cyz, czz } };
+  double v[3][3];
+
+  jacobiEigen3(a,v);
+
+  int minIdx = 0;
+
+  for (int i=1; i<3; ++i) {
+    if (fabs(a[i][i]) < fabs(a[minIdx][minIdx])) minIdx = i;
+  }
+
+  nrm.x = v[0][minIdx];
+  nrm.y = v[1][minIdx];
+  nrm.z = v[2][minIdx];
+
+  return true;
+}
+
 //---------------------------------------------------------------------------
 //----- MsrCont Methods -----------------------------------------------------
 //---------------------------------------------------------------------------
@@ -130,7 +339,7 @@ void MsrCont::resize(int newCap)
 
 MsrCont::MsrCont(double radCorrection, int layer)
 : radCorr(radCorrection), layerNr(layer),
-  itList(new MsrPoint[100]), cap(100), sz(0)
+  itList(new MsrPoint[100]), cap(100), sz(0), moms(), momSz(0)
 {
 }
 
@@ -140,7 +349,8 @@ MsrCont::MsrCont(double radCorrection, int layer)
 
 MsrCont::MsrCont(const MsrCont& cp)
 : radCorr(cp.radCorr), layerNr(cp.layerNr),
-  itList(new MsrPoint[cp.sz]),cap(cp.sz), sz(cp.sz)
+  itList(new MsrPoint[cp.sz]),cap(cp.sz), sz(cp.sz),
+  moms(cp.moms), momSz(cp.momSz)
 {
   memmove(itList,cp.itList,sz*sizeof(MsrPoint));
 }
@@ -164,6 +374,8 @@ MsrCont& MsrCont::operator=(const MsrCont& src)
   layerNr = src.layerNr;
   sz      = src.sz;
   cap     = src.sz;
+  moms    = src.moms;
+  momSz   = src.momSz;
 
   if (itList) delete[] itList;
 
@@ -197,6 +409,11 @@ void MsrCont::addPt(bool pointMode, const Vec3& p)
   MsrPoint& it = itList[sz++];
 
   it.set(p,pointMode);
+
+  if (momSz == sz-1) { // Keep the moments up to date while measuring
+    moms.add(p);
+    momSz = sz;
+  }
 }
 
 //---------------------------------------------------------------------------
@@ -235,7 +452,7 @@ void MsrCont::applyOffset(double axDist, double rollRad,
     calcWireDirTo(axDist,rollRad,pt,dir); dir.unitLen3();
 
     Vec3 nrm = dir.outer(zDir);
-    if (nrm.len3() < 1e-7) return; // Sorry, cant oblige
+    if (nrm.len3() < 1e-7) break; // Sorry, cant oblige
 
     nrm.unitLen3();
     nrm = zDir.outer(nrm);
@@ -245,6 +462,9 @@ void MsrCont::applyOffset(double axDist, double rollRad,
 
     pt += nrm;
   }
+
+  moms.clear();
+  momSz = 0;
 }
 
 //---------------------------------------------------------------------------
@@ -254,6 +474,11 @@ void MsrCont::applyOffset(double axDist, double rollRad,
 void MsrCont::removeLastPt()
 {
   if (sz > 0) sz--;
+
+  if (momSz > sz) {
+    moms.clear();
+    momSz = 0;
+  }
 }
 
 //---------------------------------------------------------------------------
@@ -302,6 +527,15 @@ bool MsrCont::calcHullRect(Vec3& minPt, Vec3& maxPt) const
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 
+size_t MsrCont::memSize() const
+{
+  return sizeof(*this) + cap * sizeof(MsrPoint);
+}
+
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
 void MsrCont::close()
 {
   if (!closed()) addPt(itList[0].point,itList[0].pt);
@@ -411,7 +645,54 @@ void MsrCont::transform(const Trf3& trf)
 {
   if (!itList) return;
 
-  for (int i=0; i<sz; ++i) itList[i].transform(trf);
+  transformRange(trf,0,sz);
+
+  moms.transform(trf);
+}
+
+//---------------------------------------------------------------------------
+// Same as MsrPoint::transform() on each point in [lwb,upb), with the matrix
+// held in locals so the loop does not reload it for every point.
+// Does not update the moments.
+
+void MsrCont::transformRange(const Trf3& trf, int lwb, int upb)
+{
+  double m00 = trf(0,0), m01 = trf(0,1), m02 = trf(0,2), m03 = trf(0,3);
+  double m10 = trf(1,0), m11 = trf(1,1), m12 = trf(1,2), m13 = trf(1,3);
+  double m20 = trf(2,0), m21 = trf(2,1), m22 = trf(2,2), m23 = trf(2,3);
+
+  bool trfDeriv = trf.isDerivative;
+
+  for (int i=lwb; i<upb; ++i) {
+    Vec3& p = itList[i].pt;
+
+    double x = p.x, y = p.y, z = p.z;
+
+    p.x = m00*x + m01*y + m02*z;
+    p.y = m10*x + m11*y + m12*z;
+    p.z = m20*x + m21*y + m22*z;
+
+    if (!p.isDerivative) {
+      p.x += m03; p.y += m13; p.z += m23;
+      p.isDerivative = trfDeriv;
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+/** Returns the moments (count, mean, scatter) of all points of this
+    contour. They are updated as points are added; after an operation that
+    moves points (other than transform()) they are rebuilt here from the
+    points not yet accounted for.
+*/
+
+const PlaneMoments& MsrCont::moments() const
+{
+  for (int i=momSz; i<sz; ++i) moms.add(itList[i].pt);
+
+  momSz = sz;
+
+  return moms;
 }
 
 //---------------------------------------------------------------------------
@@ -973,6 +1254,75 @@ bool MsrContLst::getDir(Vec3& p2) const
   return false;
 }
 
+//---------------------------------------------------------------------------
+// Total number of points in the first upb contours.
+
+long MsrContLst::pointCount(int upb) const
+{
+  long pntCnt = 0;
+
+  for (int i=0; i<upb; i++) {
+    if (contList[i]) pntCnt += contList[i]->sz;
+  }
+
+  return pntCnt;
+}
+
+//---------------------------------------------------------------------------
+// Sums the moments of the first upb contours. The points not yet in the
+// moments of their contour are added in fixed blocks on all threads; the
+// blocks and then the contours are merged in order, so the result does not
+// depend on the number of threads.
+
+void MsrContLst::sumMoments(int upb, PlaneMoments& mom) const
+{
+  vector<PtBlock> blocks;
+
+  for (int i=0; i<upb; i++) {
+    const MsrCont& cnt = *contList[i];
+    addBlocks(blocks,i,cnt.momSz,cnt.sz);
+  }
+
+  forEachTask((int)blocks.size(),pointCount(upb),[&](int b) {
+    PtBlock& blk = blocks[b];
+    const MsrCont& cnt = *contList[blk.cont];
+
+    for (int j=blk.lwb; j<blk.upb; j++) blk.mom.add(cnt.itList[j]);
+  });
+
+  for (size_t b=0; b<blocks.size(); b++) {
+    const MsrCont& cnt = *contList[blocks[b].cont];
+
+    cnt.moms.merge(blocks[b].mom);
+    cnt.momSz = blocks[b].upb;
+  }
+
+  mom.clear();
+
+  for (int i=0; i<upb; i++) mom.merge(contList[i]->moments());
+}
+
+//---------------------------------------------------------------------------
+// Transforms all points, in blocks on all threads.
+
+void MsrContLst::transformAll(const Trf3& trf)
+{
+  vector<PtBlock> blocks;
+
+  for (int i=0; i<sz; i++) {
+    if (contList[i]) addBlocks(blocks,i,0,contList[i]->sz);
+  }
+
+  forEachTask((int)blocks.size(),pointCount(sz),[&](int b) {
+    const PtBlock& blk = blocks[b];
+    contList[blk.cont]->transformRange(trf,blk.lwb,blk.upb);
+  });
+
+  for (int i=0; i<sz; i++) {
+    if (contList[i]) contList[i]->moms.transform(trf);
+  }
+}
+
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
@@ -982,43 +1332,29 @@ void MsrContLst::findOrgZXDir(bool projectFst,
 {
   // Find origin (avg of all points)
 
-  int pntCnt = 0;
-
   org.x  = 0.0; org.y  = 0.0; org.z  = 0.0;
   xDir.x = 1.0; xDir.y = 0.0; xDir.z = 0.0;
   zDir.x = 0.0; zDir.y = 0.0; zDir.z = 1.0;
 
-  org.x = 0.0; org.y = 0.0; org.z= 0.0;
-
-  Vec3 p1;
-  int i;
-
   int upb = sz;
-  if (projectFst) upb = 1;
+  if (projectFst && upb > 1) upb = 1;
 
-  for (i=0; i<upb; i++) {
-    const MsrCont& cnt = *contList[i];
-
-    for (int j=0; j<cnt.sz; j++) {
-      const MsrPoint& pnt = cnt.itList[j];
-      const Vec3& pt = pnt;
-
-      if (i==0 && j==0) p1 = pt;
+  if (upb < 1) return;
 
-      org += pt;
+  PlaneMoments mom;
+  sumMoments(upb,mom);
 
-      pntCnt++;
-    }
-  }
+  long pntCnt = mom.count();
 
   if (pntCnt < 1) return;
 
-  org.x /= pntCnt;
-  org.y /= pntCnt;
-  org.z /= pntCnt;
+  org = mom.getMean();
 
   if (pntCnt < 2) return;
 
+  Vec3 p1;
+  if (contList[0]->sz > 0) p1 = contList[0]->itList[0];
+
   bool xDirSet = true;
   Vec3 p21;
 
@@ -1052,45 +1388,7 @@ void MsrContLst::findOrgZXDir(bool projectFst,
     return;
   }
 
-  Matrix mat(pntCnt,3);
-  Matrix vt(3,3);
-
-  pntCnt = 0;
-
-  for (i=0; i<upb; i++) {
-    const MsrCont& cnt = *contList[i];
-
-    for (int j=0; j<cnt.sz; j++) {
-      const MsrPoint& pnt = cnt.itList[j];
-      const Vec3& pt = pnt;
-
-      mat(pntCnt,0) = pt.x - org.x;
-      mat(pntCnt,1) = pt.y - org.y;
-      mat(pntCnt,2) = pt.z - org.z;
-
-      pntCnt++;
-    }
-  }
-
-  int rank = 0;
-  int iter = 16+pntCnt*2;
-
-  if (!mat.solveSvd(pntCnt,3,vt,rank,iter)) return;
-
-  double minLabda = fabs(mat(0,0));
-  zDir.x = vt(0,0);
-  zDir.y = vt(0,1);
-  zDir.z = vt(0,2);
-
-  for (i=1; i<3; ++i) {
-    if (fabs(mat(i,i)) < minLabda) {
-      minLabda = fabs(mat(i,i));
-
-      zDir.x = vt(i,0);
-      zDir.y = vt(i,1);
-      zDir.z = vt(i,2);
-    }
-  }
+  if (!mom.fitPlane(zDir)) return;
 
   xDirSet = false;
 
@@ -1157,23 +1455,26 @@ void MsrContLst::projectToPlane(double axDist, double rollRad,
 
   // Apply horizontal pen offsets:
 
-  for (int i=0; i<sz; i++) contList[i]->applyOffset(axDist,rollRad,horOffset,zDir);
+  forEachTask(sz,pointCount(sz),[&](int i) {
+    contList[i]->applyOffset(axDist,rollRad,horOffset,zDir);
+  });
 
   Trf3 trf(org,zDir,xDir);
-  for (int i=0; i<sz; i++) contList[i]->transform(trf);
 
   // Now make first point the origin (at same z_level)
   MsrCont *cnt = contList[0];
-  if (cnt == NULL || cnt->sz < 1) return;
+  if (cnt == NULL || cnt->sz < 1) {
+    transformAll(trf);
+    return;
+  }
 
-  const Vec3& pt0 = cnt->itList[0];
-  Vec3 p0(pt0); p0.z = 0;
+  Vec3 p0(cnt->itList[0]); p0.transform3(trf); p0.z = 0;
 
   Trf3 trf2(p0,Vec3(0,0,1),Vec3(1,0,0));
 
-  for (int i=0; i<sz; i++) contList[i]->transform(trf2);
-
   planeTrf = trf2; planeTrf *= trf;
+
+  transformAll(planeTrf); // One pass instead of trf and then trf2
 }
 
 //---------------------------------------------------------------------------
@@ -1219,9 +1520,7 @@ void MsrContLst::transform(const Trf3& trf)
 {
   if (!contList) return;
 
-  for (int i=0; i<sz; ++i) {
-    if (contList[i]) contList[i]->transform(trf);
-  }
+  transformAll(trf);
 }
 
 //---------------------------------------------------------------------------
@@ -1248,6 +1547,19 @@ bool MsrContLst::calcHullRect(Vec3& minPt, Vec3& maxPt) const
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 
+size_t MsrContLst::memSize() const
+{
+  size_t memSz = sizeof(*this) + cap * sizeof(MsrCont *);
+
+  for (int i=0; i<sz; ++i) memSz += contList[i]->memSize();
+
+  return memSz;
+}
+
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
 #ifndef __GNUC__
 bool MsrContLst::appendToCcd(DB2* ccdDb, bool threeD,bool unitInch,
                                                 const char *contourTag) const
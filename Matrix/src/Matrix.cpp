@@ -17,15 +17,121 @@
 #include <string.h>
 #include <algorithm>
 
-#ifdef _WIN32
-#include <malloc.h>
-#else
-#include <alloca.h>
-#endif
-
 namespace Ino
 {
 
+//---------------------------------------------------------------------------
+//------ MatrixWorkspace ----------------------------------------------------
+//---------------------------------------------------------------------------
+
+struct MatrixWorkspace::Block
+{
+  Block *next;
+  size_t cap, used; // In doubles
+  double *data;
+
+  Block(size_t sz) : next(NULL), cap(sz), used(0), data(new double[sz]) {}
+  ~Block() { delete[] data; }
+};
+
+//---------------------------------------------------------------------------
+
+MatrixWorkspace::MatrixWorkspace(size_t initDoubles)
+: first(NULL), cur(NULL), nextBlockSz(initDoubles), heapAllocs(0)
+{
+  if (nextBlockSz < 64) nextBlockSz = 64;
+
+  first = cur = new Block(nextBlockSz);
+  heapAllocs++;
+}
+
+//---------------------------------------------------------------------------
+
+MatrixWorkspace::~MatrixWorkspace()
+{
+  while (first) {
+    Block *nxt = first->next;
+    delete first;
+    first = nxt;
+  }
+}
+
+//---------------------------------------------------------------------------
+// The rest of the current block, else the next (emptied) block that is
+// large enough. A new block is twice the last one, at least.
+
+double *MatrixWorkspace::take(size_t doubles)
+{
+  if (doubles < 1) doubles = 1;
+
+  while (cur->used + doubles > cur->cap) {
+    if (!cur->next) {
+      nextBlockSz *= 2;
+      if (nextBlockSz < doubles) nextBlockSz = doubles;
+
+      cur->next = new Block(nextBlockSz);
+      heapAllocs++;
+    }
+
+    cur = cur->next;
+    cur->used = 0;
+  }
+
+  double *p = cur->data + cur->used;
+  cur->used += doubles;
+
+  return p;
+}
+
+//---------------------------------------------------------------------------
+
+void *MatrixWorkspace::takeBytes(size_t bytes)
+{
+  return take((bytes + sizeof(double) - 1) / sizeof(double));
+}
+
+//---------------------------------------------------------------------------
+
+size_t MatrixWorkspace::capacity() const
+{
+  size_t cap = 0;
+
+  for (Block *blk = first; blk; blk = blk->next) cap += blk->cap;
+
+  return cap;
+}
+
+//---------------------------------------------------------------------------
+
+void MatrixWorkspace::release(Block *blk, size_t used)
+{
+  cur = blk;
+  cur->used = used;
+}
+
+//---------------------------------------------------------------------------
+
+MatrixWorkspace::Mark::Mark(MatrixWorkspace& workspace)
+: ws(workspace), blk(workspace.cur), used(workspace.cur->used)
+{
+}
+
+//---------------------------------------------------------------------------
+
+MatrixWorkspace::Mark::~Mark()
+{
+  ws.release(blk,used);
+}
+
+//---------------------------------------------------------------------------
+
+MatrixWorkspace& MatrixWorkspace::local()
+{
+  static thread_local MatrixWorkspace threadWs;
+
+  return threadWs;
+}
+
 //---------------------------------------------------------------------------
 
 void Vector::setSize(int newSz, bool preserve, bool zeroInit)
@@ -39,7 +145,7 @@ void Vector::setSize(int newSz, bool preserve, bool zeroInit)
   }
 
   if (preserve && va) {
-    double* newVa = new double[newSz];
+    double* newVa = ws ? ws->take(newSz) : new double[newSz];
 
     if (newSz <= sz) memmove(newVa,va,newSz*sizeof(double));
     else {
@@ -47,13 +153,16 @@ void Vector::setSize(int newSz, bool preserve, bool zeroInit)
       if (zeroInit) memset(newVa+sz,0,(newSz-sz)*sizeof(double));
     }
 
-    delete[] va;
+    if (!ws) delete[] va;
 
     va = newVa;
   }
   else {
-    delete[] va;
-    va = new double[newSz];
+    if (ws) va = ws->take(newSz);
+    else {
+      delete[] va;
+      va = new double[newSz];
+    }
 
     if (zeroInit) memset(va,0,newSz * sizeof(double));
   }
@@ -66,14 +175,14 @@ void Vector::setSize(int newSz, bool preserve, bool zeroInit)
 // For PVector
 
 Vector::Vector(double *arr, int len)
-: va(arr), sz(arr ? len : 0), cap(len)
+: va(arr), sz(arr ? len : 0), cap(len), ws(NULL)
 {
 }
 
 //---------------------------------------------------------------------------
 
 Vector::Vector(int vSize, bool zeroInit)
-: va(NULL), sz(vSize), cap(vSize)
+: va(NULL), sz(vSize), cap(vSize), ws(NULL)
 {
   if (vSize < 0) throw IllegalArgumentException("Vector::Vector");
 
@@ -84,8 +193,20 @@ Vector::Vector(int vSize, bool zeroInit)
 
 //---------------------------------------------------------------------------
 
+Vector::Vector(MatrixWorkspace& workspace, int vSize, bool zeroInit)
+: va(NULL), sz(vSize), cap(vSize), ws(&workspace)
+{
+  if (vSize < 0) throw IllegalArgumentException("Vector::Vector");
+
+  va = ws->take(cap);
+
+  if (zeroInit) memset(va,0,sz*sizeof(double));
+}
+
+//---------------------------------------------------------------------------
+
 Vector::Vector(const Vector& cp)
-: va(NULL), sz(cp.sz), cap(cp.sz)
+: va(NULL), sz(cp.sz), cap(cp.sz), ws(NULL)
 {
   va = new double[cap];
 
@@ -96,7 +217,7 @@ Vector::Vector(const Vector& cp)
 
 Vector::~Vector()
 {
-  delete[] va;
+  if (!ws) delete[] va;
 }
 
 //---------------------------------------------------------------------------
@@ -251,14 +372,22 @@ double Vector::len(int dims) const
 
 void Matrix::alloc(int rows, int cols, bool setZero)
 {
+  if (rows < 0 || cols < 0) throw IllegalArgumentException("Matrix::alloc");
+
   rws = rows;
   cls = cols;
 
-  delete[] mat;
-  delete[] matRows;
+  if (ws) {
+    mat     = (double **)ws->takeBytes(rws*sizeof(double *));
+    matRows = ws->take(rws*cls);
+  }
+  else {
+    delete[] mat;
+    delete[] matRows;
 
-  mat     = new double*[rws];
-  matRows = new double[rws*cls];
+    mat     = new double*[rws];
+    matRows = new double[rws*cls];
+  }
 
   double *p = matRows;
 
@@ -274,7 +403,7 @@ void Matrix::alloc(int rows, int cols, bool setZero)
 
 Matrix::Matrix(int rows, int columns, double *elems) // For PMatrix
 : mat(new double*[rows]), matRows(elems),
-  rws(rows), cls(columns)
+  rws(rows), cls(columns), ws(NULL)
 {
   double *p = matRows;
 
@@ -287,7 +416,15 @@ Matrix::Matrix(int rows, int columns, double *elems) // For PMatrix
 //---------------------------------------------------------------------------
 
 Matrix::Matrix(int rows, int cols, bool zeroInit)
-: mat(NULL), matRows(NULL), rws(rows), cls(cols)
+: mat(NULL), matRows(NULL), rws(rows), cls(cols), ws(NULL)
+{
+  alloc(rows,cols,zeroInit);
+}
+
+//---------------------------------------------------------------------------
+
+Matrix::Matrix(MatrixWorkspace& workspace, int rows, int cols, bool zeroInit)
+: mat(NULL), matRows(NULL), rws(rows), cls(cols), ws(&workspace)
 {
   alloc(rows,cols,zeroInit);
 }
@@ -296,7 +433,7 @@ Matrix::Matrix(int rows, int cols, bool zeroInit)
 
 Matrix::Matrix(const Matrix& cp)
 : mat(new double*[cp.rws]), matRows(new double[cp.rws*cp.cls]),
-  rws(cp.rws), cls(cp.cls)
+  rws(cp.rws), cls(cp.cls), ws(NULL)
 {
   double *p = matRows;
 
@@ -312,6 +449,8 @@ Matrix::Matrix(const Matrix& cp)
 
 Matrix::~Matrix()
 {
+  if (ws) return;
+
   delete[] matRows;
   delete[] mat;
 }
@@ -416,6 +555,13 @@ void Matrix::multiply(const Matrix& b, Matrix& result) const
 // matrix bandwidth.
 
 void Matrix::solveLDLT(Vector& rhs)
+{
+  solveLDLT(rhs,MatrixWorkspace::local());
+}
+
+//---------------------------------------------------------------------------
+
+void Matrix::solveLDLT(Vector& rhs, MatrixWorkspace& ws)
 {
   if (rws < cls)
     throw IllegalArgumentException("Matrix::solveLDLT (rows < columns");
@@ -423,19 +569,10 @@ void Matrix::solveLDLT(Vector& rhs)
   if (rhs.size() != rws)
     throw IllegalArgumentException("Matrix::solveLDLT (unmatching row counts");
 
-  enum { MaxAllocSz = 4000 };
-
-  int *lwbIdx;
-  double *r;
+  MatrixWorkspace::Mark mark(ws);
 
-  if (rws > MaxAllocSz) {
-    lwbIdx = new int[rws];
-    r =      new double[rws];
-  }
-  else {
-    lwbIdx = (int *)_malloca(rws * sizeof(int));
-    r      = (double *)_malloca(rws * sizeof(double));
-  }
+  int *lwbIdx = (int *)ws.takeBytes(rws * sizeof(int));
+  double *r   = ws.take(rws);
 
   for (int i=0; i<cls; ++i) lwbIdx[i] = 0;
   for (int i=cls; i<rws; ++i) lwbIdx[i] = i-cls+1;
@@ -486,11 +623,6 @@ void Matrix::solveLDLT(Vector& rhs)
     for (int j=i+1; j<upb; ++j) rhs[i] -= mat[i][j-i] * rhs[j];
   }
 
-  if (rws > MaxAllocSz) {
-    delete[] lwbIdx;
-    delete[] r;
-  }
-
 //  ops += 0; // Put breakpoint here
 }
 
@@ -514,6 +646,13 @@ void Matrix::solveLDLT(Vector& rhs)
 // matrix bandwidth.
 
 void Matrix::solveLDLT(Matrix& rhs)
+{
+  solveLDLT(rhs,MatrixWorkspace::local());
+}
+
+//---------------------------------------------------------------------------
+
+void Matrix::solveLDLT(Matrix& rhs, MatrixWorkspace& ws)
 {
   if (rws < cls)
     throw IllegalArgumentException("Matrix::solveLDLT (less rows than columns");
@@ -521,19 +660,10 @@ void Matrix::solveLDLT(Matrix& rhs)
   if (rhs.rws != rws)
     throw IllegalArgumentException("Matrix::solveLDLT (unmatching row counts");
 
-  enum { MaxAllocSz = 4000 };
+  MatrixWorkspace::Mark mark(ws);
 
-  int *lwbIdx;
-  double *r;
-
-  if (rws > MaxAllocSz) {
-    lwbIdx = new int[rws];
-    r =      new double[rws];
-  }
-  else {
-    lwbIdx = (int *)_malloca(rws * sizeof(int));
-    r      = (double *)_malloca(rws * sizeof(double));
-  }
+  int *lwbIdx = (int *)ws.takeBytes(rws * sizeof(int));
+  double *r   = ws.take(rws);
 
   for (int i=0; i<cls; ++i) lwbIdx[i] = 0;
   for (int i=cls; i<rws; ++i) lwbIdx[i] = i-cls+1;
@@ -591,11 +721,6 @@ void Matrix::solveLDLT(Matrix& rhs)
       for (int k=0; k<rhsColSz; ++k) rhs(i,k) -= m * rhs(j,k);
     }
   }
-
-  if (rws > MaxAllocSz) {
-    delete[] lwbIdx;
-    delete[] r;
-  }
 }
 
 } // namespace Ino
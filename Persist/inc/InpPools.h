@@ -13,6 +13,8 @@
 
 #include "Exceptions.h"
 
+#include <stddef.h>
+
 //---------------------------------------------------------------------------
 
 namespace Ino
@@ -59,6 +61,8 @@ public:
   void readTypeDef(DataReader& dRdr);
 
   Type *get(short idx) const;
+
+  size_t memSize() const;
 };
 
 //---------------------------------------------------------------------------
@@ -74,6 +78,11 @@ class InpStructPool
 
   int inpFstInvalid;
 
+  int threads;                      // > 1: Construction is deferred
+
+  char *recBuf;                     // Deferred struct records
+  size_t recSz, recCap;
+
   InpStructPool(const InpStructPool& cp);             // No Copying
   InpStructPool& operator=(const InpStructPool& src); // No Assignment
 
@@ -91,6 +100,18 @@ public:
 
   void setPostProcess(int idx);
   void postProcess(PersistentReader& pi);
+
+  void setThreads(int thrds) { threads = thrds > 1 ? thrds : 1; }
+  int  getThreads() const { return threads; }
+
+  char *deferRecord(int idx, int recLen);  // Buffer to read record into
+  int  getRecord(int idx, const char *&rec) const; // -1: Not deferred
+  int  firstPending() const { return inpFstInvalid; }
+  int  size() const { return inpSz; }
+  void allocateDeferred();                  // Before parallel construction
+  void clearRecords();
+
+  size_t memSize() const; // Blocks and objects not yet handed out
 };
 
 //---------------------------------------------------------------------------
@@ -120,6 +141,8 @@ public:
 
   wchar_t *get(int idx);
   int getSz(int idx);
+
+  size_t memSize() const; // Blocks, read buffer and owned strings
 };
 
 //---------------------------------------------------------------------------
@@ -133,6 +156,8 @@ class InpArrayPool
   InpArray *inpLst[8192];
   int inpSz, inpCap, inpFstInvalid;
 
+  bool fpCodec;                     // Float/double arrays are transformed
+
   InpArrayPool(const InpArrayPool& cp);             // No Copying
   InpArrayPool& operator=(const InpArrayPool& src); // No Assignment
 
@@ -149,6 +174,13 @@ public:
   int    getSize(int idx);
 
   void *getPtr(int idx, int& arrSz);
+  void allocateAll();               // Before parallel construction
+  void copy(int srcIdx, int idx);   // Contents of srcIdx into idx
+
+  void setFpCodec(bool transformed) { fpCodec = transformed; }
+  bool isFpCodec() const { return fpCodec; }
+
+  size_t memSize() const; // Blocks and arrays not yet handed out
 };
 
 } //namespace Ino
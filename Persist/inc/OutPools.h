@@ -131,6 +131,8 @@ public:
 class OutArray
 {
   OutArray *nextHash, *nextQ;
+  OutArray *nextCont;
+  unsigned long long contHash;
 
   OutArray(const OutArray& cp);             // No Copying
   OutArray& operator=(const OutArray& src); // No Assignment
@@ -157,8 +159,16 @@ class OutArrayPool
 
   OutArray *outFirst, *outLast;
 
+  bool dedup;                 // Content deduplication of basic arrays
+  bool fpCodec;               // Transform float/double arrays
+  OutArray **contLst;         // Arrays emitted by content hash
+  int contSz, contCap;
+  int dupArrs;
+  long long dupBytes;
+
   OutArray *chainHash();
   void incCapacity();
+  void incContCapacity();
 
   OutArrayPool(const OutArrayPool& cp);             // No Copying
   OutArrayPool& operator=(const OutArrayPool& src); // No Assignment
@@ -172,6 +182,18 @@ public:
   int get(const void *array, int arrSz, const Array& arrType);
 
   const OutArray *getNext();
+
+  void setDedup(bool dedupArrs) { dedup = dedupArrs; }
+  bool isDedup() const { return dedup; }
+
+  void setFpCodec(bool transform) { fpCodec = transform; }
+  bool isFpCodec() const { return fpCodec; }
+
+  const OutArray *findDuplicate(const OutArray& oa, int memSz, int recSz);
+  void clearDedup();
+
+  int dupArrays() const { return dupArrs; }       // Replaced by a copy
+  long long dupBytesSaved() const { return dupBytes; }
 };
 
 } // namespace InoPersist
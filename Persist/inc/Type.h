@@ -37,10 +37,14 @@ enum RecordType { Record_Eof        = 0,
                   Record_ArrayDecl  = 5,
                   Record_String     = 6,
                   Record_Struct     = 7,
-                  Record_Array      = 8 };
+                  Record_Array      = 8,
+                  Record_ArrayCopy  = 9 };  // Same contents as earlier array
 
 enum { FormatMajor = 1, FormatMinor = 0 };
 
+enum { FormatMinorDedup   = 1,  // Flags: Stream may hold Record_ArrayCopy
+       FormatMinorFpCodec = 2 }; //        Float/double arrays transformed
+
 //-------------------------------------------------------------------------
 
 class Type
@@ -106,6 +110,14 @@ public:
   virtual const type_info& getInfo() const;
 
   virtual void write(DataWriter& dWrt) const;
+
+  // Lossless float/double array transform (FormatMinorFpCodec):
+  // XOR with the value two back, then split into byte planes
+
+  static void encodeFp(const double *arr, int sz, unsigned char *buf);
+  static void decodeFp(const unsigned char *buf, int sz, double *arr);
+  static void encodeFp(const float *arr, int sz, unsigned char *buf);
+  static void decodeFp(const unsigned char *buf, int sz, float *arr);
 };
 
 //-------------------------------------------------------------------------
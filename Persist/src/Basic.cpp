@@ -12,6 +12,8 @@
 #include "Type.h"
 #include "Writer.h"
 
+#include <cstring>
+
 namespace InoPersist
 {
 
@@ -79,6 +81,78 @@ void Basic::write(DataWriter& dWrt) const
   dWrt.writeShort((short)dataType,"Basic::write");
 }
 
+//---------------------------------------------------------------------------
+// Coordinates in an array differ mainly in the low mantissa bits. XOR with
+// the value two places back (arrays mostly hold x,y pairs) zeroes the
+// common sign, exponent and high mantissa bits, and the byte planes (most
+// significant plane first) put those zeroes in long runs that deflate well.
+// Buffer byte (plane k, item i) is buf[k*sz + i]; the format is
+// independent of the byte order of the platform.
+
+void Basic::encodeFp(const double *arr, int sz, unsigned char *buf)
+{
+  unsigned long long prev[2] = { 0, 0 };
+
+  for (int i=0; i<sz; ++i) {
+    unsigned long long bits;
+    memcpy(&bits,arr+i,8);
+
+    unsigned long long x = bits ^ prev[i & 1];
+    prev[i & 1] = bits;
+
+    for (int k=0; k<8; ++k) buf[k*sz + i] = (unsigned char)(x >> (56-8*k));
+  }
+}
+
+//---------------------------------------------------------------------------
+
+void Basic::decodeFp(const unsigned char *buf, int sz, double *arr)
+{
+  unsigned long long prev[2] = { 0, 0 };
+
+  for (int i=0; i<sz; ++i) {
+    unsigned long long x = 0;
+
+    for (int k=0; k<8; ++k) x = (x << 8) | buf[k*sz + i];
+
+    prev[i & 1] ^= x;
+    memcpy(arr+i,&prev[i & 1],8);
+  }
+}
+
+//---------------------------------------------------------------------------
+
+void Basic::encodeFp(const float *arr, int sz, unsigned char *buf)
+{
+  unsigned int prev[2] = { 0, 0 };
+
+  for (int i=0; i<sz; ++i) {
+    unsigned int bits;
+    memcpy(&bits,arr+i,4);
+
+    unsigned int x = bits ^ prev[i & 1];
+    prev[i & 1] = bits;
+
+    for (int k=0; k<4; ++k) buf[k*sz + i] = (unsigned char)(x >> (24-8*k));
+  }
+}
+
+//---------------------------------------------------------------------------
+
+void Basic::decodeFp(const unsigned char *buf, int sz, float *arr)
+{
+  unsigned int prev[2] = { 0, 0 };
+
+  for (int i=0; i<sz; ++i) {
+    unsigned int x = 0;
+
+    for (int k=0; k<4; ++k) x = (x << 8) | buf[k*sz + i];
+
+    prev[i & 1] ^= x;
+    memcpy(arr+i,&prev[i & 1],4);
+  }
+}
+
 } // namespace InoPersist
 
 //---------------------------------------------------------------------------
@@ -152,6 +152,13 @@ Type *InTypePool::get(short idx) const
   return typeArr[idx];
 }
 
+//---------------------------------------------------------------------------
+
+size_t InTypePool::memSize() const // Type table only
+{
+  return sizeof(*this) + cap * sizeof(Type *);
+}
+
 } // namespace InoPersist
 
 //---------------------------------------------------------------------------
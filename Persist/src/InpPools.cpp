@@ -27,14 +27,19 @@ struct InpStruct
   Persistable *p;
   bool postProcess;
 
-  InpStruct() : type(NULL), p(NULL), postProcess(false) {}
+  size_t recOff;          // Deferred record in the record buffer
+  int recLen;             // -1 if not deferred
+
+  InpStruct() : type(NULL), p(NULL), postProcess(false),
+                recOff(0), recLen(-1) {}
 };
 
 //---------------------------------------------------------------------------
 
 InpStructPool::InpStructPool(InTypePool& typePool)
 : tpPool(typePool), inpSz(1), inpCap(0),
-  inpFstInvalid(1) // First entry is not used
+  inpFstInvalid(1), // First entry is not used
+  threads(1), recBuf(NULL), recSz(0), recCap(0)
 {
 }
 
@@ -53,6 +58,8 @@ InpStructPool::~InpStructPool()
   for (int i=0; i<sz; ++i) {
     if (inpLst[i]) delete[] inpLst[i];
   }
+
+  if (recBuf) delete[] recBuf;
 }
 
 //---------------------------------------------------------------------------
@@ -65,8 +72,11 @@ void InpStructPool::clear()
     if (is.p) delete[] (char *)(is.p); // Must not call destructor!!!
     is.p = NULL;
     is.type = NULL;
+    is.recLen = -1;
   }
 
+  clearRecords();
+
   inpSz = 1;
   inpFstInvalid = 1;
 
@@ -87,6 +97,7 @@ void InpStructPool::clear()
     is.type = NULL;
     is.p = NULL;
     is.postProcess = false;
+    is.recLen = -1;
   }
 }
 
@@ -111,6 +122,7 @@ void InpStructPool::add(short typeId)
   is.type = sTp;
   is.p    = NULL;
   is.postProcess = false;
+  is.recLen = -1;
 
   inpSz++;
 }
@@ -170,6 +182,89 @@ void InpStructPool::postProcess(PersistentReader& pi)
   }
 }
 
+//---------------------------------------------------------------------------
+// Deferred construction (PersistentReader::setParallel()): the records of
+// all structs of one main object are kept in a single buffer and the
+// objects are constructed after the Eof record.
+
+char *InpStructPool::deferRecord(int idx, int recLen)
+{
+  if (idx <= 0 || idx >= inpSz || recLen < 0)
+               throw IndexOutOfBoundsException("InpStructPool::deferRecord");
+
+  if (recSz + recLen > recCap) {
+    size_t newCap = recCap < 65536 ? 65536 : recCap * 2;
+    while (newCap < recSz + recLen) newCap *= 2;
+
+    char *newBuf = new char[newCap];
+    if (recSz > 0) memcpy(newBuf,recBuf,recSz);
+
+    if (recBuf) delete[] recBuf;
+
+    recBuf = newBuf;
+    recCap = newCap;
+  }
+
+  InpStruct& is = inpLst[idx >> 13][idx & 0x1FFF];
+
+  is.recOff = recSz;
+  is.recLen = recLen;
+
+  recSz += recLen;
+
+  return recBuf + is.recOff;
+}
+
+//---------------------------------------------------------------------------
+
+int InpStructPool::getRecord(int idx, const char *&rec) const
+{
+  if (idx <= 0 || idx >= inpSz)
+               throw IndexOutOfBoundsException("InpStructPool::getRecord");
+
+  InpStruct& is = inpLst[idx >> 13][idx & 0x1FFF];
+
+  rec = is.recLen >= 0 ? recBuf + is.recOff : NULL;
+
+  return is.recLen;
+}
+
+//---------------------------------------------------------------------------
+// Allocates all objects that are still to be constructed, so get() does
+// not modify the pool while objects are constructed concurrently.
+
+void InpStructPool::allocateDeferred()
+{
+  for (int i=inpFstInvalid; i<inpSz; ++i) get(i);
+}
+
+//---------------------------------------------------------------------------
+
+void InpStructPool::clearRecords()
+{
+  for (int i=inpFstInvalid; i<inpSz; ++i) {
+    InpStruct& is = inpLst[i >> 13][i & 0x1FFF];
+    is.recLen = -1;
+  }
+
+  recSz = 0;
+}
+
+//---------------------------------------------------------------------------
+
+size_t InpStructPool::memSize() const
+{
+  size_t memSz = sizeof(*this) + inpCap * sizeof(InpStruct) + recCap;
+
+  for (int i=inpFstInvalid; i<inpSz; ++i) {
+    InpStruct& is = inpLst[i >> 13][i & 0x1FFF];
+
+    if (is.p) memSz += is.type->baseType.sz;
+  }
+
+  return memSz;
+}
+
 //---------------------------------------------------------------------------
 
 struct InpString
@@ -298,6 +393,22 @@ int InpStringPool::getSz(int idx)
 
 //---------------------------------------------------------------------------
 
+size_t InpStringPool::memSize() const
+{
+  size_t memSz = sizeof(*this) + inpCap * sizeof(InpString) +
+                                            readBufCap * sizeof(wchar_t);
+
+  for (int i=inpFstInvalid; i<inpSz; ++i) {
+    InpString& is = inpLst[i >> 13][i & 0x1FFF];
+
+    if (is.wc) memSz += (is.wcSz + 1) * sizeof(wchar_t);
+  }
+
+  return memSz;
+}
+
+//---------------------------------------------------------------------------
+
 struct InpArray
 {
   Array *type;
@@ -310,7 +421,8 @@ struct InpArray
 //---------------------------------------------------------------------------
 
 InpArrayPool::InpArrayPool(InTypePool& typePool)
-: tpPool(typePool), inpSz(1), inpCap(0), inpFstInvalid(1)
+: tpPool(typePool), inpSz(1), inpCap(0), inpFstInvalid(1),
+  fpCodec(false)
 {
 }
 
@@ -447,6 +559,56 @@ void *InpArrayPool::getPtr(int idx, int& arrSz)
   return ia.arr;
 }
 
+//---------------------------------------------------------------------------
+// Allocates all arrays not yet allocated, so getPtr() does not modify the
+// pool while objects are constructed concurrently.
+
+void InpArrayPool::allocateAll()
+{
+  int arrSz;
+
+  for (int i=inpFstInvalid; i<inpSz; ++i) getPtr(i,arrSz);
+}
+
+//---------------------------------------------------------------------------
+// Handles Record_ArrayCopy: array idx gets its own copy of the contents of
+// the earlier array srcIdx (read during the same readMainObject()).
+
+void InpArrayPool::copy(int srcIdx, int idx)
+{
+  if (srcIdx <= 0 || srcIdx >= idx || idx >= inpSz)
+               throw StreamCorruptedException("InpArrayPool::copy 1");
+
+  InpArray& src = inpLst[srcIdx >> 13][srcIdx & 0x1FFF];
+  InpArray& dst = inpLst[idx >> 13][idx & 0x1FFF];
+
+  if (!dst.type) return;   // Type not known by this reader
+
+  if (src.type != dst.type || src.arrSz != dst.arrSz)
+               throw StreamCorruptedException("InpArrayPool::copy 2");
+
+  int srcSz, dstSz;
+  char *srcArr = (char *)getPtr(srcIdx,srcSz);
+  char *dstArr = (char *)getPtr(idx,dstSz);
+
+  memcpy(dstArr,srcArr,dstSz*dst.type->elemType.getDataSize());
+}
+
+//---------------------------------------------------------------------------
+
+size_t InpArrayPool::memSize() const
+{
+  size_t memSz = sizeof(*this) + inpCap * sizeof(InpArray);
+
+  for (int i=inpFstInvalid; i<inpSz; ++i) {
+    InpArray& ia = inpLst[i >> 13][i & 0x1FFF];
+
+    if (ia.arr) memSz += ia.arrSz * ia.type->elemType.getDataSize();
+  }
+
+  return memSz;
+}
+
 } // namespace Ino
 
 //---------------------------------------------------------------------------
@@ -413,7 +413,7 @@ int OutStringPool::get(const wchar_t *wc, int wcSz)
 //---------------------------------------------------------------------------
 
 OutArray::OutArray(int pId, const Array& arrType, const void *array, int arrSz)
-: nextHash(NULL), nextQ(NULL),
+: nextHash(NULL), nextQ(NULL), nextCont(NULL), contHash(0),
   id(pId), type(arrType), arr(array), sz(arrSz)
 {
 }
@@ -471,7 +471,9 @@ void OutArrayPool::incCapacity()
 //---------------------------------------------------------------------------
 
 OutArrayPool::OutArrayPool(DataWriter& wrt)
-: dWrt(wrt), outSz(0), outCap(0), outFirst(NULL), outLast(NULL)
+: dWrt(wrt), outSz(0), outCap(0), outFirst(NULL), outLast(NULL),
+  dedup(false), fpCodec(false), contLst(NULL), contSz(0), contCap(0),
+  dupArrs(0), dupBytes(0)
 {
 }
 
@@ -481,6 +483,8 @@ OutArrayPool::~OutArrayPool()
 {
   clear();
 
+  if (contLst) delete[] contLst;
+
   int sz = outCap >> 13;
 
   for (int i=0; i<sz; ++i) {
@@ -492,6 +496,8 @@ OutArrayPool::~OutArrayPool()
 
 void OutArrayPool::clear()
 {
+  clearDedup();
+
   outSz = 0;
 
   if (outCap < 1) return;
@@ -576,6 +582,110 @@ const OutArray *OutArrayPool::getNext()
   return oa;
 }
 
+//---------------------------------------------------------------------------
+
+static unsigned long long contentHash(const void *arr, int byteSz)
+{
+  const unsigned char *b = (const unsigned char *)arr;
+
+  unsigned long long h = 0xcbf29ce484222325ULL ^ (unsigned)byteSz;
+
+  int i = 0;
+
+  for (; i+8 <= byteSz; i += 8) {
+    unsigned long long w;
+    memcpy(&w,b+i,8);
+
+    h = (h ^ w) * 0x100000001b3ULL;
+    h ^= h >> 29;
+  }
+
+  for (; i<byteSz; ++i) h = (h ^ b[i]) * 0x100000001b3ULL;
+
+  return h;
+}
+
+//---------------------------------------------------------------------------
+
+void OutArrayPool::incContCapacity()
+{
+  int newCap = contCap < 1 ? 1024 : contCap * 2;
+
+  OutArray **newLst = new OutArray*[newCap];
+  memset(newLst,0,newCap*sizeof(OutArray *));
+
+  for (int i=0; i<contCap; ++i) {
+    OutArray *oa = contLst[i];
+
+    while (oa) {
+      OutArray *nxt = oa->nextCont;
+
+      OutArray* &pRef = newLst[oa->contHash & (newCap-1)];
+      oa->nextCont = pRef;
+      pRef = oa;
+
+      oa = nxt;
+    }
+  }
+
+  if (contLst) delete[] contLst;
+
+  contLst = newLst;
+  contCap = newCap;
+}
+
+//---------------------------------------------------------------------------
+/** Looks up an earlier emitted array with the same type and contents as
+    \c oa, only if deduplication is on.\n
+    \c memSz is the size of the array contents in memory, \c recSz
+    the size of its Record_Array.\n
+    Returns the earlier array, or \c NULL after registering \c oa.
+*/
+
+const OutArray *OutArrayPool::findDuplicate(const OutArray& oa,
+                                                     int memSz, int recSz)
+{
+  if (!dedup || recSz <= 8) return NULL;  // Not worth a copy record
+
+  if (contSz >= contCap) incContCapacity();
+
+  unsigned long long hash = contentHash(oa.arr,memSz);
+
+  OutArray* &pRef = contLst[hash & (contCap-1)];
+
+  for (OutArray *ca = pRef; ca; ca = ca->nextCont) {
+    if (ca->contHash == hash && &ca->type == &oa.type && ca->sz == oa.sz &&
+                                      memcmp(ca->arr,oa.arr,memSz) == 0) {
+      dupArrs++;
+      dupBytes += recSz;
+
+      return ca;
+    }
+  }
+
+  OutArray& newCa = const_cast<OutArray&>(oa); // Owned by this pool
+
+  newCa.contHash = hash;
+  newCa.nextCont = pRef;
+  pRef = &newCa;
+
+  contSz++;
+
+  return NULL;
+}
+
+//---------------------------------------------------------------------------
+// The contents of arrays are only guaranteed to be valid during one call
+// of PersistentWriter::writeMainObject(), so must be forgotten after it.
+
+void OutArrayPool::clearDedup()
+{
+  if (contSz < 1) return;
+
+  memset(contLst,0,contCap*sizeof(OutArray *));
+  contSz = 0;
+}
+
 } // namespace InoPersist
 
 //---------------------------------------------------------------------------
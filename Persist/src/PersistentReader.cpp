@@ -12,8 +12,12 @@
 
 #include "Type.h"
 #include "InpPools.h"
+#include "TaskPool.h"
+#include "Trace.h"
 
+#include <atomic>
 #include <cstring>
+#include <vector>
 
 namespace Ino
 {
@@ -232,6 +236,55 @@ PersistentReader::~PersistentReader()
   delete &stringPool;
   delete &arrayPool;
 }
+
+//---------------------------------------------------------------------------
+/** Memory accounting.
+  \return The number of bytes held by the internal pools: the type table,
+  the pool blocks, the string read buffer and all objects, strings and
+  arrays read but not yet handed out to the application.
+*/
+
+size_t PersistentReader::memSize() const
+{
+  return sizeof(*this) + typePool.memSize() + structPool.memSize() +
+                         stringPool.memSize() + arrayPool.memSize();
+}
+
+//---------------------------------------------------------------------------
+/** Sets the number of threads used to construct the objects (default 1).
+
+  \param threads With more than one thread readMainObject() works in two
+  phases: first all records up to the Eof record are decoded by the calling
+  thread, then the objects are constructed concurrently on at most
+  \c threads threads of the shared TaskPool (the calling thread
+  included).\n
+  A value below one selects all threads of that pool.
+
+  Persistable::postProcess() and MainPersistable::readPersistentComplete()
+  are still called afterwards by the calling thread, in stream order.\n
+  The stream format is not affected.
+
+  \note Only use this if the persistence constructors of all classes in
+  the stream are thread safe: they must not modify shared data (other than
+  through this reader) nor dereference pointers to other restored objects,
+  which was already forbidden.
+*/
+
+void PersistentReader::setParallel(int threads)
+{
+  if (threads < 1) threads = TaskPool::executor().threads();
+
+  structPool.setThreads(threads);
+}
+
+//---------------------------------------------------------------------------
+/** \return The number of threads used to construct the objects.
+*/
+
+int PersistentReader::getParallel() const
+{
+  return structPool.getThreads();
+}
                                              
 //---------------------------------------------------------------------------
 
@@ -248,8 +301,11 @@ void PersistentReader::readHeader()
   mmajor = dRdr.readByte();
   mminor = dRdr.readByte();
 
-  dRdr.readByte(); // FormatMajor and minor: internal version
-  dRdr.readByte(); // indicators for this sfw, not used yet
+  dRdr.readByte(); // FormatMajor: internal version indicator, not used yet
+
+  char fmtFlags = dRdr.readByte(); // FormatMinor: internal format flags
+
+  arrayPool.setFpCodec((fmtFlags & FormatMinorFpCodec) != 0);
 
   bool compressed = dRdr.readBool();
 
@@ -385,16 +441,68 @@ void PersistentReader::processEof(MainPersistable *mps, bool reset)
   }
 }
 
+//---------------------------------------------------------------------------
+// Per thread state while objects are constructed in parallel (see
+// setParallel()). A worker thread reads the fields of the object it is
+// constructing through its own context instead of curType/byteRdr.
+
+struct ParCtx
+{
+  const PersistentReader *owner;
+
+  Struct *type;
+  int structId;
+
+  ByteArrayReader rdr;
+  DataReader dataRdr;
+
+  ParCtx(const PersistentReader *pr)
+  : owner(pr), type(NULL), structId(0), rdr(1024), dataRdr(rdr) {}
+};
+
+static thread_local ParCtx *parCtx = NULL;
+
+enum { ParChunk = 64 }; // Objects taken at a time by a worker
+
+//---------------------------------------------------------------------------
+
+static inline ParCtx *ctxOf(const PersistentReader *pr)
+{
+  ParCtx *ctx = parCtx;
+
+  return ctx && ctx->owner == pr ? ctx : NULL;
+}
+
+//---------------------------------------------------------------------------
+
+static inline DataReader& seekField(const PersistentReader *pr,
+                                    ByteArrayReader& rdr, DataReader& dRdr,
+                                    Field *fld)
+{
+  ParCtx *ctx = ctxOf(pr);
+
+  if (ctx) {
+    ctx->rdr.setPos(fld->getOffset());
+    return ctx->dataRdr;
+  }
+
+  rdr.setPos(fld->getOffset());
+  return dRdr;
+}
+
 //---------------------------------------------------------------------------
 
 Field *PersistentReader::getValField(const char *fldName,
                                           const type_info& inf,
                                           const char *msg, bool nullOk)
 {
-  if (!curType)
+  ParCtx *ctx = ctxOf(this);
+  Struct *tp = ctx ? ctx->type : curType;
+
+  if (!tp)
         throw IllegalStateException("PersistentReader::getValField");
 
-  Field *fld = curType->getValField(fldName);
+  Field *fld = tp->getValField(fldName);
 
   if (!fld) {
     if (nullOk) return NULL;
@@ -430,17 +538,20 @@ Field *PersistentReader::getValField(const char *fldName,
 
 Field *PersistentReader::getRefField(const char *fldName, bool nullOk)
 {
-  if (!curType)
+  ParCtx *ctx = ctxOf(this);
+  Struct *tp = ctx ? ctx->type : curType;
+
+  if (!tp)
            throw IllegalStateException("PersistentReader::getRefField");
 
-  Field *fld = curType->getRefField(fldName);
+  Field *fld = tp->getRefField(fldName);
 
   if (!fld) {
     if (nullOk) return NULL;
     else {
       char msg[512];
       sprintf(msg,"Field: \"%s\" is not defined in class: \"%s\"",
-                                           fldName,curType->getInfo().name());
+                                           fldName,tp->getInfo().name());
       throw NoSuchElementException(msg);
     }
   }
@@ -450,7 +561,7 @@ Field *PersistentReader::getRefField(const char *fldName, bool nullOk)
     else {
       char msgBuf[512];
       sprintf(msgBuf,"Type of field: \"%s\" is not defined in class: \"%s\"",
-                                        fldName,curType->getInfo().name());
+                                        fldName,tp->getInfo().name());
       throw IllegalArgumentException(msgBuf);
     }
   }
@@ -458,7 +569,7 @@ Field *PersistentReader::getRefField(const char *fldName, bool nullOk)
   if (!fld->type->isRefType()) {
     char msg[512];
     sprintf(msg,"Field \"%s\" is not an object type (in class \"%s\"",
-                                        fldName,curType->getInfo().name());
+                                        fldName,tp->getInfo().name());
     throw IllegalArgumentException(msg);
   }
 
@@ -469,17 +580,20 @@ Field *PersistentReader::getRefField(const char *fldName, bool nullOk)
 
 Field *PersistentReader::getArrayField(const char *fldName, bool nullOk)
 {
-  if (!curType)
+  ParCtx *ctx = ctxOf(this);
+  Struct *tp = ctx ? ctx->type : curType;
+
+  if (!tp)
       throw IllegalStateException("PersistentReader::getValArrayField");
 
-  Field *fld = curType->getRefField(fldName);
+  Field *fld = tp->getRefField(fldName);
 
   if (!fld) {
     if (nullOk) return NULL;
     else {
       char msg[512];
       sprintf(msg,"Field: \"%s\" is not defined in class: \"%s\"",
-                                           fldName,curType->getInfo().name());
+                                           fldName,tp->getInfo().name());
       throw NoSuchElementException(msg);
     }
   }
@@ -489,7 +603,7 @@ Field *PersistentReader::getArrayField(const char *fldName, bool nullOk)
     else {
       char msgBuf[512];
       sprintf(msgBuf,"Type of array field: \"%s\" is not defined in class: \"%s\"",
-                                        fldName,curType->getInfo().name());
+                                        fldName,tp->getInfo().name());
       throw IllegalArgumentException(msgBuf);
     }
   }
@@ -497,7 +611,7 @@ Field *PersistentReader::getArrayField(const char *fldName, bool nullOk)
   if (fld->type->getCategory() != Type::CatArray) {
     char msg[512];
     sprintf(msg,"Field \"%s\" is not an array (in class \"%s\"",
-                                        fldName,curType->getInfo().name());
+                                        fldName,tp->getInfo().name());
     throw IllegalArgumentException(msg);
   }
 
@@ -544,6 +658,15 @@ void PersistentReader::readStruct()
   if (rSz != recLen)
           throw StreamCorruptedException("PersistentReader::readStruct 5");
 
+  if (structPool.getThreads() > 1) { // Constructed after the Eof record
+    char *rec = structPool.deferRecord(curStructId,rSz);
+
+    dRdr.read(rec,rSz,"PersistentReader::readStruct 6");
+
+    curType = NULL;
+    return;
+  }
+
   byteRdr.ensureCap(rSz);
   char* &byteBuf = byteRdr.getBuffer();
 
@@ -559,6 +682,94 @@ void PersistentReader::readStruct()
   curType = NULL;
 }
 
+//---------------------------------------------------------------------------
+// Job of constructDeferred(): takes chunks of object ids until all are
+// taken. The first exception cancels the group, which stops all jobs.
+
+void PersistentReader::constructChunks(std::atomic<int>& nextId, int endId,
+                                                     const TaskGroup& grp)
+{
+  ParCtx ctx(this);
+
+  ParCtx *prevCtx = parCtx;
+  parCtx = &ctx;
+
+  try {
+    while (!grp.cancelled()) {
+      int fstId = nextId.fetch_add(ParChunk);
+      if (fstId >= endId) break;
+
+      int lstId = fstId + ParChunk;
+      if (lstId > endId) lstId = endId;
+
+      for (int id=fstId; id<lstId; ++id) {
+        const char *rec;
+        int recLen = structPool.getRecord(id,rec);
+
+        if (recLen < 0) continue; // Unknown type, skipped
+
+        ctx.type     = structPool.getType(id);
+        ctx.structId = id;
+
+        ctx.rdr.ensureCap(recLen);
+        memcpy(ctx.rdr.getBuffer(),rec,recLen);
+
+        ctx.rdr.setPos(0);
+        ctx.rdr.setSize(recLen);
+
+        ctx.type->baseType.construct(structPool.get(id),*this);
+      }
+    }
+  }
+  catch (...) {
+    parCtx = prevCtx;
+    throw;
+  }
+
+  parCtx = prevCtx;
+}
+
+//---------------------------------------------------------------------------
+// Second phase of a parallel read: constructs all objects whose records
+// were deferred by readStruct(). All objects and arrays are allocated
+// first, so the jobs only read the pools. The jobs run on the shared task
+// pool, under the tolerances of the reading thread.
+
+void PersistentReader::constructDeferred()
+{
+  int fstId = structPool.firstPending(), endId = structPool.size();
+
+  TraceScope trc("PersistentReader::construct",endId - fstId);
+
+  structPool.allocateDeferred();
+  arrayPool.allocateAll();
+
+  int thrCnt = structPool.getThreads();
+  int chunks = (endId - fstId + ParChunk - 1) / ParChunk;
+  if (thrCnt > chunks) thrCnt = chunks;
+
+  std::atomic<int> nextId(fstId);
+
+  try {
+    TaskGroup grp;
+
+    auto work = [&]() { constructChunks(nextId,endId,grp); };
+
+    if (thrCnt > grp.threads()) thrCnt = grp.threads();
+
+    for (int i=1; i<thrCnt; ++i) grp.run(work);
+
+    grp.runHere(work);
+    grp.wait();
+  }
+  catch (...) {
+    structPool.clearRecords();
+    throw;
+  }
+
+  structPool.clearRecords();
+}
+
 //---------------------------------------------------------------------------
 /** Reads and restores a MainPersistable and all related classes.
 
@@ -586,6 +797,8 @@ void PersistentReader::readStruct()
 
 MainPersistable *PersistentReader::readMainObject(void *userPtr)
 {
+  TraceScope trc("PersistentReader::readMainObject");
+
   if (errMsg) delete[] errMsg;
   errMsg = NULL;
 
@@ -601,18 +814,24 @@ MainPersistable *PersistentReader::readMainObject(void *userPtr)
 
       switch (recType) {
         case Record_Eof: {
+          if (structPool.getThreads() > 1) constructDeferred();
+
           Persistable *ps = structPool.get(mainStructId);
           MainPersistable *mps = dynamic_cast<MainPersistable *>(ps);
 
+          trc.count(curStructId - mainStructId + 1); // Objects read
           processEof(mps,false);
 
           return mps;
         }
 
         case Record_EofReset: {
+          if (structPool.getThreads() > 1) constructDeferred();
+
           Persistable *ps = structPool.get(mainStructId);
           MainPersistable *mps = dynamic_cast<MainPersistable *>(ps);
 
+          trc.count(curStructId - mainStructId + 1); // Objects read
           processEof(mps,true);
   
           return mps;
@@ -648,6 +867,12 @@ MainPersistable *PersistentReader::readMainObject(void *userPtr)
           readArray();
         break;
 
+        case Record_ArrayCopy: {
+          int srcId = dRdr.readInt("PersistentReader::readMainObject: ArrayCopy");
+          arrayPool.copy(srcId,++curArrayId);
+        }
+        break;
+
         default: 
           throw StreamCorruptedException(
                     "PersistentReader::readMainObject: Unknown Record Type");
@@ -698,11 +923,14 @@ MainPersistable *PersistentReader::readMainObject(void *userPtr)
 
 bool PersistentReader::fieldExists(const char *fldName)
 {
-  if (!curType) throw IllegalStateException(
+  ParCtx *ctx = ctxOf(this);
+  Struct *tp = ctx ? ctx->type : curType;
+
+  if (!tp) throw IllegalStateException(
                         "PersistentReader::fieldExists: Illegal Call");
 
-  return curType->getValField(fldName) != NULL || 
-                               curType->getRefField(fldName) != NULL;
+  return tp->getValField(fldName) != NULL || 
+                               tp->getRefField(fldName) != NULL;
 }
 
 //---------------------------------------------------------------------------
@@ -711,10 +939,12 @@ bool PersistentReader::fieldExists(const char *fldName)
 
 void PersistentReader::callPostProcess()
 {
-  if (!curType) throw IllegalStateException(
+  ParCtx *ctx = ctxOf(this);
+
+  if (!(ctx ? ctx->type : curType)) throw IllegalStateException(
                         "PersistentReader::callPostProcess: Illegal Call");
 
-  structPool.setPostProcess(curStructId);
+  structPool.setPostProcess(ctx ? ctx->structId : curStructId);
 }
 
 //---------------------------------------------------------------------------
@@ -739,9 +969,9 @@ bool PersistentReader::readBool(const char *fldName)
 {
   Field *fld = getValField(fldName,typeid(bool),"Boolean",false);
 
-  byteRdr.setPos(fld->getOffset());
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
 
-  return byteDataRdr.readBool();
+  return fRdr.readBool();
 }
 
 //---------------------------------------------------------------------------
@@ -770,9 +1000,9 @@ bool PersistentReader::readBool(const char *fldName, bool defVal)
   Field *fld = getValField(fldName,typeid(bool),"Boolean",true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
 
-  return byteDataRdr.readBool();
+  return fRdr.readBool();
 }
 
 //---------------------------------------------------------------------------
@@ -797,8 +1027,8 @@ wchar_t PersistentReader::readWChar(const char *fldName)
 {
   Field *fld = getValField(fldName,typeid(wchar_t),"WChar",false);
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readWChar();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readWChar();
 }
 
 //---------------------------------------------------------------------------
@@ -827,8 +1057,8 @@ wchar_t PersistentReader::readWChar(const char *fldName, wchar_t defVal)
   Field *fld = getValField(fldName,typeid(wchar_t),"WChar",true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readWChar();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readWChar();
 }
 
 //---------------------------------------------------------------------------
@@ -853,8 +1083,8 @@ char PersistentReader::readByte(const char *fldName)
 {
   Field *fld = getValField(fldName,typeid(char),"Byte",false);
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readByte();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readByte();
 }
 
 //---------------------------------------------------------------------------
@@ -883,8 +1113,8 @@ char PersistentReader::readByte(const char *fldName, char defVal)
   Field *fld = getValField(fldName,typeid(char),"Byte",true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readByte();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readByte();
 }
 
 //---------------------------------------------------------------------------
@@ -909,8 +1139,8 @@ short PersistentReader::readShort(const char *fldName)
 {
   Field *fld = getValField(fldName,typeid(short),"Short",false);
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readShort();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readShort();
 }
 
 //---------------------------------------------------------------------------
@@ -939,8 +1169,8 @@ short PersistentReader::readShort(const char *fldName, short defVal)
   Field *fld = getValField(fldName,typeid(short),"Short",true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readShort();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readShort();
 }
 
 //---------------------------------------------------------------------------
@@ -965,8 +1195,8 @@ long PersistentReader::readInt(const char *fldName)
 {
   Field *fld = getValField(fldName,typeid(long),"Int",false);
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readInt();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readInt();
 }
 
 //---------------------------------------------------------------------------
@@ -995,8 +1225,8 @@ long PersistentReader::readInt(const char *fldName, long defVal)
   Field *fld = getValField(fldName,typeid(long),"Int",true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readInt();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readInt();
 }
 
 //---------------------------------------------------------------------------
@@ -1023,8 +1253,8 @@ __int64 PersistentReader::readLong(const char *fldName)
 {
   Field *fld = getValField(fldName,typeid(__int64),"Long",false);
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readLong();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readLong();
 }
 
 //---------------------------------------------------------------------------
@@ -1055,8 +1285,8 @@ __int64 PersistentReader::readLong(const char *fldName, __int64 defVal)
   Field *fld = getValField(fldName,typeid(__int64),"Long",true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readLong();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readLong();
 }
 
 //---------------------------------------------------------------------------
@@ -1081,8 +1311,8 @@ float PersistentReader::readFloat(const char *fldName)
 {
   Field *fld = getValField(fldName,typeid(float),"Float",false);
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readFloat();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readFloat();
 }
 
 //---------------------------------------------------------------------------
@@ -1111,8 +1341,8 @@ float PersistentReader::readFloat(const char *fldName, float defVal)
   Field *fld = getValField(fldName,typeid(float),"Float",true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readFloat();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readFloat();
 }
 
 //---------------------------------------------------------------------------
@@ -1137,8 +1367,8 @@ double PersistentReader::readDouble(const char *fldName)
 {
   Field *fld = getValField(fldName,typeid(double),"Double",false);
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readDouble();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readDouble();
 }
 
 //---------------------------------------------------------------------------
@@ -1167,8 +1397,8 @@ double PersistentReader::readDouble(const char *fldName, double defVal)
   Field *fld = getValField(fldName,typeid(double),"Double",true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
-  return byteDataRdr.readDouble();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  return fRdr.readDouble();
 }
 
 //---------------------------------------------------------------------------
@@ -1195,8 +1425,8 @@ wchar_t *PersistentReader::readString(const char *fldName)
 {
   Field *fld = getValField(fldName,typeid(wchar_t *),"String",false);
 
-  byteRdr.setPos(fld->getOffset());
-  int strId = byteDataRdr.readInt();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  int strId = fRdr.readInt();
 
   if (strId == 0) return NULL;
   return stringPool.get(strId);
@@ -1229,8 +1459,8 @@ wchar_t *PersistentReader::readString(const char *fldName, wchar_t *defVal)
   Field *fld = getValField(fldName,typeid(wchar_t *),"String",true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
-  int strId = byteDataRdr.readInt();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  int strId = fRdr.readInt();
 
   if (strId == 0) return NULL;
   return stringPool.get(strId);
@@ -1265,8 +1495,8 @@ Persistable *PersistentReader::readObject(const char *fldName)
 {
   Field *fld = getRefField(fldName,false);
 
-  byteRdr.setPos(fld->getOffset());
-  int pId = byteDataRdr.readInt();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  int pId = fRdr.readInt();
 
   if (pId == 0) return NULL;
 
@@ -1307,8 +1537,8 @@ Persistable *PersistentReader::readObject(const char *fldName,
   Field *fld = getRefField(fldName,true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
-  int pId = byteDataRdr.readInt();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  int pId = fRdr.readInt();
 
   if (pId == 0) return NULL;
 
@@ -1337,8 +1567,8 @@ int PersistentReader::readArraySize(const char *fldName)
 {
   Field *fld = getArrayField(fldName, false);
 
-  byteRdr.setPos(fld->getOffset());
-  int arrId = byteDataRdr.readInt();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  int arrId = fRdr.readInt();
 
   if (arrId == 0) return 0;
 
@@ -1370,8 +1600,8 @@ int PersistentReader::readArraySize(const char *fldName, int defVal)
   Field *fld = getArrayField(fldName, true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
-  int arrId = byteDataRdr.readInt();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  int arrId = fRdr.readInt();
 
   if (arrId == 0) return 0;
 
@@ -1407,8 +1637,8 @@ void *PersistentReader::readValArray(const char *fldName)
 {
   Field *fld = getArrayField(fldName, false);
 
-  byteRdr.setPos(fld->getOffset());
-  int arrId = byteDataRdr.readInt();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  int arrId = fRdr.readInt();
 
   if (arrId == 0) return NULL;
 
@@ -1449,8 +1679,8 @@ void *PersistentReader::readValArray(const char *fldName, void *defVal)
   Field *fld = getArrayField(fldName, true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
-  int arrId = byteDataRdr.readInt();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  int arrId = fRdr.readInt();
 
   if (arrId == 0) return NULL;
 
@@ -1489,8 +1719,8 @@ Persistable **PersistentReader::readObjArray(const char *fldName)
 {
   Field *fld = getArrayField(fldName, false);
 
-  byteRdr.setPos(fld->getOffset());
-  int arrId = byteDataRdr.readInt();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  int arrId = fRdr.readInt();
 
   if (arrId == 0) return NULL;
 
@@ -1532,8 +1762,8 @@ Persistable **PersistentReader::readObjArray(const char *fldName,
   Field *fld = getArrayField(fldName,true);
   if (!fld) return defVal;
 
-  byteRdr.setPos(fld->getOffset());
-  int arrId = byteDataRdr.readInt();
+  DataReader& fRdr = seekField(this,byteRdr,byteDataRdr,fld);
+  int arrId = fRdr.readInt();
 
   if (arrId == 0) return NULL;
 
@@ -1630,13 +1860,27 @@ void PersistentReader::readBasicArray(void *arr, int items, Basic &elType)
 
     case Type::Float: {
       float *fArr = (float *)arr;
-      dRdr.read(fArr,items,"PersistentReader::readBasicArray (float)");
+
+      if (arrayPool.isFpCodec()) {
+        std::vector<unsigned char> buf(items*4);
+        dRdr.read((char *)&buf[0],items*4,
+                                  "PersistentReader::readBasicArray (float)");
+        Basic::decodeFp(&buf[0],items,fArr);
+      }
+      else dRdr.read(fArr,items,"PersistentReader::readBasicArray (float)");
     }
     break;
 
     case Type::Double: {
       double *dArr = (double *)arr;
-      dRdr.read(dArr,items,"PersistentReader::readBasicArray (double)");
+
+      if (arrayPool.isFpCodec()) {
+        std::vector<unsigned char> buf(items*8);
+        dRdr.read((char *)&buf[0],items*8,
+                                 "PersistentReader::readBasicArray (double)");
+        Basic::decodeFp(&buf[0],items,dArr);
+      }
+      else dRdr.read(dArr,items,"PersistentReader::readBasicArray (double)");
     }
     break;
 
@@ -12,8 +12,10 @@
 
 #include "Type.h"
 #include "OutPools.h"
+#include "Trace.h"
 
 #include <cstring>
+#include <vector>
 
 namespace Ino
 {
@@ -58,7 +60,12 @@ void PersistentWriter::writeHeader()
   dWrt.writeByte(tpDef.mmajor);
   dWrt.writeByte(tpDef.mminor);
   dWrt.writeByte(FormatMajor);  // Internal version indicator for this sfw
-  dWrt.writeByte(FormatMinor);  // Internal version indicator for this sfw
+
+  int fmtFlags = FormatMinor;   // Internal format flags
+  if (arrayPool.isDedup())   fmtFlags |= FormatMinorDedup;
+  if (arrayPool.isFpCodec()) fmtFlags |= FormatMinorFpCodec;
+
+  dWrt.writeByte((char)fmtFlags);
   dWrt.writeBool(compressed);
 
   cWrt.setCompressing(compressed);
@@ -406,6 +413,8 @@ bool PersistentWriter::isAborted() const
 bool PersistentWriter::writeMainObject(const MainPersistable& mps,
                                          bool resetWhenDone, void *userPtr)
 {
+  TraceScope trc("PersistentWriter::writeMainObject");
+
   if (errMsg) {
     delete[] errMsg;
     errMsg = NULL;
@@ -428,6 +437,8 @@ bool PersistentWriter::writeMainObject(const MainPersistable& mps,
     while (writeNextStruct()) {}
     while (writeNextArray()) {}
 
+    arrayPool.clearDedup();
+
     structPool.postProcess(*this);
 
     if (resetWhenDone) {
@@ -476,6 +487,79 @@ bool PersistentWriter::writeMainObject(const MainPersistable& mps,
   \return The user pointer.
 */
 
+//---------------------------------------------------------------------------
+/** Switches content deduplication of arrays on or off (default off).
+
+  \param dedup If \c true, an array of a basic type (other than strings)
+  with the same type, size and contents as an array written earlier during
+  the same writeMainObject() call is written as a short reference to that
+  array.
+
+  Reading stays transparent: the PersistentReader still allocates a
+  separate array for every array field and fills it with a copy.\n
+  Only use this if the stream is read by a PersistentReader that knows
+  Record_ArrayCopy; the stream header carries FormatMinorDedup then.
+
+  \note Call this before the first writeMainObject() of a stream.
+*/
+
+void PersistentWriter::setDedupArrays(bool dedup)
+{
+  arrayPool.setDedup(dedup);
+}
+
+//---------------------------------------------------------------------------
+
+bool PersistentWriter::isDedupArrays() const
+{
+  return arrayPool.isDedup();
+}
+
+//---------------------------------------------------------------------------
+/** Switches the lossless transform of \c float and \c double arrays
+  on or off (default off).
+
+  \param transform If \c true, each value in such an array is XOR-ed with
+  the value two places back (the same coordinate of the previous x,y pair)
+  and the result is written as byte planes (see Basic::encodeFp()).\n
+  Arrays of computed coordinates then compress considerably better and
+  faster; arrays with many exactly repeated values may compress better
+  without it.
+
+  The stream header carries FormatMinorFpCodec, a PersistentReader
+  restores the original values from that.\n
+  Older readers do not check the flag, so only use this if all readers
+  of the stream know it.
+
+  \note Call this before the first writeMainObject() of a stream.
+*/
+
+void PersistentWriter::setFpCodec(bool transform)
+{
+  arrayPool.setFpCodec(transform);
+}
+
+//---------------------------------------------------------------------------
+
+bool PersistentWriter::isFpCodec() const
+{
+  return arrayPool.isFpCodec();
+}
+
+//---------------------------------------------------------------------------
+/** Deduplication statistics since construction of this writer.
+
+  \param arrays Set to the number of arrays written as a reference.
+  \param bytes Set to the number of (uncompressed) array bytes that were
+  not written, and so were not compressed either.
+*/
+
+void PersistentWriter::getDedupStats(int& arrays, long long& bytes) const
+{
+  arrays = arrayPool.dupArrays();
+  bytes  = arrayPool.dupBytesSaved();
+}
+
 //---------------------------------------------------------------------------
 /** \fn const char *PersistentWriter::errorMsg() const
   Returns the error message if any.
@@ -837,6 +921,8 @@ void PersistentWriter::writeString(const char *fldName,
 
 void PersistentWriter::writeObject(const char *fldName, const Persistable *p)
 {
+  TraceScope trc("PersistentWriter::writeObject");
+
   Field& fld = getRefField(fldName);
 
   if (p) {
@@ -934,10 +1020,41 @@ void PersistentWriter::writeArrayPrivate(Field& fld, const void *arr, int len)
 
 //---------------------------------------------------------------------------
 
+static int memElemSize(Type::DataType dataType)
+{
+  switch (dataType) {
+    case Type::Boolean: return sizeof(bool);
+    case Type::WChar:   return sizeof(wchar_t);
+    case Type::Byte:    return sizeof(char);
+    case Type::Short:   return sizeof(short);
+    case Type::Integer: return sizeof(long);
+    case Type::Long:    return sizeof(__int64);
+    case Type::Float:   return sizeof(float);
+    case Type::Double:  return sizeof(double);
+
+    default:            return 0; // Not deduplicated
+  }
+}
+
+//---------------------------------------------------------------------------
+
 void PersistentWriter::emitBasicArray(const OutArray& arrObj)
 {
   const Basic& elTp = dynamic_cast<const Basic&>(arrObj.type.elemType);
 
+  int memSz = memElemSize(elTp.dataType);
+
+  if (memSz > 0 && arrayPool.isDedup()) {
+    const OutArray *orgArr =
+          arrayPool.findDuplicate(arrObj,arrObj.sz*memSz,
+                                         arrObj.sz*elTp.getDataSize());
+    if (orgArr) {
+      dWrt.writeByte(Record_ArrayCopy,"PersistentWriter::emitBasicArray");
+      dWrt.writeInt(orgArr->id,"PersistentWriter::emitBasicArray");
+      return;
+    }
+  }
+
   if (elTp.dataType == Type::String) {
     // Make sure the strings are emitted first;
 
@@ -994,13 +1111,31 @@ void PersistentWriter::emitBasicArray(const OutArray& arrObj)
 
     case Type::Float: {
       const float *fArr = (const float *)arrObj.arr;
-      dWrt.write(fArr,arrObj.sz,"PersistentWriter::emitBasicArray: float");
+
+      if (arrayPool.isFpCodec() && arrObj.sz > 0) {
+        std::vector<unsigned char> buf(arrObj.sz*4);
+        Basic::encodeFp(fArr,arrObj.sz,&buf[0]);
+
+        dWrt.write((const char *)&buf[0],arrObj.sz*4,
+                                   "PersistentWriter::emitBasicArray: float");
+      }
+      else
+        dWrt.write(fArr,arrObj.sz,"PersistentWriter::emitBasicArray: float");
     }
     break;
 
     case Type::Double: {
       const double *dArr = (const double *)arrObj.arr;
-      dWrt.write(dArr,arrObj.sz,"PersistentWriter::emitBasicArray: double");
+
+      if (arrayPool.isFpCodec() && arrObj.sz > 0) {
+        std::vector<unsigned char> buf(arrObj.sz*8);
+        Basic::encodeFp(dArr,arrObj.sz,&buf[0]);
+
+        dWrt.write((const char *)&buf[0],arrObj.sz*8,
+                                  "PersistentWriter::emitBasicArray: double");
+      }
+      else
+        dWrt.write(dArr,arrObj.sz,"PersistentWriter::emitBasicArray: double");
     }
     break;
 
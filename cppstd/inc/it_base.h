@@ -75,6 +75,25 @@ struct IT_Std_Alloc
   static void Free(T *v) { if (v) delete[] v; }
 };
 
+/* ---------------------------------------------------------------------- */
+/* ------ Allocator Statistics ------------------------------------------ */
+/* ---------------------------------------------------------------------- */
+
+struct IT_Alloc_Stats
+{
+    size_t item_size;   // Bytes per item
+    long   live;        // Items in use
+    long   free;        // Items kept in the free list
+    long   high_water;  // Highest number of items (live + free) ever
+
+    IT_Alloc_Stats() : item_size(0), live(0), free(0), high_water(0) {}
+
+    IT_Alloc_Stats& operator+=(const IT_Alloc_Stats& st);
+
+    size_t Live_Bytes() const { return live * item_size; }
+    size_t Free_Bytes() const { return free * item_size; }
+};
+
 /* ---------------------------------------------------------------------- */
 /* ------ Chain Allocator for Inofor Templates -------------------------- */
 /* ---------------------------------------------------------------------- */
@@ -85,11 +104,16 @@ class IT_Chain_Alloc
     IT_Chain_Alloc *next;
     static IT_Chain_Alloc *root;
 
+    static IT_Alloc_Stats& counters();
+
   public:
     static T* New();
     static void Free(T *v);
 
     static void Cleanup();
+
+    static void Stats(IT_Alloc_Stats& st);
+    static size_t Trim(size_t keep_bytes); // Returns bytes released
 };
 
 #include "it_base_imp.h"
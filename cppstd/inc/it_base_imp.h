@@ -13,15 +13,54 @@
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
+inline IT_Alloc_Stats& IT_Alloc_Stats::operator+=(const IT_Alloc_Stats& st)
+{
+  // Item sizes differ per allocator, so sum in bytes (item_size 1)
+  if (item_size != 1) {
+    live *= item_size; free *= item_size; high_water *= item_size;
+    item_size = 1;
+  }
+
+  live       += st.live * st.item_size;
+  free       += st.free * st.item_size;
+  high_water += st.high_water * st.item_size;
+
+  return *this;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+template <class T>
+IT_Alloc_Stats& IT_Chain_Alloc<T>::counters()
+{
+  static IT_Alloc_Stats st;
+
+  return st;
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
 template <class T>
 T *IT_Chain_Alloc<T>::New()
 {
+  IT_Alloc_Stats& st = counters();
+  st.live++;
+
   if (root) {
+    st.free--;
+
     T *n = (T *)root;
     root = root->next;
     return n;
   }
-  else return (T *)new char[sizeof(T)];
+
+  if (st.live + st.free > st.high_water) st.high_water = st.live + st.free;
+
+  return (T *)new char[sizeof(T)];
 }
 
 /* ---------------------------------------------------------------------- */
@@ -32,6 +71,10 @@ template <class T>
 void IT_Chain_Alloc<T>::Free(T *v)
 {
   if (v) {
+    IT_Alloc_Stats& st = counters();
+    st.live--;
+    st.free++;
+
     ((IT_Chain_Alloc *)v)->next = root;
     root = (IT_Chain_Alloc *)v;
   }
@@ -44,16 +87,45 @@ void IT_Chain_Alloc<T>::Free(T *v)
 template <class T>
 void IT_Chain_Alloc<T>::Cleanup()
 {
-  while (root) {
+  Trim(0);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+template <class T>
+void IT_Chain_Alloc<T>::Stats(IT_Alloc_Stats& st)
+{
+  st = counters();
+  st.item_size = sizeof(T);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------- Release free items until at most keep_bytes remain --------- */
+/* ---------------------------------------------------------------------- */
+
+template <class T>
+size_t IT_Chain_Alloc<T>::Trim(size_t keep_bytes)
+{
+  IT_Alloc_Stats& st = counters();
+
+  long keep = (long)(keep_bytes / sizeof(T));
+  size_t released = 0;
+
+  while (root && st.free > keep) {
     IT_Chain_Alloc *nxt = root->next;
 
-    delete root;
+    delete[] (char *)root;
+    released += sizeof(T);
 
     root = nxt;
+    st.free--;
   }
+
+  return released;
 }
 
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
-
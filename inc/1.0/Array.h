@@ -74,7 +74,7 @@ namespace Ino
 
 //---------------------------------------------------------------------------
 
-template <class T> class Array : public ArrayElem
+template <class T> class Array final : public ArrayElem
 {
   static const int TypeVal = ArrayTraits::BaseType<T>::TypeVal;
   typedef typename ArrayTraits::Type<T,TypeVal>::ElemType ElemType;
@@ -86,6 +86,7 @@ template <class T> class Array : public ArrayElem
   int lstSz, lstCap;
 
   void incCapacity();
+  void growFor(int extra);
 
 public:
   typedef typename ArrayTraits::Type<T,TypeVal>::ArgType ArgType;
@@ -108,26 +109,32 @@ public:
   void ensureCapacity(int minCap);
   void shrinkCapacity(int reserveCap = 0);
 
-  virtual void clear();
+  void clear();
 
-  virtual int add(ArgType item);
-  virtual void set(int idx, ArgType item);
-  virtual void insert(int idx, ArgType item);
-  virtual void remove(int idx);
+  int add(ArgType item);
+  void set(int idx, ArgType item);
+  void insert(int idx, ArgType item);
+  void remove(int idx);
 
-  virtual void swap(int idx1, int idx2);
+  void swap(int idx1, int idx2);
 
-  virtual ConstReturnType get(int idx) const;
-  virtual ReturnType get(int idx);
+  ConstReturnType get(int idx) const;
+  ReturnType get(int idx);
 
-  virtual ConstReturnType operator[](int idx) const;
-  virtual ReturnType operator[](int idx);
+  ConstReturnType operator[](int idx) const;
+  ReturnType operator[](int idx);
 
-#ifdef _WIN32
-  template <class LessThan> void sort(LessThan& lt);
-  template <class LessThan> void stableSort(LessThan *lt);
-#endif
+  // Bulk operations, at most one realloc and one memmove each
+
+  template <class InIt> void append(InIt first, InIt last);
+  void append(const Array& src);
+  template <class InIt> void insert(int idx, InIt first, InIt last);
+  template <class Pred> int removeIf(Pred pred);
 
+  template <class LessThan> void sort(LessThan lt);
+  template <class LessThan> void stableSort(LessThan lt);
+  template <class LessThan>
+                    int binarySearch(ArgType item, LessThan lt) const;
 };
 
 } // namespace Ino
@@ -18,10 +18,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <typeinfo>
-
-#ifdef _WIN32
 #include <algorithm>
-#endif
+#include <iterator>
 
 namespace Ino
 {
@@ -130,12 +128,9 @@ template <class T> struct Func<T,1>
 
     T *newLst = (T *)malloc(byteSz);
 
-#pragma warning(push)
-#pragma warning(disable : 6387)
-    memcpy_s(newLst,byteSz,lst,byteSz);
+    memcpy(newLst,lst,byteSz);
 
     return newLst;
-#pragma warning(pop)
   }
 
   static inline void clearItem(T it, bool owner) {
@@ -202,6 +197,30 @@ template <class T> struct Func<T,3>
   static inline wchar_t *getItem(wchar_t *it) { return it; }
 };
 
+//---------------------------------------------------------------------------
+// Adapts a comparator on elements to the stored ElemType
+
+template <class T, int typeVal, class LessThan> struct Less
+{
+  LessThan lt;
+
+  Less(LessThan l) : lt(l) {}
+
+  bool operator()(const T& t1, const T& t2) { return lt(t1,t2); }
+};
+
+//---------------------------------------------------------------------------
+// T is type derived from ArrayElem, the list holds pointers
+
+template <class T, class LessThan> struct Less<T,2,LessThan>
+{
+  LessThan lt;
+
+  Less(LessThan l) : lt(l) {}
+
+  bool operator()(const T *t1, const T *t2) { return lt(*t1,*t2); }
+};
+
 } // namespace ArrayFuncs
 
 //---------------------------------------------------------------------------
@@ -218,6 +237,22 @@ template <class T> void Array<T>::incCapacity()
   if (mem) lst = mem;
 }
 
+//---------------------------------------------------------------------------
+// Makes room for extra elements, growing by at least capIncPercent
+
+template <class T> void Array<T>::growFor(int extra)
+{
+  int minCap = lstSz + extra;
+  if (minCap <= lstCap) return;
+
+  int newCap = lstCap + (int)(((long long)lstCap) * capIncPercent / 100);
+
+  if (newCap < minCap) newCap = minCap;
+  if (newCap < 8) newCap = 8;
+
+  ensureCapacity(newCap);
+}
+
 //---------------------------------------------------------------------------
 /** \typedef typename ArrayTraits::Type<T,TypeVal>::ArgType Array::ArgType
   Defines the type of argument \c item for methods add(), set() and insert().
@@ -499,7 +534,7 @@ template <class T> Array<T>::Array(int initCap, int capIncrPercent)
   capIncPercent(capIncrPercent),
   lst(NULL), lstSz(0), lstCap(0)
 {
-  const type_info& tp = typeid(T);
+  const std::type_info& tp = typeid(T);
 
   if (tp != typeid(bool) && tp != typeid(short) && tp != typeid(int) &&
       tp != typeid(long) && tp != typeid(float) && tp != typeid(double) &&
@@ -551,7 +586,7 @@ template <class T> Array<T>::Array(bool owner,
   if (objOwner && !ArrayTraits::BaseType<T>::IsArrayElemPtr)
     throw WrongTypeException("Array<T>: Can only be owner of ArrayElem *");
 
-  const type_info& tp = typeid(T);
+  const std::type_info& tp = typeid(T);
 
   if (tp != typeid(bool) && tp != typeid(short) && tp != typeid(int) &&
       tp != typeid(long) && tp != typeid(float) && tp != typeid(double) &&
@@ -706,9 +741,11 @@ template <class T> void Array<T>::clear()
 
 template <class T> int Array<T>::add(ArgType item)
 {
-  insert(lstSz,item);
+  if (lstSz >= lstCap) incCapacity();
 
-  return lstSz-1;
+  lst[lstSz] = ArrayFuncs::Func<T,TypeVal>::newItem(item);
+
+  return lstSz++;
 }
 
 //---------------------------------------------------------------------------
@@ -751,7 +788,7 @@ template <class T> int Array<T>::add(ArgType item)
 
 template <class T> void Array<T>::set(int idx, ArgType item)
 {
-  if (idx < 0 || idx > lstSz)
+  if (idx < 0 || idx >= lstSz)
     throw IndexOutOfBoundsException("Array<T>::set");
 
   ArrayFuncs::Func<T,TypeVal>::clearItem(lst[idx],objOwner);
@@ -881,7 +918,8 @@ template <class T> void Array<T>::swap(int idx1, int idx2)
   The original object must then eventually be deleted by yourself.
 */
 
-template <class T> typename Array<T>::ReturnType Array<T>::get(int idx)
+template <class T> inline typename Array<T>::ReturnType
+                                               Array<T>::get(int idx)
 {
   if (idx < 0 || idx >= lstSz)
     throw IndexOutOfBoundsException("Array<T>::get");
@@ -902,7 +940,7 @@ template <class T> typename Array<T>::ReturnType Array<T>::get(int idx)
   \see \ref TypeResolution
 */
 
-template <class T> typename Array<T>::ConstReturnType
+template <class T> inline typename Array<T>::ConstReturnType
                                          Array<T>::get(int idx) const
 {
   if (idx < 0 || idx >= lstSz)
@@ -926,7 +964,7 @@ template <class T> typename Array<T>::ConstReturnType
   \see \ref TypeResolution
 */
 
-template <class T> typename Array<T>::ConstReturnType
+template <class T> inline typename Array<T>::ConstReturnType
                                     Array<T>::operator[](int idx) const
 {
   if (idx < 0 || idx >= lstSz)
@@ -955,7 +993,7 @@ template <class T> typename Array<T>::ConstReturnType
   The original object must then eventually be deleted by yourself.
 */
 
-template <class T> typename Array<T>::ReturnType
+template <class T> inline typename Array<T>::ReturnType
                                     Array<T>::operator[](int idx)
 {
   if (idx < 0 || idx >= lstSz)
@@ -965,7 +1003,115 @@ template <class T> typename Array<T>::ReturnType
 }
 
 //---------------------------------------------------------------------------
-#ifdef _WIN32
+/** Appends a range of elements to this array.
+
+  \param first Iterator (or pointer) to the first element to append.
+  \param last Iterator (or pointer) just beyond the last element.
+
+  The range must be a forward range, such as a plain C array of \c ArgType
+  values.\n
+  The capacity is increased at most once.\n
+  The elements are copied the same way as with add().
+*/
+
+template <class T> template <class InIt>
+                          void Array<T>::append(InIt first, InIt last)
+{
+  insert(lstSz,first,last);
+}
+
+//---------------------------------------------------------------------------
+/** Appends (copies of) all elements of \p src to this array.
+
+  \param src The array to append, may be this array itself.
+
+  The capacity is increased at most once.\n
+  The elements are copied the same way as with add().
+*/
+
+template <class T> void Array<T>::append(const Array& src)
+{
+  int n = src.lstSz;
+  if (n < 1) return;
+
+  growFor(n);
+
+  for (int i=0; i<n; ++i)
+    lst[lstSz+i] = ArrayFuncs::Func<T,TypeVal>::newItem(
+                         ArrayFuncs::Func<T,TypeVal>::getItem(src.lst[i]));
+
+  lstSz += n;
+}
+
+//---------------------------------------------------------------------------
+/** Inserts a range of elements into this array.
+
+  \param idx The index position \em before which the elements are inserted.\n
+  If \p idx == size() the elements are \em appended.
+
+  \param first Iterator (or pointer) to the first element to insert.
+  \param last Iterator (or pointer) just beyond the last element.
+
+  \throw IndexOutOfBoundsException If \p idx < 0 or \p idx > size().
+
+  The range must be a forward range and must not refer to this array.\n
+  The capacity is increased at most once and the tail of the array is
+  moved only once.\n
+  The elements are copied the same way as with insert(int,ArgType).
+*/
+
+template <class T> template <class InIt>
+              void Array<T>::insert(int idx, InIt first, InIt last)
+{
+  if (idx < 0 || idx > lstSz)
+    throw IndexOutOfBoundsException("Array<T>::insert range");
+
+  int n = (int)std::distance(first,last);
+  if (n < 1) return;
+
+  growFor(n);
+
+  memmove(lst+idx+n,lst+idx,(lstSz-idx)*sizeof(ElemType));
+
+  for (int i=0; i<n; ++i, ++first)
+    lst[idx+i] = ArrayFuncs::Func<T,TypeVal>::newItem(*first);
+
+  lstSz += n;
+}
+
+//---------------------------------------------------------------------------
+/** Removes all elements for which \p pred returns \c true.
+
+  \param pred A function or functor taking a \c ConstReturnType
+  and returning \c bool.
+  \return The number of elements removed.
+
+  The remaining elements keep their order; the array is compacted in a
+  single pass.\n
+  Removed elements are destroyed the same way as with remove().
+*/
+
+template <class T> template <class Pred> int Array<T>::removeIf(Pred pred)
+{
+  int dst = 0;
+
+  for (int i=0; i<lstSz; ++i) {
+    ConstReturnType v = ArrayFuncs::Func<T,TypeVal>::getItem(lst[i]);
+
+    if (pred(v)) ArrayFuncs::Func<T,TypeVal>::clearItem(lst[i],objOwner);
+    else {
+      if (dst != i) lst[dst] = lst[i];
+      dst++;
+    }
+  }
+
+  int removed = lstSz - dst;
+  lstSz = dst;
+
+  return removed;
+}
+
+//---------------------------------------------------------------------------
 /** Sort operator for this array.
 
   \param lt A comparison functor type.\n
@@ -981,15 +1127,16 @@ template <class T> typename Array<T>::ReturnType
   };</tt>\n
   with similar functionality.
 
-  \note Not (yet) available ion Linux.
+  If the element type is a class derived from ArrayElem only the element
+  pointers are moved, no copy constructor is called.
 */
 
 template <class T> template <class LessThan>
-                                         void Array<T>::sort(LessThan& lt)
+                                         void Array<T>::sort(LessThan lt)
 {
   if (lstSz < 2) return;
 
-  std::sort(lst,lst+lstSz,lt);
+  std::sort(lst,lst+lstSz,ArrayFuncs::Less<T,TypeVal,LessThan>(lt));
 }
 
 //---------------------------------------------------------------------------
@@ -997,30 +1144,46 @@ template <class T> template <class LessThan>
 
   See the STL documentation for a definition of stable sort.
 
-  \param lt A comparison functor type.\n
-  It must be either:
-  \li A function: <tt>bool (*lt)(const T& t1, const T& t2);</tt>\n
-      The function must must return \c true if and only
-      if \a t1 is <em>less than \a t2</em>.\n
-  \li A class with <tt>operator()</tt> defined:\n
-  <tt>class Comparator
-  {
-  public:
-    bool operator()(const T& t1, const T& t2);
-  };</tt>\n
-  with similar functionality.
-
-  \note Not (yet) available ion Linux.
+  \param lt A comparison functor type, see sort().
 */
 
-template <class T> template <class LessThan> 
-                                    void Array<T>::stableSort(LessThan *lt)
+template <class T> template <class LessThan>
+                                   void Array<T>::stableSort(LessThan lt)
 {
   if (lstSz < 2) return;
 
-  std::stable_sort(lst,lst+lstSz-1,lt);
+  std::stable_sort(lst,lst+lstSz,ArrayFuncs::Less<T,TypeVal,LessThan>(lt));
+}
+
+//---------------------------------------------------------------------------
+/** Binary search in this array, that must be sorted according to \p lt.
+
+  \param item The element to search for.
+  \param lt A comparison functor type, see sort().
+
+  \return The index of an element equivalent to \p item or, if there is
+  no such element, <tt>-(insertion point) - 1</tt>.\n
+  The insertion point is the index of the first element greater
+  than \p item (or size()).
+*/
+
+template <class T> template <class LessThan>
+              int Array<T>::binarySearch(ArgType item, LessThan lt) const
+{
+  int lo = 0, hi = lstSz;
+
+  while (lo < hi) {
+    int mid = (lo + hi) >> 1;
+
+    if (lt(ArrayFuncs::Func<T,TypeVal>::getItem(lst[mid]),item)) lo = mid+1;
+    else hi = mid;
+  }
+
+  if (lo < lstSz && !lt(item,ArrayFuncs::Func<T,TypeVal>::getItem(lst[lo])))
+    return lo;
+
+  return -lo - 1;
 }
-#endif
 
 }
 
@@ -102,6 +102,19 @@ extern int compareAlphaNum(const wchar_t *s1, const wchar_t *s2);
 extern int compareNcAlphaNum(const char *s1, const char *s2);
 extern int compareNcAlphaNum(const wchar_t *s1, const wchar_t *s2);
 
+extern size_t alphaNumKey(const char *s, unsigned char *key, size_t keyCap,
+                                                      bool noCase=false);
+extern size_t alphaNumKey(const wchar_t *s, unsigned char *key,
+                                      size_t keyCap, bool noCase=false);
+
+extern int compareAlphaNumKeys(const unsigned char *k1, size_t len1,
+                               const unsigned char *k2, size_t len2);
+
+extern void sortAlphaNum(const char *const *strs, int cnt, int *order,
+                                                      bool noCase=false);
+extern void sortAlphaNum(const wchar_t *const *strs, int cnt, int *order,
+                                                      bool noCase=false);
+
 extern double toDegrees(double val);
 extern double toRadians(double val);
 
@@ -12,9 +12,61 @@
 
 #include "Basics.h"
 
+#include <cstddef>
+
 namespace Ino
 {
 
+//---------------------------------------------------------------------------
+//------ Workspace: a bump allocator for solver temporaries -----------------
+//---------------------------------------------------------------------------
+// Vectors and Matrices made on a workspace take their memory from it and
+// never give it back themselves. A Mark gives back all that was taken after
+// it when it goes out of scope; the blocks are kept for the next use, so a
+// loop that makes the same temporaries over and over stops allocating once
+// the workspace has grown. A workspace must be used by one thread only,
+// local() is the one of the calling thread.
+
+class MatrixWorkspace
+{
+  struct Block;
+
+  Block *first, *cur;
+  size_t nextBlockSz;   // In doubles
+  long heapAllocs;
+
+  void release(Block *blk, size_t used);
+
+  MatrixWorkspace(const MatrixWorkspace& cp);             // No Copying
+  MatrixWorkspace& operator=(const MatrixWorkspace& src); // No Assignment
+
+public:
+  class Mark
+  {
+    MatrixWorkspace& ws;
+    Block *blk;
+    size_t used;
+
+    Mark(const Mark& cp);             // No Copying
+    Mark& operator=(const Mark& src); // No Assignment
+
+  public:
+    explicit Mark(MatrixWorkspace& workspace);
+    ~Mark();
+  };
+
+  explicit MatrixWorkspace(size_t initDoubles = 4096);
+  ~MatrixWorkspace();
+
+  double *take(size_t doubles);
+  void *takeBytes(size_t bytes); // Aligned as double
+
+  long heapAllocCount() const { return heapAllocs; } // Blocks allocated
+  size_t capacity() const;                           // In doubles
+
+  static MatrixWorkspace& local();
+};
+
 //---------------------------------------------------------------------------
 
  class Matrix;
@@ -25,10 +77,13 @@ class Vector
   int sz;
   int cap;
 
+  MatrixWorkspace *ws; // NULL: va is on the heap
+
   Vector(double *arr, int len); // For PVector
 
 public:
   Vector(int size, bool zeroInit=true);
+  Vector(MatrixWorkspace& workspace, int size, bool zeroInit=true);
   Vector(const Vector& cp);
   ~Vector();
 
@@ -70,12 +125,15 @@ class Matrix
   double  *matRows;
   int    rws, cls;
 
+  MatrixWorkspace *ws; // NULL: mat and matRows are on the heap
+
   void alloc(int rows, int cols, bool setZero = true);
 
   Matrix(int rows, int columns, double *elems); // For PMatrix
 
 public:
   Matrix(int rows, int cols, bool zeroInit=true);
+  Matrix(MatrixWorkspace& workspace, int rows, int cols, bool zeroInit=true);
   Matrix(const Matrix& cp);
   ~Matrix();
 
@@ -102,6 +160,11 @@ public:
 
   void solveLDLT(Vector& b);
   void solveLDLT(Matrix& rhs);
+
+  // Same, the work arrays are taken from ws instead of the local one
+
+  void solveLDLT(Vector& b, MatrixWorkspace& ws);
+  void solveLDLT(Matrix& rhs, MatrixWorkspace& ws);
 };
 
 } // namespace Ino
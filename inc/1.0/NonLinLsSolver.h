@@ -67,6 +67,11 @@ protected:
 
 public:
   NonLinLsSolver(int maxSolDims, int maxDataPoints);
+
+  // The matrices and vectors are taken from ws, the solver must not
+  // outlive the MatrixWorkspace::Mark they were taken under.
+
+  NonLinLsSolver(MatrixWorkspace& ws, int maxSolDims, int maxDataPoints);
   virtual ~NonLinLsSolver();
 
   void setSolSz(int newSolDims);
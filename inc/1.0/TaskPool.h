@@ -0,0 +1,246 @@
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//------- Shared Task Scheduling --------------------------------------------
+//---------------------------------------------------------------------------
+//------- Copyright Inofor Hoek Aut BV OCT 2026 -----------------------------
+//---------------------------------------------------------------------------
+//------- C. Wolters --------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
+#ifndef INOTASKPOOL_INC
+#define INOTASKPOOL_INC
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+namespace Ino
+{
+
+class TolContext;
+
+//---------------------------------------------------------------------------
+/** \class TaskExecutor
+    Runs jobs handed to it on threads of its own. An application that has
+    a thread pool already can implement this and pass it to
+    TaskPool::setExecutor(), the library then uses no threads of its own.
+
+    execute() must not run the job on the calling thread nor block until
+    it has run; it may run it late, a job handed out is also run by the
+    waiting thread when the executor has not started it yet.
+*/
+
+class TaskExecutor
+{
+public:
+  virtual ~TaskExecutor() {}
+
+  virtual int threads() const = 0;   // Concurrency, the caller included
+  virtual void execute(void (*job)(void *arg), void *arg) = 0;
+};
+
+//---------------------------------------------------------------------------
+/** \class TaskPool
+    Work stealing pool of threads - 1 workers, the thread waiting on a
+    TaskGroup being the last one. A job handed out by a worker goes to
+    the back of its own queue and is taken from there by that worker,
+    idle workers steal from the front of the queues of the others. Jobs
+    from other threads go to a shared queue.\n
+    A worker waiting on a TaskGroup runs other jobs meanwhile, so nested
+    parallel loops share the workers instead of adding threads.
+*/
+
+class TaskPool : public TaskExecutor
+{
+  struct Queue;
+  struct Worker;
+
+  std::vector<Queue *> queues;       // [0] the shared one, then workers
+  std::vector<Worker *> workers;
+
+  std::atomic<long> queued;
+  std::atomic<int> sleepers;
+  std::atomic<bool> stop;
+
+  std::mutex sleepMtx;
+  std::condition_variable wake;
+
+  TaskPool(const TaskPool& cp);             // No Copying
+  TaskPool& operator=(const TaskPool& src); // No Assignment
+
+  bool take(int self, void (*&job)(void *), void *& arg);
+  void work(int self);
+
+public:
+  explicit TaskPool(int threads = 0);      // < 1: the hardware threads
+  ~TaskPool();
+
+  int threads() const { return (int)workers.size() + 1; }
+  void execute(void (*job)(void *arg), void *arg);
+
+  static bool isWorker();                  // Of any TaskPool
+  static bool helpOne();                   // Run a job if on a worker
+
+  static void setThreads(int threads);     // Of the shared pool
+  static void setExecutor(TaskExecutor *ex); // NULL: the shared pool
+  static TaskExecutor& executor();
+};
+
+//---------------------------------------------------------------------------
+/** \class TaskGroup
+    Jobs that are waited for together. The first exception thrown by a
+    job cancels the group: jobs not yet started are skipped and wait()
+    rethrows it. A job runs under the TolContext of the thread that
+    called run().\n
+    run(), runHere() and wait() are called by one thread, the owner.
+*/
+
+class TaskGroup
+{
+  struct Job
+  {
+    TaskGroup *grp;
+    const TolContext *tol;
+    std::atomic<int> state;  // 0: new, 1: claimed
+    std::atomic<int> refs;   // The executor and the group
+
+    Job(TaskGroup *g);
+    virtual ~Job() {}
+
+    virtual void call() = 0;
+
+    bool claim() { int nw = 0; return state.compare_exchange_strong(nw,1); }
+    void release() { if (--refs == 0) delete this; }
+
+    static void invoke(void *job);
+  };
+
+  template <class Fn> struct FnJob : public Job
+  {
+    Fn fn;
+
+    FnJob(TaskGroup *g, const Fn& f) : Job(g), fn(f) {}
+    void call() { fn(); }
+  };
+
+  TaskExecutor& ex;
+  std::vector<Job *> jobs;
+
+  std::mutex mtx;
+  std::condition_variable done;
+  int pending;
+  std::exception_ptr err;
+  std::atomic<bool> cancel;
+
+  TaskGroup(const TaskGroup& cp);             // No Copying
+  TaskGroup& operator=(const TaskGroup& src); // No Assignment
+
+  void submit(Job *job);
+  void execute(Job *job);
+  void fail();
+
+public:
+  TaskGroup() : ex(TaskPool::executor()), pending(0), cancel(false) {}
+  explicit TaskGroup(TaskExecutor& executor)
+                          : ex(executor), pending(0), cancel(false) {}
+  ~TaskGroup();                            // Waits, an exception is lost
+
+  int threads() const { return ex.threads(); }
+
+  template <class Fn> void run(const Fn& fn)
+                                   { submit(new FnJob<Fn>(this,fn)); }
+
+  template <class Fn> void runHere(const Fn& fn);
+
+  void wait();
+  bool cancelled() const { return cancel.load(std::memory_order_relaxed); }
+};
+
+//---------------------------------------------------------------------------
+// Runs fn on the calling thread as a job of this group, so an exception
+// cancels the group instead of leaving run jobs unwaited.
+
+template <class Fn> void TaskGroup::runHere(const Fn& fn)
+{
+  if (cancelled()) return;
+
+  try {
+    fn();
+  }
+  catch (...) {
+    fail();
+  }
+}
+
+//---------------------------------------------------------------------------
+/** Calls fn(i) for i in [0,n), on at most maxThreads threads (< 1: all
+    of the executor) the calling thread included. The indices are handed
+    out one at a time, each to exactly one thread, so a result stored by
+    index does not depend on the thread count. The first exception stops
+    the loop and is rethrown.
+*/
+
+template <class Fn> void parallelFor(int n, int maxThreads, const Fn& fn)
+{
+  int thrCnt = n;
+  if (maxThreads > 0 && thrCnt > maxThreads) thrCnt = maxThreads;
+
+  if (thrCnt > 1) {
+    int exThreads = TaskPool::executor().threads();
+    if (thrCnt > exThreads) thrCnt = exThreads;
+  }
+
+  if (thrCnt < 2) {
+    for (int i=0; i<n; ++i) fn(i);
+    return;
+  }
+
+  TaskGroup grp;
+  std::atomic<int> nextIdx(0);
+
+  auto work = [&]() {
+    for (int i = nextIdx++; i < n && !grp.cancelled(); i = nextIdx++) fn(i);
+  };
+
+  for (int t=1; t<thrCnt; ++t) grp.run(work);
+
+  grp.runHere(work);
+  grp.wait();
+}
+
+//---------------------------------------------------------------------------
+/** Reduces [0,n) in chunks of grain indices: part = map(lwb,upb) per
+    chunk, the parts are joined as join(join(init,part0),part1)... in
+    chunk order by the calling thread. The chunks depend on n and grain
+    only, so the result is the same for any thread count, also when join
+    is not associative in floating point.
+*/
+
+template <class T, class Map, class Join>
+T parallelReduce(int n, int grain, int maxThreads, const T& init,
+                                            const Map& map, const Join& join)
+{
+  if (grain < 1) grain = 1;
+
+  int chunks = (n + grain - 1) / grain;
+
+  std::vector<T> parts(chunks > 0 ? chunks : 0, init);
+
+  parallelFor(chunks,maxThreads,[&](int c) {
+    int upb = (c+1) * grain;
+    parts[c] = map(c * grain, upb < n ? upb : n);
+  });
+
+  T res = init;
+  for (int c=0; c<chunks; ++c) res = join(res,parts[c]);
+
+  return res;
+}
+
+} // namespace Ino
+
+//---------------------------------------------------------------------------
+#endif
@@ -0,0 +1,83 @@
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//------- Timeline Tracing --------------------------------------------------
+//---------------------------------------------------------------------------
+//------- Copyright Inofor Hoek Aut BV OCT 2026 -----------------------------
+//---------------------------------------------------------------------------
+//------- C. Wolters --------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
+#ifndef INOTRACE_INC
+#define INOTRACE_INC
+
+#include <atomic>
+#include <cstdio>
+
+namespace Ino
+{
+
+//---------------------------------------------------------------------------
+/** \class Trace
+    Records begin/end events of (library) operations per thread and dumps
+    them in the Chrome/Perfetto trace event (JSON) format.
+
+    Tracing is disabled by default, then a TraceScope costs one relaxed
+    atomic load. Each thread writes into its own buffer, no locks are
+    taken while recording.\n
+    Event names must be string literals (or otherwise outlive the trace).
+*/
+
+class Trace
+{
+  static std::atomic<bool> on;
+
+  Trace();
+
+public:
+  static bool enabled() { return on.load(std::memory_order_relaxed); }
+  static void enable(bool enable);
+
+  static void begin(const char *name, long count = -1);
+  static void end(const char *name, long count = -1);
+
+  static void clear();         // Only while no thread is recording
+  static long dropped();       // Events lost because a buffer was full
+
+  static bool writeJson(FILE *fp);
+  static bool writeJson(const char *fileName);
+};
+
+//---------------------------------------------------------------------------
+/** \class TraceScope
+    Emits a begin event at construction and the matching end event at
+    destruction, when tracing was enabled at construction.\n
+    \c count is an optional size of the operation, such as the number of
+    elements; set it at the end with count(long) if only known then.
+*/
+
+class TraceScope
+{
+  const char *nm;
+  long cnt;
+  bool act;
+
+  TraceScope(const TraceScope& cp);             // No Copying
+  TraceScope& operator=(const TraceScope& src); // No Assignment
+
+public:
+  TraceScope(const char *name, long count = -1)
+  : nm(name), cnt(count), act(Trace::enabled())
+  {
+    if (act) Trace::begin(nm,cnt);
+  }
+
+  ~TraceScope() { if (act) Trace::end(nm,cnt); }
+
+  void count(long newCount) { cnt = newCount; }
+};
+
+} // namespace Ino
+
+//---------------------------------------------------------------------------
+#endif
@@ -123,6 +123,44 @@ class Trf3
     friend class Vec3;
 };
 
+// -------------------------------------------------------------------------
+// ------- Inline implementations ------------------------------------------
+// -------------------------------------------------------------------------
+
+inline Vec2 Trf2::operator* (const Vec2& p) const      // Transform vector
+{
+  Vec2 v(m[0][0] * p.x + m[0][1] * p.y,
+         m[1][0] * p.x + m[1][1] * p.y);
+
+  if (!p.isDerivative) {
+    v.x += m[0][2];
+    v.y += m[1][2];
+  }
+
+  v.isDerivative = isDerivative || p.isDerivative;
+
+  return v;
+}
+
+// -------------------------------------------------------------------------
+
+inline Vec3 Trf3::operator* (const Vec3& p) const      // Transform vector
+{
+  Vec3 v(m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z,
+         m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z,
+         m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z);
+
+  if (!p.isDerivative) {
+    v.x += m[0][3];
+    v.y += m[1][3];
+    v.z += m[2][3];
+  }
+
+  v.isDerivative = isDerivative || p.isDerivative;
+
+  return v;
+}
+
 } // namespace Ino
 
 // -------------------------------------------------------------------------
@@ -11,10 +11,42 @@
 
 #include "Basics.h"
 
+#include <cmath>
+
 namespace Ino {
 
 class Trf2;
 
+// --------------------------------------------------------------------------
+// ------- Geometric tolerances ---------------------------------------------
+// --------------------------------------------------------------------------
+// Vec2::IdentDist and Vec2::IdentDir are the process wide defaults. A
+// TolScope makes a TolContext current for its own thread only, library
+// code reads the tolerances through Vec2::identDist() and identDir().
+
+class TolContext
+{
+  public:
+   double identDist;
+   double identDir;
+
+   TolContext();                            // The current defaults
+   TolContext(double dist, double dir);
+};
+
+class TolScope
+{
+   const TolContext *prev;
+
+   TolScope(const TolScope& cp);             // No Copying
+   TolScope& operator=(const TolScope& src); // No Assignment
+
+  public:
+   explicit TolScope(const TolContext& ctx); // ctx must outlive the scope
+   explicit TolScope(const TolContext *ctx); // NULL: keep the current one
+   ~TolScope();
+};
+
 // --------------------------------------------------------------------------
 // ------- 2D Vector --------------------------------------------------------
 // --------------------------------------------------------------------------
@@ -22,37 +54,55 @@ class Trf2;
 class Vec2
 {
   public:
-   static double IdentDist;
+   static double IdentDist;  // Defaults, see TolContext
    static double IdentDir;
 
+   static thread_local const TolContext *curTol;
+
+   static double identDist()
+                   { return curTol ? curTol->identDist : IdentDist; }
+   static double identDir()
+                   { return curTol ? curTol->identDir : IdentDir; }
+
    static const double Pi;  // Pi
    static const double Pi2; // 2.0 * Pi;
 
    double x, y;
    bool isDerivative;
 
-   Vec2(double cx=0, double cy=0.0) : x(cx), y(cy), isDerivative(false) {};
+   constexpr Vec2(double cx=0, double cy=0.0)
+                             : x(cx), y(cy), isDerivative(false) {}
 
    double unitLen2();             // Make unitlength, return old length
 
-   double len2() const;
-   double lenSq2() const  { return x*x + y*y; }
+   double len2() const { return sqrt(x*x + y*y); }
+   constexpr double lenSq2() const { return x*x + y*y; }
 
    double len2(double newLen);    // Set new length return old length;
 
    double angle() const;
 
-   double distTo2(const Vec2& v) const;
-   double sqDistTo2(const Vec2& v) const; // Square of distance
+   double distTo2(const Vec2& v) const { return sqrt(sqDistTo2(v)); }
+   constexpr double sqDistTo2(const Vec2& v) const // Square of distance
+                   { return (v.x-x)*(v.x-x) + (v.y-y)*(v.y-y); }
    double angleTo2(const Vec2& v) const;
 
-   double operator * (const Vec2& v) const { return x*v.x + y*v.y; }
+   constexpr double operator * (const Vec2& v) const
+                                          { return x*v.x + y*v.y; }
+   constexpr double cross2(const Vec2& v) const  // z of (*this x v)
+                                          { return x*v.y - y*v.x; }
+
+   double sqDistToSeg2(const Vec2& s, const Vec2& e) const;
 
-   Vec2 operator * (double fact) const;
-   Vec2 operator / (double fact) const;
+   constexpr Vec2 operator * (double fact) const
+                                      { return Vec2(x*fact, y*fact); }
+   constexpr Vec2 operator / (double fact) const
+                                      { return Vec2(x/fact, y/fact); }
 
-   Vec2 operator + (const Vec2& v) const;
-   Vec2 operator - (const Vec2& v) const;
+   constexpr Vec2 operator + (const Vec2& v) const
+                                      { return Vec2(x+v.x, y+v.y); }
+   constexpr Vec2 operator - (const Vec2& v) const
+                                      { return Vec2(x-v.x, y-v.y); }
 
    void operator *= (double fact)   { x *= fact; y *= fact; }
    void operator /= (double fact)   { x /= fact; y /= fact; }
@@ -61,18 +111,18 @@ class Vec2
    void operator -= (const Vec2& v) { x -= v.x; y -= v.y; }
 
    bool operator == (const Vec2& v) const
-                          { return distTo2(v) <= IdentDist; }
+                          { return distTo2(v) <= identDist(); }
    bool operator != (const Vec2& v) const
-                          { return distTo2(v) > IdentDist; }
+                          { return distTo2(v) > identDist(); }
 
-   void rot90();                  // Rotate 90 degrees anti clkwise
-   void rot180();                 // Reverse vector
-   void rot270();                 // Rotate 270 degrees anti clkwise
+   void rot90()  { double h = x; x = -y; y = h; } // 90 degrees anti clkwise
+   void rot180() { x = -x; y = -y; }              // Reverse vector
+   void rot270() { double h = x; x = y; y = -h; } // 270 degrees anti clkwise
 
    Vec2 bisect(const Vec2& v, bool acw) const;
 
-   bool parallelTo2(const Vec2& v, double tol = Vec2::IdentDir) const;
-   bool oppositeTo2(const Vec2& v, double tol = Vec2::IdentDir) const;
+   bool parallelTo2(const Vec2& v, double tol = Vec2::identDir()) const;
+   bool oppositeTo2(const Vec2& v, double tol = Vec2::identDir()) const;
 
    void transform2(const Trf2& trf);
 };
@@ -88,33 +138,40 @@ class Vec3 : public Vec2
   public:
    double z;
 
-   Vec3(double cx=0.0, double cy=0.0, double cz=0.0)
+   constexpr Vec3(double cx=0.0, double cy=0.0, double cz=0.0)
                                     : Vec2(cx,cy), z(cz) {}
 
-   Vec3(const Vec2& v) : Vec2(v), z(0) {} // Up conversion (!!!!!)
-   Vec3(const Vec2& v, double cz) : Vec2(v), z(cz) {}
-   Vec3(const Vec3& v) : Vec2(v),z(v.z) {}
+   constexpr Vec3(const Vec2& v) : Vec2(v), z(0) {} // Up conversion (!!!!!)
+   constexpr Vec3(const Vec2& v, double cz) : Vec2(v), z(cz) {}
+   constexpr Vec3(const Vec3& v) : Vec2(v),z(v.z) {}
 
    double unitLen3();             // Make unitlength, return old length
 
-   double len3() const;           // Return length of vector
-   double lenSq3() const  { return x*x + y*y + z*z; }
+   double len3() const { return sqrt(x*x + y*y + z*z); }
+   constexpr double lenSq3() const { return x*x + y*y + z*z; }
 
    double len3(double newLen);    // Set new length return old length;
 
-   double distTo3(const Vec3& v) const;
-   double sqDistTo3(const Vec3& v) const; // Square of distance
+   double distTo3(const Vec3& v) const { return sqrt(sqDistTo3(v)); }
+   constexpr double sqDistTo3(const Vec3& v) const // Square of distance
+      { return (v.x-x)*(v.x-x) + (v.y-y)*(v.y-y) + (v.z-z)*(v.z-z); }
 
    double angleTo3(const Vec3& v) const;
 
-   double operator * (const Vec3& v) const;  // Inner product
-   Vec3 outer(const Vec3& b) const; // Outer product (*this x b)
+   constexpr double operator * (const Vec3& v) const  // Inner product
+                                  { return x*v.x + y*v.y + z*v.z; }
+   constexpr Vec3 outer(const Vec3& b) const  // Outer product (*this x b)
+       { return Vec3(y*b.z-z*b.y, z*b.x-x*b.z, x*b.y-y*b.x); }
 
-   Vec3 operator * (double fact) const;
-   Vec3 operator / (double fact) const;
+   constexpr Vec3 operator * (double fact) const
+                               { return Vec3(x*fact, y*fact, z*fact); }
+   constexpr Vec3 operator / (double fact) const
+                               { return Vec3(x/fact, y/fact, z/fact); }
 
-   Vec3 operator + (const Vec3& v) const;
-   Vec3 operator - (const Vec3& v) const;
+   constexpr Vec3 operator + (const Vec3& v) const
+                               { return Vec3(x+v.x, y+v.y, z+v.z); }
+   constexpr Vec3 operator - (const Vec3& v) const
+                               { return Vec3(x-v.x, y-v.y, z-v.z); }
 
    void operator *= (double fact) { x *= fact; y *= fact; z *= fact;}
    void operator /= (double fact) { x /= fact; y /= fact; z /= fact;}
@@ -123,13 +180,33 @@ class Vec3 : public Vec2
    void operator -= (const Vec3& v) { x -= v.x; y -= v.y; z -= v.z;  }
 
    bool operator == (const Vec3& v) const
-                          { return distTo3(v) <= IdentDist; }
+                          { return distTo3(v) <= identDist(); }
    bool operator != (const Vec3& v) const
-                          { return distTo3(v) > IdentDist; }
+                          { return distTo3(v) > identDist(); }
 
    void transform3(const Trf3& trf);
 };
 
+// --------------------------------------------------------------------------
+// ------- Inline implementations -------------------------------------------
+// --------------------------------------------------------------------------
+
+inline double Vec2::sqDistToSeg2(const Vec2& s, const Vec2& e) const
+{
+  double dx = e.x - s.x, dy = e.y - s.y;
+  double px = x - s.x,   py = y - s.y;
+
+  double lsq = dx*dx + dy*dy;
+  double t   = dx*px + dy*py;
+
+  if (t <= 0.0 || lsq <= 0.0) return px*px + py*py;
+  if (t >= lsq) return sqDistTo2(e);
+
+  double c = dx*py - dy*px;   // Cross product
+
+  return c*c/lsq;
+}
+
 } // namespace Ino
 
 // --------------------------------------------------------------------------
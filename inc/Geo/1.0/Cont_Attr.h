@@ -0,0 +1,116 @@
+/* ---------------------------------------------------------------------- */
+/* ---------------- Contour Element Attribute Table --------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ------------- Copyright Inofor Hoek Aut BV 2026, C. Wolters ---------- */
+/* ---------------------------------------------------------------------- */
+
+#ifndef CONT_ATTR_INC
+#define CONT_ATTR_INC
+
+#include "Elem.h"
+
+namespace Ino
+{
+
+/* ---------------------------------------------------------------------- */
+/* ------- Per element attributes of a contour, keyed by element index -- */
+/* ---------------------------------------------------------------------- */
+/* ------- Each attribute is a contiguous array that is only allocated -- */
+/* ------- once an element gets a value other than the default. --------- */
+/* ------- Filling an attribute just sets the default and drops the ----- */
+/* ------- array. ------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ------- A snapshot, not attached to a contour: ----------------------- */
+/* ------- Contour::Get_Attrs() copies the attributes of the elements --- */
+/* ------- into it, Contour::Set_Attrs() copies them back. The ---------- */
+/* ------- contour kernels and the bulk setters (Set_Elem_Ids(), -------- */
+/* ------- setColor() etc) only use the elements, so in between --------- */
+/* ------- changes on one side are not seen by the other. --------------- */
+/* ---------------------------------------------------------------------- */
+
+class Cont_Attr_Table
+{
+   int sz, cap;
+
+   int  *el_ids;
+   int  *cnt_ids;
+   int  *p_cnt_ids;
+   int  *cam_infs;
+   long *colors;
+   bool *ins_arcs;
+
+   Elem_Attr dflt;
+
+   void free_columns();
+   void copy_from(const Cont_Attr_Table& src);
+
+   template <class T> T *column(T*& col, T dfltVal);
+   template <class T> void grow(T*& col, int newCap, T dfltVal);
+
+  public:
+   Cont_Attr_Table();
+   Cont_Attr_Table(int elems, const Elem_Attr& defAttr = Elem_Attr());
+   Cont_Attr_Table(const Cont_Attr_Table& cp);
+   ~Cont_Attr_Table();
+
+   Cont_Attr_Table& operator=(const Cont_Attr_Table& src);
+
+   int  Size() const { return sz; }
+   void Resize(int elems);   // New elements get the default attributes
+   void Clear();             // Size zero, all defaults
+
+   const Elem_Attr& Default() const { return dflt; }
+   void Default(const Elem_Attr& defAttr); // Resets all attributes
+
+   bool Has_Ids() const       { return el_ids != NULL; }
+   bool Has_Cnt_Ids() const   { return cnt_ids != NULL; }
+   bool Has_P_Cnt_Ids() const { return p_cnt_ids != NULL; }
+   bool Has_Cam_Infs() const  { return cam_infs != NULL; }
+   bool Has_Colors() const    { return colors != NULL; }
+   bool Has_Ins_Arcs() const  { return ins_arcs != NULL; }
+
+   int  Id(int idx) const { return el_ids ? el_ids[idx] : dflt.el_id; }
+   int  Cnt_Id(int idx) const
+                     { return cnt_ids ? cnt_ids[idx] : dflt.cnt_id; }
+   int  P_Cnt_Id(int idx) const
+                     { return p_cnt_ids ? p_cnt_ids[idx] : dflt.p_cnt_id; }
+   int  Cam_Inf(int idx) const
+                     { return cam_infs ? cam_infs[idx] : dflt.cam_inf; }
+   long Color(int idx) const
+                     { return colors ? colors[idx] : dflt.color; }
+   bool Ins_Arc(int idx) const
+                     { return ins_arcs ? ins_arcs[idx] : dflt.insArc; }
+
+   void Id(int idx, int id);
+   void Cnt_Id(int idx, int id);
+   void P_Cnt_Id(int idx, int id);
+   void Cam_Inf(int idx, int camInf);
+   void Color(int idx, long color);
+   void Ins_Arc(int idx, bool insArc);
+
+   void Get(int idx, Elem_Attr& attr) const;
+   void Set(int idx, const Elem_Attr& attr);
+
+   // Bulk updates
+
+   void Fill_Ids(int id);
+   void Fill_Cnt_Ids(int id);
+   void Fill_P_Cnt_Ids(int id);
+   void Fill_Cam_Infs(int camInf);
+   void Fill_Colors(long color);
+   void Fill_Ins_Arcs(bool insArc);
+
+   void Sequence_Ids(int start_id = 0);
+   void Increment_Cnt_Ids(int diffid);
+   void Increment_P_Cnt_Ids(int diffid);
+
+   long Mem_Size() const;    // Bytes occupied by the arrays
+};
+
+} // namespace Ino
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+#endif
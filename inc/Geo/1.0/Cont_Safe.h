@@ -0,0 +1,117 @@
+/* ---------------------------------------------------------------------- */
+/* ---------------- Recoverable Contour Operations ---------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ------------- Copyright Inofor Hoek Aut BV 2026, C. Wolters ---------- */
+/* ---------------------------------------------------------------------- */
+
+#ifndef CONT_SAFE_INC
+#define CONT_SAFE_INC
+
+#include "Contour.h"
+
+namespace Ino
+{
+
+/* ---------------------------------------------------------------------- */
+/* ------- Outcome of a recoverable operation --------------------------- */
+/* ---------------------------------------------------------------------- */
+
+enum Cont_Status
+{
+   Cont_Ok,          // Done, the output is replaced
+   Cont_No_Result,   // The operation returned false, output is cleared
+   Cont_Failed       // Every attempt threw, the output is untouched
+};
+
+/* ---------------------------------------------------------------------- */
+/* ------- Details of the last attempt, per call ------------------------ */
+/* ---------------------------------------------------------------------- */
+
+struct Cont_Error
+{
+   Cont_Status status;
+   const char *op;       // Name of the operation
+   int panic_no;         // Cont_Panic error_no (cntpanic.hi), 0: other
+   char what[96];        // what() of the exception, truncated
+   int attempts;         // Attempts made, 1 if the first one did
+   double ident_dist;    // Vec2::identDist() of the last attempt
+   double nudge;         // Perturbation of the last attempt
+
+   Cont_Error() : status(Cont_Ok), op(""), panic_no(0), attempts(0),
+                  ident_dist(0.0), nudge(0.0) { what[0] = '\0'; }
+};
+
+/* ---------------------------------------------------------------------- */
+/* ------- Retry policy. Retry k (1..retries) runs under identDist ------ */
+/* ------- and identDir times tol_factor^k and moves the input by ------- */
+/* ------- k * nudge * identDist where the operation allows it: the ----- */
+/* ------- offset distance, the second area of a combine, the probe ----- */
+/* ------- points of Extract_Via. Out of memory is never retried. ------- */
+/* ---------------------------------------------------------------------- */
+
+struct Cont_Retry
+{
+   int retries;
+   double tol_factor;
+   double nudge;
+
+   Cont_Retry() : retries(2), tol_factor(2.0), nudge(4.0) {}
+   Cont_Retry(int n, double fact, double ndg)
+                          : retries(n), tol_factor(fact), nudge(ndg) {}
+};
+
+/* ---------------------------------------------------------------------- */
+/* ------- Status returning forms of the operations. They give the ------ */
+/* ------- strong guarantee: the result is built aside and moved into --- */
+/* ------- the outputs only on success, so a failure leaves them (and --- */
+/* ------- the rests of a combine) as they were. A panic does not call -- */
+/* ------- the Cont_On_Error handler, err (may be NULL) tells instead. -- */
+/* ------- Not thread safe: the operations allocate elements and list --- */
+/* ------- items from the shared, unlocked stores. Call them from one --- */
+/* ------- thread at a time. -------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+Cont_Status Cont_Try_Offset(const Contour& cnt, double offdist,
+                            Cont_List& into, Cont_Error *err = NULL,
+                            const Cont_Retry& retry = Cont_Retry());
+
+Cont_Status Cont_Try_Offset(const Cont_Area& ar, double offdist,
+                            Cont_Area& into, Cont_Error *err = NULL,
+                            const Cont_Retry& retry = Cont_Retry());
+
+Cont_Status Cont_Try_Combine(const Cont_Area& ar1, bool rev1,
+                             const Cont_Area& ar2, bool rev2,
+                             bool to_left, Cont_Area& into,
+                             Cont_List *rest1 = NULL,
+                             Cont_List *rest2 = NULL,
+                             Cont_Error *err = NULL,
+                             const Cont_Retry& retry = Cont_Retry());
+
+Cont_Status Cont_Try_Extract_Via(const Cont_Area& ar,
+                                 const Vec2& p1, const Vec2& probedir1,
+                                 const Vec2& p2, const Vec2& probedir2,
+                                 Contour& path, double& pathlen,
+                                 Cont_Error *err = NULL,
+                                 const Cont_Retry& retry = Cont_Retry());
+
+// The pairs point into cnt1 and cnt2, so these are never moved
+
+Cont_Status Cont_Try_Intersect_XY(const Contour& cnt1, const Contour& cnt2,
+                                  Cont_PPair_List& isct_lst,
+                                  bool cleanup = true,
+                                  Cont_Error *err = NULL,
+                                  const Cont_Retry& retry = Cont_Retry());
+
+// Works on a copy of cnt, which is replaced on success only
+
+Cont_Status Cont_Try_Make_Non_Intersecting(Contour& cnt, bool left,
+                                  Cont_Error *err = NULL,
+                                  const Cont_Retry& retry = Cont_Retry());
+
+} // namespace Ino
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+#endif
@@ -0,0 +1,90 @@
+/* ---------------------------------------------------------------------- */
+/* ---------------- Toolpath Sequencing of Contours --------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ------------- Copyright Inofor Hoek Aut BV 2026, C. Wolters ---------- */
+/* ---------------------------------------------------------------------- */
+
+#ifndef CONT_SEQ_INC
+#define CONT_SEQ_INC
+
+#include "Contour.h"
+
+namespace Ino
+{
+
+/* ---------------------------------------------------------------------- */
+/* ------- Options of a sequencing run ---------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+struct Cont_Seq_Opts
+{
+   Vec2 home;           // Tool position before the first contour
+   bool back_home;      // Count the travel from the last contour to home
+   bool pick_starts;    // Closed contours may start at any element
+   bool reverse_open;   // Open contours may be cut in either direction
+   bool inner_first;    // What lies inside a closed contour comes first
+   double budget_ms;    // Time for improving the nearest neighbour tour
+
+   Cont_Seq_Opts() : home(), back_home(false), pick_starts(true),
+                     reverse_open(true), inner_first(true),
+                     budget_ms(50.0) {}
+};
+
+/* ---------------------------------------------------------------------- */
+/* ------- Travel of the given and of the found sequence ---------------- */
+/* ---------------------------------------------------------------------- */
+
+struct Cont_Seq_Stats
+{
+   double travel_before;
+   double travel_after;
+   int moves;           // Improving 2-opt, Or-opt and start point moves
+   bool budget_used;    // The improvement was stopped by the budget
+
+   Cont_Seq_Stats() : travel_before(0.0), travel_after(0.0),
+                      moves(0), budget_used(false) {}
+};
+
+/* ---------------------------------------------------------------------- */
+/* ------- Orders contours so the rapid travel between them is short. --- */
+/* ------- A nearest neighbour tour is built over a grid of the entry --- */
+/* ------- points and improved by 2-opt and Or-opt moves until no move -- */
+/* ------- helps or the time budget is spent. With inner_first a -------- */
+/* ------- contour lying inside a closed contour (an island in a hole, -- */
+/* ------- a hole in its outer contour) is never moved after it. -------- */
+/* ------- Closed contours are restarted at the element begin chosen, --- */
+/* ------- open contours may be reversed. Travel is the XY distance ----- */
+/* ------- from the end of a contour to the start of the next. ---------- */
+/* ---------------------------------------------------------------------- */
+
+class Cont_Sequencer
+{
+   class Tour;
+
+   Cont_Seq_Opts opts;
+
+  public:
+   Cont_Sequencer() : opts() {}
+   Cont_Sequencer(const Cont_Seq_Opts& options) : opts(options) {}
+
+   const Cont_Seq_Opts& Options() const { return opts; }
+
+   // Reorders lst, restarts its closed and reverses its open contours.
+   // Returns the travel after, stats may be NULL.
+
+   double Sequence(Cont_List& lst, Cont_Seq_Stats *stats = NULL) const;
+
+   // The contours of an area in cutting order, every hole before the
+   // outer contour of its nest and every nest inside a hole before it.
+
+   double Sequence(const Cont_Area& ar, Cont_List& into,
+                                      Cont_Seq_Stats *stats = NULL) const;
+};
+
+} // namespace Ino
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+#endif
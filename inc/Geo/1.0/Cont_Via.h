@@ -0,0 +1,89 @@
+/* ---------------------------------------------------------------------- */
+/* ---------------- Batched Path Queries on an Area --------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ------------- Copyright Inofor Hoek Aut BV 2026, C. Wolters ---------- */
+/* ---------------------------------------------------------------------- */
+
+#ifndef CONT_VIA_INC
+#define CONT_VIA_INC
+
+#include "Contour.h"
+
+namespace Ino
+{
+
+struct Via_Path;
+
+/* ---------------------------------------------------------------------- */
+/* ------- One Extract_Via request -------------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+struct Cont_Via_Req
+{
+   Vec2 p1, probedir1;
+   Vec2 p2, probedir2;
+
+   Cont_Via_Req() : p1(), probedir1(), p2(), probedir2() {}
+   Cont_Via_Req(const Vec2& sp, const Vec2& sdir,
+                const Vec2& ep, const Vec2& edir)
+    : p1(sp), probedir1(sdir), p2(ep), probedir2(edir) {}
+};
+
+/* ---------------------------------------------------------------------- */
+/* ------- Answers Cont_Area::Extract_Via requests without building ----- */
+/* ------- the paths. The projections are those of the area itself, ---- */
+/* ------- so the contour and direction chosen are the same. ------------ */
+/* ------- The sub rectangles of all contours and a cumulative length --- */
+/* ------- table per contour are built once, after that Path_Len and ---- */
+/* ------- Path_Lens may be called from any number of threads. ---------- */
+/* ------- The area must not change while the query is in use. ---------- */
+/* ---------------------------------------------------------------------- */
+
+class Cont_Via_Query
+{
+   struct Cont_Tbl;
+
+   const Cont_Area& area;
+
+   Cont_Tbl *tbls;     // Sorted on contour address
+   int tbl_cnt;
+
+   const Cont_Tbl *find_tbl(const Contour *cnt) const;
+
+   static void add_upto(const Cont_Tbl& tbl, const Cont_Pnt& pnt1,
+                        const Cont_Pnt& pnt2, Via_Path& pth);
+
+   Cont_Via_Query(const Cont_Via_Query& cp);            // No copying
+   Cont_Via_Query& operator=(const Cont_Via_Query& src); // No assignment
+
+  public:
+   Cont_Via_Query(const Cont_Area& ar);
+   ~Cont_Via_Query();
+
+   const Cont_Area& Area() const { return area; }
+
+   // Same result as Extract_Via, false if p1 and p2 project on different
+   // contours. The length agrees up to rounding.
+
+   bool Path_Len(const Cont_Via_Req& req, double& pathlen) const;
+
+   // Answers cnt requests on thread_cnt threads of the task pool (< 1:
+   // all of them), found may be NULL. Returns the number found.
+
+   int Path_Lens(const Cont_Via_Req *reqs, int cnt, double *pathlens,
+                                 bool *found = NULL, int thread_cnt = 0) const;
+
+   // The path itself, as Extract_Via. Not for concurrent use.
+
+   bool Path(const Cont_Via_Req& req, Contour& path, double& pathlen) const;
+
+   size_t Mem_Size() const;
+};
+
+} // namespace Ino
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+#endif
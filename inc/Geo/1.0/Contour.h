@@ -33,6 +33,7 @@ extern const int Cont_Sub_Rect_Max_Elems;
 extern const double Cont_Sub_Rect_Max_Area_Rel;
 
 class Elem_Rect_List;
+class Cont_Attr_Table;
 
 class Contour;
 class Cont_Clsd;
@@ -43,7 +44,86 @@ class Cont_Area;
 /* ---------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------- */
 
-extern void Cont_On_Error(void (*Error_Handler)(int error_no));
+typedef void (*Cont_Error_Handler)(int error_no);
+
+extern void Cont_On_Error(Cont_Error_Handler Error_Handler);
+
+// A handler set per thread replaces the one above on that thread only,
+// NULL falls back to it. Returns the previous thread handler.
+
+extern Cont_Error_Handler Cont_On_Thread_Error(
+                                         Cont_Error_Handler Error_Handler);
+
+// error_no of the last panic on the calling thread, 0 if none since reset
+
+extern int  Cont_Last_Panic();
+extern void Cont_Reset_Panic();
+
+/* ---------------------------------------------------------------------- */
+/* -------- Sharp transition (corner) between two elements -------------- */
+/* ---------------------------------------------------------------------- */
+
+struct Cont_Corner
+{
+   const Contour *cont;
+   double par;    // Contour parameter of the joint
+   double angle;  // Change of direction, positive turning left
+};
+
+/* ---------------------------------------------------------------------- */
+/* -------- Curvature Summary, kept with the Inert Properties ----------- */
+/* -------- Joints turning less than Vec2::identDir() are not corners ----- */
+/* -------- A nest/area summary combines those of its contours ---------- */
+/* ---------------------------------------------------------------------- */
+
+class Cont_Geom
+{
+   bool valid;
+   bool lrad_found, rrad_found;
+   double min_lrad, min_rrad;
+   double min_len;
+   double turning;
+
+   int elem_cnt;
+   int corner_cnt;
+   Cont_Corner *corners; // Sorted on decreasing fabs(angle)
+
+   Cont_Geom();
+   Cont_Geom(const Cont_Geom& cp);  // Copies are recalculated
+   ~Cont_Geom();
+
+   Cont_Geom& operator=(const Cont_Geom& src);
+
+   void invalidate();
+   void add(const Cont_Geom& src);
+   void sort_corners();
+
+   void calc(const Contour&   cont);
+   void calc(const Cont_Nest& nest);
+   void calc(const Cont_Area& ar);
+  public:
+
+   bool Min_Left_Rad(double& min_rad) const
+                               { min_rad = min_lrad; return lrad_found; }
+   bool Min_Right_Rad(double& min_rad) const
+                               { min_rad = min_rrad; return rrad_found; }
+
+   double Min_Elem_Len() const { return min_len; }
+   double Turning()      const { return turning; }  // Arcs and corners
+
+   int Corner_Cnt() const { return corner_cnt; }
+   int Corner_Cnt(double min_ang) const;  // Corners turning more
+
+   double Max_Corner() const
+                 { return corner_cnt > 0 ? fabs(corners[0].angle) : 0.0; }
+
+   const Cont_Corner& Corner(int idx) const { return corners[idx]; }
+
+   friend class Cont_Inert;
+   friend class Contour;
+   friend class Cont_Nest;
+   friend class Cont_Area;
+};
 
 /* ---------------------------------------------------------------------- */
 /* -------- Private Class for Inert Properties -------------------------- */
@@ -54,6 +134,8 @@ class Cont_Inert
    bool area_valid, inert_valid;
    double area,cogx,cogy,ix,iy,ixy;
 
+   Cont_Geom geom;
+
    Cont_Inert();
    Cont_Inert(const Cont_Inert& cp);
    
@@ -157,7 +239,7 @@ class Cont_Pnt
     bool Update();
 
     bool Contiguous_Upto(const Cont_Pnt& upto,
-                        double tol = 2.0*Vec2::IdentDist) const;
+                        double tol = 2.0*Vec2::identDist()) const;
     bool Contiguous_Upto(const Cont_Pnt& upto, double tol,
                                        Elem_C_Cursor& elc) const;
 
@@ -234,6 +316,28 @@ typedef IT_D_List<Cont_PPair, Cont_PPair_Alloc> Cont_PPair_List;
 typedef Cont_PPair_List::C_Cursor Cont_PPair_C_Cursor;
 typedef Cont_PPair_List::Cursor   Cont_PPair_Cursor;
 
+/* ---------------------------------------------------------------------- */
+/* ------- Memory usage of contours by component (bytes) ---------------- */
+/* ---------------------------------------------------------------------- */
+
+struct Cont_Mem_Usage
+{
+  size_t elems;      // Line, arc and circle objects
+  size_t nodes;      // Element and contour list items
+  size_t rect_lists; // Sub rectangle lists
+  size_t attrs;      // Element attribute blocks
+  size_t infos;      // Element info (shares divided over the users)
+  size_t caches;     // Persistence element arrays
+
+  Cont_Mem_Usage() : elems(0), nodes(0), rect_lists(0), attrs(0),
+                                             infos(0), caches(0) {}
+
+  void Clear() { *this = Cont_Mem_Usage(); }
+
+  size_t Total() const
+        { return elems + nodes + rect_lists + attrs + infos + caches; }
+};
+
 /* ---------------------------------------------------------------------- */
 /* ------- General Open or Closed Contour ------------------------------- */
 /* ---------------------------------------------------------------------- */
@@ -261,7 +365,7 @@ class Contour: public Persistable, protected Rect_Ax
   mutable int persistLstLen;
   mutable Elem **persistLst;
 
-  void calc_invar(double tol = Vec2::IdentDist);
+  void calc_invar(double tol = Vec2::identDist());
 
   void inval_rects() const;
   void copy_invar_to(Contour& dst) const;
@@ -270,6 +374,11 @@ class Contour: public Persistable, protected Rect_Ax
 
   void cleanSingle(bool closed, double offset);
 
+  int  merge_pass(Elem_List *dead);
+  void merge_finish(int state, bool limit_arcs, double bpar);
+
+  static void merge_all(Contour **conts, int cnt, bool limit_arcs);
+
  public:
  
   Contour();
@@ -326,6 +435,7 @@ class Contour: public Persistable, protected Rect_Ax
                                                        double& area) const;
 
   const Cont_Inert& Inert() const;
+  const Cont_Geom&  Geom() const;
 
   void  Parent(void *newparent) { parent = newparent; }
   void *Parent() const { return parent; }
@@ -345,6 +455,12 @@ class Contour: public Persistable, protected Rect_Ax
 
   void Find_First_Cnt_Id_With(int id, Elem_Cursor& elc) const;
 
+  // Element attributes (ids, colors etc) by element index. The table is a
+  // copy, the elements keep their own attributes (see Cont_Attr.h)
+  void Get_Attrs(Cont_Attr_Table& tbl) const;
+  void Set_Attrs(const Cont_Attr_Table& tbl);
+  void Strip_Attrs(Cont_Attr_Table& tbl); // Elements keep geometry only
+
   void Intersect_With_XY(const Contour& cnt, 
                          Cont_PPair_List& isct_lst,
                          bool cleanup = true) const;
@@ -354,11 +470,37 @@ class Contour: public Persistable, protected Rect_Ax
   bool Offset_Into(double offdist, Cont_List& cnt_list) const;
   bool Offset_Into(double offdist, Cont_List& cnt_list,
                                        double limAng,bool noArcs) const;
+
+  // One sided offset of an open contour, offdist > 0 is left. The ends
+  // are trimmed back to where the offset is offdist away from the whole
+  // contour, then capped. Self intersections are removed, so the result
+  // may be several open contours. Offset_Into keeps its two sided result
+  // for open contours.
+
+  enum Cap_Type { Cap_Butt, Cap_Round, Cap_Extended };
+
+  bool Offset_Open_Into(double offdist, Cont_List& cnt_list,
+                                       Cap_Type cap = Cap_Butt) const;
+
   bool Offset_Back(double offdist, Contour& bcnt) const;
 
   bool OffsetSingle_Into(double offdist, Contour& cnt,
                                        double limAng, bool noArcs) const;
 
+  // Rounds the corners turning between min_ang and max_ang (radians,
+  // either way), only those turning left for sides > 0, right for < 0.
+  // A corner gets radius rad, less where its elements are too short (an
+  // element between two such corners gives each half its length), but
+  // not below min_rad. Corners where the fillet does not fit or would
+  // cross other elements are kept. A chamfer is the chord of the fillet.
+  // Returns the number of corners changed.
+
+  enum Corner_Type { Corner_Round, Corner_Chamfer };
+
+  int Round_Corners(double rad, double min_rad, double min_ang,
+                    double max_ang = Vec2::Pi, int sides = 0,
+                    Corner_Type tp = Corner_Round);
+
   bool Split_At(Cont_Pnt& p);
   bool Split_At(Cont_Pnt& p, Contour& succ_cont);
   bool Start_At(Cont_Pnt& p);
@@ -388,7 +530,7 @@ class Contour: public Persistable, protected Rect_Ax
   bool TakeElems(Elem_C_Cursor& from, Elem_C_Cursor& upto,
                                          Contour& dst, bool prepend=false);
 
-  bool IsContiguous(double tol=2.0*Vec2::IdentDist) const;
+  bool IsContiguous(double tol=2.0*Vec2::identDist()) const;
   bool IsContiguous(const Elem_C_Cursor& elc) const;
 
   bool ConnectTo(Contour& cnt2, double tol);
@@ -409,6 +551,13 @@ class Contour: public Persistable, protected Rect_Ax
 
   static void CleanupMem();
 
+  // Memory accounting, Mem_Usage adds the heap usage to usage
+
+  void Mem_Usage(Cont_Mem_Usage& usage) const;
+
+  static void   Alloc_Stats(IT_Alloc_Stats& st); // All allocators, bytes
+  static size_t TrimMem(size_t keep_bytes); // Returns bytes released
+
   // Persistent Section
 
   Contour(PersistentReader& pi);
@@ -423,10 +572,14 @@ class Contour: public Persistable, protected Rect_Ax
   friend class Cont1_Isect_List;
   friend class Cont2_Isect_List;
   friend class Cont_List;
+  friend class Cont_Nest;
   friend class Cont_Area;
   friend class Cont_Pocket;
   friend class Cont_Final;
   friend class Cont_Mill_Old;
+  friend class Cont_Via_Query;
+  friend class Cont_Round;
+  friend class Cont_Sequencer;
 };
 
 /* ---------------------------------------------------------------------- */
@@ -494,6 +647,7 @@ class Cont_Clsd
    double Area_XY() const { return cont.Area_XY(); }
 
    const Cont_Inert& Inert() const { return cont.Inert(); }
+   const Cont_Geom&  Geom()  const { return cont.Geom(); }
 
    void  Parent(void *newparent) { cont.parent = newparent; }
    void *Parent() const { return cont.parent; }
@@ -528,6 +682,8 @@ class Cont_Clsd
 
    void Merge_Elems(bool limit_arcs = false);
 
+   void Mem_Usage(Cont_Mem_Usage& usage) const { cont.Mem_Usage(usage); }
+
    bool Min_Left_Rad(double& min_rad) const
                                     { return cont.Min_Left_Rad(min_rad);  }
    bool Min_Right_Rad(double& min_rad) const
@@ -604,6 +760,8 @@ class Cont_List : protected Rect_Ax
 
    void Merge_Elems(bool limit_arcs = false);
 
+   void Mem_Usage(Cont_Mem_Usage& usage) const;
+
    friend class Contour;
    friend class Cont_Nest;
    friend class Cont_Area;
@@ -612,6 +770,7 @@ class Cont_List : protected Rect_Ax
    friend class Cont_Pocket;
    friend class Cont_Final;
    friend class Cont_Mill_Old;
+   friend class Cont_Sequencer;
 };
 
 /* ---------------------------------------------------------------------- */
@@ -670,6 +829,7 @@ class Cont_Nest : protected Rect_Ax
 
   double Area_XY() const;
   const Cont_Inert& Inert() const;
+  const Cont_Geom&  Geom() const;
 
   void Set_Elem_Ids(int newid);
   void Sequence_Elem_Ids(int start_id = 0);
@@ -688,8 +848,12 @@ class Cont_Nest : protected Rect_Ax
 
   void Set_Elem_Z(double new_z);
 
+  void Transform(const Trf2& trf);
+
   void Merge_Elems(bool limit_arcs = false);
 
+  void Mem_Usage(Cont_Mem_Usage& usage) const;
+
   bool Min_Left_Rad(double& min_rad) const;
   bool Min_Right_Rad(double& min_rad) const;
 
@@ -734,6 +898,18 @@ class Cont_Area : protected Rect_Ax
   bool compile_from_cont(Elem_List& el_lst, bool is_ccw,
                                             bool to_left, double tol);
 
+  // The decisions of Extract_Via, shared with Cont_Via_Query::Path_Len.
+  // The path runs along the contour between from and upto, then reversed
+  // if rev, unless that part is too short (along false). Returns false
+  // if p1 and p2 project on different contours.
+
+  bool via_ends(const Vec2& p1, const Vec2& probedir1,
+                const Vec2& p2, const Vec2& probedir2,
+                Cont_Pnt& from, Cont_Pnt& upto, bool& rev,
+                                                bool& along) const;
+
+  static bool via_drop(double ellen); // Short first or last element
+
  public:
   Cont_Area() : Rect_Ax(), nestlst(), lccw(false), z(0.0) {}
   Cont_Area(const Cont_Clsd& cl_cont);
@@ -789,9 +965,12 @@ class Cont_Area : protected Rect_Ax
 
   double Area_XY() const;
   const Cont_Inert& Inert() const;
+  const Cont_Geom&  Geom() const;
 
   void Set_Elem_Z(double new_z);
 
+  void Transform(const Trf2& trf);
+
   void Remove_Inners();
 
   bool Extract_Via(const Vec2& p1, const Vec2& probedir1,
@@ -811,6 +990,25 @@ class Cont_Area : protected Rect_Ax
                                 bool to_left, Cont_Area& into,
                                 Cont_List *rest1 = NULL,
                                 Cont_List *rest2 = NULL) const;
+
+  // Area of the closed contours in lst, which may overlap themselves and
+  // each other, under a fill rule on the winding number (ccw counts +1).
+  // false, with this area empty, if nothing is filled or a boundary could
+  // not be traced
+
+  enum Fill_Rule { Fill_Even_Odd, Fill_Non_Zero, Fill_Positive };
+
+  bool Fill_From(const Cont_List& lst, Fill_Rule rule = Fill_Non_Zero);
+
+  // Contour::Round_Corners on all contours, the fillets are also checked
+  // against the other contours and each other. The nests are done on
+  // thread_cnt threads of the task pool (< 1: all of them).
+
+  int Round_Corners(double rad, double min_rad, double min_ang,
+                    double max_ang = Vec2::Pi, int sides = 0,
+                    Contour::Corner_Type tp = Contour::Corner_Round,
+                    int thread_cnt = 0);
+
   void Reverse();
 
   void Del_Info();
@@ -820,6 +1018,8 @@ class Cont_Area : protected Rect_Ax
 
   void Merge_Elems(bool limit_arcs = false);
 
+  void Mem_Usage(Cont_Mem_Usage& usage) const;
+
   void Start_Outside();
 
   void Filter_Arcs(bool ccw, double tol);
@@ -837,6 +1037,7 @@ class Cont_Area : protected Rect_Ax
   friend class Cont_NcJob;
   friend class Cont_Pr_Lvl;
   friend class Cont_Slice;
+  friend class Cont_Via_Query;
 };
 
 /* ---------------------------------------------------------------------- */
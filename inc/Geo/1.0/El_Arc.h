@@ -40,6 +40,8 @@ class Elem_Arc : public Elem
    void operator delete(void *);
 
    static void CleanupStore();
+   static void StoreStats(IT_Alloc_Stats& st);
+   static size_t TrimStore(size_t keep_bytes); // Returns bytes released
 
    void *operator new(size_t, Persistable *p) { return p; }
 
@@ -127,6 +129,8 @@ class Elem_Arc : public Elem
    virtual void Stretch_Begin_XY(const Vec2& isp, bool check=true);
    virtual void Stretch_End_XY(const Vec2& isp, bool check=true);
 
+   bool  Can_Merge(const Elem_Arc& el, bool& to_circle) const;
+   void  Absorb(const Elem_Arc& el);    // In place Merge_With, no circle
    Elem *Merge_With(const Elem_Arc& el) const;
 
    bool Limit_Span_180(Elem_Cursor& newpair) const;
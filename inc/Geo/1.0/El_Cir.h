@@ -41,6 +41,8 @@ class Elem_Circle : public Elem
    void operator delete(void *);
 
    static void CleanupStore();
+   static void StoreStats(IT_Alloc_Stats& st);
+   static size_t TrimStore(size_t keep_bytes); // Returns bytes released
 
    void *operator new(size_t, Persistable *p) { return p; }
 
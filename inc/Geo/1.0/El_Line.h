@@ -40,6 +40,8 @@ class Elem_Line : public Elem
    void operator delete(void *);
 
    static void CleanupStore();
+   static void StoreStats(IT_Alloc_Stats& st);
+   static size_t TrimStore(size_t keep_bytes); // Returns bytes released
 
    void *operator new(size_t, Persistable *p) { return p; }
 
@@ -124,6 +126,8 @@ class Elem_Line : public Elem
    virtual void Stretch_Begin_XY(const Vec2& isp, bool check=true);
    virtual void Stretch_End_XY(const Vec2& isp, bool check=true);
 
+   bool  Can_Merge(const Elem_Line& el) const;
+   void  Absorb(const Elem_Line& el);   // In place Merge_With
    Elem *Merge_With(const Elem_Line& el) const;
 
    virtual void Transform(const Trf2& trf);
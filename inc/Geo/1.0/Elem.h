@@ -17,6 +17,8 @@
 
 #include "it_dlist.h"
 
+#include <stddef.h>
+
 #include "PersistentIO.h"
 
 namespace Ino
@@ -36,6 +38,59 @@ class Elem_Info;
 extern Elem_Info *Clone_Elem_Info (const Elem_Info *from);
 extern void       Delete_Elem_Info(Elem_Info *info);
 
+// Element copies share their Elem_Info (reference counted).
+// Next is called when a shared info is about to be modified through
+// Elem::Info() (copy on write), the default calls Clone_Elem_Info.
+
+extern Elem_Info *Unshare_Elem_Info(const Elem_Info *from);
+
+// Heap bytes owned by an info payload (memory accounting), default 0
+
+extern size_t Size_Elem_Info(const Elem_Info *info);
+
+/* ---------------------------------------------------------------------- */
+/* ------- Elem_Info sharing statistics --------------------------------- */
+/* ---------------------------------------------------------------------- */
+
+struct Elem_Info_Stats
+{
+  long clones;    // Calls to Clone_Elem_Info (Add_Info)
+  long shares;    // Copies that shared the info instead of cloning
+  long unshares;  // Copy on write clones through Unshare_Elem_Info
+  long deletes;   // Calls to Delete_Elem_Info
+
+  Elem_Info_Stats() : clones(0), shares(0), unshares(0), deletes(0) {}
+};
+
+struct Elem_Info_Share;
+
+/* ---------------------------------------------------------------------- */
+/* ------- Element attributes ------------------------------------------- */
+/* ---------------------------------------------------------------------- */
+/* ------- Only allocated for elements that have non default values, ---- */
+/* ------- attribute free geometry just carries a NULL pointer ---------- */
+/* ---------------------------------------------------------------------- */
+
+struct Elem_Attr
+{
+   int el_id;         // id number for use in milling
+   int cnt_id;        // id number for use in milling
+   int p_cnt_id;      // id number of parent contour
+   int cam_inf;       // extra info for cam use
+
+   long color;
+
+   bool insArc;
+
+   Elem_Attr() : el_id(0), cnt_id(0), p_cnt_id(0), cam_inf(0),
+                 color(0), insArc(false) {}
+
+   bool Is_Default() const;
+
+   void *operator new(size_t);
+   void operator delete(void *);
+};
+
 class Elem;
 class Elem_Arc;
 
@@ -89,7 +144,15 @@ double Elem_Calc_Par_Len(const Elem_List& ellst);
 class Elem : public Persistable, protected Rect_Ax
 {
   private:
-   Elem_Info *inf;    // Optional additional element info
+   Elem_Info_Share *inf; // Optional additional element info (shared)
+   Elem_Attr *attr;      // Ids, color etc, NULL if all default (color 0)
+
+   static const Elem_Attr defaultAttr;
+
+   Elem_Attr& mod_attr();
+   bool own_attr() const;  // Not shared with other elements
+   const Elem_Attr& get_attr() const
+                          { return attr ? *attr : defaultAttr; }
 
    Elem& operator=(const Elem& src); // No Assignment
 
@@ -101,26 +164,18 @@ class Elem : public Persistable, protected Rect_Ax
    double len_xy;     // 2D length of this element
    double bpar;       // Begin 3D parametric value
 
-   int el_id;         // id number for use in milling
-   int cnt_id;        // id number for use in milling
-   int p_cnt_id;      // id number of parent contour
-   int cam_inf;       // extra info for cam use
-
-   bool insArc;
-
-   long color;
-
    void clone_from(const Elem& from, bool keep_info = true);
    Elem(const Elem& cp) : Persistable(cp), Rect_Ax(cp), 
-                          inf(NULL) { clone_from(cp, true); }
+                          inf(NULL), attr(NULL) { clone_from(cp, true); }
    Elem(const Elem& cp, bool keep_info) : Persistable(cp), Rect_Ax(cp),
-                          inf(NULL)  { clone_from(cp, keep_info); }
+                          inf(NULL), attr(NULL) { clone_from(cp, keep_info); }
+
+   // Fillet from this element, a line (c NULL) or arc about c, to el2
+   bool fillet_to(const Vec2 *c, bool acw, const Elem& el2,
+                                 double filletRad, Elem_Arc& fillet) const;
 
   public:
-   Elem() : Persistable(), Rect_Ax(), inf(NULL), plen(0.0),
-            len(0.0), len_xy(0.0),
-            bpar(0.0), el_id(0), cnt_id(0), p_cnt_id(0),
-            cam_inf(0), insArc(false),color(defaultColor) {}
+   Elem();
    virtual ~Elem();
 
    virtual Elem *Clone(bool keep_info = true) const = 0;
@@ -134,7 +189,7 @@ class Elem : public Persistable, protected Rect_Ax
    static long getDefaultColor();
    static void setDefaultColor(long newColor);
 
-   long getColor() const { return color; }
+   long getColor() const { return get_attr().color; }
    bool setColor(long newColor);
 
    const Rect_Ax& Rect() const { return *this; }
@@ -142,23 +197,43 @@ class Elem : public Persistable, protected Rect_Ax
    void Add_Info(const Elem_Info& info);
    void Del_Info();
 
-   const Elem_Info *Info() const { return inf; }
-   Elem_Info *Info() { return inf; }
+   const Elem_Info *Info() const;
+   Elem_Info *Info();                  // Unshares the info first
 
-   void Id(int id) { el_id = id; }
-   int  Id() const { return el_id; }
+   bool Info_Shared() const;
 
-   void Cnt_Id(int id) { cnt_id = id; }
-   int  Cnt_Id() const { return cnt_id; }
+   static void Info_Stats(Elem_Info_Stats& stats);
+   static void Reset_Info_Stats();
 
-   void P_Cnt_Id(int id) { p_cnt_id = id; }
-   int  P_Cnt_Id() const { return p_cnt_id; }
+   size_t Info_Mem_Size() const; // Share of a (shared) info in bytes
 
-   void Cam_Inf(int new_inf) { cam_inf = new_inf; }
-   int  Cam_Inf() const      { return cam_inf; }
+   void Id(int id) { if (attr || id) mod_attr().el_id = id; }
+   int  Id() const { return get_attr().el_id; }
 
-   void setInsArc(bool newInsArc) { insArc = newInsArc; }
-   bool isInsArc() const { return insArc; }
+   void Cnt_Id(int id) { if (attr || id) mod_attr().cnt_id = id; }
+   int  Cnt_Id() const { return get_attr().cnt_id; }
+
+   void P_Cnt_Id(int id) { if (attr || id) mod_attr().p_cnt_id = id; }
+   int  P_Cnt_Id() const { return get_attr().p_cnt_id; }
+
+   void Cam_Inf(int new_inf)
+                      { if (attr || new_inf) mod_attr().cam_inf = new_inf; }
+   int  Cam_Inf() const { return get_attr().cam_inf; }
+
+   void setInsArc(bool newInsArc)
+                   { if (attr || newInsArc) mod_attr().insArc = newInsArc; }
+   bool isInsArc() const { return get_attr().insArc; }
+
+   const Elem_Attr& Attr() const { return get_attr(); }
+   void Attr(const Elem_Attr& newAttr);
+   bool Has_Attr() const { return attr != NULL; }
+   void Del_Attr();
+   size_t Attr_Mem_Size() const
+                            { return own_attr() ? sizeof(Elem_Attr) : 0; }
+
+   static void CleanupAttrStore();
+   static void AttrStoreStats(IT_Alloc_Stats& st);
+   static size_t TrimAttrStore(size_t keep_bytes);
 
    virtual const Vec3& P1() const = 0;
    virtual const Vec3& P2() const = 0;
@@ -245,13 +320,16 @@ class Elem : public Persistable, protected Rect_Ax
 
    virtual void Transform(const Trf2& trf) = 0;
 
+   // Fillet to el2, which begins where this element ends, on the inside
+   // of the turn. False if its tangent points are not on both elements.
+
    virtual bool Fillet(const Elem& el2, double filletRad,
                                              Elem_Arc& fillet) const = 0;
 
    static void Sort(Elem_List& elLst);
    static bool IsContiguous(const Elem_List& elLst,
                             bool mustBeClosed = false,
-                            double tol = Vec2::IdentDist);
+                            double tol = Vec2::identDist());
 
    // Persistable Section:
 
@@ -293,7 +371,8 @@ class Elem_Sort
 /* ---------------------------------------------------------------------- */
 
 extern bool Remove_Short_Elems(Elem_Cursor& elc,
-                                            double maxlen, double maxdist);
+                                            double maxlen, double maxdist,
+                                            Elem_List *dead = NULL);
 
 
 } // namespace Ino
@@ -56,6 +56,21 @@ extern Vec2 Geo_Arc_Mid(const Vec2& p1, const Vec2& p2,
 
 extern bool Geo_In_Between(const Vec2& a, const Vec2& b, const Vec2& c);
 
+/* --------------------------------------------------------------------- */
+/* ------------ Orientation of a, b, c (> 0 acw, < 0 cw, 0 on line) ---- */
+/* ------------ Sign is exact (adaptive precision) --------------------- */
+/* --------------------------------------------------------------------- */
+
+extern double Geo_Orient(const Vec2& a, const Vec2& b, const Vec2& c);
+
+/* --------------------------------------------------------------------- */
+/* ------------ Is p within the span of arc s-e around c? -------------- */
+/* ------------ (no trigonometry, endpoints within tol accepted) ------- */
+/* --------------------------------------------------------------------- */
+
+extern bool Geo_In_Arc_Span(const Vec2& p, const Vec2& s, const Vec2& e,
+                            const Vec2& c, bool acw, double tol);
+
 /* --------------------------------------------------------------------- */
 /* ------------ Project Point on a Line -------------------------------- */
 /* --------------------------------------------------------------------- */
@@ -144,6 +159,20 @@ extern int Geo_Isct_Circle_Circle(const Vec2& s1, const Vec2& c1, bool acw1,
                                   double& pr1a, double& pr1b,
                                   double& pr2a, double& pr2b);
 
+/* --------------------------------------------------------------------- */
+/* ---------- Fillet of radius rad between element 1, ending where ----- */
+/* ---------- element 2 begins, and element 2. c1/c2 NULL for a line. -- */
+/* ---------- The fillet runs from t1 to t2 about fc, inside the turn, - */
+/* ---------- false if the tangent points are not on the elements ------ */
+/* --------------------------------------------------------------------- */
+
+extern bool Geo_Fillet(const Vec2& s1, const Vec2& e1,
+                       const Vec2 *c1, bool acw1,
+                       const Vec2& s2, const Vec2& e2,
+                       const Vec2 *c2, bool acw2,
+                       double rad, double tol,
+                       Vec2& t1, Vec2& t2, Vec2& fc, bool& facw);
+
 } // namespace Ino
 
 /* --------------------------------------------------------------------- */
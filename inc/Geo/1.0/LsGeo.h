@@ -41,7 +41,8 @@ protected:
   Vec2 p1;          // Start Point
   Vec2 p2;          // End Point
 
-  double maxRes;
+  double maxRes;    // Of the points that are not outliers
+  int outliers;     // Points ignored by a robust fit
 
   bool tangent; // True if tangent (thru point or tangent to previous element)
 
@@ -68,6 +69,10 @@ protected:
   bool checkJoin(const LsAprxEl& prvEl);
 
   int insIdx(double par) const;
+
+  bool robustAvg(int fstIdx, int n, const Vec2& pol, const Vec2& nrm,
+                                                    Vec2& avgPt) const;
+  bool outliersOk(int n) const;
 public: 
   virtual Type getType() const = 0;
 
@@ -75,6 +80,7 @@ public:
   int upbIdx() const { return eIdx; }
 
   int rangeLen() const;
+  int outlierCount() const { return outliers; }
 
   const Vec2& getP1()  const { return p1; }
   const Vec2& getP2()  const { return p2; }
@@ -108,6 +114,9 @@ class LsAprxLine : public LsAprxEl
   int intersect(const LsAprxEl& el, Vec2& ipa, Vec2& ipb,
                         double& pr1a, double& pr1b,
                         double& pr2a, double& pr2b) const;
+  bool seedRobust(Vec2& pol, Vec2& nrm) const;
+  bool computeRobustLs();
+
   bool computeLs();
   bool computeBasic();
   bool computeLongestLs(int lwb, int uLim);
@@ -156,6 +165,8 @@ class LsAprxArc : public LsAprxEl
   int intersect(const LsAprxEl& el, Vec2& ipa, Vec2& ipb,
                         double& pr1a, double& pr1b,
                         double& pr2a, double& pr2b) const;
+  bool seedRobust(Vec2& c, double& r) const;
+
   bool computeLs();
   bool computeLongestLs(int lwb, int uLim);
 
@@ -187,20 +198,46 @@ public:
 
 class LsAprxCnt
 {
+public:
+  // FitLs: plain least squares. FitHuber and FitTukey: iteratively
+  // reweighted least squares from a sampled consensus seed. A few short
+  // runs of points off by more than the tolerance (tracer glitches) are
+  // then left out as outliers instead of ending the element.
+  // FitMinimax: a least squares fit that misses the tolerance by a little
+  // is moved to the fit with the smallest maximum residual, which allows
+  // longer elements at the same tolerance.
+
+  enum FitMode { FitLs, FitHuber, FitTukey, FitMinimax };
+
+  static const int maxOutlierRun = 2;
+
+private:
   LsAprxEl **elList;
   int cap, sz;
 
+  int *olList;      // Outlier indices of the last interpolate
+  int olCap, olSz;
+
   MsrCont& msrCnt;
 
   double tol;
   double maxRad;
   bool   genNoArcs;
 
+  FitMode fitMode;
+
   void resize(int newSz);
   void append(LsAprxEl& newElem);
+  void appendOutlier(int idx);
 
   void clear();
 
+  bool robust() const { return fitMode == FitHuber || fitMode == FitTukey; }
+  bool minimax() const { return fitMode == FitMinimax; }
+  double weight(double res) const;
+
+  void collectOutliers();
+
   bool unfoldEl(LsAprxEl& el, int uLim);
 
   LsAprxEl *findFstElem();
@@ -219,6 +256,14 @@ public:
   int size() const { return sz; }
   const LsAprxEl& operator[](int idx) const;
 
+  FitMode getFitMode() const { return fitMode; }
+  void setFitMode(FitMode mode) { fitMode = mode; }
+
+  // Indices (into the MsrCont) of the points left out by a robust fit
+
+  int outlierCount() const { return olSz; }
+  int outlierIdx(int idx) const;
+
   bool interpolate();
 
   friend class LsAprxEl;
@@ -27,6 +27,33 @@ namespace Ino
   class DxfOut;
   class Contour;
 
+//---------------------------------------------------------------------------
+//------- Mergeable moments of a set of points (least squares plane) --------
+//---------------------------------------------------------------------------
+
+class PlaneMoments
+{
+  long cnt;
+  Vec3 mean;
+  double cxx, cxy, cxz, cyy, cyz, czz; // Sums of products of deviations
+
+public:
+  PlaneMoments()
+  : cnt(0), mean(), cxx(0.0), cxy(0.0), cxz(0.0),
+                    cyy(0.0), cyz(0.0), czz(0.0) {}
+
+  void clear() { *this = PlaneMoments(); }
+
+  long count() const { return cnt; }
+  const Vec3& getMean() const { return mean; }
+
+  void add(const Vec3& p);
+  void merge(const PlaneMoments& m);
+  void transform(const Trf3& trf);    // As if all points were transformed
+
+  bool fitPlane(Vec3& nrm) const;     // Normal of least squares plane
+};
+
 //---------------------------------------------------------------------------
 //------- A single measurement point ----------------------------------------
 //---------------------------------------------------------------------------
@@ -66,6 +93,9 @@ private:
   MsrPoint *itList;
   int cap, sz;
 
+  mutable PlaneMoments moms; // Of the first momSz points
+  mutable int momSz;
+
   void resize(int newCap);
 
   MsrCont(double radiusCorr, int layer);
@@ -75,6 +105,8 @@ private:
 
   void applyOffset(double axDist, double rollRad,
                                   double horOffset, const Vec3& zDir);
+
+  void transformRange(const Trf3& trf, int lwb, int upb);
 public:
   MsrCont(const MsrCont& cp);
   ~MsrCont();
@@ -93,6 +125,8 @@ public:
 
   bool calcHullRect(Vec3& minPt, Vec3& maxPt) const;
 
+  size_t memSize() const; // Including the unused capacity
+
   double getRadCorr() const { return radCorr; }
   void setRadCorr(double newRadCorr) { radCorr = newRadCorr; }
 
@@ -103,6 +137,8 @@ public:
 
   void transform(const Trf3& trf);
 
+  const PlaneMoments& moments() const; // Updated as points are added
+
   void appendToCcd(DB2* ccdDb, bool threeD, bool unitInch,
                    const Layer& layer) const;
 
@@ -164,6 +200,10 @@ private:
   void findOrgZXDir(bool projectFst,
                     Vec3& org, Vec3& zDir, Vec3& xDir) const;
 
+  long pointCount(int upb) const;
+  void sumMoments(int upb, PlaneMoments& mom) const;
+  void transformAll(const Trf3& trf);
+
 public:
   MsrContLst(double pointTolerance);
   MsrContLst(const MsrContLst& cp);
@@ -197,6 +237,8 @@ public:
 
   bool calcHullRect(Vec3& minPt, Vec3& maxPt) const;
 
+  size_t memSize() const; // Including the unused capacity
+
   bool appendToCcd(DB2* ccdDb, bool threeD, bool unitInch,
                    const char *contourTag) const;
 